@@ -322,7 +322,11 @@ function(ADD_SHOGUN_BENCHMARK REL_BENCHMARK_NAME)
 		set(NO_COLOR "--color_print=false")
 	endif()
 
-	add_test(${BENCHMARK_NAME} ${CMAKE_BINARY_DIR}/bin/${BENCHMARK_NAME} ${NO_COLOR})
+	# results are also written as json, so that runs can be compared
+	set(JSON_OUT "--benchmark_out=${BENCHMARK_OUTPUT_DIR}/${BENCHMARK_NAME}.json"
+		"--benchmark_out_format=json")
+
+	add_test(${BENCHMARK_NAME} ${CMAKE_BINARY_DIR}/bin/${BENCHMARK_NAME} ${NO_COLOR} ${JSON_OUT})
 	set_tests_properties(${BENCHMARK_NAME} PROPERTIES LABELS "benchmark")
 	if(ARGN)
 		set_tests_properties(${BENCHMARK_NAME} PROPERTIES ${ARGN})
@@ -6,6 +6,7 @@
  */
 
 #include <shogun/base/Parallel.h>
+#include <shogun/base/TaskScheduler.h>
 #include <shogun/lib/RefCount.h>
 #include <shogun/lib/config.h>
 #include <shogun/lib/memory.h>
@@ -78,13 +79,25 @@ void Parallel::set_num_threads(int32_t n)
 #if !defined(HAVE_PTHREAD) && !defined(HAVE_OPENMP)
 	ASSERT(n==1)
 #endif
+	std::lock_guard<std::mutex> lock(m_task_scheduler_mutex);
 	num_threads=n;
 #ifdef HAVE_OPENMP
 	omp_set_num_threads(num_threads);
 #endif
+	if (m_task_scheduler && m_task_scheduler->get_num_threads()!=n)
+		m_task_scheduler.reset();
 }
 
 int32_t Parallel::get_num_threads() const
 {
 	return num_threads;
 }
+
+TaskScheduler* Parallel::get_task_scheduler()
+{
+	std::lock_guard<std::mutex> lock(m_task_scheduler_mutex);
+	if (!m_task_scheduler)
+		m_task_scheduler=std::make_unique<TaskScheduler>(num_threads);
+
+	return m_task_scheduler.get();
+}
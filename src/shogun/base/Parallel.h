@@ -12,13 +12,22 @@
 
 #include <shogun/lib/common.h>
 
+#include <memory>
+#include <mutex>
+
 namespace shogun
 {
+class TaskScheduler;
+
 /** @brief Class Parallel provides helper functions for multithreading.
  *
  * For example it can be used to determine the number of CPU cores in your
  * computer and is the place where you define the number of CPUs that shall be
  * used in computations.
+ *
+ * It also owns the work-stealing TaskScheduler all parallel code of the
+ * library runs on, so the number of threads is one budget that is shared
+ * by nested parallel computations.
  */
 class Parallel
 {
@@ -37,7 +46,9 @@ public:
 	 */
 	int32_t get_num_cpus() const;
 
-	/** set number of threads
+	/** set number of threads. Replaces the task scheduler, so no parallel
+	 * computation may be running.
+	 *
 	 * @param n number of threads
 	 */
 	void set_num_threads(int32_t n);
@@ -47,6 +58,15 @@ public:
 	 */
 	int32_t get_num_threads() const;
 
+#ifndef SWIG
+	/** get the scheduler for parallel tasks, which is created on first use
+	 * with get_num_threads() threads
+	 *
+	 * @return task scheduler
+	 */
+	TaskScheduler* get_task_scheduler();
+#endif
+
 	// FIXME: Should be dropped, but needed to be wrappable by some
 	int32_t ref() { return 1; }
 	int32_t ref_count() const { return 1; }
@@ -55,6 +75,13 @@ public:
 private:
 	/** number of threads */
 	int32_t num_threads;
+
+#ifndef SWIG
+	/** task scheduler, created lazily */
+	std::unique_ptr<TaskScheduler> m_task_scheduler;
+	/** guards creation and replacement of the task scheduler */
+	std::mutex m_task_scheduler_mutex;
+#endif
 };
 }
 #endif
@@ -0,0 +1,283 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/base/TaskScheduler.h>
+#include <shogun/io/SGIO.h>
+
+#include <algorithm>
+#include <chrono>
+
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+using namespace shogun;
+
+namespace
+{
+	/** scheduler whose worker the current thread is */
+	thread_local const TaskScheduler* tls_scheduler = nullptr;
+	/** index of the current worker thread */
+	thread_local int32_t tls_worker = -1;
+}
+
+TaskScheduler::TaskScheduler(int32_t num_threads)
+    : m_num_workers(std::max(num_threads, 1) - 1), m_num_queued(0),
+      m_stop(false)
+{
+	for (int32_t i = 0; i < m_num_workers; ++i)
+		m_queues.push_back(std::make_unique<WorkQueue>());
+
+	m_threads.reserve(m_num_workers);
+	for (int32_t i = 0; i < m_num_workers; ++i)
+		m_threads.emplace_back(&TaskScheduler::worker_loop, this, i);
+
+	SG_DEBUG("Task scheduler with {} worker threads", m_num_workers)
+}
+
+TaskScheduler::~TaskScheduler()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+		m_stop = true;
+	}
+	m_wake_up.notify_all();
+
+	for (auto& thread : m_threads)
+		thread.join();
+}
+
+void TaskScheduler::spawn(Task task)
+{
+	int32_t worker = current_worker();
+	WorkQueue& queue = worker >= 0 ? *m_queues[worker] : m_injection_queue;
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.push_back(std::move(task));
+	}
+	m_num_queued.fetch_add(1, std::memory_order_release);
+
+	// taking the lock orders this with a worker checking for work
+	// before going to sleep, so the wake up can not be lost
+	{
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+	}
+	m_wake_up.notify_one();
+}
+
+bool TaskScheduler::run_pending_task()
+{
+	Task task;
+	if (!take_task(current_worker(), task))
+		return false;
+
+	task();
+	return true;
+}
+
+bool TaskScheduler::is_worker() const
+{
+	return tls_scheduler == this;
+}
+
+int32_t TaskScheduler::current_worker() const
+{
+	return is_worker() ? tls_worker : -1;
+}
+
+bool TaskScheduler::take_task(int32_t worker, Task& task)
+{
+	if (m_num_queued.load(std::memory_order_acquire) == 0)
+		return false;
+
+	auto pop = [&task, this](WorkQueue& queue, bool back) {
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.empty())
+			return false;
+
+		if (back)
+		{
+			task = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+		}
+		else
+		{
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+		}
+		m_num_queued.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	};
+
+	// newest own task first, it is the most likely one to be in cache
+	if (worker >= 0 && pop(*m_queues[worker], true))
+		return true;
+
+	if (pop(m_injection_queue, false))
+		return true;
+
+	// steal the oldest task of another worker, which usually is the
+	// largest piece of work in that queue
+	for (int32_t i = 1; i <= m_num_workers; ++i)
+	{
+		int32_t victim = (std::max(worker, 0) + i) % m_num_workers;
+		if (victim != worker && pop(*m_queues[victim], false))
+			return true;
+	}
+
+	return false;
+}
+
+void TaskScheduler::worker_loop(int32_t worker)
+{
+	tls_scheduler = this;
+	tls_worker = worker;
+#ifdef HAVE_OPENMP
+	omp_set_num_threads(1);
+#endif
+
+	while (true)
+	{
+		if (run_pending_task())
+			continue;
+
+		std::unique_lock<std::mutex> lock(m_sleep_mutex);
+		m_wake_up.wait(lock, [this]() {
+			return m_stop || m_num_queued.load(std::memory_order_acquire) > 0;
+		});
+		if (m_stop)
+			return;
+	}
+}
+
+TaskGroup::TaskGroup() : TaskGroup(env()->get_task_scheduler())
+{
+}
+
+TaskGroup::TaskGroup(TaskScheduler* scheduler)
+    : m_scheduler(scheduler), m_pending(0), m_failed(false)
+{
+	ASSERT(m_scheduler)
+}
+
+TaskGroup::~TaskGroup()
+{
+	wait_for_tasks();
+}
+
+void TaskGroup::run(TaskScheduler::Task task)
+{
+	m_pending.fetch_add(1, std::memory_order_relaxed);
+
+	if (m_scheduler->get_num_workers() == 0)
+	{
+		execute(task);
+		return;
+	}
+
+	m_scheduler->spawn([this, task = std::move(task)]() { execute(task); });
+}
+
+void TaskGroup::execute(const TaskScheduler::Task& task)
+{
+	if (!m_failed.load(std::memory_order_relaxed))
+	{
+		try
+		{
+			task();
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!m_error)
+				m_error = std::current_exception();
+			m_failed = true;
+		}
+	}
+
+	// the waiting thread may destroy the group as soon as it sees no
+	// pending tasks, so the last access has to happen under the lock
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		m_done.notify_all();
+}
+
+void TaskGroup::wait_for_tasks()
+{
+	while (true)
+	{
+		if (m_pending.load(std::memory_order_acquire) == 0)
+		{
+			// wait for the finishing task to release the lock
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return;
+		}
+
+		if (m_scheduler->run_pending_task())
+			continue;
+
+		// the remaining tasks are running elsewhere, but they might
+		// spawn further tasks, so only sleep for a short while
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_done.wait_for(lock, std::chrono::microseconds(100), [this]() {
+			return m_pending.load(std::memory_order_acquire) == 0;
+		});
+	}
+}
+
+void TaskGroup::wait()
+{
+	wait_for_tasks();
+
+	std::exception_ptr error;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		std::swap(error, m_error);
+		m_failed = false;
+	}
+	if (error)
+		std::rethrow_exception(error);
+}
+
+namespace
+{
+	void split_range(
+	    TaskGroup& group, index_t begin, index_t end, index_t grain,
+	    const RangeFunction& body)
+	{
+		// hand off the upper halves, so thieves take large pieces
+		while (end - begin > grain)
+		{
+			index_t middle = begin + (end - begin) / 2;
+			group.run([&group, middle, end, grain, &body]() {
+				split_range(group, middle, end, grain, body);
+			});
+			end = middle;
+		}
+		body(begin, end);
+	}
+}
+
+void shogun::parallel_for(
+    index_t begin, index_t end, const RangeFunction& body, index_t grain)
+{
+	if (end <= begin)
+		return;
+
+	TaskScheduler* scheduler = env()->get_task_scheduler();
+	const index_t num_threads = scheduler->get_num_threads();
+	if (grain <= 0)
+		grain = std::max((end - begin) / (4 * num_threads), index_t(1));
+
+	if (num_threads == 1 || end - begin <= grain)
+	{
+		body(begin, end);
+		return;
+	}
+
+	TaskGroup group(scheduler);
+	split_range(group, begin, end, grain, body);
+	group.wait();
+}
@@ -0,0 +1,215 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef TASK_SCHEDULER_H__
+#define TASK_SCHEDULER_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/base/macros.h>
+#include <shogun/lib/common.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace shogun
+{
+/** @brief Work-stealing pool of worker threads.
+ *
+ * A scheduler for n threads starts n-1 workers; the thread that waits for
+ * a TaskGroup is the n-th one and executes queued tasks while waiting.
+ * Every worker owns a double ended queue: tasks spawned by a worker are
+ * pushed to and popped from the back of its own queue, while idle workers
+ * steal from the front of the other queues. Tasks spawned by threads that
+ * are not workers go into a shared injection queue.
+ *
+ * Since waiting threads keep executing tasks, nested parallelism (e.g. a
+ * parallel loop inside a task) composes and never uses more than n threads.
+ * Workers restrict OpenMP to a single thread, so OpenMP regions inside of
+ * tasks do not oversubscribe the machine either.
+ *
+ * The scheduler of the library is owned by Parallel, see
+ * Parallel::get_task_scheduler(). Use TaskGroup and parallel_for rather
+ * than spawning tasks directly.
+ */
+class TaskScheduler
+{
+public:
+	/** a unit of work */
+	typedef std::function<void()> Task;
+
+	/** constructor
+	 *
+	 * @param num_threads number of threads including the waiting thread
+	 */
+	explicit TaskScheduler(int32_t num_threads);
+
+	/** destructor, stops and joins the workers. No TaskGroup of the
+	 * scheduler may be active.
+	 */
+	~TaskScheduler();
+
+	SG_DELETE_COPY_AND_ASSIGN(TaskScheduler);
+
+	/** @return number of threads including the waiting thread */
+	int32_t get_num_threads() const
+	{
+		return m_num_workers + 1;
+	}
+
+	/** @return number of worker threads */
+	int32_t get_num_workers() const
+	{
+		return m_num_workers;
+	}
+
+	/** queue a task for execution by any thread
+	 *
+	 * @param task task to execute
+	 */
+	void spawn(Task task);
+
+	/** execute one queued task on the calling thread, if there is any
+	 *
+	 * @return whether a task was executed
+	 */
+	bool run_pending_task();
+
+	/** @return whether the calling thread is a worker of this scheduler */
+	bool is_worker() const;
+
+private:
+	/** task queue of a worker */
+	struct WorkQueue
+	{
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	/** main loop of worker threads */
+	void worker_loop(int32_t worker);
+
+	/** take a task from the own queue, the injection queue or steal it
+	 *
+	 * @param worker index of the calling worker, -1 for other threads
+	 * @param task the task taken
+	 * @return whether a task was found
+	 */
+	bool take_task(int32_t worker, Task& task);
+
+	/** @return index of the calling worker, -1 if it is not one */
+	int32_t current_worker() const;
+
+	/** number of worker threads */
+	int32_t m_num_workers;
+	/** per worker queues */
+	std::vector<std::unique_ptr<WorkQueue>> m_queues;
+	/** queue for tasks spawned by threads other than the workers */
+	WorkQueue m_injection_queue;
+	/** worker threads */
+	std::vector<std::thread> m_threads;
+
+	/** number of tasks in all queues */
+	std::atomic<int64_t> m_num_queued;
+	/** set when the workers shall exit */
+	bool m_stop;
+	/** guards m_stop and sleeping */
+	std::mutex m_sleep_mutex;
+	/** signalled when tasks are queued or the workers shall exit */
+	std::condition_variable m_wake_up;
+};
+
+/** @brief Set of tasks that are waited for together.
+ *
+ * Tasks are run on the scheduler's threads; wait() blocks until all tasks
+ * of the group have finished, executing queued tasks in the meantime.
+ * If a task throws, tasks of the group that have not started yet are
+ * skipped and wait() rethrows the first exception.
+ *
+ * A TaskGroup must not be shared between threads except by the tasks it
+ * runs, which may add further tasks to it.
+ */
+class TaskGroup
+{
+public:
+	/** constructor for a group using the scheduler of the library */
+	TaskGroup();
+
+	/** constructor
+	 *
+	 * @param scheduler scheduler to run the tasks on
+	 */
+	explicit TaskGroup(TaskScheduler* scheduler);
+
+	/** destructor, waits for all tasks but discards their exceptions */
+	~TaskGroup();
+
+	SG_DELETE_COPY_AND_ASSIGN(TaskGroup);
+
+	/** run a task as part of the group. Without worker threads the task
+	 * is executed immediately.
+	 *
+	 * @param task task to run
+	 */
+	void run(TaskScheduler::Task task);
+
+	/** wait for all tasks of the group, rethrowing the first exception
+	 * thrown by any of them
+	 */
+	void wait();
+
+	/** @return scheduler of the group */
+	TaskScheduler* get_scheduler() const
+	{
+		return m_scheduler;
+	}
+
+private:
+	/** execute a task and account for its completion */
+	void execute(const TaskScheduler::Task& task);
+
+	/** block until no task is pending */
+	void wait_for_tasks();
+
+	/** scheduler the tasks run on */
+	TaskScheduler* m_scheduler;
+	/** number of tasks that have not finished */
+	std::atomic<int64_t> m_pending;
+	/** set once a task has thrown */
+	std::atomic<bool> m_failed;
+	/** first exception thrown by a task */
+	std::exception_ptr m_error;
+	/** guards m_error and finishing tasks */
+	std::mutex m_mutex;
+	/** signalled when the last pending task finished */
+	std::condition_variable m_done;
+};
+
+/** function processing the indices [start, stop) of a range */
+typedef std::function<void(index_t, index_t)> RangeFunction;
+
+/** process [begin, end) in parallel on the scheduler of the library.
+ *
+ * The range is split recursively into chunks of at most grain indices,
+ * idle threads steal the larger halves, so uneven chunks balance out.
+ * Returns once the whole range has been processed; exceptions thrown by
+ * the body are rethrown.
+ *
+ * @param begin first index
+ * @param end index one past the last one
+ * @param body function called with [start, stop) of every chunk
+ * @param grain maximum number of indices in a chunk, 0 picks a size that
+ * gives a few chunks per thread
+ */
+void parallel_for(
+    index_t begin, index_t end, const RangeFunction& body, index_t grain = 0);
+}
+#endif
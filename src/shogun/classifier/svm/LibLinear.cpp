@@ -8,9 +8,13 @@
 #include <shogun/lib/config.h>
 
 #include <shogun/base/Parameter.h>
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/base/TaskScheduler.h>
 #include <shogun/base/progress.h>
 #include <shogun/classifier/svm/LibLinear.h>
+#include <shogun/features/DenseFeatures.h>
 #include <shogun/features/DotFeatures.h>
+#include <shogun/features/SparseFeatures.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/labels/BinaryLabels.h>
 #include <shogun/lib/Signal.h>
@@ -19,9 +23,152 @@
 #include <shogun/mathematics/RandomNamespace.h>
 #include <shogun/mathematics/UniformIntDistribution.h>
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 using namespace shogun;
 
+namespace
+{
+	// number of coordinates updated by one task of the asynchronous solvers
+	const index_t async_grain = 1024;
+
+	/* primal weights shared by the threads of the asynchronous coordinate
+	 * descent solvers. The threads read and update w without locking, every
+	 * element is updated atomically so that no update gets lost, but a dot
+	 * product may see the updates of other threads only partially.
+	 */
+	class AsyncWeights
+	{
+	public:
+		AsyncWeights(const liblinear_problem* prob, int32_t dim)
+		    : m_features(prob->x), m_dim(dim), m_use_bias(prob->use_bias),
+		      m_w(new std::atomic<float64_t>[dim + 1])
+		{
+			for (int32_t j = 0; j <= m_dim; j++)
+				m_w[j].store(0, std::memory_order_relaxed);
+
+			if (m_features->get_feature_type() != F_DREAL)
+				return;
+
+			if (m_features->get_feature_class() == C_DENSE)
+				m_dense = (CDenseFeatures<float64_t>*)m_features;
+			else if (m_features->get_feature_class() == C_SPARSE)
+			{
+				m_sparse = (CSparseFeatures<float64_t>*)m_features;
+
+				// CSR vectors are read from the flat arrays, as
+				// get_sparse_feature_vector() would copy them
+				CSubsetStack* subset_stack = m_sparse->get_subset_stack();
+				if (m_sparse->is_csr() && !subset_stack->has_subsets())
+				{
+					m_csr_offsets = m_sparse->get_csr_offsets();
+					m_csr_indices = m_sparse->get_csr_indices();
+					m_csr_values = m_sparse->get_csr_values();
+				}
+				SG_UNREF(subset_stack);
+			}
+		}
+
+		/** @return w^T x_i, plus the bias if used */
+		float64_t dot(int32_t i) const
+		{
+			float64_t result = 0;
+			for_each_feature(i, [&](int32_t j, float64_t value) {
+				result += value * m_w[j].load(std::memory_order_relaxed);
+			});
+
+			if (m_use_bias)
+				result += m_w[m_dim].load(std::memory_order_relaxed);
+
+			return result;
+		}
+
+		/** w += alpha * x_i, and the bias += alpha if used */
+		void add(int32_t i, float64_t alpha)
+		{
+			for_each_feature(i, [&](int32_t j, float64_t value) {
+				atomic_add(m_w[j], alpha * value);
+			});
+
+			if (m_use_bias)
+				atomic_add(m_w[m_dim], alpha);
+		}
+
+		/** copies w, with the bias in w[dim] if used */
+		void get(SGVector<float64_t>& w) const
+		{
+			for (int32_t j = 0; j < m_dim; j++)
+				w.vector[j] = m_w[j].load(std::memory_order_relaxed);
+
+			if (m_use_bias)
+				w.vector[m_dim] = m_w[m_dim].load(std::memory_order_relaxed);
+		}
+
+	private:
+		static void atomic_add(std::atomic<float64_t>& target, float64_t value)
+		{
+			float64_t old = target.load(std::memory_order_relaxed);
+			while (!target.compare_exchange_weak(
+			    old, old + value, std::memory_order_relaxed))
+				;
+		}
+
+		template <class F>
+		void for_each_feature(int32_t i, F f) const
+		{
+			if (m_dense)
+			{
+				int32_t len;
+				bool dofree;
+				float64_t* vec = m_dense->get_feature_vector(i, len, dofree);
+				for (int32_t j = 0; j < len; j++)
+					f(j, vec[j]);
+				m_dense->free_feature_vector(vec, i, dofree);
+				return;
+			}
+
+			if (m_csr_offsets.vlen)
+			{
+				for (index_t k = m_csr_offsets[i]; k < m_csr_offsets[i + 1]; k++)
+					f(m_csr_indices[k], m_csr_values[k]);
+				return;
+			}
+
+			if (m_sparse)
+			{
+				SGSparseVector<float64_t> vec =
+				    m_sparse->get_sparse_feature_vector(i);
+				for (int32_t k = 0; k < vec.num_feat_entries; k++)
+					f(vec.features[k].feat_index, vec.features[k].entry);
+				m_sparse->free_sparse_feature_vector(i);
+				return;
+			}
+
+			int32_t index;
+			float64_t value;
+			void* it = m_features->get_feature_iterator(i);
+			while (m_features->get_next_feature(index, value, it))
+				f(index, value);
+			m_features->free_feature_iterator(it);
+		}
+
+		CDotFeatures* m_features;
+		CDenseFeatures<float64_t>* m_dense = NULL;
+		CSparseFeatures<float64_t>* m_sparse = NULL;
+		SGVector<index_t> m_csr_offsets;
+		SGVector<index_t> m_csr_indices;
+		SGVector<float64_t> m_csr_values;
+		int32_t m_dim;
+		bool m_use_bias;
+		std::unique_ptr<std::atomic<float64_t>[]> m_w;
+	};
+} // namespace
+
 CLibLinear::CLibLinear() : RandomMixin<CLinearMachine>()
 {
 	init();
@@ -52,6 +199,7 @@ void CLibLinear::init()
 	set_C(1, 1);
 	set_max_iterations();
 	set_epsilon(1e-5);
+	m_async_coordinate_descent = false;
 
 	SG_ADD(&C1, "C1", "C Cost constant 1.", ParameterProperties::HYPER);
 	SG_ADD(&C2, "C2", "C Cost constant 2.", ParameterProperties::HYPER);
@@ -59,6 +207,11 @@ void CLibLinear::init()
 	SG_ADD(&epsilon, "epsilon", "Convergence precision.", ParameterProperties::HYPER);
 	SG_ADD(&max_iterations, "max_iterations", "Max number of iterations.", ParameterProperties::HYPER);
 	SG_ADD(&m_linear_term, "linear_term", "Linear Term", ParameterProperties::MODEL);
+	SG_ADD(
+	    &m_async_coordinate_descent, "async_coordinate_descent",
+	    "Whether the dual coordinate descent solvers update w asynchronously "
+	    "from multiple threads.",
+	    ParameterProperties::SETTING);
 	SG_ADD_OPTIONS(
 	    (machine_int_t*)&liblinear_solver_type, "liblinear_solver_type",
 	    "Type of LibLinear solver.", ParameterProperties::SETTING,
@@ -165,6 +318,9 @@ bool CLibLinear::train_machine(CFeatures* data)
 
 	io::info("{} training points {} dims", prob.l, prob.n);
 
+	const bool async =
+	    m_async_coordinate_descent && env()->get_num_threads() > 1;
+
 	function* fun_obj = NULL;
 	switch (solver_type)
 	{
@@ -191,12 +347,12 @@ bool CLibLinear::train_machine(CFeatures* data)
 		break;
 	}
 	case L2R_L2LOSS_SVC_DUAL:
-		solve_l2r_l1l2_svc(
-		    w, &prob, get_epsilon(), Cp, Cn, L2R_L2LOSS_SVC_DUAL);
-		break;
 	case L2R_L1LOSS_SVC_DUAL:
-		solve_l2r_l1l2_svc(
-		    w, &prob, get_epsilon(), Cp, Cn, L2R_L1LOSS_SVC_DUAL);
+		if (async)
+			solve_l2r_l1l2_svc_async(
+			    w, &prob, get_epsilon(), Cp, Cn, solver_type);
+		else
+			solve_l2r_l1l2_svc(w, &prob, get_epsilon(), Cp, Cn, solver_type);
 		break;
 	case L1R_L2LOSS_SVC:
 	{
@@ -214,7 +370,10 @@ bool CLibLinear::train_machine(CFeatures* data)
 	}
 	case L2R_LR_DUAL:
 	{
-		solve_l2r_lr_dual(w, &prob, get_epsilon(), Cp, Cn);
+		if (async)
+			solve_l2r_lr_dual_async(w, &prob, get_epsilon(), Cp, Cn);
+		else
+			solve_l2r_lr_dual(w, &prob, get_epsilon(), Cp, Cn);
 		break;
 	}
 	default:
@@ -337,7 +496,7 @@ void CLibLinear::solve_l2r_l1l2_svc(
 		PGmax_new = -CMath::INFTY;
 		PGmin_new = CMath::INFTY;
 
-		random::shuffle(index, index+active_size, m_prng);
+		shuffle_indices(prob, index, active_size);
 
 		for (s = 0; s < active_size; s++)
 		{
@@ -1262,7 +1421,7 @@ void CLibLinear::solve_l2r_lr_dual(
 	auto pb = SG_PROGRESS(range(10));
 	while (iter < max_iter)
 	{
-		random::shuffle(index, index+l, m_prng);
+		shuffle_indices(prob, index, l);
 		int newton_iter = 0;
 		double Gmax = 0;
 		for (s = 0; s < l; s++)
@@ -1368,6 +1527,344 @@ void CLibLinear::solve_l2r_lr_dual(
 	delete[] index;
 }
 
+// Asynchronous variants of the dual coordinate descent solvers above.
+//
+// The coordinates of every epoch are shuffled and split among the threads,
+// which update the shared w without locking (Hogwild, Niu et al. 2011). Every
+// thread owns the alphas of its coordinates for the epoch, so only w is
+// shared. There is no shrinking, as the active set would have to be shared as
+// well.
+
+#undef GETI
+#define GETI(i) (y[i] + 1)
+// To support weights for instances, use GETI(i) (i)
+
+void CLibLinear::solve_l2r_l1l2_svc_async(
+    SGVector<float64_t>& w, const liblinear_problem* prob, double eps,
+    double Cp, double Cn, LIBLINEAR_SOLVER_TYPE st)
+{
+	int l = prob->l;
+	int w_size = prob->n;
+	int iter = 0;
+	SGVector<float64_t> QD(l);
+	SGVector<int32_t> index(l);
+	SGVector<float64_t> alpha(l);
+	SGVector<int32_t> y(l);
+
+	SGVector<float64_t> linear_term;
+	if (linear_term_inited())
+	{
+		linear_term = get_linear_term();
+	}
+
+	// default solver_type: L2R_L2LOSS_SVC_DUAL
+	double diag[3] = {0.5 / Cn, 0, 0.5 / Cp};
+	double upper_bound[3] = {CMath::INFTY, 0, CMath::INFTY};
+	if (st == L2R_L1LOSS_SVC_DUAL)
+	{
+		diag[0] = 0;
+		diag[2] = 0;
+		upper_bound[0] = Cn;
+		upper_bound[2] = Cp;
+	}
+
+	int n = prob->n;
+
+	if (prob->use_bias)
+		n--;
+
+	AsyncWeights shared_w(prob, n);
+	parallel_for(0, l, [&](index_t begin, index_t end) {
+		for (index_t i = begin; i < end; i++)
+		{
+			alpha[i] = 0;
+			y[i] = prob->y[i] > 0 ? +1 : -1;
+			QD[i] = diag[GETI(i)] + prob->x->dot(i, prob->x, i);
+			index[i] = i;
+		}
+	}, async_grain);
+
+	std::mutex mutex;
+	auto pb = SG_PROGRESS(range(10));
+	CTime start_time;
+	while (iter < get_max_iterations())
+	{
+		COMPUTATION_CONTROLLERS
+		if (m_max_train_time > 0 &&
+		    start_time.cur_time_diff() > m_max_train_time)
+			break;
+
+		double PGmax_new = -CMath::INFTY;
+		double PGmin_new = CMath::INFTY;
+
+		shuffle_indices(prob, index.vector, l);
+
+		parallel_for(0, l, [&](index_t begin, index_t end) {
+			double PGmax = -CMath::INFTY;
+			double PGmin = CMath::INFTY;
+			for (index_t s = begin; s < end; s++)
+			{
+				int32_t i = index[s];
+				int32_t yi = y[i];
+
+				double G = shared_w.dot(i);
+				if (linear_term.vector)
+					G = G * yi + linear_term.vector[i];
+				else
+					G = G * yi - 1;
+
+				double C = upper_bound[GETI(i)];
+				G += alpha[i] * diag[GETI(i)];
+
+				double PG = 0;
+				if (alpha[i] == 0)
+				{
+					if (G < 0)
+						PG = G;
+				}
+				else if (alpha[i] == C)
+				{
+					if (G > 0)
+						PG = G;
+				}
+				else
+					PG = G;
+
+				PGmax = CMath::max(PGmax, PG);
+				PGmin = CMath::min(PGmin, PG);
+
+				if (fabs(PG) > 1.0e-12)
+				{
+					double alpha_old = alpha[i];
+					alpha[i] =
+					    CMath::min(CMath::max(alpha[i] - G / QD[i], 0.0), C);
+					shared_w.add(i, (alpha[i] - alpha_old) * yi);
+				}
+			}
+
+			std::lock_guard<std::mutex> lock(mutex);
+			PGmax_new = CMath::max(PGmax_new, PGmax);
+			PGmin_new = CMath::min(PGmin_new, PGmin);
+		}, async_grain);
+
+		iter++;
+
+		float64_t gap=PGmax_new - PGmin_new;
+		pb.print_absolute(
+		    gap, -CMath::log10(gap), -CMath::log10(1), -CMath::log10(eps));
+
+		if (gap <= eps)
+			break;
+	}
+
+	pb.complete_absolute();
+	io::info("optimization finished, #iter = {}",iter);
+	if (iter >= get_max_iterations())
+	{
+		io::warn(
+		    "reaching max number of iterations\nUsing -s 2 may be faster"
+		    "(also see liblinear FAQ)\n\n");
+	}
+
+	shared_w.get(w);
+
+	// calculate objective value
+
+	double v = 0;
+	int nSV = 0;
+	for (int i = 0; i < w_size; i++)
+		v += w.vector[i] * w.vector[i];
+	for (int i = 0; i < l; i++)
+	{
+		v += alpha[i] * (alpha[i] * diag[GETI(i)] - 2);
+		if (alpha[i] > 0)
+			++nSV;
+	}
+	io::info("Objective value = {}", v / 2);
+	io::info("nSV = {}", nSV);
+}
+
+void CLibLinear::solve_l2r_lr_dual_async(
+    SGVector<float64_t>& w, const liblinear_problem* prob, double eps,
+    double Cp, double Cn)
+{
+	int l = prob->l;
+	int w_size = prob->n;
+	int iter = 0;
+	SGVector<float64_t> xTx(l);
+	int max_iter = 1000;
+	SGVector<int32_t> index(l);
+	SGVector<float64_t> alpha(2 * l); // store alpha and C - alpha
+	SGVector<int32_t> y(l);
+	int max_inner_iter = 100; // for inner Newton
+	double innereps = 1e-2;
+	double innereps_min = CMath::min(1e-8, eps);
+	double upper_bound[3] = {Cn, 0, Cp};
+	double Gmax_init = 0;
+
+	// Initial alpha can be set here. Note that
+	// 0 < alpha[i] < upper_bound[GETI(i)]
+	// alpha[2*i] + alpha[2*i+1] = upper_bound[GETI(i)]
+	AsyncWeights shared_w(prob, w_size);
+	parallel_for(0, l, [&](index_t begin, index_t end) {
+		for (index_t i = begin; i < end; i++)
+		{
+			y[i] = prob->y[i] > 0 ? +1 : -1;
+			alpha[2 * i] = CMath::min(0.001 * upper_bound[GETI(i)], 1e-8);
+			alpha[2 * i + 1] = upper_bound[GETI(i)] - alpha[2 * i];
+
+			xTx[i] = prob->x->dot(i, prob->x, i);
+			if (prob->use_bias)
+				xTx[i] += 1;
+			shared_w.add(i, y[i] * alpha[2 * i]);
+			index[i] = i;
+		}
+	}, async_grain);
+
+	std::mutex mutex;
+	auto pb = SG_PROGRESS(range(10));
+	while (iter < max_iter)
+	{
+		COMPUTATION_CONTROLLERS
+
+		shuffle_indices(prob, index.vector, l);
+		int newton_iter = 0;
+		double Gmax = 0;
+
+		parallel_for(0, l, [&](index_t begin, index_t end) {
+			int block_newton_iter = 0;
+			double block_Gmax = 0;
+			for (index_t s = begin; s < end; s++)
+			{
+				int32_t i = index[s];
+				int32_t yi = y[i];
+				double C = upper_bound[GETI(i)];
+				double a = xTx[i], b = shared_w.dot(i) * yi;
+
+				// Decide to minimize g_1(z) or g_2(z)
+				int ind1 = 2 * i, ind2 = 2 * i + 1, sign = 1;
+				if (0.5 * a * (alpha[ind2] - alpha[ind1]) + b < 0)
+				{
+					ind1 = 2 * i + 1;
+					ind2 = 2 * i;
+					sign = -1;
+				}
+
+				//  g_t(z) = z*log(z) + (C-z)*log(C-z) + 0.5a(z-alpha_old)^2 +
+				//  sign*b(z-alpha_old)
+				double alpha_old = alpha[ind1];
+				double z = alpha_old;
+				if (C - z < 0.5 * C)
+					z = 0.1 * z;
+				double gp =
+				    a * (z - alpha_old) + sign * b + std::log(z / (C - z));
+				block_Gmax = CMath::max(block_Gmax, CMath::abs(gp));
+
+				// Newton method on the sub-problem
+				const double eta = 0.1; // xi in the paper
+				int inner_iter = 0;
+				while (inner_iter <= max_inner_iter)
+				{
+					if (fabs(gp) < innereps)
+						break;
+					double gpp = a + C / (C - z) / z;
+					double tmpz = z - gp / gpp;
+					if (tmpz <= 0)
+						z *= eta;
+					else // tmpz in (0, C)
+						z = tmpz;
+					gp = a * (z - alpha_old) + sign * b + log(z / (C - z));
+					block_newton_iter++;
+					inner_iter++;
+				}
+
+				if (inner_iter > 0) // update w
+				{
+					alpha[ind1] = z;
+					alpha[ind2] = C - z;
+					shared_w.add(i, sign * (z - alpha_old) * yi);
+				}
+			}
+
+			std::lock_guard<std::mutex> lock(mutex);
+			newton_iter += block_newton_iter;
+			Gmax = CMath::max(Gmax, block_Gmax);
+		}, async_grain);
+
+		if (iter == 0)
+			Gmax_init = Gmax;
+		iter++;
+
+		pb.print_absolute(
+		    Gmax, -CMath::log10(Gmax), -CMath::log10(Gmax_init),
+		    -CMath::log10(eps * Gmax_init));
+
+		if (Gmax < eps)
+			break;
+
+		if (newton_iter <= l / 10)
+			innereps = CMath::max(innereps_min, 0.1 * innereps);
+	}
+
+	pb.complete_absolute();
+	io::info("optimization finished, #iter = {}",iter);
+
+	if (iter >= get_max_iterations())
+		io::warn("reaching max number of iterations\nUsing -s 0 may be "
+		           "faster (also see FAQ)\n\n");
+
+	shared_w.get(w);
+
+	// calculate objective value
+
+	double v = 0;
+	for (int i = 0; i < w_size; i++)
+		v += w[i] * w[i];
+	v *= 0.5;
+	for (int i = 0; i < l; i++)
+		v += alpha[2 * i] * log(alpha[2 * i]) +
+		     alpha[2 * i + 1] * log(alpha[2 * i + 1]) -
+		     upper_bound[GETI(i)] * log(upper_bound[GETI(i)]);
+	io::info("Objective value = {}", v);
+}
+
+void CLibLinear::shuffle_indices(
+    const liblinear_problem* prob, int32_t* index, int32_t len)
+{
+	if (len == 0 || prob->x->get_vector_block(index[0]) < 0)
+	{
+		random::shuffle(index, index + len, m_prng);
+		return;
+	}
+
+	// sorted by block, and by index for an order that does not depend on
+	// the previous one
+	std::vector<std::pair<int32_t, int32_t>> blocks(len);
+	for (int32_t i = 0; i < len; i++)
+		blocks[i] = std::make_pair(prob->x->get_vector_block(index[i]), index[i]);
+	std::sort(blocks.begin(), blocks.end());
+
+	// [begin, end) of every block in blocks
+	std::vector<std::pair<int32_t, int32_t>> block_ranges;
+	for (int32_t begin = 0, end; begin < len; begin = end)
+	{
+		for (end = begin + 1;
+		     end < len && blocks[end].first == blocks[begin].first; end++)
+			;
+		block_ranges.emplace_back(begin, end);
+	}
+	random::shuffle(block_ranges, m_prng);
+
+	int32_t k = 0;
+	for (const auto& block : block_ranges)
+	{
+		int32_t* first = index + k;
+		for (int32_t i = block.first; i < block.second; i++)
+			index[k++] = blocks[i].second;
+		random::shuffle(first, index + k, m_prng);
+	}
+}
+
 void CLibLinear::set_linear_term(const SGVector<float64_t> linear_term)
 {
 	if (!m_labels)
@@ -193,6 +193,24 @@ namespace shogun
 			max_iterations = max_iter;
 		}
 
+		/** set whether the dual coordinate descent solvers (L2R_L1LOSS_SVC_DUAL,
+		 * L2R_L2LOSS_SVC_DUAL and L2R_LR_DUAL) update the weights
+		 * asynchronously from all threads. This scales to very many examples,
+		 * but the solution depends on the scheduling of the threads.
+		 *
+		 * @param async whether to use the asynchronous solvers
+		 */
+		inline void set_async_coordinate_descent(bool async)
+		{
+			m_async_coordinate_descent = async;
+		}
+
+		/** @return whether the asynchronous dual solvers are used */
+		inline bool get_async_coordinate_descent()
+		{
+			return m_async_coordinate_descent;
+		}
+
 		/** set the linear term for qp */
 		void set_linear_term(const SGVector<float64_t> linear_term);
 
@@ -228,6 +246,18 @@ namespace shogun
 		/** set up parameters */
 		void init();
 
+		/** shuffle the visit order of the vectors of the dual solvers.
+		 * For features stored in blocks (CDotFeatures::get_vector_block())
+		 * the blocks are visited in random order and the vectors of a block
+		 * in random order, so that every pass reads each block once.
+		 *
+		 * @param prob problem whose vectors are visited
+		 * @param index indices of the vectors to visit
+		 * @param len number of indices
+		 */
+		void shuffle_indices(
+		    const liblinear_problem* prob, int32_t* index, int32_t len);
+
 		void train_one(
 		    const liblinear_problem* prob, const liblinear_parameter* param,
 		    double Cp, double Cn);
@@ -245,6 +275,13 @@ namespace shogun
 		    SGVector<float64_t>& w, const liblinear_problem* prob, double eps,
 		    double Cp, double Cn);
 
+		void solve_l2r_l1l2_svc_async(
+		    SGVector<float64_t>& w, const liblinear_problem* prob, double eps,
+		    double Cp, double Cn, LIBLINEAR_SOLVER_TYPE st);
+		void solve_l2r_lr_dual_async(
+		    SGVector<float64_t>& w, const liblinear_problem* prob, double eps,
+		    double Cp, double Cn);
+
 	protected:
 		/** C1 */
 		float64_t C1;
@@ -262,6 +299,9 @@ namespace shogun
 
 		/** solver type */
 		LIBLINEAR_SOLVER_TYPE liblinear_solver_type;
+
+		/** whether the dual solvers update w asynchronously */
+		bool m_async_coordinate_descent;
 	};
 
 } /* namespace shogun  */
@@ -36,10 +36,19 @@ CLibSVM::~CLibSVM()
 
 void CLibSVM::register_params()
 {
+	m_use_kernel_row_cache = false;
+	m_parallel_grain = LIBSVM_PARALLEL_GRAIN;
+
 	SG_ADD_OPTIONS(
 	    (machine_int_t*)&solver_type, "libsvm_solver_type",
 	    "LibSVM Solver type", ParameterProperties::SETTING,
 	    SG_OPTIONS(LIBSVM_C_SVC, LIBSVM_NU_SVC));
+	SG_ADD(&m_use_kernel_row_cache, "use_kernel_row_cache",
+	    "Whether kernel rows are read from the kernel's row cache",
+	    ParameterProperties::SETTING);
+	SG_ADD(&m_parallel_grain, "parallel_grain",
+	    "Minimum number of examples per task of the parallel loops",
+	    ParameterProperties::SETTING);
 }
 
 bool CLibSVM::train_machine(CFeatures* data)
@@ -137,6 +146,8 @@ bool CLibSVM::train_machine(CFeatures* data)
 	param.weight_label = weights_label;
 	param.weight = weights;
 	param.use_bias = get_bias_enabled();
+	param.use_kernel_row_cache = m_use_kernel_row_cache;
+	param.parallel_grain = m_parallel_grain;
 
 	const char* error_msg = svm_check_parameter(&problem, &param);
 
@@ -57,6 +57,46 @@ class CLibSVM : public CSVM
 		/** @return object name */
 		virtual const char* get_name() const { return "LibSVM"; }
 
+		/** read the rows of the kernel matrix from the shared row cache of
+		 * the kernel rather than computing them. This pays off when
+		 * several machines are trained at the same time on one kernel, as
+		 * done by CKernelMulticlassMachine, since every row is computed
+		 * only once for all of them.
+		 *
+		 * @param use_kernel_row_cache whether to use the kernel's row cache
+		 */
+		void set_use_kernel_row_cache(bool use_kernel_row_cache)
+		{
+			m_use_kernel_row_cache=use_kernel_row_cache;
+		}
+
+		/** @return whether the kernel's row cache is used */
+		bool get_use_kernel_row_cache() const
+		{
+			return m_use_kernel_row_cache;
+		}
+
+		/** set the minimum number of examples per task of the parallel
+		 * loops over the examples, LIBSVM_PARALLEL_GRAIN by default. The
+		 * solution does not depend on it, nor on the number of threads.
+		 *
+		 * @param parallel_grain minimum number of examples per task
+		 */
+		void set_parallel_grain(int32_t parallel_grain)
+		{
+			require(parallel_grain > 0,
+				"Parallel grain ({}) must be positive", parallel_grain);
+			m_parallel_grain=parallel_grain;
+		}
+
+		/** @return minimum number of examples per task of the parallel
+		 * loops
+		 */
+		int32_t get_parallel_grain() const
+		{
+			return m_parallel_grain;
+		}
+
 	private:
 		void register_params();
 
@@ -74,6 +114,10 @@ class CLibSVM : public CSVM
 	protected:
 		/** solver type */
 		LIBSVM_SOLVER_TYPE solver_type;
+		/** whether kernel rows are read from the kernel's row cache */
+		bool m_use_kernel_row_cache;
+		/** minimum number of examples per task of the parallel loops */
+		int32_t m_parallel_grain;
 };
 }
 #endif
@@ -440,12 +440,6 @@ class CSVMLight : public CSVM
 	float64_t* a_old, int32_t *working2dnum, int32_t totdoc, float64_t *lin,
 	float64_t *aicache, float64_t* c);
 
-  /** helper for update linear component MKL linadd
-   *
-   * @param p p
-   */
-  static void* update_linear_component_mkl_linadd_helper(void* p);
-
   /** update linear component MKL
    *
    * @param docs docs
@@ -610,29 +604,18 @@ protected:
 		return kernel->kernel(i, j);
 	}
 
-	/** helper for compute kernel
-	 *
-	 * @param p p
-	 */
-	static void* compute_kernel_helper(void* p);
-
-	/** helper for update linear component linadd
-	 *
-	 * @param p p
-	 */
-	static void* update_linear_component_linadd_helper(void* p);
-
-	/** helper for reactivate inactive examples vanilla
-	 *
-	 * @param p p
-	 */
-	static void* reactivate_inactive_examples_vanilla_helper(void* p);
-
-	/** helper for reactivate inactive examples linadd
+	/** add a scaled kernel row to the gradient, in parallel over the
+	 * given examples
 	 *
-	 * @param p p
+	 * @param lin linear component of the gradient
+	 * @param row kernel row
+	 * @param index2dnum indices of the examples to update
+	 * @param num_index number of indices
+	 * @param factor scale of the row
 	 */
-	static void* reactivate_inactive_examples_linadd_helper(void* p);
+	static void update_lin(
+		float64_t* lin, const float64_t* row, const int32_t* index2dnum,
+		int32_t num_index, float64_t factor);
 
 	/* interface to QP-solver */
 	float64_t *optimize_qp( QP *qp,float64_t *epsilon_crit, int32_t nx,
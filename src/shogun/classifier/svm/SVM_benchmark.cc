@@ -0,0 +1,107 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <shogun/base/some.h>
+#include <shogun/classifier/svm/LibLinear.h>
+#include <shogun/classifier/svm/LibSVM.h>
+#include <shogun/classifier/svm/SVMLight.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/labels/BinaryLabels.h>
+#include <shogun/util/benchmark_data.h>
+
+namespace shogun
+{
+
+class SVMFixture : public benchmark::Fixture
+{
+public:
+	void SetUp(const ::benchmark::State& st)
+	{
+		SGVector<float64_t> lab;
+		feats = new CDenseFeatures<float64_t>(
+		    benchmark_binary_blobs(st.range(1), st.range(0), lab));
+		labels = new CBinaryLabels(lab);
+		SG_REF(feats);
+		SG_REF(labels);
+	}
+
+	void TearDown(const ::benchmark::State&)
+	{
+		SG_UNREF(feats);
+		SG_UNREF(labels);
+	}
+
+	void train_liblinear(benchmark::State& state, LIBLINEAR_SOLVER_TYPE solver)
+	{
+		for (auto _ : state)
+		{
+			auto svm = some<CLibLinear>(1.0, feats, labels);
+			svm->set_liblinear_solver_type(solver);
+			svm->set_epsilon(1e-3);
+			svm->train();
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	template <class T>
+	void train_kernel_svm(benchmark::State& state)
+	{
+		for (auto _ : state)
+		{
+			auto kernel = some<CGaussianKernel>(feats, feats, 2.0 * state.range(1));
+			auto svm = some<T>(1.0, kernel, labels);
+			svm->train();
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	CDenseFeatures<float64_t>* feats;
+	CBinaryLabels* labels;
+};
+
+BENCHMARK_DEFINE_F(SVMFixture, LibLinear_l2r_l2loss_dual)(benchmark::State& state)
+{
+	train_liblinear(state, L2R_L2LOSS_SVC_DUAL);
+}
+
+BENCHMARK_DEFINE_F(SVMFixture, LibLinear_l2r_l1loss_dual)(benchmark::State& state)
+{
+	train_liblinear(state, L2R_L1LOSS_SVC_DUAL);
+}
+
+BENCHMARK_DEFINE_F(SVMFixture, LibLinear_l2r_lr)(benchmark::State& state)
+{
+	train_liblinear(state, L2R_LR);
+}
+
+BENCHMARK_DEFINE_F(SVMFixture, LibSVM_gaussian)(benchmark::State& state)
+{
+	train_kernel_svm<CLibSVM>(state);
+}
+
+BENCHMARK_REGISTER_F(SVMFixture, LibLinear_l2r_l2loss_dual)
+    ->RangeMultiplier(4)->Ranges(BENCHMARK_LARGE_SCALE)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(SVMFixture, LibLinear_l2r_l1loss_dual)
+    ->RangeMultiplier(4)->Ranges(BENCHMARK_LARGE_SCALE)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(SVMFixture, LibLinear_l2r_lr)
+    ->RangeMultiplier(4)->Ranges(BENCHMARK_LARGE_SCALE)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(SVMFixture, LibSVM_gaussian)
+    ->RangeMultiplier(4)->Ranges(BENCHMARK_SMALL_SCALE)->Unit(benchmark::kMillisecond);
+
+#ifdef USE_SVMLIGHT
+BENCHMARK_DEFINE_F(SVMFixture, SVMLight_gaussian)(benchmark::State& state)
+{
+	train_kernel_svm<CSVMLight>(state);
+}
+
+BENCHMARK_REGISTER_F(SVMFixture, SVMLight_gaussian)
+    ->RangeMultiplier(4)->Ranges(BENCHMARK_SMALL_SCALE)->Unit(benchmark::kMillisecond);
+#endif //USE_SVMLIGHT
+
+}
@@ -7,6 +7,7 @@
 
 #include <shogun/base/Parallel.h>
 #include <shogun/base/progress.h>
+#include <shogun/base/TaskScheduler.h>
 #include <shogun/clustering/Hierarchical.h>
 #include <shogun/distance/Distance.h>
 #include <shogun/features/Features.h>
@@ -108,17 +109,27 @@ bool CHierarchical::train_machine(CFeatures* data)
 	pair* index=SG_MALLOC(pair, num_pairs);
 	float64_t* distances=SG_MALLOC(float64_t, num_pairs);
 
-	int32_t offs=0;
-	for (auto i : SG_PROGRESS(range(0, num)))
-	{
-		for (int32_t j=i+1; j<num; j++)
+	auto distance_progress = SG_PROGRESS(range(num));
+	parallel_for(0, num, [&](index_t start, index_t end) {
+		// distances of the rows to all vectors behind the first row
+		SGMatrix<float64_t> block=
+			distance->get_distance_block(start, end, start, num);
+
+		for (int32_t i=start; i<end; i++)
 		{
-			distances[offs] = distance->distance(i, j);
-			index[offs].idx1 = i;
-			index[offs].idx2 = j;
-			offs++; // offs=i*(i+1)/2+j
+			// pairs (k,l) with k<i come first
+			int64_t offs=int64_t(i)*(2*num-i-1)/2;
+			for (int32_t j=i+1; j<num; j++)
+			{
+				distances[offs] = block(i-start, j-start);
+				index[offs].idx1 = i;
+				index[offs].idx2 = j;
+				offs++;
+			}
+			distance_progress.print_progress();
 		}
-	}
+	}, 64);
+	distance_progress.complete();
 
 	CMath::qsort_index<float64_t,pair>(distances, index, (num-1)*num/2);
 	//CMath::display_vector(distances, (num-1)*num/2, "dists");
@@ -6,15 +6,21 @@
  *          Bjoern Esser, parijat
  */
 
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/base/progress.h>
+#include <shogun/base/TaskScheduler.h>
 #include <shogun/clustering/KMeans.h>
 #include <shogun/distance/Distance.h>
 #include <shogun/distance/EuclideanDistance.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/lib/observers/ObservedValueTemplated.h>
+#include <shogun/mathematics/Math.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
 
+#include <limits>
+#include <mutex>
+
 using namespace Eigen;
 using namespace shogun;
 
@@ -24,20 +30,143 @@ namespace shogun
 
 CKMeans::CKMeans():CKMeansBase()
 {
+	init_km_params();
 }
 
 CKMeans::CKMeans(int32_t k_i, CDistance* d_i, bool use_kmpp_i):CKMeansBase(k_i, d_i, use_kmpp_i)
 {
+	init_km_params();
 }
 
 CKMeans::CKMeans(int32_t k_i, CDistance* d_i, SGMatrix<float64_t> centers_i):CKMeansBase(k_i, d_i, centers_i)
 {
+	init_km_params();
 }
 
 CKMeans::~CKMeans()
 {
 }
 
+void CKMeans::init_km_params()
+{
+	method=KMM_LLOYD;
+	SG_ADD_OPTIONS(
+	    (machine_int_t*)&method, "method",
+	    "Algorithm of the assignment step",
+	    ParameterProperties::HYPER | ParameterProperties::SETTING,
+	    SG_OPTIONS(KMM_LLOYD, KMM_ELKAN, KMM_HAMERLY));
+}
+
+void CKMeans::set_method(EKMeansMethod m)
+{
+	method=m;
+}
+
+EKMeansMethod CKMeans::get_method() const
+{
+	return method;
+}
+
+/** recompute the centers as means of their assigned points.
+ *
+ * Every thread sums its share of the points into an own accumulator, the
+ * accumulators are merged at the end. Centers without points become zero.
+ */
+static void compute_means(
+	CDenseFeatures<float64_t>* lhs, const SGVector<int32_t>& assignments,
+	SGMatrix<float64_t>& centers, SGVector<int64_t>& weights)
+{
+	const int32_t dim=centers.num_rows;
+	const int32_t num_centers=centers.num_cols;
+	const index_t num_points=assignments.vlen;
+
+	centers.zero();
+	weights.zero();
+
+	// one chunk per thread, as the accumulators are as large as the centers
+	const index_t num_threads=env()->get_num_threads();
+	const index_t grain=CMath::max(
+		(num_points+num_threads-1)/num_threads, index_t(1024));
+
+	std::mutex centers_mutex;
+	parallel_for(0, num_points, [&](index_t start, index_t end) {
+		SGMatrix<float64_t> sums(dim, num_centers);
+		SGVector<int64_t> counts(num_centers);
+		sums.zero();
+		counts.zero();
+
+		for (index_t i=start; i<end; i++)
+		{
+			int32_t cluster_i=assignments[i];
+
+			auto vec=lhs->get_feature_vector(i);
+			linalg::add_col_vec(sums, cluster_i, vec, sums);
+			lhs->free_feature_vector(vec, i);
+			counts[cluster_i]++;
+		}
+
+		std::lock_guard<std::mutex> lock(centers_mutex);
+		linalg::add(centers, sums, centers);
+		for (int32_t j=0; j<num_centers; j++)
+			weights[j]+=counts[j];
+	}, grain);
+
+	for (int32_t i=0; i<num_centers; i++)
+	{
+		if (weights[i]!=0)
+		{
+			auto col=centers.get_column(i);
+			linalg::scale(col, col, 1.0/weights[i]);
+		}
+	}
+}
+
+/** @return Euclidean distances between all pairs of centers */
+static SGMatrix<float64_t> compute_center_distances(
+	const SGMatrix<float64_t>& centers)
+{
+	auto center_features=some<CDenseFeatures<float64_t>>(centers);
+	auto center_distance=some<CEuclideanDistance>(
+		center_features.get(), center_features.get());
+	return center_distance->get_distance_matrix();
+}
+
+/** @return half the distance of every center to its closest other center,
+ * points closer to their center than that keep their assignment
+ */
+static SGVector<float64_t> compute_half_min_distances(
+	const SGMatrix<float64_t>& center_distances)
+{
+	const int32_t num_centers=center_distances.num_cols;
+	SGVector<float64_t> half_min(num_centers);
+	for (int32_t j=0; j<num_centers; j++)
+	{
+		float64_t min_dist=std::numeric_limits<float64_t>::infinity();
+		for (int32_t l=0; l<num_centers; l++)
+		{
+			if (l!=j)
+				min_dist=CMath::min(min_dist, center_distances(l, j));
+		}
+		half_min[j]=0.5*min_dist;
+	}
+	return half_min;
+}
+
+/** @return distance every center moved in the update step */
+static SGVector<float64_t> compute_center_shifts(
+	const SGMatrix<float64_t>& old_centers, const SGMatrix<float64_t>& centers)
+{
+	SGVector<float64_t> shifts(centers.num_cols);
+	for (int32_t j=0; j<centers.num_cols; j++)
+	{
+		float64_t sum=0;
+		for (int32_t d=0; d<centers.num_rows; d++)
+			sum+=CMath::sq(centers(d, j)-old_centers(d, j));
+		shifts[j]=std::sqrt(sum);
+	}
+	return shifts;
+}
+
 void CKMeans::Lloyd_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
 {
 	CDenseFeatures<float64_t>* lhs =
@@ -59,6 +188,8 @@ void CKMeans::Lloyd_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
 
 	distance->precompute_lhs();
 
+	// bounds the memory of the distances computed at once
+	const int32_t assignment_block_size=1024;
 	int32_t changed=1;
 
 	for (auto iter : SG_PROGRESS(range(max_iter)))
@@ -71,109 +202,462 @@ void CKMeans::Lloyd_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
 		auto rhs_mus = some<CDenseFeatures<float64_t>>(centers.clone());
 		distance->replace_rhs(rhs_mus);
 
-#pragma omp parallel for firstprivate(lhs_size, dim, num_centers) \
-		shared(centers, cluster_assignments, weights_set) \
-		reduction(+:changed) if (!fixed_centers)
 		/* Assigment step : Assign each point to nearest cluster */
-		for (int32_t i=0; i<lhs_size; i++)
+		std::mutex assignment_mutex;
+		auto assign_points = [&](index_t start, index_t end) {
+			// distances of all points of the chunk to all centers at once
+			SGMatrix<float64_t> dists=
+				distance->get_distance_block(start, end, 0, num_centers);
+			SGVector<int64_t> weights_change(num_centers);
+			weights_change.zero();
+			int32_t chunk_changed=0;
+
+			for (int32_t i=start; i<end; i++)
+			{
+				const int32_t cluster_assignments_i=cluster_assignments[i];
+				int32_t min_cluster, j;
+				float64_t min_dist, dist;
+
+				min_cluster=0;
+				min_dist=dists(i-start, 0);
+				for (j=1; j<num_centers; j++)
+				{
+					dist=dists(i-start, j);
+					if (dist<min_dist)
+					{
+						min_dist=dist;
+						min_cluster=j;
+					}
+				}
+
+				if (min_cluster==cluster_assignments_i)
+					continue;
+
+				chunk_changed++;
+				cluster_assignments[i] = min_cluster;
+
+				if(!fixed_centers)
+				{
+					++weights_change[min_cluster];
+					--weights_change[cluster_assignments_i];
+					continue;
+				}
+
+				++weights_set[min_cluster];
+				--weights_set[cluster_assignments_i];
+
+				SGVector<float64_t>vec=lhs->get_feature_vector(i);
+				float64_t temp_min = 1.0 / weights_set[min_cluster];
+
+				/* mu_new = mu_old + (x - mu_old)/(w) */
+				for (j=0; j<dim; j++)
+				{
+					centers(j, min_cluster)+=
+						(vec[j]-centers(j, min_cluster))*temp_min;
+				}
+
+				lhs->free_feature_vector(vec, i);
+
+				/* mu_new = mu_old - (x - mu_old)/(w-1) */
+				/* if weights_set(j)~=0 */
+				if (weights_set[cluster_assignments_i]!=0)
+				{
+					float64_t temp_i = 1.0 / weights_set[cluster_assignments_i];
+					SGVector<float64_t>vec1=lhs->get_feature_vector(i);
+
+					for (j=0; j<dim; j++)
+					{
+						centers(j, cluster_assignments_i)-=
+							(vec1[j]-centers(j, cluster_assignments_i))*temp_i;
+					}
+					lhs->free_feature_vector(vec1, i);
+				}
+				else
+				{
+					/*  mus(:,j)=zeros(dim,1) ; */
+					for (j=0; j<dim; j++)
+						centers(j, cluster_assignments_i)=0;
+				}
+			}
+
+			std::lock_guard<std::mutex> lock(assignment_mutex);
+			changed+=chunk_changed;
+			for (int32_t j=0; j<num_centers; j++)
+				weights_set[j]+=weights_change[j];
+		};
+
+		// moving the centers online makes the order of points matter
+		if (fixed_centers)
+		{
+			for (int32_t start=0; start<lhs_size; start+=assignment_block_size)
+			{
+				assign_points(start,
+					CMath::min(start+assignment_block_size, lhs_size));
+			}
+		}
+		else
+			parallel_for(0, lhs_size, assign_points, assignment_block_size);
+
+		if(changed==0)
+			break;
+
+		/* Update Step : Calculate new means */
+		if (!fixed_centers)
 		{
-			const int32_t cluster_assignments_i=cluster_assignments[i];
-			int32_t min_cluster, j;
-			float64_t min_dist, dist;
+			compute_means(lhs, cluster_assignments, centers, weights_set);
+		}
+
+		observe<SGMatrix<float64_t>>(iter, "mus");
+
+		if (iter%(max_iter/10) == 0)
+			io::info("Iteration[{}/{}]: Assignment of {} patterns changed.", iter, max_iter, changed);
+	}
+	distance->reset_precompute();
+	distance->replace_rhs(rhs_cache);
+	SG_UNREF(lhs);
+	SG_UNREF(rhs_cache);
+}
+
+void CKMeans::Elkan_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
+{
+	CDenseFeatures<float64_t>* lhs =
+		distance->get_lhs()->as<CDenseFeatures<float64_t>>();
+
+	int32_t lhs_size=lhs->get_num_vectors();
+	auto rhs_cache = distance->get_rhs();
+
+	// the bounds need actual distances, not squared ones
+	const bool squared=distance->as<CEuclideanDistance>()->get_disable_sqrt();
+	auto point_distance = [&](int32_t i, int32_t j) {
+		float64_t dist=distance->distance(i, j);
+		return squared ? std::sqrt(dist) : dist;
+	};
+
+	SGVector<int32_t> cluster_assignments(lhs_size);
+	SGVector<int64_t> weights_set(num_centers);
+	/* upper bound of the distance of every point to its center */
+	SGVector<float64_t> upper_bounds(lhs_size);
+	/* lower bounds of the distances of every point to all centers */
+	SGMatrix<float64_t> lower_bounds(num_centers, lhs_size);
+
+	distance->precompute_lhs();
+	distance->replace_rhs(some<CDenseFeatures<float64_t>>(centers.clone()));
+
+	// bounds the memory of the distances computed at once
+	const int32_t assignment_block_size=1024;
 
-			min_cluster=0;
-		   	min_dist=distance->distance(i,0);
-			for (j=1; j<num_centers; j++)
+	/* Initial assignment : all distances are computed once */
+	parallel_for(0, lhs_size, [&](index_t start, index_t end) {
+		SGMatrix<float64_t> dists=
+			distance->get_distance_block(start, end, 0, num_centers);
+
+		for (int32_t i=start; i<end; i++)
+		{
+			int32_t min_cluster=0;
+			float64_t min_dist=std::numeric_limits<float64_t>::infinity();
+			for (int32_t j=0; j<num_centers; j++)
 			{
-				dist=distance->distance(i,j);
+				float64_t dist=dists(i-start, j);
+				if (squared)
+					dist=std::sqrt(dist);
+
+				lower_bounds(j, i)=dist;
 				if (dist<min_dist)
 				{
 					min_dist=dist;
 					min_cluster=j;
 				}
 			}
+			cluster_assignments[i]=min_cluster;
+			upper_bounds[i]=min_dist;
+		}
+	}, assignment_block_size);
 
-			if (min_cluster!=cluster_assignments_i)
-			{
-				changed++;
-#pragma omp atomic
-				++weights_set[min_cluster];
-#pragma omp atomic
-				--weights_set[cluster_assignments_i];
+	int64_t num_distances=int64_t(lhs_size)*num_centers;
+	int32_t changed=1;
+	int32_t iter=0;
+
+	for (; iter<max_iter; iter++)
+	{
+		if (iter==max_iter-1)
+			io::warn("KMeans clustering has reached maximum number of ( {} ) iterations without having converged. \
+				   	Terminating. ", iter);
+
+		/* Update Step : Calculate new means and move the bounds along */
+		SGMatrix<float64_t> old_centers=centers.clone();
+		compute_means(lhs, cluster_assignments, centers, weights_set);
+		observe<SGMatrix<float64_t>>(iter, "mus");
 
-				if(fixed_centers)
+		SGVector<float64_t> shifts=compute_center_shifts(old_centers, centers);
+		parallel_for(0, lhs_size, [&](index_t start, index_t end) {
+			for (int32_t i=start; i<end; i++)
+			{
+				upper_bounds[i]+=shifts[cluster_assignments[i]];
+				for (int32_t j=0; j<num_centers; j++)
 				{
-					SGVector<float64_t>vec=lhs->get_feature_vector(i);
-					float64_t temp_min = 1.0 / weights_set[min_cluster];
+					lower_bounds(j, i)=
+						CMath::max(lower_bounds(j, i)-shifts[j], 0.0);
+				}
+			}
+		}, assignment_block_size);
 
-					/* mu_new = mu_old + (x - mu_old)/(w) */
-					for (j=0; j<dim; j++)
-					{
-						centers(j, min_cluster)+=
-							(vec[j]-centers(j, min_cluster))*temp_min;
-					}
+		auto rhs_mus = some<CDenseFeatures<float64_t>>(centers.clone());
+		distance->replace_rhs(rhs_mus);
+
+		SGMatrix<float64_t> center_dists=compute_center_distances(centers);
+		SGVector<float64_t> half_min_dists=
+			compute_half_min_distances(center_dists);
+
+		/* Assigment step : only distances that can change the assignment */
+		changed=0;
+		std::mutex assignment_mutex;
+		parallel_for(0, lhs_size, [&](index_t start, index_t end) {
+			int32_t chunk_changed=0;
+			int64_t chunk_distances=0;
+
+			for (int32_t i=start; i<end; i++)
+			{
+				int32_t min_cluster=cluster_assignments[i];
+				float64_t upper=upper_bounds[i];
 
-					lhs->free_feature_vector(vec, i);
+				if (upper<=half_min_dists[min_cluster])
+					continue;
 
-					/* mu_new = mu_old - (x - mu_old)/(w-1) */
-					/* if weights_set(j)~=0 */
-					if (weights_set[cluster_assignments_i]!=0)
+				// whether upper is the exact distance to the center
+				bool tight=false;
+				for (int32_t j=0; j<num_centers; j++)
+				{
+					if (j==min_cluster)
+						continue;
+
+					float64_t bound=CMath::max(
+						lower_bounds(j, i), 0.5*center_dists(j, min_cluster));
+					if (upper<=bound)
+						continue;
+
+					if (!tight)
 					{
-						float64_t temp_i = 1.0 / weights_set[cluster_assignments_i];
-						SGVector<float64_t>vec1=lhs->get_feature_vector(i);
-
-						for (j=0; j<dim; j++)
-						{
-							centers(j, cluster_assignments_i)-=
-								(vec1[j]-centers(j, cluster_assignments_i))*temp_i;
-						}
-						lhs->free_feature_vector(vec1, i);
+						upper=point_distance(i, min_cluster);
+						lower_bounds(min_cluster, i)=upper;
+						chunk_distances++;
+						tight=true;
+						if (upper<=bound)
+							continue;
 					}
-					else
+
+					float64_t dist=point_distance(i, j);
+					lower_bounds(j, i)=dist;
+					chunk_distances++;
+					if (dist<upper)
 					{
-						/*  mus(:,j)=zeros(dim,1) ; */
-						for (j=0; j<dim; j++)
-							centers(j, cluster_assignments_i)=0;
+						upper=dist;
+						min_cluster=j;
 					}
+				}
 
+				upper_bounds[i]=upper;
+				if (min_cluster!=cluster_assignments[i])
+				{
+					cluster_assignments[i]=min_cluster;
+					chunk_changed++;
 				}
+			}
 
-				cluster_assignments[i] = min_cluster;
+			std::lock_guard<std::mutex> lock(assignment_mutex);
+			changed+=chunk_changed;
+			num_distances+=chunk_distances;
+		}, assignment_block_size);
+
+		SG_DEBUG("Iteration[{}/{}]: Assignment of {} patterns changed.", iter, max_iter, changed)
+		if (changed==0)
+			break;
+	}
+
+	io::info(
+	    "Elkan's KMeans finished after {} iterations, computing {} of {} "
+	    "distances.", iter, num_distances,
+	    int64_t(lhs_size)*num_centers*(iter+1));
+
+	distance->reset_precompute();
+	distance->replace_rhs(rhs_cache);
+	SG_UNREF(lhs);
+	SG_UNREF(rhs_cache);
+}
+
+void CKMeans::Hamerly_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
+{
+	CDenseFeatures<float64_t>* lhs =
+		distance->get_lhs()->as<CDenseFeatures<float64_t>>();
+
+	int32_t lhs_size=lhs->get_num_vectors();
+	auto rhs_cache = distance->get_rhs();
+
+	// the bounds need actual distances, not squared ones
+	const bool squared=distance->as<CEuclideanDistance>()->get_disable_sqrt();
+	auto point_distance = [&](int32_t i, int32_t j) {
+		float64_t dist=distance->distance(i, j);
+		return squared ? std::sqrt(dist) : dist;
+	};
+
+	SGVector<int32_t> cluster_assignments(lhs_size);
+	SGVector<int64_t> weights_set(num_centers);
+	/* upper bound of the distance of every point to its center */
+	SGVector<float64_t> upper_bounds(lhs_size);
+	/* lower bound of the distance of every point to its second closest
+	 * center */
+	SGVector<float64_t> lower_bounds(lhs_size);
+
+	distance->precompute_lhs();
+	distance->replace_rhs(some<CDenseFeatures<float64_t>>(centers.clone()));
+
+	// bounds the memory of the distances computed at once
+	const int32_t assignment_block_size=1024;
+
+	/* Initial assignment : all distances are computed once */
+	parallel_for(0, lhs_size, [&](index_t start, index_t end) {
+		SGMatrix<float64_t> dists=
+			distance->get_distance_block(start, end, 0, num_centers);
+
+		for (int32_t i=start; i<end; i++)
+		{
+			int32_t min_cluster=0;
+			float64_t min_dist=std::numeric_limits<float64_t>::infinity();
+			float64_t second_dist=min_dist;
+			for (int32_t j=0; j<num_centers; j++)
+			{
+				float64_t dist=dists(i-start, j);
+				if (squared)
+					dist=std::sqrt(dist);
+
+				if (dist<min_dist)
+				{
+					second_dist=min_dist;
+					min_dist=dist;
+					min_cluster=j;
+				}
+				else if (dist<second_dist)
+					second_dist=dist;
 			}
+			cluster_assignments[i]=min_cluster;
+			upper_bounds[i]=min_dist;
+			lower_bounds[i]=second_dist;
 		}
-		if(changed==0)
-			break;
+	}, assignment_block_size);
 
-		/* Update Step : Calculate new means */
-		if (!fixed_centers)
+	int64_t num_distances=int64_t(lhs_size)*num_centers;
+	int32_t changed=1;
+	int32_t iter=0;
+
+	for (; iter<max_iter; iter++)
+	{
+		if (iter==max_iter-1)
+			io::warn("KMeans clustering has reached maximum number of ( {} ) iterations without having converged. \
+				   	Terminating. ", iter);
+
+		/* Update Step : Calculate new means and move the bounds along */
+		SGMatrix<float64_t> old_centers=centers.clone();
+		compute_means(lhs, cluster_assignments, centers, weights_set);
+		observe<SGMatrix<float64_t>>(iter, "mus");
+
+		// the second closest center moved at most by the largest shift of
+		// all other centers
+		SGVector<float64_t> shifts=compute_center_shifts(old_centers, centers);
+		int32_t max_shift_cluster=0;
+		float64_t max_shift=0;
+		float64_t second_max_shift=0;
+		for (int32_t j=0; j<num_centers; j++)
 		{
-			/* mus=zeros(dim, num_centers) ; */
-			centers.zero();
+			if (shifts[j]>max_shift)
+			{
+				second_max_shift=max_shift;
+				max_shift=shifts[j];
+				max_shift_cluster=j;
+			}
+			else if (shifts[j]>second_max_shift)
+				second_max_shift=shifts[j];
+		}
 
-			for (int32_t i=0; i<lhs_size; i++)
+		parallel_for(0, lhs_size, [&](index_t start, index_t end) {
+			for (int32_t i=start; i<end; i++)
 			{
 				int32_t cluster_i=cluster_assignments[i];
-
-				auto vec = lhs->get_feature_vector(i);
-				linalg::add_col_vec(centers, cluster_i, vec, centers);
-				lhs->free_feature_vector(vec, i);
+				upper_bounds[i]+=shifts[cluster_i];
+				lower_bounds[i]-=
+					cluster_i==max_shift_cluster ? second_max_shift : max_shift;
 			}
+		}, assignment_block_size);
+
+		auto rhs_mus = some<CDenseFeatures<float64_t>>(centers.clone());
+		distance->replace_rhs(rhs_mus);
+
+		SGVector<float64_t> half_min_dists=
+			compute_half_min_distances(compute_center_distances(centers));
+
+		/* Assigment step : only points whose bounds overlap */
+		changed=0;
+		std::mutex assignment_mutex;
+		parallel_for(0, lhs_size, [&](index_t start, index_t end) {
+			int32_t chunk_changed=0;
+			int64_t chunk_distances=0;
 
-			for (int32_t i=0; i<num_centers; i++)
+			for (int32_t i=start; i<end; i++)
 			{
-				if (weights_set[i]!=0)
+				const int32_t cluster_i=cluster_assignments[i];
+				const float64_t bound=
+					CMath::max(half_min_dists[cluster_i], lower_bounds[i]);
+
+				if (upper_bounds[i]<=bound)
+					continue;
+
+				upper_bounds[i]=point_distance(i, cluster_i);
+				chunk_distances++;
+				if (upper_bounds[i]<=bound)
+					continue;
+
+				int32_t min_cluster=cluster_i;
+				float64_t min_dist=upper_bounds[i];
+				float64_t second_dist=std::numeric_limits<float64_t>::infinity();
+				for (int32_t j=0; j<num_centers; j++)
 				{
-					auto col = centers.get_column(i);
-					linalg::scale(col, col, 1.0 / weights_set[i]);
+					if (j==cluster_i)
+						continue;
+
+					float64_t dist=point_distance(i, j);
+					if (dist<min_dist)
+					{
+						second_dist=min_dist;
+						min_dist=dist;
+						min_cluster=j;
+					}
+					else if (dist<second_dist)
+						second_dist=dist;
+				}
+				chunk_distances+=num_centers-1;
+
+				upper_bounds[i]=min_dist;
+				lower_bounds[i]=second_dist;
+				if (min_cluster!=cluster_i)
+				{
+					cluster_assignments[i]=min_cluster;
+					chunk_changed++;
 				}
 			}
-		}
 
-		observe<SGMatrix<float64_t>>(iter, "mus");
+			std::lock_guard<std::mutex> lock(assignment_mutex);
+			changed+=chunk_changed;
+			num_distances+=chunk_distances;
+		}, assignment_block_size);
 
-		if (iter%(max_iter/10) == 0)
-			io::info("Iteration[{}/{}]: Assignment of {} patterns changed.", iter, max_iter, changed);
+		SG_DEBUG("Iteration[{}/{}]: Assignment of {} patterns changed.", iter, max_iter, changed)
+		if (changed==0)
+			break;
 	}
+
+	io::info(
+	    "Hamerly's KMeans finished after {} iterations, computing {} of {} "
+	    "distances.", iter, num_distances,
+	    int64_t(lhs_size)*num_centers*(iter+1));
+
 	distance->reset_precompute();
 	distance->replace_rhs(rhs_cache);
 	SG_UNREF(lhs);
@@ -183,7 +667,27 @@ void CKMeans::Lloyd_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
 bool CKMeans::train_machine(CFeatures* data)
 {
 	initialize_training(data);
-	Lloyd_KMeans(mus, k);
+
+	switch (method)
+	{
+	case KMM_LLOYD:
+		Lloyd_KMeans(mus, k);
+		break;
+	case KMM_ELKAN:
+	case KMM_HAMERLY:
+		require(
+		    distance->get_distance_type()==D_EUCLIDEAN,
+		    "{} requires the Euclidean distance for Elkan's or Hamerly's "
+		    "method", get_name());
+		require(
+		    !fixed_centers, "{} does not support fixed centers with "
+		    "Elkan's or Hamerly's method", get_name());
+		if (method==KMM_ELKAN)
+			Elkan_KMeans(mus, k);
+		else
+			Hamerly_KMeans(mus, k);
+		break;
+	}
 	compute_cluster_variances();
 	auto cluster_centres = new CDenseFeatures<float64_t>(mus);
 	SG_REF(cluster_centres);
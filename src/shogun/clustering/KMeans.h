@@ -21,6 +21,20 @@ namespace shogun
 {
 class CKMeansBase;
 
+/** algorithm used by CKMeans to assign the points to the centers */
+enum EKMeansMethod
+{
+	/** compute the distances of all points to all centers in every
+	 * iteration */
+	KMM_LLOYD,
+	/** Elkan's algorithm, keeps a lower bound on the distance of every
+	 * point to every center. Needs memory for k bounds per point. */
+	KMM_ELKAN,
+	/** Hamerly's algorithm, keeps a single lower bound per point. Skips
+	 * fewer distances than Elkan's, but scales to large k. */
+	KMM_HAMERLY
+};
+
 /** @brief KMeans clustering,  partitions the data into k (a-priori specified) clusters.
  *
  * It minimizes
@@ -35,6 +49,18 @@ class CKMeansBase;
  *
  * To use mini-batch based training was see CKMeansMiniBatch 
  *
+ * Besides Lloyd's algorithm, the assignment step can use Elkan's or
+ * Hamerly's algorithm (see set_method()). Both keep bounds on the
+ * distances of every point to the centers and use the triangle inequality
+ * to skip distance computations that can not change the assignment, which
+ * makes later iterations much cheaper. The result is the same as with
+ * Lloyd's algorithm. They require the Euclidean distance and do not
+ * support fixed centers.
+ *
+ * cf. Elkan, C. (2003). Using the triangle inequality to accelerate
+ * k-means. ICML.
+ * cf. Hamerly, G. (2010). Making k-means even faster. SDM.
+ *
  * cf. http://en.wikipedia.org/wiki/K-means_algorithm
  * cf. http://en.wikipedia.org/wiki/Lloyd's_algorithm
  *
@@ -67,7 +93,18 @@ class CKMeans : public CKMeansBase
 		/** @return object name */
 		virtual const char* get_name() const { return "KMeans"; }		
 
+		/** set the algorithm of the assignment step
+		 *
+		 * @param method KMM_LLOYD (default), KMM_ELKAN or KMM_HAMERLY
+		 */
+		void set_method(EKMeansMethod method);
+
+		/** @return algorithm of the assignment step */
+		EKMeansMethod get_method() const;
+
 	private:
+		/** register parameters */
+		void init_km_params();
 
 		/** train k-means
 		 *
@@ -82,6 +119,20 @@ class CKMeans : public CKMeansBase
 		/** Lloyd's KMeans training method
 		 */
 		void Lloyd_KMeans(SGMatrix<float64_t> centers, int32_t num_centers);
+
+		/** Elkan's KMeans training method, keeps lower bounds on the
+		 * distances of every point to every center
+		 */
+		void Elkan_KMeans(SGMatrix<float64_t> centers, int32_t num_centers);
+
+		/** Hamerly's KMeans training method, keeps a lower bound on the
+		 * distance of every point to its second closest center
+		 */
+		void Hamerly_KMeans(SGMatrix<float64_t> centers, int32_t num_centers);
+
+	private:
+		/** algorithm of the assignment step */
+		EKMeansMethod method;
 };
 }
 #endif
@@ -0,0 +1,95 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <shogun/base/some.h>
+#include <shogun/clustering/KMeans.h>
+#include <shogun/clustering/KMeansMiniBatch.h>
+#include <shogun/distance/EuclideanDistance.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/util/benchmark_data.h>
+
+namespace shogun
+{
+
+/** number of clusters in the benchmark data */
+static const int32_t kmeans_num_clusters = 16;
+
+class KMeansFixture : public benchmark::Fixture
+{
+public:
+	void SetUp(const ::benchmark::State& st)
+	{
+		SGVector<float64_t> labels;
+		feats = new CDenseFeatures<float64_t>(benchmark_blobs(
+		    st.range(1), st.range(0), kmeans_num_clusters, labels));
+		SG_REF(feats);
+
+		// all methods start from the same centers
+		initial_centers = SGMatrix<float64_t>(st.range(1), kmeans_num_clusters);
+		for (int32_t i = 0; i < kmeans_num_clusters; ++i)
+		{
+			SGVector<float64_t> vec = feats->get_feature_vector(i);
+			sg_memcpy(initial_centers.get_column_vector(i), vec.vector, vec.vlen * sizeof(float64_t));
+		}
+	}
+
+	void TearDown(const ::benchmark::State&)
+	{
+		SG_UNREF(feats);
+	}
+
+	void train(benchmark::State& state, EKMeansMethod method)
+	{
+		for (auto _ : state)
+		{
+			auto distance = some<CEuclideanDistance>(feats, feats);
+			auto kmeans = some<CKMeans>(kmeans_num_clusters, distance, initial_centers);
+			kmeans->set_method(method);
+			kmeans->put("max_iter", 20);
+			kmeans->train();
+		}
+	}
+
+	CDenseFeatures<float64_t>* feats;
+	SGMatrix<float64_t> initial_centers;
+};
+
+BENCHMARK_DEFINE_F(KMeansFixture, KMeans_lloyd)(benchmark::State& state)
+{
+	train(state, KMM_LLOYD);
+}
+
+BENCHMARK_DEFINE_F(KMeansFixture, KMeans_elkan)(benchmark::State& state)
+{
+	train(state, KMM_ELKAN);
+}
+
+BENCHMARK_DEFINE_F(KMeansFixture, KMeans_hamerly)(benchmark::State& state)
+{
+	train(state, KMM_HAMERLY);
+}
+
+BENCHMARK_DEFINE_F(KMeansFixture, KMeans_minibatch)(benchmark::State& state)
+{
+	for (auto _ : state)
+	{
+		auto distance = some<CEuclideanDistance>(feats, feats);
+		auto kmeans = some<CKMeansMiniBatch>(kmeans_num_clusters, distance, initial_centers);
+		kmeans->put("batch_size", 256);
+		kmeans->put("max_iter", 20);
+		kmeans->train();
+	}
+}
+
+#define ADD_KMEANS_ARGS(WHAT) \
+	WHAT->RangeMultiplier(4)->Ranges(BENCHMARK_LARGE_SCALE)->Unit(benchmark::kMillisecond);
+
+ADD_KMEANS_ARGS(BENCHMARK_REGISTER_F(KMeansFixture, KMeans_lloyd))
+ADD_KMEANS_ARGS(BENCHMARK_REGISTER_F(KMeansFixture, KMeans_elkan))
+ADD_KMEANS_ARGS(BENCHMARK_REGISTER_F(KMeansFixture, KMeans_hamerly))
+ADD_KMEANS_ARGS(BENCHMARK_REGISTER_F(KMeansFixture, KMeans_minibatch))
+
+}
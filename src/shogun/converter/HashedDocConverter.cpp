@@ -94,72 +94,11 @@ CFeatures* CHashedDocConverter::transform(CFeatures* features, bool inplace)
 SGSparseVector<float64_t> CHashedDocConverter::apply(SGVector<char> document)
 {
 	ASSERT(document.size()>0)
-	const int32_t array_size = 1024*1024;
-	/** the array will contain all the hashes generated from the tokens */
-	CDynamicArray<uint32_t> hashed_indices(array_size);
-
-	/** this vector will maintain the current n+k active tokens
-	 * in a circular manner */
-	SGVector<uint32_t> cached_hashes(ngrams+tokens_to_skip);
-	index_t hashes_start = 0;
-	index_t hashes_end = 0;
-	int32_t len = cached_hashes.vlen - 1;
-
-	/** the combinations generated from the current active tokens will be
-	 * stored here to avoid creating new objects */
-	SGVector<index_t> ngram_indices((ngrams-1)*(tokens_to_skip+1) + 1);
-
-	/** Reading n+s-1 tokens */
-	const int32_t seed = 0xdeadbeaf;
-	tokenizer->set_text(document);
-	index_t token_start = 0;
-	while (hashes_end<ngrams-1+tokens_to_skip && tokenizer->has_next())
-	{
-		index_t end = tokenizer->next_token_idx(token_start);
-		uint32_t token_hash = CHash::MurmurHash3((uint8_t* ) &document.vector[token_start],
-				end-token_start, seed);
-		cached_hashes[hashes_end++] = token_hash;
-	}
-
-	/** Reading token and storing index to hashed_indices */
-	while (tokenizer->has_next())
-	{
-		index_t end = tokenizer->next_token_idx(token_start);
-		uint32_t token_hash = CHash::MurmurHash3((uint8_t* ) &document.vector[token_start],
-				end-token_start, seed);
-		cached_hashes[hashes_end] = token_hash;
-
-		CHashedDocConverter::generate_ngram_hashes(cached_hashes, hashes_start, len,
-				ngram_indices, num_bits, ngrams, tokens_to_skip);
-
-		for (index_t i=0; i<ngram_indices.vlen; i++)
-			hashed_indices.append_element(ngram_indices[i]);
-
-		hashes_start++;
-		hashes_end++;
-		if (hashes_end==cached_hashes.vlen)
-			hashes_end = 0;
-		if (hashes_start==cached_hashes.vlen)
-			hashes_start = 0;
-	}
-
-	/** For remaining combinations */
-	if (ngrams>1)
-	{
-		while (hashes_start!=hashes_end)
-		{
-			len--;
-			index_t max_idx = CHashedDocConverter::generate_ngram_hashes(cached_hashes, hashes_start,
-					len, ngram_indices, num_bits, ngrams, tokens_to_skip);
-
-			for (index_t i=0; i<max_idx; i++)
-				hashed_indices.append_element(ngram_indices[i]);
 
-			hashes_start++;
-			if (hashes_start==cached_hashes.vlen)
-				hashes_start = 0;
-		}
-	}
+	/** the array will contain all the hashes generated from the tokens */
+	std::vector<uint32_t> indices;
+	generate_hashed_indices(document, tokenizer, num_bits, ngrams, tokens_to_skip, indices);
+	CDynamicArray<uint32_t> hashed_indices(indices.data(), indices.size(), false, false);
 
 	SGSparseVector<float64_t> sparse_doc_rep = create_hashed_representation(hashed_indices);
 
@@ -174,6 +113,43 @@ SGSparseVector<float64_t> CHashedDocConverter::apply(SGVector<char> document)
 	return sparse_doc_rep;
 }
 
+void CHashedDocConverter::generate_hashed_indices(SGVector<char> document, CTokenizer* tokenizer,
+	int32_t num_bits, int32_t ngrams, int32_t tokens_to_skip, std::vector<uint32_t>& indices)
+{
+	std::vector<index_t> starts;
+	std::vector<index_t> ends;
+	tokenizer->set_text(document);
+	const index_t num_tokens = tokenizer->next_token_spans(starts, ends);
+
+	const int32_t seed = 0xdeadbeaf;
+	std::vector<uint32_t> hashes(num_tokens);
+	CHash::BatchMurmurHash3((uint8_t*) document.vector, starts.data(), ends.data(),
+			num_tokens, seed, hashes.data());
+
+	/** Every token on its own, followed by its combinations with the next
+	 * tokens, where n+s is limited by the number of remaining tokens */
+	const uint32_t mask = (1 << num_bits) - 1;
+	indices.reserve(indices.size() + num_tokens*((ngrams-1)*(tokens_to_skip+1) + 1));
+	for (index_t t=0; t<num_tokens; t++)
+	{
+		indices.push_back(hashes[t] & mask);
+
+		for (index_t n=1; n<ngrams; n++)
+		{
+			for (index_t s=0; s<=tokens_to_skip; s++)
+			{
+				if (t+n+s >= num_tokens)
+					break;
+
+				uint32_t ngram_hash = hashes[t];
+				for (index_t i=t+1+s; i<=t+n+s; i++)
+					ngram_hash = ngram_hash ^ hashes[i];
+				indices.push_back(ngram_hash & mask);
+			}
+		}
+	}
+}
+
 SGSparseVector<float64_t> CHashedDocConverter::create_hashed_representation(CDynamicArray<uint32_t>& hashed_indices)
 {
 	int32_t num_nnz_features = count_distinct_indices(hashed_indices);
@@ -98,6 +98,24 @@ public:
 	static index_t generate_ngram_hashes(SGVector<uint32_t>& hashes, index_t hashes_start, index_t len,
 			SGVector<index_t>& ngram_hashes, int32_t num_bits, int32_t ngrams, int32_t tokens_to_skip);
 
+#ifndef SWIG
+	/** Computes the hashed indices of all the k-skip n-grams of a document, in
+	 * the order in which apply() generates them. The document is tokenized at once
+	 * into token spans, whose hashes are computed with a single
+	 * CHash::BatchMurmurHash3() call.
+	 *
+	 * @param document the document
+	 * @param tokenizer the tokenizer to use, its text is set to the document
+	 * @param num_bits the dimension in which to limit the hashed indices (means a dimension of size 2^num_bits)
+	 * @param ngrams the n in k-skip n-grams or the max number of tokens to combine
+	 * @param tokens_to_skip the k in k-skip n-grams or the max number of tokens to skip when
+	 * combining
+	 * @param indices vector to append the hashed indices to
+	 */
+	static void generate_hashed_indices(SGVector<char> document, CTokenizer* tokenizer,
+			int32_t num_bits, int32_t ngrams, int32_t tokens_to_skip, std::vector<uint32_t>& indices);
+#endif // SWIG
+
 	/** @return object name */
 	virtual const char* get_name() const;
 
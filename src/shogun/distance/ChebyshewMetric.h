@@ -67,6 +67,21 @@ class CChebyshewMetric: public CDenseDistance<float64_t>
 		/// idx_{a,b} denote the index of the feature vectors
 		/// in the corresponding feature object
 		virtual float64_t compute(int32_t idx_a, int32_t idx_b);
+
+		/** @return whether blocks of distances can be computed on the
+		 * feature matrices directly
+		 */
+		virtual bool supports_distance_block();
+
+		/** compute a block of distances, vectorized over the left-hand
+		 * side vectors
+		 *
+		 * @param row_begin index of the first left-hand side vector
+		 * @param col_begin index of the first right-hand side vector
+		 * @param block pre-allocated output block
+		 */
+		virtual void compute_distance_block(
+			index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block);
 };
 
 } // namespace shogun
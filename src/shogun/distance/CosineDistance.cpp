@@ -8,7 +8,9 @@
 #include <shogun/lib/common.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/distance/CosineDistance.h>
+#include <shogun/features/DenseFeatures.h>
 #include <shogun/features/Features.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
 
 using namespace shogun;
 
@@ -76,3 +78,47 @@ float64_t CCosineDistance::compute(int32_t idx_a, int32_t idx_b)
 	else
 		return s ;
 }
+
+bool CCosineDistance::supports_distance_block()
+{
+	return get_distance_type()==D_COSINE && has_dense_real_features(lhs, rhs);
+}
+
+void CCosineDistance::compute_distance_block(
+	index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block)
+{
+	SGMatrix<float64_t> lhs_matrix=get_dense_feature_matrix(lhs);
+	SGMatrix<float64_t> rhs_matrix=get_dense_feature_matrix(rhs);
+	ASSERT(lhs_matrix.matrix && rhs_matrix.matrix)
+
+	const index_t dim=lhs_matrix.num_rows;
+
+	SGMatrix<float64_t> lhs_block(lhs_matrix.matrix+int64_t(row_begin)*dim,
+		dim, block.num_rows, false);
+	SGMatrix<float64_t> rhs_block(rhs_matrix.matrix+int64_t(col_begin)*dim,
+		dim, block.num_cols, false);
+
+	linalg::matrix_prod(lhs_block, rhs_block, block, true, false);
+
+	SGVector<float64_t> lhs_norms=linalg::colwise_sum(
+		linalg::element_prod(lhs_block, lhs_block));
+	SGVector<float64_t> rhs_norms=linalg::colwise_sum(
+		linalg::element_prod(rhs_block, rhs_block));
+
+	for (index_t j=0; j<block.num_cols; j++)
+	{
+		for (index_t i=0; i<block.num_rows; i++)
+		{
+			float64_t s=std::sqrt(lhs_norms[i])*std::sqrt(rhs_norms[j]);
+
+			// trap division by zero
+			if (s==0)
+			{
+				block(i, j)=0;
+				continue;
+			}
+
+			block(i, j)=CMath::max(1-block(i, j)/s, 0.0);
+		}
+	}
+}
@@ -12,6 +12,7 @@
 #include <shogun/base/Parallel.h>
 #include <shogun/base/Parameter.h>
 #include <shogun/base/progress.h>
+#include <shogun/base/TaskScheduler.h>
 #include <shogun/io/File.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/lib/Signal.h>
@@ -20,6 +21,7 @@
 #include <shogun/lib/config.h>
 
 #include <shogun/distance/Distance.h>
+#include <shogun/features/DenseFeatures.h>
 #include <shogun/features/Features.h>
 
 #include <string.h>
@@ -27,11 +29,6 @@
 #include <unistd.h>
 #endif
 
-#ifdef HAVE_OPENMP
-#include <omp.h>
-
-#endif
-
 using namespace shogun;
 
 CDistance::CDistance() : CSGObject()
@@ -230,6 +227,51 @@ void CDistance::run_distance_lhs(SGVector<float64_t>& result, const index_t idx_
         result.vector[i] = this->distance(idx_start,idx_b);
 }
 
+SGMatrix<float64_t> CDistance::get_distance_block(
+	index_t row_begin, index_t row_end, index_t col_begin, index_t col_end)
+{
+	require(has_features(), "no features assigned to distance");
+	require(row_begin>=0 && row_begin<=row_end && row_end<=num_lhs,
+		"Invalid left-hand side range [{}, {}) for {} vectors",
+		row_begin, row_end, num_lhs);
+	require(col_begin>=0 && col_begin<=col_end && col_end<=num_rhs,
+		"Invalid right-hand side range [{}, {}) for {} vectors",
+		col_begin, col_end, num_rhs);
+
+	SGMatrix<float64_t> block(row_end-row_begin, col_end-col_begin);
+	get_distance_block(row_begin, col_begin, block);
+	return block;
+}
+
+void CDistance::get_distance_block(
+	index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block)
+{
+	if (block.num_rows==0 || block.num_cols==0)
+		return;
+
+	if (supports_distance_block())
+	{
+		compute_distance_block(row_begin, col_begin, block);
+		return;
+	}
+
+	for (index_t j=0; j<block.num_cols; j++)
+	{
+		for (index_t i=0; i<block.num_rows; i++)
+			block(i, j)=distance(row_begin+i, col_begin+j);
+	}
+}
+
+void CDistance::compute_distance_block(
+	index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block)
+{
+	for (index_t j=0; j<block.num_cols; j++)
+	{
+		for (index_t i=0; i<block.num_rows; i++)
+			block(i, j)=compute(row_begin+i, col_begin+j);
+	}
+}
+
 void CDistance::do_precompute_matrix()
 {
 	int32_t num_left=lhs->get_num_vectors();
@@ -263,6 +305,52 @@ void CDistance::init()
 	SG_ADD(&rhs, "rhs", "Right hand side features.");
 }
 
+template <class T>
+void CDistance::get_distance_matrix_blocked(
+	T* result, int32_t m, int32_t n, bool symmetric)
+{
+	const index_t block_size=256;
+	const index_t num_row_blocks=(m+block_size-1)/block_size;
+	const index_t num_col_blocks=(n+block_size-1)/block_size;
+	const index_t num_blocks=num_row_blocks*num_col_blocks;
+
+	SG_DEBUG("computing distance matrix in {} blocks", num_blocks)
+
+	parallel_for(0, num_blocks, [&](index_t start, index_t end) {
+		SGMatrix<float64_t> buffer(block_size, block_size);
+
+		for (index_t b=start; b<end; b++)
+		{
+			index_t row_block=b%num_row_blocks;
+			index_t col_block=b/num_row_blocks;
+
+			// the lower triangle is mirrored from the upper one
+			if (symmetric && row_block>col_block)
+				continue;
+
+			index_t row_begin=row_block*block_size;
+			index_t col_begin=col_block*block_size;
+			SGMatrix<float64_t> block(buffer.matrix,
+				CMath::min(block_size, m-row_begin),
+				CMath::min(block_size, n-col_begin), false);
+
+			compute_distance_block(row_begin, col_begin, block);
+
+			for (index_t j=0; j<block.num_cols; j++)
+			{
+				for (index_t i=0; i<block.num_rows; i++)
+				{
+					index_t r=row_begin+i;
+					index_t c=col_begin+j;
+					result[r+int64_t(c)*m]=block(i, j);
+					if (symmetric && row_block!=col_block)
+						result[c+int64_t(r)*m]=block(i, j);
+				}
+			}
+		}
+	}, 1);
+}
+
 template <class T>
 SGMatrix<T> CDistance::get_distance_matrix()
 {
@@ -275,7 +363,6 @@ SGMatrix<T> CDistance::get_distance_matrix()
 	int32_t n=get_num_vec_rhs();
 
 	int64_t total_num = int64_t(m)*n;
-	int64_t total=0;
 
 	// if lhs == rhs and sizes match assume k(i,j)=k(j,i)
 	bool symmetric= (lhs && lhs==rhs && m==n);
@@ -284,30 +371,16 @@ SGMatrix<T> CDistance::get_distance_matrix()
 
 	result=SG_MALLOC(T, total_num);
 
-	PRange<int64_t> pb = PRange<int64_t>(
-	    range(total_num), "PROGRESS: ", UTF8, []() { return true; });
-	int32_t num_threads;
-	int64_t step;
-	#pragma omp parallel shared(num_threads, step)
+	if (supports_distance_block())
 	{
-#ifdef HAVE_OPENMP
-		#pragma omp single
-		{
-			num_threads=omp_get_num_threads();
-			step=total_num/num_threads;
-			num_threads--;
-		}
-		int32_t thread_num=omp_get_thread_num();
-#else
-		num_threads=0;
-		step=total_num;
-		int32_t thread_num=0;
-#endif
-		bool verbose=(thread_num == 0);
-
-		int32_t start=compute_row_start(thread_num*step, n, symmetric);
-		int32_t end=(thread_num==num_threads) ? m : compute_row_start((thread_num+1)*step, n, symmetric);
+		get_distance_matrix_blocked<T>(result, m, n, symmetric);
+		return SGMatrix<T>(result,m,n,true);
+	}
 
+	auto pb = SG_PROGRESS(range(m));
+	// rows of the symmetric case differ in length, small chunks let the
+	// scheduler balance them
+	parallel_for(0, m, [&](index_t start, index_t end) {
 		for (int32_t i=start; i<end; i++)
 		{
 			int32_t j_start=0;
@@ -322,23 +395,10 @@ SGMatrix<T> CDistance::get_distance_matrix()
 
 				if (symmetric && i!=j)
 					result[j+i*m]=v;
-
-				if (verbose)
-				{
-					total++;
-
-					if (symmetric && i!=j)
-						total++;
-
-					pb.print_progress();
-
-					// TODO: replace with new signal
-					// if (CSignal::cancel_computations())
-					//	break;
-				}
 			}
+			pb.print_progress();
 		}
-	}
+	}, 16);
 	pb.complete();
 
 	return SGMatrix<T>(result,m,n,true);
@@ -162,6 +162,37 @@ class CDistance : public CSGObject
 		 */
 		template <class T> SGMatrix<T> get_distance_matrix();
 
+		/** get the distances between a range of left-hand side vectors
+		 * and a range of right-hand side vectors
+		 *
+		 * @param row_begin index of the first left-hand side vector
+		 * @param row_end index one past the last left-hand side vector
+		 * @param col_begin index of the first right-hand side vector
+		 * @param col_end index one past the last right-hand side vector
+		 * @return matrix with entry (i,j) being
+		 * distance(row_begin+i, col_begin+j)
+		 */
+		SGMatrix<float64_t> get_distance_block(
+			index_t row_begin, index_t row_end,
+			index_t col_begin, index_t col_end);
+
+#ifndef SWIG
+		/** compute a block of distances
+		 * block(i,j)=distance(row_begin+i, col_begin+j)
+		 *
+		 * Distances on dense features compute the whole block with
+		 * matrix products, others call distance() for every entry.
+		 * Different blocks may be computed by several threads at once.
+		 *
+		 * @param row_begin index of the first left-hand side vector
+		 * @param col_begin index of the first right-hand side vector
+		 * @param block pre-allocated block, its size determines the number
+		 * of vectors on both sides
+		 */
+		void get_distance_block(
+			index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block);
+#endif
+
 		/** compute row start offset for parallel kernel matrix computation
 		 *
 		 * @param offs offset
@@ -369,6 +400,28 @@ class CDistance : public CSGObject
 		/// matrix precomputation
 		void do_precompute_matrix();
 
+		/** whether the distance can compute whole blocks of distances at
+		 * once through compute_distance_block(), e.g. from a matrix
+		 * product. If so, get_distance_block() and get_distance_matrix()
+		 * use it instead of calling compute() for every entry.
+		 *
+		 * @return false, override in distances that provide a block path
+		 */
+		virtual bool supports_distance_block() { return false; }
+
+		/** compute a block of distances
+		 * block(i,j)=compute(row_begin+i, col_begin+j)
+		 *
+		 * The base method calls compute() for every entry.
+		 *
+		 * @param row_begin index of the first left-hand side vector
+		 * @param col_begin index of the first right-hand side vector
+		 * @param block pre-allocated block, its size determines the number
+		 * of vectors on both sides
+		 */
+		virtual void compute_distance_block(
+			index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block);
+
 		/**
 		 * Checks the compatibility between two supplied features
 		 *
@@ -381,6 +434,18 @@ class CDistance : public CSGObject
 	private:
 		void init();
 
+		/** compute the distance matrix tile by tile via
+		 * compute_distance_block()
+		 *
+		 * @param result pre-allocated m x n matrix
+		 * @param m number of rows
+		 * @param n number of columns
+		 * @param symmetric whether d(i,j)=d(j,i) can be assumed
+		 */
+		template <class T>
+		void get_distance_matrix_blocked(
+			T* result, int32_t m, int32_t n, bool symmetric);
+
 	protected:
 		/** FIXME: precompute matrix should be dropped, handling
 		 * should be via customdistance
@@ -11,6 +11,7 @@
 #include <shogun/features/DotFeatures.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
 
 using namespace shogun;
 
@@ -76,6 +77,45 @@ float64_t CEuclideanDistance::compute(int32_t idx_a, int32_t idx_b)
 	return std::sqrt(result);
 }
 
+bool CEuclideanDistance::supports_distance_block()
+{
+	// subclasses modify compute()
+	return get_distance_type()==D_EUCLIDEAN && has_dense_real_features(lhs, rhs) &&
+		m_lhs_squared_norms.vlen==num_lhs &&
+		m_rhs_squared_norms.vlen==num_rhs;
+}
+
+void CEuclideanDistance::compute_distance_block(
+	index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block)
+{
+	SGMatrix<float64_t> lhs_matrix=get_dense_feature_matrix(lhs);
+	SGMatrix<float64_t> rhs_matrix=get_dense_feature_matrix(rhs);
+	ASSERT(lhs_matrix.matrix && rhs_matrix.matrix)
+
+	const index_t dim=lhs_matrix.num_rows;
+
+	// the vectors of a block are contiguous columns of the feature matrix
+	SGMatrix<float64_t> lhs_block(lhs_matrix.matrix+int64_t(row_begin)*dim,
+		dim, block.num_rows, false);
+	SGMatrix<float64_t> rhs_block(rhs_matrix.matrix+int64_t(col_begin)*dim,
+		dim, block.num_cols, false);
+
+	linalg::matrix_prod(lhs_block, rhs_block, block, true, false);
+
+	for (index_t j=0; j<block.num_cols; j++)
+	{
+		for (index_t i=0; i<block.num_rows; i++)
+		{
+			float64_t result=m_lhs_squared_norms[row_begin+i]+
+				m_rhs_squared_norms[col_begin+j]-2*block(i, j);
+
+			// rounding may leave tiny negative distances
+			result=CMath::max(result, 0.0);
+			block(i, j)=disable_sqrt ? result : std::sqrt(result);
+		}
+	}
+}
+
 void CEuclideanDistance::precompute_lhs()
 {
 	require(lhs, "Left hand side feature cannot be NULL!");
@@ -176,6 +176,20 @@ protected:
 	/// in the corresponding feature object
 	virtual float64_t compute(int32_t idx_a, int32_t idx_b);
 
+	/** @return whether blocks of distances can be computed from the
+	 * precomputed squared norms and one matrix product
+	 */
+	virtual bool supports_distance_block();
+
+	/** compute a block of distances as sqrt(||x||^2+||y||^2-2x'y)
+	 *
+	 * @param row_begin index of the first left-hand side vector
+	 * @param col_begin index of the first right-hand side vector
+	 * @param block pre-allocated output block
+	 */
+	virtual void compute_distance_block(
+		index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block);
+
 	/** if application of sqrt on matrix computation is disabled */
 	bool disable_sqrt;
 
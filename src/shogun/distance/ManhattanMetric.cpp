@@ -8,9 +8,12 @@
 #include <shogun/lib/common.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/distance/ManhattanMetric.h>
+#include <shogun/features/DenseFeatures.h>
 #include <shogun/features/Features.h>
+#include <shogun/mathematics/eigen3.h>
 
 using namespace shogun;
+using namespace Eigen;
 
 CManhattanMetric::CManhattanMetric()
 : CDenseDistance<float64_t>()
@@ -66,3 +69,26 @@ float64_t CManhattanMetric::compute(int32_t idx_a, int32_t idx_b)
 
 	return result;
 }
+
+bool CManhattanMetric::supports_distance_block()
+{
+	return get_distance_type()==D_MANHATTAN && has_dense_real_features(lhs, rhs);
+}
+
+void CManhattanMetric::compute_distance_block(
+	index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block)
+{
+	SGMatrix<float64_t> lhs_matrix=get_dense_feature_matrix(lhs);
+	SGMatrix<float64_t> rhs_matrix=get_dense_feature_matrix(rhs);
+	ASSERT(lhs_matrix.matrix && rhs_matrix.matrix)
+
+	const index_t dim=lhs_matrix.num_rows;
+	Map<MatrixXd> x(lhs_matrix.matrix+int64_t(row_begin)*dim,
+		dim, block.num_rows);
+	Map<MatrixXd> y(rhs_matrix.matrix+int64_t(col_begin)*dim,
+		dim, block.num_cols);
+	Map<MatrixXd> values(block.matrix, block.num_rows, block.num_cols);
+
+	for (index_t j=0; j<block.num_cols; j++)
+		values.col(j)=(x.colwise()-y.col(j)).cwiseAbs().colwise().sum().transpose();
+}
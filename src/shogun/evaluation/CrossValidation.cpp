@@ -8,6 +8,7 @@
 
 #include <shogun/base/Parameter.h>
 #include <shogun/base/progress.h>
+#include <shogun/base/TaskScheduler.h>
 #include <shogun/evaluation/CrossValidation.h>
 #include <shogun/evaluation/CrossValidationStorage.h>
 #include <shogun/evaluation/Evaluation.h>
@@ -96,48 +97,51 @@ float64_t CCrossValidation::evaluate_one_run(int64_t index) const
 
 	SGVector<float64_t> results(num_subsets);
 
-	#pragma omp parallel for shared(results)
-	for (auto i = 0; i<num_subsets; ++i)
-	{
-		// only need to clone hyperparameters and settings of machine
-		// model parameters are inferred/learned during training
-		auto machine = make_clone(m_machine,
-				ParameterProperties::HYPER | ParameterProperties::SETTING);
-
-		SGVector<index_t> idx_train =
-			m_splitting_strategy->generate_subset_inverse(i);
-
-		SGVector<index_t> idx_test =
-			m_splitting_strategy->generate_subset_indices(i);
-
-		auto features_train = view(m_features, idx_train);
-		auto labels_train = view(m_labels, idx_train);
-		auto features_test = view(m_features, idx_test);
-		auto labels_test = view(m_labels, idx_test);
-		SG_REF(features_train);
-		SG_REF(labels_train);
-		SG_REF(features_test);
-		SG_REF(labels_test);
-
-		auto evaluation_criterion = make_clone(m_evaluation_criterion);
-
-		machine->set_labels(labels_train);
-		machine->train(features_train);
-
-		auto result_labels = machine->apply(features_test);
-		SG_REF(result_labels);
-
-		results[i] = evaluation_criterion->evaluate(result_labels, labels_test);
-		io::info("Result of cross-validation fold {}/{} is {}", i+1, num_subsets, results[i]);
-
-		SG_UNREF(machine);
-		SG_UNREF(features_train);
-		SG_UNREF(labels_train);
-		SG_UNREF(features_test);
-		SG_UNREF(labels_test);
-		SG_UNREF(evaluation_criterion);
-		SG_UNREF(result_labels);
-	}
+	// folds are tasks, so machines that train in parallel themselves share
+	// the threads with the other folds rather than oversubscribing
+	parallel_for(0, num_subsets, [&](index_t start, index_t end) {
+		for (index_t i = start; i < end; ++i)
+		{
+			// only need to clone hyperparameters and settings of machine
+			// model parameters are inferred/learned during training
+			auto machine = make_clone(m_machine,
+					ParameterProperties::HYPER | ParameterProperties::SETTING);
+
+			SGVector<index_t> idx_train =
+				m_splitting_strategy->generate_subset_inverse(i);
+
+			SGVector<index_t> idx_test =
+				m_splitting_strategy->generate_subset_indices(i);
+
+			auto features_train = view(m_features, idx_train);
+			auto labels_train = view(m_labels, idx_train);
+			auto features_test = view(m_features, idx_test);
+			auto labels_test = view(m_labels, idx_test);
+			SG_REF(features_train);
+			SG_REF(labels_train);
+			SG_REF(features_test);
+			SG_REF(labels_test);
+
+			auto evaluation_criterion = make_clone(m_evaluation_criterion);
+
+			machine->set_labels(labels_train);
+			machine->train(features_train);
+
+			auto result_labels = machine->apply(features_test);
+			SG_REF(result_labels);
+
+			results[i] = evaluation_criterion->evaluate(result_labels, labels_test);
+			io::info("Result of cross-validation fold {}/{} is {}", i+1, num_subsets, results[i]);
+
+			SG_UNREF(machine);
+			SG_UNREF(features_train);
+			SG_UNREF(labels_train);
+			SG_UNREF(features_test);
+			SG_UNREF(labels_test);
+			SG_UNREF(evaluation_criterion);
+			SG_UNREF(result_labels);
+		}
+	}, 1);
 
 	/* build arithmetic mean of results */
 	float64_t mean = CStatistics::mean(results);
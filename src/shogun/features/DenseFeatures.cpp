@@ -9,6 +9,8 @@
  */
 
 #include <shogun/base/some.h>
+#include <shogun/base/TaskScheduler.h>
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/preprocessor/DensePreprocessor.h>
 #include <shogun/io/SGIO.h>
@@ -18,6 +20,7 @@
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
 #include <algorithm>
 #include <string.h>
+#include <type_traits>
 
 #define ASSERT_FLOATING_POINT                                                  \
 	switch (get_feature_type())                                                \
@@ -629,6 +632,60 @@ GET_FEATURE_TYPE(F_DREAL, float64_t)
 GET_FEATURE_TYPE(F_LONGREAL, floatmax_t)
 #undef GET_FEATURE_TYPE
 
+template <class ST>
+void CDenseFeatures<ST>::dense_dot_range(float64_t* output, int32_t start,
+		int32_t stop, float64_t* alphas, float64_t* vec, int32_t dim,
+		float64_t b) const
+{
+	if (!feature_matrix.matrix || m_subset_stack->has_subsets() ||
+		get_num_preprocessors())
+	{
+		CDotFeatures::dense_dot_range(output, start, stop, alphas, vec, dim, b);
+		return;
+	}
+
+	ASSERT(output)
+	ASSERT(start>=0)
+	ASSERT(start<stop)
+	ASSERT(stop<=get_num_vectors())
+	require(dim==num_features, "Dimension of the vector ({}) should be {}",
+		dim, num_features);
+
+	// vectors of other types are converted block by block, so that the
+	// buffer stays in cache
+	const index_t block_size=256;
+	const index_t num_threads=env()->get_num_threads();
+	const index_t grain=std::max<index_t>(
+		(stop-start+num_threads-1)/num_threads, block_size);
+	SGVector<float64_t> w(vec, dim, false);
+
+	parallel_for(start, stop, [&](index_t t_start, index_t t_stop) {
+		SGMatrix<float64_t> buffer;
+		if (!std::is_same<ST, float64_t>::value)
+			buffer=SGMatrix<float64_t>(num_features, block_size);
+
+		for (index_t first=t_start; first<t_stop; first+=block_size)
+		{
+			const index_t num=std::min(block_size, t_stop-first);
+			const ST* block=feature_matrix.matrix+int64_t(first)*num_features;
+			SGMatrix<float64_t> vectors;
+			if constexpr (std::is_same<ST, float64_t>::value)
+				vectors=SGMatrix<float64_t>(const_cast<ST*>(block), num_features, num, false);
+			else
+			{
+				std::copy(block, block+int64_t(num)*num_features, buffer.matrix);
+				vectors=SGMatrix<float64_t>(buffer.matrix, num_features, num, false);
+			}
+
+			SGVector<float64_t> dots(output+first-start, num, false);
+			linalg::matrix_prod(vectors, w, dots, true);
+		}
+	}, grain);
+
+	for (int32_t i=0; i<stop-start; i++)
+		output[i]=(alphas ? alphas[i] : 1.0)*output[i]+b;
+}
+
 template <typename ST>
 float64_t
 CDenseFeatures<ST>::dot(int32_t vec_idx1, const SGVector<float64_t>& vec2) const
@@ -813,6 +870,80 @@ SGVector<ST> CDenseFeatures<ST>::dot(const SGVector<ST>& other) const
 	return linalg::matrix_prod(get_feature_matrix(), other, false);
 }
 
+template <typename ST>
+SGVector<ST> CDenseFeatures<ST>::dot_range(
+	int32_t start, int32_t stop, const SGVector<ST>& vec, ST b) const
+{
+	require(
+		start >= 0 && start <= stop && stop <= get_num_vectors(),
+		"Range [{}, {}) out of bounds [0, {})", start, stop,
+		get_num_vectors());
+	require(
+		vec.vlen == num_features,
+		"Dimension of the vector ({}) should be {}", vec.vlen, num_features);
+
+	SGVector<ST> result(stop - start);
+	if (stop == start)
+		return result;
+
+	if (feature_matrix.matrix && !m_subset_stack->has_subsets() &&
+		!get_num_preprocessors())
+	{
+		// one matrix-vector product over the contiguous vectors
+		SGMatrix<ST> vectors(
+			feature_matrix.matrix + int64_t(start) * num_features,
+			num_features, stop - start, false);
+		linalg::matrix_prod(vectors, vec, result, true);
+	}
+	else
+	{
+		for (int32_t i = start; i < stop; ++i)
+		{
+			SGVector<ST> vec1 = get_feature_vector(i);
+			result[i - start] = linalg::dot(vec1, vec);
+			free_feature_vector(vec1, i);
+		}
+	}
+
+	for (index_t i = 0; i < result.vlen; ++i)
+		result[i] += b;
+
+	return result;
+}
+
+SGMatrix<float64_t> get_dense_feature_matrix(CFeatures* features)
+{
+	if (!features || features->get_feature_class()!=C_DENSE ||
+		features->get_feature_type()!=F_DREAL)
+		return SGMatrix<float64_t>();
+
+	CSubsetStack* subset_stack=features->get_subset_stack();
+	bool has_subsets=subset_stack->has_subsets();
+	SG_UNREF(subset_stack);
+	if (has_subsets)
+		return SGMatrix<float64_t>();
+
+	// preprocessors that are attached but not applied are only applied
+	// by get_feature_vector()
+	auto dense=features->as<CDenseFeatures<float64_t>>();
+	if (dense->get_num_preprocessors())
+		return SGMatrix<float64_t>();
+
+	SGMatrix<float64_t> matrix=dense->get_feature_matrix();
+
+	// features computed on the fly have no matrix in memory
+	if (!matrix.matrix || matrix.num_cols!=dense->get_num_vectors())
+		return SGMatrix<float64_t>();
+
+	return matrix;
+}
+
+bool has_dense_real_features(CFeatures* lhs, CFeatures* rhs)
+{
+	return get_dense_feature_matrix(lhs).matrix &&
+		get_dense_feature_matrix(rhs).matrix;
+}
+
 template class CDenseFeatures<bool>;
 template class CDenseFeatures<char>;
 template class CDenseFeatures<int8_t>;
@@ -336,6 +336,27 @@ public:
 	 */
 	SGVector<ST> dot(const SGVector<ST>& other) const;
 
+	/** Computes the dot products of a range of feature vectors with a dense
+	 * vector in the precision of the features, that is
+	 *
+	 *\f[
+	 * X_{start:stop}^\top w + b
+	 * \f]
+	 *
+	 * Unlike dense_dot_range(), float32 features are not promoted to double
+	 * precision, which makes this the single precision path for float32
+	 * linear models.
+	 *
+	 * possible with subset
+	 *
+	 * @param start first vector of the range
+	 * @param stop vector after the last vector of the range
+	 * @param vec dense vector of dimension get_num_features()
+	 * @param b bias added to every dot product
+	 * @return stop-start dot products
+	 */
+	SGVector<ST> dot_range(int32_t start, int32_t stop, const SGVector<ST>& vec, ST b=0) const;
+
 	/** compute dot product between vector1 and a dense vector
 	 *
 	 * possible with subset
@@ -359,6 +380,21 @@ public:
 	virtual void add_to_dense_vec(float64_t alpha, int32_t vec_idx1,
 			float64_t* vec2, int32_t vec2_len, bool abs_val = false) const;
 
+	/** Compute the dot product for a range of vectors. Without subsets,
+	 * the vectors of every thread are scored in blocks with one
+	 * matrix-vector product per block instead of one dot() per vector.
+	 *
+	 * @param output result for the given vector range
+	 * @param start start vector range from this idx
+	 * @param stop stop vector range at this idx
+	 * @param alphas scalars to multiply with, may be NULL
+	 * @param vec dense vector to compute dot product with
+	 * @param dim length of the dense vector
+	 * @param b bias
+	 */
+	virtual void dense_dot_range(float64_t* output, int32_t start, int32_t stop,
+			float64_t* alphas, float64_t* vec, int32_t dim, float64_t b) const;
+
 	/** get number of non-zero features in vector
 	 *
 	 * @param num which vector
@@ -557,5 +593,22 @@ protected:
 	/** feature cache */
 	CCache<ST>* feature_cache;
 };
+
+/** get the feature matrix of dense real valued features that can be used
+ * directly, i.e. which are held in memory and have no active subset and no
+ * preprocessors that would be applied on the fly
+ *
+ * @param features features to check
+ * @return feature matrix or empty matrix if not applicable
+ */
+SGMatrix<float64_t> get_dense_feature_matrix(CFeatures* features);
+
+/** @return whether both features are dense real valued features whose
+ * matrices can be used directly, see get_dense_feature_matrix()
+ *
+ * @param lhs left-hand side features
+ * @param rhs right-hand side features
+ */
+bool has_dense_real_features(CFeatures* lhs, CFeatures* rhs);
 }
 #endif // _DENSEFEATURES__H__
@@ -0,0 +1,319 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/features/DiskDotFeatures.h>
+#include <shogun/io/ShogunErrc.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace shogun;
+
+/** iterator over the features of a vector */
+struct disk_feature_iterator
+{
+	/** copy of the vector */
+	SGVector<float64_t> vec;
+	/** feature index */
+	int32_t index;
+};
+
+CDiskDotFeatures::CDiskDotFeatures() : CDotFeatures()
+{
+	init();
+}
+
+CDiskDotFeatures::CDiskDotFeatures(const char* fname, int32_t num_cached_blocks)
+: CDotFeatures()
+{
+	init();
+	require(num_cached_blocks>0, "Number of cached blocks ({}) should be positive",
+		num_cached_blocks);
+
+	m_fname=fname;
+	m_num_cached_blocks=num_cached_blocks;
+	m_dataset=new CDatasetFile(fname);
+	SG_REF(m_dataset);
+
+	require(!m_dataset->is_sparse(), "{} holds sparse vectors", fname);
+	require(m_dataset->get_primitive_type()==PT_FLOAT64
+		|| m_dataset->get_primitive_type()==PT_FLOAT32,
+		"{} holds vectors of type {}, not float32 or float64", fname,
+		ptype_name(m_dataset->get_primitive_type()));
+	require(m_dataset->get_num_vectors()<=std::numeric_limits<int32_t>::max(),
+		"{} holds more vectors ({}) than supported", fname, m_dataset->get_num_vectors());
+
+	std::error_condition ec;
+	if ((ec=env()->new_random_access_file(fname, &m_reader)))
+		throw io::to_system_error(ec);
+
+	m_block_starts.clear();
+	for (int64_t i=0; i<m_dataset->get_num_chunks(); ++i)
+		m_block_starts.push_back(m_dataset->get_chunk_first_vector(i));
+	m_block_starts.push_back(m_dataset->get_num_vectors());
+}
+
+CDiskDotFeatures::~CDiskDotFeatures()
+{
+	// the background read uses the file
+	if (m_prefetch.valid())
+		m_prefetch.wait();
+
+	SG_UNREF(m_dataset);
+}
+
+void CDiskDotFeatures::init()
+{
+	m_dataset=NULL;
+	m_num_cached_blocks=2;
+	m_prefetch_block=-1;
+	m_block_starts.assign(1, 0);
+}
+
+CFeatures* CDiskDotFeatures::duplicate() const
+{
+	CDiskDotFeatures* dup=new CDiskDotFeatures(m_fname.c_str(), m_num_cached_blocks);
+	if (m_subset_stack != NULL)
+	{
+		SG_UNREF(dup->m_subset_stack);
+		dup->m_subset_stack=new CSubsetStack(*m_subset_stack);
+		SG_REF(dup->m_subset_stack);
+	}
+	return dup;
+}
+
+EFeatureType CDiskDotFeatures::get_feature_type() const
+{
+	return F_DREAL;
+}
+
+EFeatureClass CDiskDotFeatures::get_feature_class() const
+{
+	return C_DISK_DENSE;
+}
+
+int32_t CDiskDotFeatures::get_num_vectors() const
+{
+	return m_subset_stack->has_subsets() ? m_subset_stack->get_size() : m_block_starts.back();
+}
+
+int32_t CDiskDotFeatures::get_dim_feature_space() const
+{
+	return m_dataset ? m_dataset->get_num_features() : 0;
+}
+
+int32_t CDiskDotFeatures::get_num_blocks() const
+{
+	return m_block_starts.size()-1;
+}
+
+int32_t CDiskDotFeatures::get_block_start(int32_t block) const
+{
+	require(block>=0 && block<get_num_blocks(), "Block {} out of bounds", block);
+	return m_block_starts[block];
+}
+
+int32_t CDiskDotFeatures::find_block(int32_t num) const
+{
+	require(num>=0 && num<m_block_starts.back(), "Index {} out of bounds", num);
+	return std::upper_bound(m_block_starts.begin(), m_block_starts.end(), num)-m_block_starts.begin()-1;
+}
+
+SGMatrix<float64_t> CDiskDotFeatures::read_block(int32_t block) const
+{
+	std::lock_guard<std::mutex> lock(m_read_lock);
+	if (m_dataset->get_primitive_type()==PT_FLOAT64)
+		return m_dataset->read_dense_chunk<float64_t>(block, m_reader.get());
+
+	SGMatrix<float32_t> mat32=m_dataset->read_dense_chunk<float32_t>(block, m_reader.get());
+	SGMatrix<float64_t> mat(mat32.num_rows, mat32.num_cols);
+	std::copy(mat32.matrix, mat32.matrix+int64_t(mat32.num_rows)*mat32.num_cols, mat.matrix);
+	return mat;
+}
+
+void CDiskDotFeatures::cache_block(int32_t block, SGMatrix<float64_t> mat) const
+{
+	if (int32_t(m_blocks.size())>=m_num_cached_blocks)
+		m_blocks.erase(m_blocks.begin());
+	m_blocks.emplace_back(block, mat);
+}
+
+SGMatrix<float64_t> CDiskDotFeatures::get_block(int32_t block) const
+{
+	require(block>=0 && block<get_num_blocks(), "Block {} out of bounds", block);
+	std::lock_guard<std::mutex> lock(m_block_lock);
+
+	auto is_cached=[&](int32_t b) {
+		return std::find_if(m_blocks.begin(), m_blocks.end(),
+			[b](const auto& cached) { return cached.first==b; });
+	};
+
+	// blocks are reference counted, so evicting a block does not free it
+	// while it is used
+	SGMatrix<float64_t> mat;
+	auto it=is_cached(block);
+	if (it!=m_blocks.end())
+	{
+		mat=it->second;
+		std::rotate(it, it+1, m_blocks.end());
+	}
+	else
+	{
+		if (m_prefetch_block==block)
+		{
+			mat=m_prefetch.get();
+			m_prefetch_block=-1;
+		}
+		else
+			mat=read_block(block);
+		cache_block(block, mat);
+	}
+
+	const int32_t next=block+1;
+	if (next<get_num_blocks() && m_prefetch_block!=next && is_cached(next)==m_blocks.end())
+	{
+		if (m_prefetch_block>=0)
+			cache_block(m_prefetch_block, m_prefetch.get());
+
+		m_prefetch_block=next;
+		m_prefetch=std::async(std::launch::async, [this, next]() {
+			return read_block(next);
+		});
+	}
+
+	return mat;
+}
+
+SGVector<float64_t> CDiskDotFeatures::get_feature_vector(int32_t num) const
+{
+	const int32_t real_num=m_subset_stack->subset_idx_conversion(num);
+	const int32_t block=find_block(real_num);
+	const int32_t dim=get_dim_feature_space();
+	SGMatrix<float64_t> mat=get_block(block);
+
+	SGVector<float64_t> vec(dim);
+	sg_memcpy(vec.vector, mat.matrix+int64_t(real_num-m_block_starts[block])*dim,
+		dim*sizeof(float64_t));
+	return vec;
+}
+
+float64_t CDiskDotFeatures::dot(int32_t vec_idx1, CDotFeatures* df, int32_t vec_idx2) const
+{
+	require(df, "No features given");
+	require(df->get_dim_feature_space()==get_dim_feature_space(),
+		"Dimension of the features ({}) should be {}",
+		df->get_dim_feature_space(), get_dim_feature_space());
+
+	return df->dot(vec_idx2, get_feature_vector(vec_idx1));
+}
+
+float64_t CDiskDotFeatures::dot(int32_t vec_idx1, const SGVector<float64_t>& vec2) const
+{
+	const int32_t real_num=m_subset_stack->subset_idx_conversion(vec_idx1);
+	const int32_t block=find_block(real_num);
+	const int32_t dim=get_dim_feature_space();
+	require(vec2.vlen==dim, "Dimension of the vector ({}) should be {}", vec2.vlen, dim);
+
+	SGMatrix<float64_t> mat=get_block(block);
+	SGVector<float64_t> vec(mat.matrix+int64_t(real_num-m_block_starts[block])*dim, dim, false);
+	return linalg::dot(vec, vec2);
+}
+
+void CDiskDotFeatures::add_to_dense_vec(float64_t alpha, int32_t vec_idx1, float64_t* vec2, int32_t vec2_len, bool abs_val) const
+{
+	const int32_t real_num=m_subset_stack->subset_idx_conversion(vec_idx1);
+	const int32_t block=find_block(real_num);
+	const int32_t dim=get_dim_feature_space();
+	require(vec2_len==dim, "Dimension of the vector ({}) should be {}", vec2_len, dim);
+
+	SGMatrix<float64_t> mat=get_block(block);
+	const float64_t* vec=mat.matrix+int64_t(real_num-m_block_starts[block])*dim;
+	if (abs_val)
+	{
+		for (int32_t i=0; i<dim; ++i)
+			vec2[i]+=alpha*std::abs(vec[i]);
+	}
+	else
+	{
+		for (int32_t i=0; i<dim; ++i)
+			vec2[i]+=alpha*vec[i];
+	}
+}
+
+void CDiskDotFeatures::dense_dot_range(float64_t* output, int32_t start, int32_t stop, float64_t* alphas, float64_t* vec, int32_t dim, float64_t b) const
+{
+	if (m_subset_stack->has_subsets())
+	{
+		CDotFeatures::dense_dot_range(output, start, stop, alphas, vec, dim, b);
+		return;
+	}
+
+	ASSERT(output)
+	ASSERT(start>=0)
+	ASSERT(start<stop)
+	ASSERT(stop<=get_num_vectors())
+	require(dim==get_dim_feature_space(), "Dimension of the vector ({}) should be {}",
+		dim, get_dim_feature_space());
+
+	// one pass over the blocks, the next one is read while a block is used
+	SGVector<float64_t> w(vec, dim, false);
+	for (int32_t block=find_block(start); block<get_num_blocks() && m_block_starts[block]<stop; ++block)
+	{
+		SGMatrix<float64_t> mat=get_block(block);
+		const int32_t first=std::max(start, m_block_starts[block]);
+		const int32_t last=std::min(stop, m_block_starts[block+1]);
+
+		SGMatrix<float64_t> vectors(mat.matrix+int64_t(first-m_block_starts[block])*dim,
+			dim, last-first, false);
+		SGVector<float64_t> dots=linalg::matrix_prod(vectors, w, true);
+		for (int32_t i=first; i<last; ++i)
+		{
+			const float64_t alpha=alphas ? alphas[i-start] : 1.0;
+			output[i-start]=alpha*dots[i-first]+b;
+		}
+	}
+}
+
+int32_t CDiskDotFeatures::get_nnz_features_for_vector(int32_t num) const
+{
+	return get_dim_feature_space();
+}
+
+int32_t CDiskDotFeatures::get_vector_block(int32_t num) const
+{
+	return find_block(m_subset_stack->subset_idx_conversion(num));
+}
+
+void* CDiskDotFeatures::get_feature_iterator(int32_t vector_index)
+{
+	disk_feature_iterator* iterator=new disk_feature_iterator();
+	iterator->vec=get_feature_vector(vector_index);
+	iterator->index=0;
+	return iterator;
+}
+
+bool CDiskDotFeatures::get_next_feature(int32_t& index, float64_t& value, void* iterator)
+{
+	disk_feature_iterator* it=(disk_feature_iterator*) iterator;
+	if (!it || it->index>=it->vec.vlen)
+		return false;
+
+	index=it->index++;
+	value=it->vec[index];
+	return true;
+}
+
+void CDiskDotFeatures::free_feature_iterator(void* iterator)
+{
+	delete (disk_feature_iterator*) iterator;
+}
+
+CDatasetFile* CDiskDotFeatures::get_dataset_file() const
+{
+	SG_REF(m_dataset);
+	return m_dataset;
+}
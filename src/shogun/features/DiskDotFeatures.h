@@ -0,0 +1,232 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef _DISKDOTFEATURES__H__
+#define _DISKDOTFEATURES__H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/features/DotFeatures.h>
+#include <shogun/io/DatasetFile.h>
+#include <shogun/io/fs/FileSystem.h>
+#include <shogun/lib/SGMatrix.h>
+
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace shogun
+{
+
+/** @brief Dense real valued features of a CDatasetFile that are read from
+ * disk in blocks, for datasets larger than memory.
+ *
+ * Every chunk of the file is a block, which is read through io/fs when
+ * one of its vectors is accessed and kept in a small cache of the most
+ * recently used blocks. While a block is used, the next one is read on a
+ * background thread, so that sequential passes over the data, as done by
+ * the dot product range functions, SVMOcas, SGD based minimizers or a
+ * learner iterating over the vectors in order, overlap computing with
+ * reading. Random access is correct, but may read a block per vector, so
+ * learners visiting the vectors in random order, such as the dual solvers
+ * of LibLinear, shuffle block by block, see get_vector_block().
+ *
+ * Files of float32 vectors are converted to float64 blocks when read.
+ * Memory use is bounded by the block size times the number of cached
+ * blocks plus one prefetched block.
+ */
+class CDiskDotFeatures : public CDotFeatures
+{
+public:
+	/** default constructor */
+	CDiskDotFeatures();
+
+	/** constructor
+	 *
+	 * @param fname name of a dense dataset file of float32 or float64 vectors
+	 * @param num_cached_blocks number of blocks kept in memory
+	 */
+	CDiskDotFeatures(const char* fname, int32_t num_cached_blocks=2);
+
+	/** destructor */
+	virtual ~CDiskDotFeatures();
+
+	/** duplicate feature object
+	 *
+	 * @return feature object reading the same file
+	 */
+	virtual CFeatures* duplicate() const;
+
+	/** @return F_DREAL */
+	virtual EFeatureType get_feature_type() const;
+
+	/** @return C_DISK_DENSE */
+	virtual EFeatureClass get_feature_class() const;
+
+	/** @return number of vectors */
+	virtual int32_t get_num_vectors() const;
+
+	/** @return dimension of the vectors */
+	virtual int32_t get_dim_feature_space() const;
+
+	/** compute dot product between vector1 and vector2,
+	 * appointed by their indices
+	 *
+	 * @param vec_idx1 index of first vector
+	 * @param df DotFeatures to compute dot product with
+	 * @param vec_idx2 index of second vector
+	 */
+	virtual float64_t dot(int32_t vec_idx1, CDotFeatures* df, int32_t vec_idx2) const;
+
+	/** compute dot product between vector1 and a dense vector
+	 *
+	 * @param vec_idx1 index of first vector
+	 * @param vec2 dense vector
+	 */
+	virtual float64_t dot(int32_t vec_idx1, const SGVector<float64_t>& vec2) const;
+
+	/** add vector 1 multiplied with alpha to dense vector2
+	 *
+	 * @param alpha scalar alpha
+	 * @param vec_idx1 index of first vector
+	 * @param vec2 pointer to real valued vector
+	 * @param vec2_len length of real valued vector
+	 * @param abs_val if true add the absolute value
+	 */
+	virtual void add_to_dense_vec(float64_t alpha, int32_t vec_idx1, float64_t* vec2, int32_t vec2_len, bool abs_val=false) const;
+
+	/** Compute the dot product for a range of vectors, block by block
+	 *
+	 * @param output result for the given vector range
+	 * @param start start vector range from this idx
+	 * @param stop stop vector range at this idx
+	 * @param alphas scalars to multiply with, may be NULL
+	 * @param vec dense vector to compute dot product with
+	 * @param dim length of the dense vector
+	 * @param b bias
+	 */
+	virtual void dense_dot_range(float64_t* output, int32_t start, int32_t stop, float64_t* alphas, float64_t* vec, int32_t dim, float64_t b) const;
+
+	/** @return dimension of the vectors, as they are dense
+	 * @param num which vector
+	 */
+	virtual int32_t get_nnz_features_for_vector(int32_t num) const;
+
+	/** @return block of a vector
+	 * @param num which vector
+	 */
+	virtual int32_t get_vector_block(int32_t num) const;
+
+	/** iterate over the features of a vector
+	 *
+	 * @param vector_index the index of the vector over whose components to iterate over
+	 * @return feature iterator (to be passed to get_next_feature)
+	 */
+	virtual void* get_feature_iterator(int32_t vector_index);
+
+	/** iterate over the features of a vector
+	 *
+	 * @param index the index of the next feature
+	 * @param value the value of the next feature
+	 * @param iterator as returned by get_feature_iterator
+	 * @return true if there is a next feature
+	 */
+	virtual bool get_next_feature(int32_t& index, float64_t& value, void* iterator);
+
+	/** clean up iterator
+	 *
+	 * @param iterator as returned by get_feature_iterator
+	 */
+	virtual void free_feature_iterator(void* iterator);
+
+	/** @return number of blocks */
+	int32_t get_num_blocks() const;
+
+	/** @return index of the first vector of a block
+	 * @param block index of the block
+	 */
+	int32_t get_block_start(int32_t block) const;
+
+	/** vectors of a block, read from the cache or from disk. Starts
+	 * reading the next block in the background.
+	 *
+	 * @param block index of the block
+	 * @return num_features x number of vectors of the block matrix
+	 */
+	SGMatrix<float64_t> get_block(int32_t block) const;
+
+	/** feature vector
+	 *
+	 * @param num index of the vector
+	 * @return vector, which shares the memory of its cached block
+	 */
+	SGVector<float64_t> get_feature_vector(int32_t num) const;
+
+	/** @return dataset file of the features */
+	CDatasetFile* get_dataset_file() const;
+
+	/** @return object name */
+	virtual const char* get_name() const { return "DiskDotFeatures"; }
+
+private:
+	/** initialize members */
+	void init();
+
+	/** @return block of a vector, ignoring subsets
+	 * @param num index of the vector
+	 */
+	int32_t find_block(int32_t num) const;
+
+	/** read a block from disk
+	 *
+	 * @param block index of the block
+	 * @return vectors of the block
+	 */
+	SGMatrix<float64_t> read_block(int32_t block) const;
+
+	/** add a block to the cache, evicting the least recently used one
+	 *
+	 * @param block index of the block
+	 * @param mat vectors of the block
+	 */
+	void cache_block(int32_t block, SGMatrix<float64_t> mat) const;
+
+private:
+	/** name of the dataset file */
+	std::string m_fname;
+
+	/** dataset file, for its layout and labels */
+	CDatasetFile* m_dataset;
+
+	/** the dataset file opened for reading blocks */
+	std::unique_ptr<io::RandomAccessFile> m_reader;
+
+	/** index of the first vector of every block, followed by the number
+	 * of vectors
+	 */
+	std::vector<int32_t> m_block_starts;
+
+	/** maximum number of cached blocks */
+	int32_t m_num_cached_blocks;
+
+	/** cached blocks, least recently used first */
+	mutable std::vector<std::pair<int32_t, SGMatrix<float64_t>>> m_blocks;
+
+	/** protects the cache and the prefetch */
+	mutable std::mutex m_block_lock;
+
+	/** serializes reading and decompressing blocks */
+	mutable std::mutex m_read_lock;
+
+	/** block being read in the background, -1 if none */
+	mutable int32_t m_prefetch_block;
+
+	/** result of the background read */
+	mutable std::future<SGMatrix<float64_t>> m_prefetch;
+};
+}
+#endif // _DISKDOTFEATURES__H__
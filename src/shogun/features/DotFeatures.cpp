@@ -9,6 +9,7 @@
 #include <shogun/base/Parallel.h>
 #include <shogun/base/Parameter.h>
 #include <shogun/base/progress.h>
+#include <shogun/base/TaskScheduler.h>
 #include <shogun/features/DotFeatures.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/lib/Signal.h>
@@ -16,10 +17,6 @@
 #include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
 
-#ifdef HAVE_OPENMP
-#include <omp.h>
-#endif
-
 using namespace shogun;
 
 
@@ -54,36 +51,9 @@ void CDotFeatures::dense_dot_range(float64_t* output, int32_t start, int32_t sto
 	ASSERT(num_vectors>0)
 	SGVector<float64_t> sgvec(vec, dim, false);
 
-	int32_t num_threads;
-	int32_t step;
 	auto pb = SG_PROGRESS(range(num_vectors));
-#pragma omp parallel shared(num_threads, step)
-	{
-#ifdef HAVE_OPENMP
-		#pragma omp single
-		{
-			num_threads=omp_get_num_threads();
-			step=num_vectors/num_threads;
-			num_threads--;
-		}
-		int32_t thread_num=omp_get_thread_num();
-#else
-		num_threads=0;
-		step=num_vectors;
-		int32_t thread_num=0;
-#endif
-
-		int32_t t_start=thread_num*step;
-		int32_t t_stop=(thread_num==num_threads) ? num_vectors : (thread_num+1)*step;
-
-#ifdef WIN32
-		for (int32_t i=t_start; i<t_stop; i++)
-#else
-		// TODO: replace with the new signal
-		// for (int32_t i=t_start; i<t_stop &&
-		//		!CSignal::cancel_computations(); i++)
+	parallel_for(0, num_vectors, [&](index_t t_start, index_t t_stop) {
 		for (int32_t i = t_start; i < t_stop; i++)
-#endif
 		{
 			if (alphas)
 				output[i]=alphas[i]*this->dot(i + start, sgvec)+b;
@@ -91,7 +61,7 @@ void CDotFeatures::dense_dot_range(float64_t* output, int32_t start, int32_t sto
 				output[i]=this->dot(i + start, sgvec)+b;
 			pb.print_progress();
 		}
-	}
+	});
 	pb.complete();
 }
 
@@ -102,35 +72,8 @@ void CDotFeatures::dense_dot_range_subset(int32_t* sub_index, int32_t num, float
 
 	SGVector<float64_t> sgvec(vec, dim, false);
 	auto pb = SG_PROGRESS(range(num));
-	int32_t num_threads;
-	int32_t step;
-	#pragma omp parallel shared(num_threads, step)
-	{
-#ifdef HAVE_OPENMP
-		#pragma omp single
-		{
-			num_threads=omp_get_num_threads();
-			step=num/num_threads;
-			num_threads--;
-		}
-		int32_t thread_num=omp_get_thread_num();
-#else
-		num_threads=0;
-		step = num;
-		int32_t thread_num=0;
-#endif
-
-		int32_t t_start=thread_num*step;
-		int32_t t_stop=(thread_num==num_threads) ? num : (thread_num+1)*step;
-
-#ifdef WIN32
-		for (int32_t i=t_start; i<t_stop; i++)
-#else
-		// TODO: replace with the new signal
-		// for (int32_t i=t_start; i<t_stop &&
-		//		!CSignal::cancel_computations(); i++)
+	parallel_for(0, num, [&](index_t t_start, index_t t_stop) {
 		for (int32_t i = t_start; i < t_stop; i++)
-#endif
 		{
 			if (alphas)
 				output[i]=alphas[sub_index[i]]*this->dot(sub_index[i], sgvec)+b;
@@ -138,7 +81,7 @@ void CDotFeatures::dense_dot_range_subset(int32_t* sub_index, int32_t num, float
 				output[i]=this->dot(sub_index[i], sgvec)+b;
 			pb.print_progress();
 		}
-	}
+	});
 	pb.complete();
 }
 
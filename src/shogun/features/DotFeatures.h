@@ -133,6 +133,20 @@ class CDotFeatures : public CFeatures
 		 */
 		virtual int32_t get_nnz_features_for_vector(int32_t num) const=0;
 
+		/** get block of a vector, for features that read their vectors in
+		 * blocks, e.g. from disk. Learners visiting the vectors in random
+		 * order should visit the blocks in random order and the vectors of
+		 * a block one after the other.
+		 *
+		 * @param num which vector
+		 * @return block of the vector, -1 if the vectors are not stored in
+		 * blocks
+		 */
+		virtual int32_t get_vector_block(int32_t num) const
+		{
+			return -1;
+		}
+
 		/** compute the feature matrix in feature space
 		 *
 		 * @return computed feature matrix
@@ -0,0 +1,65 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/features/MappedDenseFeatures.h>
+
+namespace shogun
+{
+
+template <class ST> CMappedDenseFeatures<ST>::CMappedDenseFeatures()
+: CDenseFeatures<ST>(), m_file(NULL)
+{
+}
+
+template <class ST> CMappedDenseFeatures<ST>::CMappedDenseFeatures(const char* fname)
+: CMappedDenseFeatures<ST>(new CDatasetFile(fname))
+{
+}
+
+template <class ST> CMappedDenseFeatures<ST>::CMappedDenseFeatures(CDatasetFile* file)
+: CDenseFeatures<ST>(), m_file(file)
+{
+	require(file, "No dataset file given");
+	SG_REF(m_file);
+	this->set_feature_matrix(m_file->get_matrix<ST>());
+}
+
+template <class ST> CMappedDenseFeatures<ST>::CMappedDenseFeatures(const CMappedDenseFeatures& orig)
+: CDenseFeatures<ST>(orig), m_file(orig.m_file)
+{
+	SG_REF(m_file);
+}
+
+template <class ST> CMappedDenseFeatures<ST>::~CMappedDenseFeatures()
+{
+	// release the borrowed matrix before unmapping it
+	this->free_feature_matrix();
+	SG_UNREF(m_file);
+}
+
+template <class ST> CFeatures* CMappedDenseFeatures<ST>::duplicate() const
+{
+	return new CMappedDenseFeatures<ST>(*this);
+}
+
+template <class ST> CDatasetFile* CMappedDenseFeatures<ST>::get_dataset_file() const
+{
+	SG_REF(m_file);
+	return m_file;
+}
+
+template class CMappedDenseFeatures<bool>;
+template class CMappedDenseFeatures<char>;
+template class CMappedDenseFeatures<int8_t>;
+template class CMappedDenseFeatures<uint8_t>;
+template class CMappedDenseFeatures<int16_t>;
+template class CMappedDenseFeatures<uint16_t>;
+template class CMappedDenseFeatures<int32_t>;
+template class CMappedDenseFeatures<uint32_t>;
+template class CMappedDenseFeatures<int64_t>;
+template class CMappedDenseFeatures<uint64_t>;
+template class CMappedDenseFeatures<float32_t>;
+template class CMappedDenseFeatures<float64_t>;
+template class CMappedDenseFeatures<floatmax_t>;
+}
@@ -0,0 +1,67 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef _MAPPEDDENSEFEATURES__H__
+#define _MAPPEDDENSEFEATURES__H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/io/DatasetFile.h>
+
+namespace shogun
+{
+
+/** @brief Dense features of a CDatasetFile.
+ *
+ * Without compression, the feature matrix is the memory mapped data of the
+ * file, so opening even large files is fast, and vectors are only read
+ * from disk when they are accessed. The file is kept open for as long as
+ * the features exist. The mapping is read only: the feature matrix must
+ * not be modified, e.g. by preprocessors applied in place.
+ *
+ * Compressed files are decompressed into memory when opened.
+ */
+template <class ST> class CMappedDenseFeatures : public CDenseFeatures<ST>
+{
+public:
+	/** default constructor */
+	CMappedDenseFeatures();
+
+	/** constructor
+	 *
+	 * @param fname name of the dataset file
+	 */
+	CMappedDenseFeatures(const char* fname);
+
+	/** constructor
+	 *
+	 * @param file dataset file opened for reading
+	 */
+	CMappedDenseFeatures(CDatasetFile* file);
+
+	/** copy constructor, shares the mapped file */
+	CMappedDenseFeatures(const CMappedDenseFeatures& orig);
+
+	/** destructor */
+	virtual ~CMappedDenseFeatures();
+
+	/** duplicate feature object
+	 *
+	 * @return feature object sharing the mapped file
+	 */
+	virtual CFeatures* duplicate() const;
+
+	/** @return dataset file of the features */
+	CDatasetFile* get_dataset_file() const;
+
+	/** @return object name */
+	virtual const char* get_name() const { return "MappedDenseFeatures"; }
+
+protected:
+	/** dataset file of the features */
+	CDatasetFile* m_file;
+};
+}
+#endif // _MAPPEDDENSEFEATURES__H__
@@ -0,0 +1,66 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/features/MappedSparseFeatures.h>
+
+namespace shogun
+{
+
+template <class ST> CMappedSparseFeatures<ST>::CMappedSparseFeatures()
+: CSparseFeatures<ST>(), m_file(NULL)
+{
+}
+
+template <class ST> CMappedSparseFeatures<ST>::CMappedSparseFeatures(const char* fname)
+: CMappedSparseFeatures<ST>(new CDatasetFile(fname))
+{
+}
+
+template <class ST> CMappedSparseFeatures<ST>::CMappedSparseFeatures(CDatasetFile* file)
+: CSparseFeatures<ST>(), m_file(file)
+{
+	require(file, "No dataset file given");
+	SG_REF(m_file);
+	// the file stores the dimension, so the vectors need not be checked
+	this->sparse_feature_matrix=m_file->get_sparse_matrix<ST>();
+}
+
+template <class ST> CMappedSparseFeatures<ST>::CMappedSparseFeatures(const CMappedSparseFeatures& orig)
+: CSparseFeatures<ST>(orig), m_file(orig.m_file)
+{
+	SG_REF(m_file);
+}
+
+template <class ST> CMappedSparseFeatures<ST>::~CMappedSparseFeatures()
+{
+	// release the borrowed matrix before unmapping it
+	this->free_sparse_feature_matrix();
+	SG_UNREF(m_file);
+}
+
+template <class ST> CFeatures* CMappedSparseFeatures<ST>::duplicate() const
+{
+	return new CMappedSparseFeatures<ST>(*this);
+}
+
+template <class ST> CDatasetFile* CMappedSparseFeatures<ST>::get_dataset_file() const
+{
+	SG_REF(m_file);
+	return m_file;
+}
+
+template class CMappedSparseFeatures<bool>;
+template class CMappedSparseFeatures<char>;
+template class CMappedSparseFeatures<int8_t>;
+template class CMappedSparseFeatures<uint8_t>;
+template class CMappedSparseFeatures<int16_t>;
+template class CMappedSparseFeatures<uint16_t>;
+template class CMappedSparseFeatures<int32_t>;
+template class CMappedSparseFeatures<uint32_t>;
+template class CMappedSparseFeatures<int64_t>;
+template class CMappedSparseFeatures<uint64_t>;
+template class CMappedSparseFeatures<float32_t>;
+template class CMappedSparseFeatures<float64_t>;
+template class CMappedSparseFeatures<floatmax_t>;
+}
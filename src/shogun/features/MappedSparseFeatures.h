@@ -0,0 +1,67 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef _MAPPEDSPARSEFEATURES__H__
+#define _MAPPEDSPARSEFEATURES__H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/features/SparseFeatures.h>
+#include <shogun/io/DatasetFile.h>
+
+namespace shogun
+{
+
+/** @brief Sparse features of a CDatasetFile.
+ *
+ * Without compression, the entries of the sparse vectors are the memory
+ * mapped data of the file, so opening even large files is fast, and
+ * vectors are only read from disk when they are accessed. The file is kept
+ * open for as long as the features exist. The mapping is read only: the
+ * entries must not be modified, e.g. by sorting them.
+ *
+ * Compressed files are decompressed into memory when opened.
+ */
+template <class ST> class CMappedSparseFeatures : public CSparseFeatures<ST>
+{
+public:
+	/** default constructor */
+	CMappedSparseFeatures();
+
+	/** constructor
+	 *
+	 * @param fname name of the dataset file
+	 */
+	CMappedSparseFeatures(const char* fname);
+
+	/** constructor
+	 *
+	 * @param file dataset file opened for reading
+	 */
+	CMappedSparseFeatures(CDatasetFile* file);
+
+	/** copy constructor, shares the mapped file */
+	CMappedSparseFeatures(const CMappedSparseFeatures& orig);
+
+	/** destructor */
+	virtual ~CMappedSparseFeatures();
+
+	/** duplicate feature object
+	 *
+	 * @return feature object sharing the mapped file
+	 */
+	virtual CFeatures* duplicate() const;
+
+	/** @return dataset file of the features */
+	CDatasetFile* get_dataset_file() const;
+
+	/** @return object name */
+	virtual const char* get_name() const { return "MappedSparseFeatures"; }
+
+protected:
+	/** dataset file of the features */
+	CDatasetFile* m_file;
+};
+}
+#endif // _MAPPEDSPARSEFEATURES__H__
@@ -1,18 +1,66 @@
 #include <shogun/lib/common.h>
 #include <shogun/lib/memory.h>
+#include <shogun/base/TaskScheduler.h>
 #include <shogun/features/SparseFeatures.h>
 #include <shogun/preprocessor/SparsePreprocessor.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
 #include <shogun/io/SGIO.h>
 
 #include <string.h>
 #include <stdlib.h>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
 
 namespace shogun
 {
 
 template <class ST> class CSparsePreprocessor;
 
+/** dot product of a vector in CSR storage with a dense vector. Consecutive
+ * entries are added to independent partial sums, so that their gathers
+ * from the dense vector do not wait for each other and can be vectorized.
+ */
+template <class T, class ST>
+static T csr_dense_dot(const index_t* indices, const ST* values, index_t len, const T* vec)
+{
+	T sum[4]={T(0), T(0), T(0), T(0)};
+	index_t k=0;
+	for (; k+4<=len; k+=4)
+	{
+		sum[0]+=vec[indices[k]]*values[k];
+		sum[1]+=vec[indices[k+1]]*values[k+1];
+		sum[2]+=vec[indices[k+2]]*values[k+2];
+		sum[3]+=vec[indices[k+3]]*values[k+3];
+	}
+	for (; k<len; k++)
+		sum[0]+=vec[indices[k]]*values[k];
+
+	return (sum[0]+sum[1])+(sum[2]+sum[3]);
+}
+
+/** dot product of two vectors in CSR storage with sorted feature indices */
+template <class ST>
+static ST csr_sparse_dot(const index_t* a_indices, const ST* a_values, index_t a_len,
+		const index_t* b_indices, const ST* b_values, index_t b_len)
+{
+	ST result=0;
+	index_t i=0;
+	index_t j=0;
+	while (i<a_len && j<b_len)
+	{
+		if (a_indices[i]<b_indices[j])
+			i++;
+		else if (a_indices[i]>b_indices[j])
+			j++;
+		else
+			result+=a_values[i++]*b_values[j++];
+	}
+
+	return result;
+}
+
 template<class ST> CSparseFeatures<ST>::CSparseFeatures(int32_t size)
 : CDotFeatures(size), feature_cache(NULL)
 {
@@ -35,13 +83,26 @@ template<class ST> CSparseFeatures<ST>::CSparseFeatures(SGMatrix<ST> dense)
 	set_full_feature_matrix(dense);
 }
 
+template<class ST> CSparseFeatures<ST>::CSparseFeatures(SGVector<index_t> offsets,
+		SGVector<index_t> indices, SGVector<ST> values, int32_t num_features)
+: CDotFeatures(0), feature_cache(NULL)
+{
+	init();
+
+	set_csr_feature_matrix(offsets, indices, values, num_features);
+}
+
 template<class ST> CSparseFeatures<ST>::CSparseFeatures(const CSparseFeatures & orig)
 : CDotFeatures(orig), sparse_feature_matrix(orig.sparse_feature_matrix),
-	feature_cache(orig.feature_cache)
+	m_csr_offsets(orig.m_csr_offsets), m_csr_indices(orig.m_csr_indices),
+	m_csr_values(orig.m_csr_values), feature_cache(orig.feature_cache)
 {
 	init();
 
-	m_subset_stack=orig.m_subset_stack;
+	// a copy of the subsets, so that subsets of the copy do not change the
+	// original
+	SG_UNREF(m_subset_stack);
+	m_subset_stack=new CSubsetStack(*orig.m_subset_stack);
 	SG_REF(m_subset_stack);
 }
 
@@ -102,6 +163,13 @@ template<class ST> SGVector<ST> CSparseFeatures<ST>::get_full_feature_vector(int
 
 template<class ST> int32_t CSparseFeatures<ST>::get_nnz_features_for_vector(int32_t num) const
 {
+	if (is_csr())
+	{
+		index_t len;
+		csr_vector_start(num, len);
+		return len;
+	}
+
 	SGSparseVector<ST> sv = get_sparse_feature_vector(num);
 	int32_t len=sv.num_feat_entries;
 	free_sparse_feature_vector(num);
@@ -115,7 +183,19 @@ template<class ST> SGSparseVector<ST> CSparseFeatures<ST>::get_sparse_feature_ve
 		num, get_num_vectors()-1);
 	index_t real_num=m_subset_stack->subset_idx_conversion(num);
 
-	if (sparse_feature_matrix.sparse_matrix)
+	if (is_csr())
+	{
+		index_t len;
+		const index_t start=csr_vector_start(num, len);
+		SGSparseVector<ST> result(len);
+		for (index_t i=0; i<len; i++)
+		{
+			result.features[i].feat_index=m_csr_indices[start+i];
+			result.features[i].entry=m_csr_values[start+i];
+		}
+		return result;
+	}
+	else if (sparse_feature_matrix.sparse_matrix)
 	{
 		return sparse_feature_matrix[real_num];
 	}
@@ -170,8 +250,27 @@ template<class ST> SGSparseVector<ST> CSparseFeatures<ST>::get_sparse_feature_ve
 	}
 }
 
+template<class ST> index_t CSparseFeatures<ST>::csr_vector_start(int32_t num, index_t& len) const
+{
+	require(num>=0 && num<get_num_vectors(),
+		"Index {} out of bounds (number of vectors {})", num, get_num_vectors());
+	index_t real_num=m_subset_stack->subset_idx_conversion(num);
+
+	len=m_csr_offsets[real_num+1]-m_csr_offsets[real_num];
+	return m_csr_offsets[real_num];
+}
+
 template<class ST> ST CSparseFeatures<ST>::dense_dot(ST alpha, int32_t num, ST* vec, int32_t dim, ST b) const
 {
+	// feature indices are checked when set, so they need no check against dim
+	if (is_csr() && dim>=get_num_features())
+	{
+		index_t len;
+		const index_t start=csr_vector_start(num, len);
+		return b+alpha*csr_dense_dot<ST, ST>(m_csr_indices.vector+start,
+				m_csr_values.vector+start, len, vec);
+	}
+
 	SGSparseVector<ST> sv=get_sparse_feature_vector(num);
 	ST result = sv.dense_dot(alpha,vec,dim,b);
 	free_sparse_feature_vector(num);
@@ -186,6 +285,26 @@ template<class ST> void CSparseFeatures<ST>::add_to_dense_vec(float64_t alpha, i
 		"add_to_dense_vec(num={},dim={}): dim should contain number of features {}",
 		num, dim, get_num_features());
 
+	if (is_csr())
+	{
+		index_t len;
+		const index_t start=csr_vector_start(num, len);
+		const index_t* indices=m_csr_indices.vector+start;
+		const ST* values=m_csr_values.vector+start;
+
+		if (abs_val)
+		{
+			for (index_t i=0; i<len; i++)
+				vec[indices[i]]+=alpha*CMath::abs(values[i]);
+		}
+		else
+		{
+			for (index_t i=0; i<len; i++)
+				vec[indices[i]]+=alpha*values[i];
+		}
+		return;
+	}
+
 	SGSparseVector<ST> sv=get_sparse_feature_vector(num);
 
 	if (sv.features)
@@ -231,14 +350,159 @@ template<class ST> SGSparseMatrix<ST> CSparseFeatures<ST>::get_sparse_feature_ma
 	if (m_subset_stack->has_subsets())
 		error("Not allowed with subset");
 
+	if (is_csr())
+	{
+		SGSparseMatrix<ST> sm(get_num_features(), get_num_vectors());
+		for (index_t i=0; i<sm.num_vectors; i++)
+			sm[i]=get_sparse_feature_vector(i);
+
+		return sm;
+	}
+
 	return sparse_feature_matrix;
 }
 
+template<class ST> void CSparseFeatures<ST>::set_csr_feature_matrix(SGVector<index_t> offsets,
+		SGVector<index_t> indices, SGVector<ST> values, int32_t num_features)
+{
+	if (m_subset_stack->has_subsets())
+		error("Not allowed with subset");
+
+	require(offsets.vlen>0 && offsets[0]==0,
+		"Offsets should start with 0");
+	const index_t num_vec=offsets.vlen-1;
+	require(indices.vlen==offsets[num_vec] && values.vlen==offsets[num_vec],
+		"Number of feature indices ({}) and values ({}) should be the last offset ({})",
+		indices.vlen, values.vlen, offsets[num_vec]);
+
+	index_t max_index=-1;
+	for (index_t i=0; i<num_vec; i++)
+	{
+		require(offsets[i]<=offsets[i+1] && offsets[i+1]<=offsets[num_vec],
+			"Offsets should be increasing (offset {} is {}, offset {} is {})",
+			i, offsets[i], i+1, offsets[i+1]);
+
+		for (index_t k=offsets[i]; k<offsets[i+1]; k++)
+		{
+			require(indices[k]>=0, "Feature index {} of vector {} is negative",
+				indices[k], i);
+			require(k==offsets[i] || indices[k-1]<indices[k],
+				"Feature indices of vector {} should be sorted (increasing)", i);
+		}
+
+		if (offsets[i]<offsets[i+1])
+			max_index=std::max(max_index, indices[offsets[i+1]-1]);
+	}
+	require(num_features==0 || max_index<num_features,
+		"Feature index {} exceeds the number of features {}", max_index, num_features);
+
+	free_sparse_feature_matrix();
+	m_csr_offsets=offsets;
+	m_csr_indices=indices;
+	m_csr_values=values;
+	sparse_feature_matrix.num_features=num_features>0 ? num_features : max_index+1;
+}
+
+template<class ST> void CSparseFeatures<ST>::convert_to_csr()
+{
+	if (m_subset_stack->has_subsets())
+		error("Not allowed with subset");
+
+	if (is_csr())
+		return;
+
+	// sorting merges duplicate features, so vectors are sorted before
+	// their entries are counted
+	const index_t num_vec=sparse_feature_matrix.num_vectors;
+	std::vector<SGSparseVector<ST>> vectors(num_vec);
+	SGVector<index_t> offsets(num_vec+1);
+	offsets[0]=0;
+	for (index_t i=0; i<num_vec; i++)
+	{
+		vectors[i]=sparse_feature_matrix[i];
+		if (!vectors[i].is_sorted())
+		{
+			vectors[i]=vectors[i].clone();
+			vectors[i].sort_features();
+		}
+		offsets[i+1]=offsets[i]+vectors[i].num_feat_entries;
+	}
+
+	SGVector<index_t> indices(offsets[num_vec]);
+	SGVector<ST> values(offsets[num_vec]);
+	for (index_t i=0; i<num_vec; i++)
+	{
+		for (index_t j=0; j<vectors[i].num_feat_entries; j++)
+		{
+			indices[offsets[i]+j]=vectors[i].features[j].feat_index;
+			values[offsets[i]+j]=vectors[i].features[j].entry;
+		}
+	}
+
+	set_csr_feature_matrix(offsets, indices, values, get_num_features());
+}
+
+template<class ST> void CSparseFeatures<ST>::get_csc_feature_matrix(SGVector<index_t>& offsets,
+		SGVector<index_t>& indices, SGVector<ST>& values) const
+{
+	if (m_subset_stack->has_subsets())
+		error("Not allowed with subset");
+
+	const int32_t num_feat=get_num_features();
+	const int32_t num_vec=get_num_vectors();
+
+	auto for_each_entry=[this](index_t i, auto&& fun)
+	{
+		if (is_csr())
+		{
+			for (index_t k=m_csr_offsets[i]; k<m_csr_offsets[i+1]; k++)
+				fun(m_csr_indices[k], m_csr_values[k]);
+		}
+		else
+		{
+			const SGSparseVector<ST>& sv=sparse_feature_matrix[i];
+			for (index_t j=0; j<sv.num_feat_entries; j++)
+				fun(sv.features[j].feat_index, sv.features[j].entry);
+		}
+	};
+
+	// counting sort of the entries by feature, vectors are visited in
+	// order so the vector indices of every feature are sorted
+	offsets=SGVector<index_t>(num_feat+1);
+	offsets.zero();
+	for (index_t i=0; i<num_vec; i++)
+		for_each_entry(i, [&](index_t j, ST) { offsets[j+1]++; });
+	for (index_t j=0; j<num_feat; j++)
+		offsets[j+1]+=offsets[j];
+
+	indices=SGVector<index_t>(offsets[num_feat]);
+	values=SGVector<ST>(offsets[num_feat]);
+	SGVector<index_t> next=offsets.clone();
+	for (index_t i=0; i<num_vec; i++)
+	{
+		for_each_entry(i, [&](index_t j, ST value)
+		{
+			indices[next[j]]=i;
+			values[next[j]]=value;
+			next[j]++;
+		});
+	}
+}
+
 template<class ST> CSparseFeatures<ST>* CSparseFeatures<ST>::get_transposed()
 {
 	if (m_subset_stack->has_subsets())
 		error("Not allowed with subset");
 
+	if (is_csr())
+	{
+		SGVector<index_t> offsets;
+		SGVector<index_t> indices;
+		SGVector<ST> values;
+		get_csc_feature_matrix(offsets, indices, values);
+		return new CSparseFeatures<ST>(offsets, indices, values, get_num_vectors());
+	}
+
 	return new CSparseFeatures<ST>(sparse_feature_matrix.get_transposed());
 }
 
@@ -247,6 +511,7 @@ template<class ST> void CSparseFeatures<ST>::set_sparse_feature_matrix(SGSparseM
 	if (m_subset_stack->has_subsets())
 		error("Not allowed with subset");
 
+	free_sparse_feature_matrix();
 	sparse_feature_matrix=sm;
 
 	// TODO: check should be implemented in sparse matrix class
@@ -264,10 +529,19 @@ template<class ST> SGMatrix<ST> CSparseFeatures<ST>::get_full_feature_matrix()
 	full.zero();
 
 	io::info("converting sparse features to full feature matrix of {} x {}"
-			" entries", sparse_feature_matrix.num_vectors, get_num_features());
+			" entries", get_num_vectors(), get_num_features());
 
 	for (int32_t v=0; v<full.num_cols; v++)
 	{
+		if (is_csr())
+		{
+			index_t len;
+			const index_t start=csr_vector_start(v, len);
+			for (index_t k=start; k<start+len; k++)
+				full(m_csr_indices[k], v)=m_csr_values[k];
+			continue;
+		}
+
 		int32_t idx=m_subset_stack->subset_idx_conversion(v);
 		SGSparseVector<ST> current=sparse_feature_matrix[idx];
 
@@ -292,6 +566,9 @@ template<class ST> void CSparseFeatures<ST>::free_sparse_features()
 template<class ST> void CSparseFeatures<ST>::free_sparse_feature_matrix()
 {
 	sparse_feature_matrix=SGSparseMatrix<ST>();
+	m_csr_offsets=SGVector<index_t>();
+	m_csr_indices=SGVector<index_t>();
+	m_csr_values=SGVector<ST>();
 }
 
 template<class ST> void CSparseFeatures<ST>::set_full_feature_matrix(SGMatrix<ST> full)
@@ -303,7 +580,10 @@ template<class ST> void CSparseFeatures<ST>::set_full_feature_matrix(SGMatrix<ST
 
 template<class ST> int32_t  CSparseFeatures<ST>::get_num_vectors() const
 {
-	return m_subset_stack->has_subsets() ? m_subset_stack->get_size() : sparse_feature_matrix.num_vectors;
+	if (m_subset_stack->has_subsets())
+		return m_subset_stack->get_size();
+
+	return is_csr() ? m_csr_offsets.vlen-1 : sparse_feature_matrix.num_vectors;
 }
 
 template<class ST> int32_t  CSparseFeatures<ST>::get_num_features() const
@@ -336,6 +616,14 @@ template<class ST> int64_t CSparseFeatures<ST>::get_num_nonzero_entries()
 {
 	int64_t num=0;
 	index_t num_vec=get_num_vectors();
+	if (is_csr())
+	{
+		for (int32_t i=0; i<num_vec; i++)
+			num+=get_nnz_features_for_vector(i);
+
+		return num;
+	}
+
 	for (int32_t i=0; i<num_vec; i++)
 		num+=sparse_feature_matrix[m_subset_stack->subset_idx_conversion(i)].num_feat_entries;
 
@@ -347,6 +635,20 @@ template<class ST> float64_t* CSparseFeatures<ST>::compute_squared(float64_t* sq
 	ASSERT(sq)
 
 	index_t num_vec=get_num_vectors();
+	if (is_csr())
+	{
+		for (int32_t i=0; i<num_vec; i++)
+		{
+			index_t len;
+			const index_t start=csr_vector_start(i, len);
+			sq[i]=0;
+			for (index_t k=start; k<start+len; k++)
+				sq[i]+=m_csr_values[k]*m_csr_values[k];
+		}
+
+		return sq;
+	}
+
 	for (int32_t i=0; i<num_vec; i++)
 	{
 		sq[i]=0;
@@ -440,6 +742,16 @@ template<class ST> float64_t CSparseFeatures<ST>::dot(int32_t vec_idx1,
 	ASSERT(df->get_feature_class() == get_feature_class())
 	CSparseFeatures<ST>* sf = (CSparseFeatures<ST>*) df;
 
+	if (is_csr() && sf->is_csr())
+	{
+		index_t a_len;
+		index_t b_len;
+		const index_t a_start=csr_vector_start(vec_idx1, a_len);
+		const index_t b_start=sf->csr_vector_start(vec_idx2, b_len);
+		return csr_sparse_dot(m_csr_indices.vector+a_start, m_csr_values.vector+a_start, a_len,
+				sf->m_csr_indices.vector+b_start, sf->m_csr_values.vector+b_start, b_len);
+	}
+
 	SGSparseVector<ST> avec=get_sparse_feature_vector(vec_idx1);
 	SGSparseVector<ST> bvec=sf->get_sparse_feature_vector(vec_idx2);
 
@@ -467,6 +779,14 @@ CSparseFeatures<ST>::dot(int32_t vec_idx1, const SGVector<float64_t>& vec2) cons
 		"features {} {}",
 		vec_idx1, vec2.size(), get_num_features());
 
+	if (is_csr())
+	{
+		index_t len;
+		const index_t start=csr_vector_start(vec_idx1, len);
+		return csr_dense_dot<float64_t, ST>(m_csr_indices.vector+start,
+				m_csr_values.vector+start, len, vec2.vector);
+	}
+
 	float64_t result=0;
 	SGSparseVector<ST> sv=get_sparse_feature_vector(vec_idx1);
 
@@ -499,6 +819,56 @@ float64_t CSparseFeatures<complex128_t>::dot(
 	return 0.0;
 }
 
+template<class ST> void CSparseFeatures<ST>::dense_dot_range(float64_t* output,
+		int32_t start, int32_t stop, float64_t* alphas, float64_t* vec,
+		int32_t dim, float64_t b) const
+{
+	const bool in_place_vectors=std::is_same<ST, float64_t>::value
+		&& sparse_feature_matrix.sparse_matrix;
+	if (m_subset_stack->has_subsets() || dim<get_num_features()
+		|| !(is_csr() || in_place_vectors))
+	{
+		CDotFeatures::dense_dot_range(output, start, stop, alphas, vec, dim, b);
+		return;
+	}
+
+	ASSERT(output)
+	ASSERT(start>=0)
+	ASSERT(start<stop)
+	ASSERT(stop<=get_num_vectors())
+
+	SGVector<float64_t> dots(output, stop-start, false);
+	if (is_csr())
+	{
+		parallel_for(start, stop, [&](index_t t_start, index_t t_stop) {
+			for (index_t i=t_start; i<t_stop; i++)
+			{
+				const index_t k=m_csr_offsets[i];
+				dots[i-start]=csr_dense_dot<float64_t, ST>(m_csr_indices.vector+k,
+						m_csr_values.vector+k, m_csr_offsets[i+1]-k, vec);
+			}
+		});
+	}
+	else if constexpr (std::is_same<ST, float64_t>::value)
+	{
+		// feature indices are below the number of features, so the vectors
+		// can be multiplied as if they had dim features
+		SGSparseMatrix<float64_t> vectors(sparse_feature_matrix.sparse_matrix+start,
+				dim, stop-start, false);
+		linalg::matrix_prod(vectors, SGVector<float64_t>(vec, dim, false), dots, true);
+	}
+
+	for (index_t i=0; i<dots.vlen; i++)
+		output[i]=(alphas ? alphas[i] : 1.0)*dots[i]+b;
+}
+
+template<> void CSparseFeatures<complex128_t>::dense_dot_range(float64_t* output,
+		int32_t start, int32_t stop, float64_t* alphas, float64_t* vec,
+		int32_t dim, float64_t b) const
+{
+	not_implemented(SOURCE_LOCATION);;
+}
+
 template<class ST> void* CSparseFeatures<ST>::get_feature_iterator(int32_t vector_index)
 {
 	if (vector_index>=get_num_vectors())
@@ -507,13 +877,26 @@ template<class ST> void* CSparseFeatures<ST>::get_feature_iterator(int32_t vecto
 				"requested {})", get_num_vectors(), vector_index);
 	}
 
-	if (!sparse_feature_matrix.sparse_matrix)
+	if (!sparse_feature_matrix.sparse_matrix && !is_csr())
 		error("Requires a in-memory feature matrix");
 
 	sparse_feature_iterator* it=new sparse_feature_iterator();
-	it->sv=get_sparse_feature_vector(vector_index);
 	it->index=0;
 	it->vector_index=vector_index;
+	it->csr_indices=NULL;
+	it->csr_values=NULL;
+	it->csr_len=0;
+
+	if (is_csr())
+	{
+		index_t len;
+		const index_t start=csr_vector_start(vector_index, len);
+		it->csr_indices=m_csr_indices.vector+start;
+		it->csr_values=m_csr_values.vector+start;
+		it->csr_len=len;
+	}
+	else
+		it->sv=get_sparse_feature_vector(vector_index);
 
 	return it;
 }
@@ -521,6 +904,17 @@ template<class ST> void* CSparseFeatures<ST>::get_feature_iterator(int32_t vecto
 template<class ST> bool CSparseFeatures<ST>::get_next_feature(int32_t& index, float64_t& value, void* iterator)
 {
 	sparse_feature_iterator* it=(sparse_feature_iterator*) iterator;
+	if (it && it->csr_indices)
+	{
+		if (it->index>=it->csr_len)
+			return false;
+
+		int32_t i=it->index++;
+		index=it->csr_indices[i];
+		value=(float64_t) it->csr_values[i];
+		return true;
+	}
+
 	if (!it || it->index>=it->sv.num_feat_entries)
 		return false;
 
@@ -549,6 +943,28 @@ template<class ST> void CSparseFeatures<ST>::free_feature_iterator(void* iterato
 
 template<class ST> CFeatures* CSparseFeatures<ST>::copy_subset(SGVector<index_t> indices) const
 {
+	if (is_csr())
+	{
+		SGVector<index_t> offsets(indices.vlen+1);
+		offsets[0]=0;
+		for (index_t i=0; i<indices.vlen; ++i)
+			offsets[i+1]=offsets[i]+get_nnz_features_for_vector(indices[i]);
+
+		SGVector<index_t> feat_indices(offsets[indices.vlen]);
+		SGVector<ST> values(offsets[indices.vlen]);
+		for (index_t i=0; i<indices.vlen; ++i)
+		{
+			index_t len;
+			const index_t start=csr_vector_start(indices[i], len);
+			std::copy(m_csr_indices.vector+start, m_csr_indices.vector+start+len,
+					feat_indices.vector+offsets[i]);
+			std::copy(m_csr_values.vector+start, m_csr_values.vector+start+len,
+					values.vector+offsets[i]);
+		}
+
+		return new CSparseFeatures<ST>(offsets, feat_indices, values, get_num_features());
+	}
+
 	SGSparseMatrix<ST> matrix_copy=SGSparseMatrix<ST>(get_dim_feature_space(),
 			indices.vlen);
 
@@ -597,6 +1013,10 @@ template<class ST> void CSparseFeatures<ST>::init()
 
 	m_parameters->add(&sparse_feature_matrix.num_features, "sparse_feature_matrix.num_features",
 			"Total number of features.");
+
+	SG_ADD(&m_csr_offsets, "csr_offsets", "Offsets of the vectors in CSR storage.");
+	SG_ADD(&m_csr_indices, "csr_indices", "Feature indices in CSR storage.");
+	SG_ADD(&m_csr_values, "csr_values", "Feature values in CSR storage.");
 }
 
 #define GET_FEATURE_TYPE(sg_type, f_type)									\
@@ -641,7 +1061,7 @@ template<class ST> void CSparseFeatures<ST>::save(CFile* writer)
 	if (m_subset_stack->has_subsets())
 		error("Not allowed with subset");
 	ASSERT(writer)
-	sparse_feature_matrix.save(writer);
+	get_sparse_feature_matrix().save(writer);
 }
 
 template<class ST> void CSparseFeatures<ST>::save_with_labels(CLibSVMFile* writer, SGVector<float64_t> labels)
@@ -649,7 +1069,7 @@ template<class ST> void CSparseFeatures<ST>::save_with_labels(CLibSVMFile* write
 	if (m_subset_stack->has_subsets())
 		error("Not allowed with subset");
 	ASSERT(writer)
-	sparse_feature_matrix.save_with_labels(writer, labels);
+	get_sparse_feature_matrix().save_with_labels(writer, labels);
 }
 
 template class CSparseFeatures<bool>;
@@ -33,6 +33,17 @@ template <class T> class CCache;
  * Features are an array of SGSparseVector. Within each vector feat_index are
  * sorted (increasing).
  *
+ * Alternatively, features can be stored in compressed sparse row (CSR)
+ * format, as three flat arrays: offsets of size num_vectors+1, and the
+ * feature indices and values of all vectors, where vector i has the entries
+ * from offsets[i] to offsets[i+1]-1. The arrays are SGVectors, so buffers of
+ * other libraries (e.g. the indptr, indices and data of a scipy.sparse
+ * matrix) can be used without copying them by wrapping them in SGVectors
+ * without reference counting. See set_csr_feature_matrix() and
+ * convert_to_csr(). In CSR storage, the dot product functions and the
+ * feature iterator work on the flat arrays, and get_sparse_feature_vector()
+ * returns a copy of the vector.
+ *
  * Sparse feature vectors can be accessed via get_sparse_feature_vector() and
  * should be freed (this operation is a NOP in most cases) via
  * free_sparse_feature_vector().
@@ -69,6 +80,17 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		 */
 		CSparseFeatures(SGMatrix<ST> dense);
 
+		/** constructor for features in CSR storage
+		 *
+		 * @param offsets num_vectors+1 offsets of the vectors' entries
+		 * @param indices feature index of every entry
+		 * @param values value of every entry
+		 * @param num_features number of features, 0 to use the largest
+		 * feature index plus one
+		 */
+		CSparseFeatures(SGVector<index_t> offsets, SGVector<index_t> indices,
+				SGVector<ST> values, int32_t num_features=0);
+
 		/** copy constructor */
 		CSparseFeatures(const CSparseFeatures & orig);
 
@@ -189,12 +211,62 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		 *
 		 * not possible with subset
 		 *
-		 * @return sparse matrix
+		 * @return sparse matrix, a copy in CSR storage
 		 *
 		 */
 		SGSparseMatrix<ST> get_sparse_feature_matrix();
 
-		/** get a transposed copy of the features
+		/** set features in CSR storage, which replace any sparse feature
+		 * matrix. The arrays are used as they are, without copying them.
+		 *
+		 * not possible with subset
+		 *
+		 * @param offsets num_vectors+1 offsets of the vectors' entries,
+		 * starting with 0
+		 * @param indices feature index of every entry, sorted (increasing)
+		 * within each vector
+		 * @param values value of every entry
+		 * @param num_features number of features, 0 to use the largest
+		 * feature index plus one
+		 */
+		void set_csr_feature_matrix(SGVector<index_t> offsets,
+				SGVector<index_t> indices, SGVector<ST> values,
+				int32_t num_features=0);
+
+		/** convert the sparse feature matrix to CSR storage
+		 *
+		 * not possible with subset
+		 */
+		void convert_to_csr();
+
+		/** @return whether the features are in CSR storage */
+		bool is_csr() const { return m_csr_offsets.vlen>0; }
+
+		/** @return offsets of the vectors' entries in CSR storage */
+		SGVector<index_t> get_csr_offsets() const { return m_csr_offsets; }
+
+		/** @return feature index of every entry in CSR storage */
+		SGVector<index_t> get_csr_indices() const { return m_csr_indices; }
+
+		/** @return value of every entry in CSR storage */
+		SGVector<ST> get_csr_values() const { return m_csr_values; }
+
+		/** compute the compressed sparse column (CSC) form of the features,
+		 * i.e. the CSR form of their transpose, in which feature j has the
+		 * entries from offsets[j] to offsets[j+1]-1, sorted by vector index.
+		 * Takes time linear in the number of entries.
+		 *
+		 * not possible with subset
+		 *
+		 * @param offsets num_features+1 offsets of the features' entries
+		 * @param indices vector index of every entry
+		 * @param values value of every entry
+		 */
+		void get_csc_feature_matrix(SGVector<index_t>& offsets,
+				SGVector<index_t>& indices, SGVector<ST>& values) const;
+
+		/** get a transposed copy of the features, in CSR storage if the
+		 * features are
 		 *
 		 * not possible with subset
 		 *
@@ -393,6 +465,24 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		virtual float64_t
 		dot(int32_t vec_idx1, const SGVector<float64_t>& vec2) const override;
 
+		/** Compute the dot product for a range of vectors
+		 * alphas[i] * sparse[i]^T * w + b
+		 *
+		 * Vectors in CSR storage, and float64 vectors, are multiplied with
+		 * the dense vector in parallel without per vector calls. Otherwise,
+		 * and with subset, this is the same as in CDotFeatures.
+		 *
+		 * @param output result for the given vector range
+		 * @param start start vector range from this idx
+		 * @param stop stop vector range at this idx
+		 * @param alphas scalars to multiply with, may be NULL
+		 * @param vec dense vector to compute dot product with
+		 * @param dim length of the dense vector
+		 * @param b bias
+		 */
+		virtual void dense_dot_range(float64_t* output, int32_t start, int32_t stop,
+				float64_t* alphas, float64_t* vec, int32_t dim, float64_t b) const;
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 		/** iterator for sparse features */
 		struct sparse_feature_iterator
@@ -406,6 +496,15 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 			/** feature index */
 			int32_t index;
 
+			/** feature indices of the vector in CSR storage, NULL otherwise */
+			const index_t* csr_indices;
+
+			/** feature values of the vector in CSR storage */
+			const ST* csr_values;
+
+			/** number of entries of the vector in CSR storage */
+			int32_t csr_len;
+
 			/** print details of iterator (for debugging purposes)*/
 			void print_info()
 			{
@@ -475,11 +574,30 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 	private:
 		void init();
 
+		/** start of a vector's entries in CSR storage
+		 *
+		 * @param num index of the vector, possibly of subset
+		 * @param len number of entries of the vector, returned by reference
+		 * @return offset of the vector's first entry
+		 */
+		index_t csr_vector_start(int32_t num, index_t& len) const;
+
 	protected:
 
 		/// array of sparse vectors of size num_vectors
 		SGSparseMatrix<ST> sparse_feature_matrix;
 
+		/** offsets of the vectors' entries in CSR storage, empty if the
+		 * features are stored in sparse_feature_matrix
+		 */
+		SGVector<index_t> m_csr_offsets;
+
+		/** feature index of every entry in CSR storage */
+		SGVector<index_t> m_csr_indices;
+
+		/** value of every entry in CSR storage */
+		SGVector<ST> m_csr_values;
+
 		/** feature cache */
 		CCache< SGSparseVectorEntry<ST> >* feature_cache;
 };
@@ -4,11 +4,14 @@
  * Authors: Sergey Lisitsyn
  */
 
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/base/TaskScheduler.h>
 #include <shogun/features/hashed/HashedDocDotFeatures.h>
 #include <shogun/lib/DelimiterTokenizer.h>
 #include <shogun/lib/Hash.h>
 #include <shogun/mathematics/Math.h>
 
+#include <algorithm>
 #include <cmath>
 
 namespace shogun
@@ -30,6 +33,7 @@ CHashedDocDotFeatures::CHashedDocDotFeatures(const CHashedDocDotFeatures& orig)
 {
 	init(orig.num_bits, orig.doc_collection, orig.tokenizer, orig.should_normalize,
 			orig.ngrams, orig.tokens_to_skip);
+	hash_cache = orig.hash_cache;
 }
 
 CHashedDocDotFeatures::CHashedDocDotFeatures(CFile* loader)
@@ -81,6 +85,11 @@ float64_t CHashedDocDotFeatures::dot(int32_t vec_idx1, CDotFeatures* df, int32_t
 	ASSERT(df->get_name() == get_name())
 
 	CHashedDocDotFeatures* hddf = (CHashedDocDotFeatures*) df;
+	if (is_hash_cached() && hddf->is_hash_cached())
+	{
+		return SGSparseVector<float64_t>::sparse_dot(hash_cache[vec_idx1],
+				hddf->hash_cache[vec_idx2]);
+	}
 
 	SGVector<char> sv1 = doc_collection->get_feature_vector(vec_idx1);
 	SGVector<char> sv2 = hddf->doc_collection->get_feature_vector(vec_idx2);
@@ -98,78 +107,42 @@ float64_t CHashedDocDotFeatures::dot(int32_t vec_idx1, CDotFeatures* df, int32_t
 	return result;
 }
 
+void CHashedDocDotFeatures::get_hashed_indices(SGVector<char> doc,
+	std::vector<uint32_t>& indices) const
+{
+	/** the shared tokenizer is not used, so that several threads can hash */
+	CTokenizer* local_tzer = tokenizer->get_copy();
+	SG_REF(local_tzer);
+	CHashedDocConverter::generate_hashed_indices(doc, local_tzer, num_bits, ngrams,
+			tokens_to_skip, indices);
+	SG_UNREF(local_tzer);
+}
+
 float64_t CHashedDocDotFeatures::dot(
 	int32_t vec_idx1, const SGVector<float64_t>& vec2) const
 {
 	ASSERT(vec2.size() == std::pow(2,num_bits))
 
-	SGVector<char> sv = doc_collection->get_feature_vector(vec_idx1);
-
-	/** this vector will maintain the current n+k active tokens
-	 * in a circular manner */
-	SGVector<uint32_t> hashes(ngrams+tokens_to_skip);
-	index_t hashes_start = 0;
-	index_t hashes_end = 0;
-	int32_t len = hashes.vlen - 1;
-
-	/** the combinations generated from the current active tokens will be
-	 * stored here to avoid creating new objects */
-	SGVector<index_t> hashed_indices((ngrams-1)*(tokens_to_skip+1) + 1);
-
-	float64_t result = 0;
-	CTokenizer* local_tzer = tokenizer->get_copy();
-
-	/** Reading n+k-1 tokens */
-	const int32_t seed = 0xdeadbeaf;
-	local_tzer->set_text(sv);
-	index_t start = 0;
-	while (hashes_end<ngrams-1+tokens_to_skip && local_tzer->has_next())
-	{
-		index_t end = local_tzer->next_token_idx(start);
-		uint32_t token_hash = CHash::MurmurHash3((uint8_t* ) &sv.vector[start], end-start, seed);
-		hashes[hashes_end++] = token_hash;
-	}
-
-	/** Reading token and storing indices to hashed_indices */
-	while (local_tzer->has_next())
+	if (is_hash_cached())
 	{
-		index_t end = local_tzer->next_token_idx(start);
-		uint32_t token_hash = CHash::MurmurHash3((uint8_t* ) &sv.vector[start], end-start, seed);
-		hashes[hashes_end] = token_hash;
-
-		CHashedDocConverter::generate_ngram_hashes(hashes, hashes_start, len, hashed_indices,
-				num_bits, ngrams, tokens_to_skip);
-
-		for (index_t i=0; i<hashed_indices.vlen; i++)
-			result += vec2[hashed_indices[i]];
-
-		hashes_start++;
-		hashes_end++;
-		if (hashes_end==hashes.vlen)
-			hashes_end = 0;
-		if (hashes_start==hashes.vlen)
-			hashes_start = 0;
+		const SGSparseVector<float64_t>& hv = hash_cache[vec_idx1];
+		float64_t result = 0;
+		for (index_t i=0; i<hv.num_feat_entries; i++)
+			result += hv.features[i].entry * vec2[hv.features[i].feat_index];
+		return result;
 	}
 
-	if (ngrams>1)
-	{
-		while (hashes_start!=hashes_end)
-		{
-			len--;
-			index_t max_idx = CHashedDocConverter::generate_ngram_hashes(hashes, hashes_start,
-					len, hashed_indices, num_bits, ngrams, tokens_to_skip);
+	SGVector<char> sv = doc_collection->get_feature_vector(vec_idx1);
+	std::vector<uint32_t> hashed_indices;
+	get_hashed_indices(sv, hashed_indices);
 
-			for (index_t i=0; i<max_idx; i++)
-				result += vec2[hashed_indices[i]];
+	float64_t result = 0;
+	for (auto index : hashed_indices)
+		result += vec2[index];
 
-			hashes_start++;
-			if (hashes_start==hashes.vlen)
-				hashes_start = 0;
-		}
-	}
+	const index_t doc_size = sv.size();
 	doc_collection->free_feature_vector(sv, vec_idx1);
-	SG_UNREF(local_tzer);
-	return should_normalize ? result / std::sqrt((float64_t)sv.size()) : result;
+	return should_normalize ? result / std::sqrt((float64_t)doc_size) : result;
 }
 
 void CHashedDocDotFeatures::add_to_dense_vec(float64_t alpha, int32_t vec_idx1,
@@ -180,73 +153,58 @@ void CHashedDocDotFeatures::add_to_dense_vec(float64_t alpha, int32_t vec_idx1,
 	if (abs_val)
 		alpha = CMath::abs(alpha);
 
+	if (is_hash_cached())
+	{
+		const SGSparseVector<float64_t>& hv = hash_cache[vec_idx1];
+		for (index_t i=0; i<hv.num_feat_entries; i++)
+			vec2[hv.features[i].feat_index] += alpha * hv.features[i].entry;
+		return;
+	}
+
 	SGVector<char> sv = doc_collection->get_feature_vector(vec_idx1);
 	const float64_t value =
 		should_normalize ? alpha / std::sqrt((float64_t)sv.size()) : alpha;
 
-	/** this vector will maintain the current n+k active tokens
-	 * in a circular manner */
-	SGVector<uint32_t> hashes(ngrams+tokens_to_skip);
-	index_t hashes_start = 0;
-	index_t hashes_end = 0;
-	index_t len = hashes.vlen - 1;
+	std::vector<uint32_t> hashed_indices;
+	get_hashed_indices(sv, hashed_indices);
+	for (auto index : hashed_indices)
+		vec2[index] += value;
 
-	/** the combinations generated from the current active tokens will be
-	 * stored here to avoid creating new objects */
-	SGVector<index_t> hashed_indices((ngrams-1)*(tokens_to_skip+1) + 1);
-
-	CTokenizer* local_tzer = tokenizer->get_copy();
+	doc_collection->free_feature_vector(sv, vec_idx1);
+}
 
-	/** Reading n+k-1 tokens */
-	const int32_t seed = 0xdeadbeaf;
-	local_tzer->set_text(sv);
-	index_t start = 0;
-	while (hashes_end<ngrams-1+tokens_to_skip && local_tzer->has_next())
-	{
-		index_t end = local_tzer->next_token_idx(start);
-		uint32_t token_hash = CHash::MurmurHash3((uint8_t* ) &sv.vector[start], end-start, seed);
-		hashes[hashes_end++] = token_hash;
-	}
+void CHashedDocDotFeatures::cache_hashes()
+{
+	require(doc_collection, "No document collection set");
 
-	while (local_tzer->has_next())
-	{
-		index_t end = local_tzer->next_token_idx(start);
-		uint32_t token_hash = CHash::MurmurHash3((uint8_t* ) &sv.vector[start], end-start, seed);
-		hashes[hashes_end] = token_hash;
-
-		CHashedDocConverter::generate_ngram_hashes(hashes, hashes_start, len, hashed_indices,
-				num_bits, ngrams, tokens_to_skip);
-
-		for (index_t i=0; i<hashed_indices.vlen; i++)
-			vec2[hashed_indices[i]] += value;
-
-		hashes_start++;
-		hashes_end++;
-		if (hashes_end==hashes.vlen)
-			hashes_end = 0;
-		if (hashes_start==hashes.vlen)
-			hashes_start = 0;
-	}
+	const int32_t num_docs = doc_collection->get_num_vectors();
+	SGSparseMatrix<float64_t> cache(get_dim_feature_space(), num_docs);
 
-	if (ngrams>1)
-	{
-		while (hashes_start!=hashes_end)
+	parallel_for(0, num_docs, [&](index_t start, index_t end) {
+		CHashedDocConverter* converter = new CHashedDocConverter(tokenizer->get_copy(),
+				num_bits, should_normalize, ngrams, tokens_to_skip);
+		SG_REF(converter);
+		for (index_t i=start; i<end; i++)
 		{
-			len--;
-			index_t max_idx = CHashedDocConverter::generate_ngram_hashes(hashes,
-					hashes_start, len, hashed_indices, num_bits, ngrams, tokens_to_skip);
+			SGVector<char> sv = doc_collection->get_feature_vector(i);
+			if (sv.size()>0)
+				cache[i] = converter->apply(sv);
+			doc_collection->free_feature_vector(sv, i);
+		}
+		SG_UNREF(converter);
+	});
 
-			for (index_t i=0; i<max_idx; i++)
-				vec2[hashed_indices[i]] += value;
+	hash_cache = cache;
+}
 
-			hashes_start++;
-			if (hashes_start==hashes.vlen)
-				hashes_start = 0;
-		}
-	}
+void CHashedDocDotFeatures::clear_hash_cache()
+{
+	hash_cache = SGSparseMatrix<float64_t>();
+}
 
-	doc_collection->free_feature_vector(sv, vec_idx1);
-	SG_UNREF(local_tzer);
+bool CHashedDocDotFeatures::is_hash_cached() const
+{
+	return hash_cache.num_vectors > 0;
 }
 
 uint32_t CHashedDocDotFeatures::calculate_token_hash(char* token,
@@ -260,10 +218,14 @@ void CHashedDocDotFeatures::set_doc_collection(CStringFeatures<char>* docs)
 {
 	SG_UNREF(doc_collection);
 	doc_collection = docs;
+	clear_hash_cache();
 }
 
 int32_t CHashedDocDotFeatures::get_nnz_features_for_vector(int32_t num) const
 {
+	if (is_hash_cached())
+		return hash_cache[num].num_feat_entries;
+
 	SGVector<char> sv = doc_collection->get_feature_vector(num);
 	int32_t num_nnz_features = sv.size();
 	doc_collection->free_feature_vector(sv, num);
@@ -30,6 +30,10 @@ class CTokenizer;
  * The latter implements a k-skip n-grams approach, meaning that you can combine up to n tokens, while skipping up to k.
  * Eg. for the tokens ["a", "b", "c", "d"], with n_grams = 2 and skips = 2, one would get the following combinations :
  * ["a", "ab", "ac" (skipped 1), "ad" (skipped 2), "b", "bc", "bd" (skipped 1), "c", "cd", "d"].
+ *
+ * Documents are tokenized and hashed every time they are accessed. Learners that pass
+ * over the collection several times can call cache_hashes() to hash every document only
+ * once and keep its hashed representation in memory instead.
  */
 class CHashedDocDotFeatures: public CDotFeatures
 {
@@ -144,6 +148,19 @@ public:
 	 */
 	void set_doc_collection(CStringFeatures<char>* docs);
 
+	/** hash all documents of the collection in parallel and keep their
+	 * sparse hashed representation, which is used by the dot products
+	 * instead of tokenizing and hashing the documents again.
+	 * The cache is dropped when the document collection is changed.
+	 */
+	void cache_hashes();
+
+	/** drop the hashed representation of the documents */
+	void clear_hash_cache();
+
+	/** @return whether the hashed documents are cached */
+	bool is_hash_cached() const;
+
 	virtual const char* get_name() const;
 
 	/** duplicate feature object
@@ -185,6 +202,13 @@ private:
 	void init(int32_t hash_bits, CStringFeatures<char>* docs, CTokenizer* tzer,
 		bool normalize, int32_t n_grams, int32_t skips);
 
+	/** hashed indices of all the k-skip n-grams of a document
+	 *
+	 * @param doc the document
+	 * @param indices vector to append the indices to
+	 */
+	void get_hashed_indices(SGVector<char> doc, std::vector<uint32_t>& indices) const;
+
 protected:
 	/** the document collection*/
 	CStringFeatures<char>* doc_collection;
@@ -203,6 +227,9 @@ protected:
 
 	/** tokens to skip when combining tokens */
 	int32_t tokens_to_skip;
+
+	/** hashed representation of the documents, empty if not cached */
+	SGSparseMatrix<float64_t> hash_cache;
 };
 }
 
@@ -10,6 +10,9 @@
 #include <shogun/features/streaming/StreamingDenseFeatures.h>
 #include <shogun/io/streaming/StreamingFileFromDenseFeatures.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace shogun
 {
 template<class T>
@@ -146,6 +149,7 @@ template<class T>
 void CStreamingDenseFeatures<T>::set_vector_reader()
 {
 	parser.set_read_vector(&CStreamingFile::get_vector);
+	parser.set_parse_line(&CStreamingFile::parse_line);
 }
 
 template<class T>
@@ -200,6 +204,15 @@ void CStreamingDenseFeatures<T>::init(CStreamingFile* file, bool is_labelled,
 	seekable=false;
 }
 
+template<class T>
+void CStreamingDenseFeatures<T>::set_num_parse_threads(int32_t num_threads, bool ordered,
+		int64_t chunk_size)
+{
+	parser.set_num_parse_threads(num_threads);
+	parser.set_ordered(ordered);
+	parser.set_chunk_size(chunk_size);
+}
+
 template<class T>
 void CStreamingDenseFeatures<T>::start_parser()
 {
@@ -231,6 +244,70 @@ SGVector<T> CStreamingDenseFeatures<T>::get_vector()
 	return current_vector;
 }
 
+template<class T>
+int32_t CStreamingDenseFeatures<T>::get_next_batch(int32_t num)
+{
+	require(num>0, "Number of examples ({}) must be positive", num);
+	num=CMath::min(num, parser.get_ring_size());
+
+	std::vector<Example<T>*> examples(num);
+	int32_t num_fetched=parser.get_next_examples(examples.data(), num);
+	if (!num_fetched)
+	{
+		current_batch=SGMatrix<T>();
+		current_batch_labels=SGVector<float64_t>();
+		return 0;
+	}
+
+	int32_t dim=examples[0]->length;
+	current_batch=SGMatrix<T>(dim, num_fetched);
+	current_batch_labels=has_labels ? SGVector<float64_t>(num_fetched) : SGVector<float64_t>();
+
+	int32_t mismatch=-1;
+	for (int32_t i=0; i<num_fetched; i++)
+	{
+		if (examples[i]->length!=dim)
+		{
+			mismatch=examples[i]->length;
+			break;
+		}
+
+		std::copy(examples[i]->fv, examples[i]->fv+dim, current_batch.get_column_vector(i));
+		if (has_labels)
+			current_batch_labels[i]=examples[i]->label;
+	}
+	parser.finalize_examples(num_fetched);
+
+	require(mismatch<0, "Dimension of streamed vector ({}) does not match "
+			"dimensions of previous vectors ({})", mismatch, dim);
+
+	return num_fetched;
+}
+
+template<class T>
+int32_t CStreamingDenseFeatures<T>::dense_dot_next_batch(float64_t* output,
+		const float32_t* vec, int32_t dim, float64_t b, int32_t num)
+{
+	int32_t num_fetched=get_next_batch(num);
+	if (num_fetched)
+	{
+		require(dim==current_batch.num_rows, "Dimension of vector ({}) does not "
+				"match dimension of streamed vectors ({})", dim, current_batch.num_rows);
+	}
+
+	for (int32_t i=0; i<num_fetched; i++)
+	{
+		const T* x=current_batch.get_column_vector(i);
+		float64_t result=0;
+		for (int32_t j=0; j<dim; j++)
+			result+=x[j]*vec[j];
+
+		output[i]=result+b;
+	}
+
+	return num_fetched;
+}
+
 template<class T>
 float64_t CStreamingDenseFeatures<T>::get_label()
 {
@@ -302,10 +379,13 @@ CFeatures* CStreamingDenseFeatures<T>::get_streamed_features(
 	/* init matrix empty, as we dont know the dimension yet */
 	SGMatrix<T> matrix;
 
-	for (index_t i=0; i<num_elements; ++i)
+	for (index_t i=0; i<num_elements; )
 	{
+		/* fetch as many examples at once as the parser allows */
+		int32_t num_fetched=get_next_batch(num_elements-i);
+
 		/* check if we run out of data */
-		if (!get_next_example())
+		if (!num_fetched)
 		{
 			io::warn("Ran out of streaming data, reallocating matrix and "
 					"returning!");
@@ -320,33 +400,26 @@ CFeatures* CStreamingDenseFeatures<T>::get_streamed_features(
 			matrix=so_far;
 			break;
 		}
-		else
+
+		/* allocate matrix memory in first iteration */
+		if (!matrix.matrix)
 		{
-			/* allocate matrix memory in first iteration */
-			if (!matrix.matrix)
-			{
-				SG_DEBUG("Allocating {}x{} matrix",
-						current_vector.vlen, num_elements);
-				matrix=SGMatrix<T>(current_vector.vlen, num_elements);
-			}
-
-			/* get an example from stream and copy to feature matrix */
-			SGVector<T> vec=get_vector();
-
-			/* check for inconsistent dimensions */
-			require(vec.vlen==matrix.num_rows,
-					"Dimension of streamed vector ({}) does not match "
-					"dimensions of previous vectors ({})",
-					vec.vlen, matrix.num_rows);
-
-			/* copy vector into matrix */
-			sg_memcpy(&matrix.matrix[current_vector.vlen*i], vec.vector,
-					vec.vlen*sizeof(T));
-
-			/* clean up */
-			release_example();
+			SG_DEBUG("Allocating {}x{} matrix",
+					current_batch.num_rows, num_elements);
+			matrix=SGMatrix<T>(current_batch.num_rows, num_elements);
 		}
 
+		/* check for inconsistent dimensions */
+		require(current_batch.num_rows==matrix.num_rows,
+				"Dimension of streamed vector ({}) does not match "
+				"dimensions of previous vectors ({})",
+				current_batch.num_rows, matrix.num_rows);
+
+		/* copy batch into matrix */
+		sg_memcpy(&matrix.matrix[int64_t(matrix.num_rows)*i], current_batch.matrix,
+				int64_t(matrix.num_rows)*num_fetched*sizeof(T));
+
+		i+=num_fetched;
 	}
 
 	/* create new feature object from collected data */
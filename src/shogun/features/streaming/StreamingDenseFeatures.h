@@ -87,6 +87,20 @@ public:
 	 */
 	virtual void set_vector_and_label_reader();
 
+	/**
+	 * Sets the number of threads parsing the input.
+	 *
+	 * Only used if the input file supports parallel parsing,
+	 * which CStreamingAsciiFile does. To be called before
+	 * start_parser().
+	 *
+	 * @param num_threads number of parse threads
+	 * @param ordered whether examples keep the order of the input
+	 * @param chunk_size minimum size of the chunks of the input in bytes
+	 */
+	void set_num_parse_threads(int32_t num_threads, bool ordered=true,
+			int64_t chunk_size=PARSER_DEFAULT_CHUNKSIZE);
+
 	/**
 	 * Starts the parsing thread.
 	 *
@@ -124,6 +138,50 @@ public:
 	 */
 	SGVector<T> get_vector();
 
+	/**
+	 * Instructs the parser to return the next num examples at
+	 * once. They are copied into a matrix, which is returned by
+	 * get_batch(), and released right away, so
+	 * release_example() must not be called for them.
+	 *
+	 * Fetching a batch locks the parser once instead of once
+	 * for every example. Fewer than num examples are returned
+	 * only at the end of the stream.
+	 *
+	 * @param num number of examples, at most the parser's ring size
+	 * is used
+	 * @return number of examples fetched, 0 if there are no more
+	 */
+	int32_t get_next_batch(int32_t num);
+
+	/**
+	 * Return the examples fetched by get_next_batch().
+	 *
+	 * @return num_features x num_examples matrix
+	 */
+	SGMatrix<T> get_batch() const { return current_batch; }
+
+	/**
+	 * Return the labels of the examples fetched by get_next_batch().
+	 *
+	 * @return labels, empty if the examples are unlabelled
+	 */
+	SGVector<float64_t> get_batch_labels() const { return current_batch_labels; }
+
+	/**
+	 * Fetches the next examples in a batch and computes their dot
+	 * products with a dense vector.
+	 *
+	 * @param output dot products plus bias, at least num elements
+	 * @param vec dense vector
+	 * @param dim length of the dense vector
+	 * @param b bias
+	 * @param num number of examples
+	 * @return number of examples, 0 if there are no more
+	 */
+	virtual int32_t dense_dot_next_batch(float64_t* output,
+			const float32_t* vec, int32_t dim, float64_t b, int32_t num);
+
 	/**
 	 * Return the label of the current example as a float.
 	 *
@@ -295,6 +353,12 @@ protected:
 
 	/// The current example's label.
 	float64_t current_label;
+
+	/// The examples fetched by get_next_batch(), one per column
+	SGMatrix<T> current_batch;
+
+	/// The labels of the examples fetched by get_next_batch()
+	SGVector<float64_t> current_batch_labels;
 };
 }
 #endif // _STREAMINGDENSEFEATURES__H__
@@ -46,6 +46,20 @@ void CStreamingDotFeatures::dense_dot_range(float32_t* output, float32_t* alphas
 	end_parser();
 }
 
+int32_t CStreamingDotFeatures::dense_dot_next_batch(float64_t* output,
+		const float32_t* vec, int32_t dim, float64_t b, int32_t num)
+{
+	int32_t counter=0;
+	while (counter<num && get_next_example())
+	{
+		output[counter]=dense_dot(vec, dim)+b;
+		release_example();
+		counter++;
+	}
+
+	return counter;
+}
+
 void CStreamingDotFeatures::expand_if_required(float32_t*& vec, int32_t &len)
 {
 	int32_t dim = get_dim_feature_space();
@@ -110,6 +110,23 @@ public:
 	virtual void dense_dot_range(float32_t* output, float32_t* alphas,
 			float32_t* vec, int32_t dim, float32_t b, int32_t num_vec=0);
 
+	/** Fetch the next examples and compute their dot products with a
+	 * dense vector, output[i] = x_i^T * vec + b.
+	 *
+	 * This implementation fetches the examples one by one. Derived
+	 * classes which can fetch a batch of examples at once override it.
+	 * The parser must already be started.
+	 *
+	 * @param output result for the fetched examples, at least num elements
+	 * @param vec dense vector to compute dot product with
+	 * @param dim length of the dense vector
+	 * @param b bias
+	 * @param num number of examples to fetch
+	 * @return number of examples fetched, 0 if there are no more
+	 */
+	virtual int32_t dense_dot_next_batch(float64_t* output,
+			const float32_t* vec, int32_t dim, float64_t b, int32_t num);
+
 	/** add current vector multiplied with alpha to dense vector, 'vec'
 	 *
 	 * @param alpha scalar alpha
@@ -8,6 +8,8 @@
 #include <shogun/features/streaming/StreamingSparseFeatures.h>
 #include <shogun/mathematics/Math.h>
 
+#include <vector>
+
 namespace shogun
 {
 
@@ -226,6 +228,7 @@ int32_t CStreamingSparseFeatures<T>::get_num_vectors() const
 template <class T> void CStreamingSparseFeatures<T>::set_vector_reader()
 {
 	parser.set_read_vector(&CStreamingFile::get_sparse_vector);
+	parser.set_parse_line(&CStreamingFile::parse_line);
 }
 
 template <class T> void CStreamingSparseFeatures<T>::set_vector_and_label_reader()
@@ -279,6 +282,15 @@ void CStreamingSparseFeatures<T>::init(CStreamingFile* file,
 	parser.set_free_vector_after_release(false);
 }
 
+template <class T>
+void CStreamingSparseFeatures<T>::set_num_parse_threads(int32_t num_threads, bool ordered,
+		int64_t chunk_size)
+{
+	parser.set_num_parse_threads(num_threads);
+	parser.set_ordered(ordered);
+	parser.set_chunk_size(chunk_size);
+}
+
 template <class T>
 void CStreamingSparseFeatures<T>::start_parser()
 {
@@ -323,6 +335,65 @@ SGSparseVector<T> CStreamingSparseFeatures<T>::get_vector()
 	return current_sgvector;
 }
 
+template <class T>
+int32_t CStreamingSparseFeatures<T>::get_next_batch(int32_t num)
+{
+	require(num>0, "Number of examples ({}) must be positive", num);
+	num=CMath::min(num, parser.get_ring_size());
+
+	std::vector<Example<SGSparseVectorEntry<T>>*> examples(num);
+	int32_t num_fetched=parser.get_next_examples(examples.data(), num);
+
+	current_batch_offsets=SGVector<index_t>(num_fetched+1);
+	current_batch_offsets[0]=0;
+	for (int32_t i=0; i<num_fetched; i++)
+		current_batch_offsets[i+1]=current_batch_offsets[i]+examples[i]->length;
+
+	index_t nnz=current_batch_offsets[num_fetched];
+	current_batch_indices=SGVector<index_t>(nnz);
+	current_batch_values=SGVector<T>(nnz);
+	current_batch_labels=has_labels ? SGVector<float64_t>(num_fetched) : SGVector<float64_t>();
+
+	for (int32_t i=0; i<num_fetched; i++)
+	{
+		const SGSparseVectorEntry<T>* entries=examples[i]->fv;
+		index_t offset=current_batch_offsets[i];
+		for (index_t j=0; j<examples[i]->length; j++)
+		{
+			current_batch_indices[offset+j]=entries[j].feat_index;
+			current_batch_values[offset+j]=entries[j].entry;
+			current_num_features=CMath::max(current_num_features, entries[j].feat_index+1);
+		}
+
+		if (has_labels)
+			current_batch_labels[i]=examples[i]->label;
+	}
+	parser.finalize_examples(num_fetched);
+
+	current_vec_index+=num_fetched;
+	return num_fetched;
+}
+
+template <class T>
+int32_t CStreamingSparseFeatures<T>::dense_dot_next_batch(float64_t* output,
+		const float32_t* vec, int32_t dim, float64_t b, int32_t num)
+{
+	int32_t num_fetched=get_next_batch(num);
+	for (int32_t i=0; i<num_fetched; i++)
+	{
+		float64_t result=0;
+		for (index_t j=current_batch_offsets[i]; j<current_batch_offsets[i+1]; j++)
+		{
+			if (current_batch_indices[j]<dim)
+				result+=vec[current_batch_indices[j]]*current_batch_values[j];
+		}
+
+		output[i]=result+b;
+	}
+
+	return num_fetched;
+}
+
 template <class T>
 float64_t CStreamingSparseFeatures<T>::get_label()
 {
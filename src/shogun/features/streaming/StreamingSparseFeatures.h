@@ -95,6 +95,20 @@ public:
 	 */
 	virtual void set_vector_and_label_reader();
 
+	/**
+	 * Sets the number of threads parsing the input.
+	 *
+	 * Only used if the input file supports parallel parsing,
+	 * which CStreamingAsciiFile does. To be called before
+	 * start_parser().
+	 *
+	 * @param num_threads number of parse threads
+	 * @param ordered whether examples keep the order of the input
+	 * @param chunk_size minimum size of the chunks of the input in bytes
+	 */
+	void set_num_parse_threads(int32_t num_threads, bool ordered=true,
+			int64_t chunk_size=PARSER_DEFAULT_CHUNKSIZE);
+
 	/**
 	 * Starts the parsing thread.
 	 *
@@ -134,6 +148,59 @@ public:
 	 */
 	SGSparseVector<T> get_vector();
 
+	/**
+	 * Instructs the parser to return the next num examples at
+	 * once. They are copied into a compressed sparse row block,
+	 * returned by get_batch_offsets(), get_batch_indices() and
+	 * get_batch_values(), and released right away, so
+	 * release_example() must not be called for them.
+	 *
+	 * Fetching a batch locks the parser once instead of once
+	 * for every example. Fewer than num examples are returned
+	 * only at the end of the stream.
+	 *
+	 * @param num number of examples, at most the parser's ring size
+	 * is used
+	 * @return number of examples fetched, 0 if there are no more
+	 */
+	int32_t get_next_batch(int32_t num);
+
+	/**
+	 * Return where the entries of each example of the batch start
+	 * in get_batch_indices() and get_batch_values(). Example i has
+	 * the entries from offsets[i] to offsets[i+1]-1.
+	 *
+	 * @return num_examples+1 offsets
+	 */
+	SGVector<index_t> get_batch_offsets() const { return current_batch_offsets; }
+
+	/** @return feature index of every entry of the batch */
+	SGVector<index_t> get_batch_indices() const { return current_batch_indices; }
+
+	/** @return value of every entry of the batch */
+	SGVector<T> get_batch_values() const { return current_batch_values; }
+
+	/**
+	 * Return the labels of the examples fetched by get_next_batch().
+	 *
+	 * @return labels, empty if the examples are unlabelled
+	 */
+	SGVector<float64_t> get_batch_labels() const { return current_batch_labels; }
+
+	/**
+	 * Fetches the next examples in a batch and computes their dot
+	 * products with a dense vector.
+	 *
+	 * @param output dot products plus bias, at least num elements
+	 * @param vec dense vector
+	 * @param dim length of the dense vector
+	 * @param b bias
+	 * @param num number of examples
+	 * @return number of examples, 0 if there are no more
+	 */
+	virtual int32_t dense_dot_next_batch(float64_t* output,
+			const float32_t* vec, int32_t dim, float64_t b, int32_t num);
+
 	/**
 	 * Return the label of the current example as a float.
 	 *
@@ -350,6 +417,18 @@ protected:
 
 	/// Number of features in current vector (as seen so far upto the current vector)
 	int32_t current_num_features;
+
+	/// Start of the entries of every example fetched by get_next_batch()
+	SGVector<index_t> current_batch_offsets;
+
+	/// Feature indices of the entries fetched by get_next_batch()
+	SGVector<index_t> current_batch_indices;
+
+	/// Values of the entries fetched by get_next_batch()
+	SGVector<T> current_batch_values;
+
+	/// The labels of the examples fetched by get_next_batch()
+	SGVector<float64_t> current_batch_labels;
 };
 
 }
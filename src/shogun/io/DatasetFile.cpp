@@ -0,0 +1,613 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/features/streaming/StreamingDenseFeatures.h>
+#include <shogun/features/streaming/StreamingSparseFeatures.h>
+#include <shogun/io/DatasetFile.h>
+#include <shogun/io/ShogunErrc.h>
+#include <shogun/io/streaming/StreamingAsciiFile.h>
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+using namespace shogun;
+
+/** file magic, stored at the start and in the header */
+static const char dataset_magic[8]="SGDATA";
+static const uint32_t dataset_version=1;
+
+/** the chunks start after the magic, at the first cache line */
+static const int64_t dataset_data_offset=64;
+
+/** alignment of sparse chunks and of the labels */
+static const int64_t dataset_alignment=16;
+
+template <class T>
+static EPrimitiveType dataset_ptype()
+{
+	if constexpr (std::is_same_v<T, bool>)
+		return PT_BOOL;
+	else if constexpr (std::is_same_v<T, char>)
+		return PT_CHAR;
+	else if constexpr (std::is_same_v<T, int8_t>)
+		return PT_INT8;
+	else if constexpr (std::is_same_v<T, uint8_t>)
+		return PT_UINT8;
+	else if constexpr (std::is_same_v<T, int16_t>)
+		return PT_INT16;
+	else if constexpr (std::is_same_v<T, uint16_t>)
+		return PT_UINT16;
+	else if constexpr (std::is_same_v<T, int32_t>)
+		return PT_INT32;
+	else if constexpr (std::is_same_v<T, uint32_t>)
+		return PT_UINT32;
+	else if constexpr (std::is_same_v<T, int64_t>)
+		return PT_INT64;
+	else if constexpr (std::is_same_v<T, uint64_t>)
+		return PT_UINT64;
+	else if constexpr (std::is_same_v<T, float32_t>)
+		return PT_FLOAT32;
+	else if constexpr (std::is_same_v<T, float64_t>)
+		return PT_FLOAT64;
+	else
+		return PT_FLOATMAX;
+}
+
+/** @return offset of the entries of a sparse chunk of n vectors */
+static int64_t sparse_entries_offset(int64_t n)
+{
+	int64_t size=(n+1)*sizeof(int64_t);
+	return (size+dataset_alignment-1)/dataset_alignment*dataset_alignment;
+}
+
+CDatasetFile::CDatasetFile() : CSGObject()
+{
+	init();
+}
+
+CDatasetFile::CDatasetFile(const char* fname, char rw,
+		E_COMPRESSION_TYPE compression, index_t chunk_size) : CSGObject()
+{
+	init();
+	require(fname, "No file name given");
+	require(rw=='r' || rw=='w', "Only 'r' and 'w' flags are allowed");
+
+	if (rw=='w')
+	{
+		require(chunk_size>0, "Chunk size ({}) should be positive", chunk_size);
+
+		std::error_condition ec;
+		if ((ec=env()->new_writable_file(fname, &m_writer)))
+			throw io::to_system_error(ec);
+
+		m_chunk_size=chunk_size;
+		m_header.compression=compression;
+		m_compressor=new CCompressor(compression);
+		SG_REF(m_compressor);
+
+		append(dataset_magic, sizeof(dataset_magic));
+		pad(dataset_data_offset);
+		return;
+	}
+
+	m_file=new CMemoryMappedFile<char>(fname, 'r');
+	SG_REF(m_file);
+
+	const int64_t size=m_file->get_size();
+	const char* map=m_file->get_map();
+	require(size>=dataset_data_offset+int64_t(sizeof(DatasetFileHeader))
+		&& !std::memcmp(map, dataset_magic, sizeof(dataset_magic)),
+		"{} is not a dataset file", fname);
+
+	std::memcpy(&m_header, map+size-sizeof(DatasetFileHeader), sizeof(DatasetFileHeader));
+	require(!std::memcmp(m_header.magic, dataset_magic, sizeof(dataset_magic)),
+		"{} is incomplete, it was not closed after writing", fname);
+	require(m_header.version==dataset_version,
+		"Version {} of {} is not supported", m_header.version, fname);
+	require(m_header.ptype<=PT_FLOATMAX, "Unknown type {} in {}", m_header.ptype, fname);
+
+	const int64_t table_end=m_header.chunks_offset+m_header.num_chunks*int64_t(sizeof(DatasetFileChunk));
+	require(m_header.num_chunks>=0 && m_header.chunks_offset>=dataset_data_offset
+		&& table_end<=size-int64_t(sizeof(DatasetFileHeader)),
+		"Chunk table of {} is out of bounds", fname);
+
+	m_chunks.resize(m_header.num_chunks);
+	std::memcpy(m_chunks.data(), map+m_header.chunks_offset, m_chunks.size()*sizeof(DatasetFileChunk));
+
+	int64_t num_vectors=0;
+	for (const auto& chunk : m_chunks)
+	{
+		require(chunk.first_vector==num_vectors && chunk.num_vectors>=0
+			&& chunk.offset>=dataset_data_offset && chunk.size>=0
+			&& chunk.offset+chunk.size<=m_header.chunks_offset,
+			"Chunk of {} is out of bounds", fname);
+		num_vectors+=chunk.num_vectors;
+	}
+	require(num_vectors==m_header.num_vectors,
+		"{} has {} vectors in its chunks, but {} in its header",
+		fname, num_vectors, m_header.num_vectors);
+
+	if (m_header.labels_offset)
+	{
+		require(m_header.labels_offset>=dataset_data_offset
+			&& m_header.labels_offset+num_vectors*int64_t(sizeof(float64_t))<=m_header.chunks_offset,
+			"Labels of {} are out of bounds", fname);
+		m_mapped_labels=(const float64_t*) (map+m_header.labels_offset);
+	}
+
+	m_compressor=new CCompressor((E_COMPRESSION_TYPE) m_header.compression);
+	SG_REF(m_compressor);
+}
+
+CDatasetFile::~CDatasetFile()
+{
+	if (m_writer)
+	{
+		try
+		{
+			close();
+		}
+		catch (const std::exception& e)
+		{
+			io::warn("Failed to close dataset file: {}", e.what());
+		}
+	}
+
+	SG_UNREF(m_compressor);
+	SG_UNREF(m_file);
+}
+
+void CDatasetFile::init()
+{
+	m_file=NULL;
+	m_mapped_labels=NULL;
+	m_write_offset=0;
+	m_chunk_size=0;
+	m_compressor=NULL;
+
+	std::memset(&m_header, 0, sizeof(m_header));
+	std::memcpy(m_header.magic, dataset_magic, sizeof(dataset_magic));
+	m_header.version=dataset_version;
+}
+
+void CDatasetFile::append(const void* data, int64_t size)
+{
+	if (!size)
+		return;
+
+	std::error_condition ec;
+	if ((ec=m_writer->append(std::string_view((const char*) data, size))))
+		throw io::to_system_error(ec);
+	m_write_offset+=size;
+}
+
+void CDatasetFile::pad(int64_t alignment)
+{
+	static const char zeros[dataset_data_offset]={0};
+	int64_t remainder=m_write_offset%alignment;
+	if (remainder)
+		append(zeros, alignment-remainder);
+}
+
+void CDatasetFile::check_write(EPrimitiveType ptype, bool sparse, index_t num_vectors,
+		const SGVector<float64_t>& labels)
+{
+	require(m_writer, "File is not opened for writing");
+	if (m_header.num_vectors)
+	{
+		require(m_header.ptype==uint32_t(ptype) && m_header.sparse==uint32_t(sparse),
+			"Vectors of type {} cannot be appended to {} vectors of type {}",
+			ptype_name(ptype), m_header.sparse ? "sparse" : "dense",
+			ptype_name((EPrimitiveType) m_header.ptype));
+		require((labels.vlen>0)==!m_labels.empty(),
+			"Either all or no vectors should be labelled");
+	}
+	else
+	{
+		m_header.ptype=ptype;
+		m_header.sparse=sparse;
+	}
+
+	require(!labels.vlen || labels.vlen==num_vectors,
+		"Number of labels ({}) should be the number of vectors ({})", labels.vlen, num_vectors);
+}
+
+void CDatasetFile::write_chunk(const char* data, int64_t size, int64_t num_vectors,
+		int64_t nnz, int64_t alignment)
+{
+	DatasetFileChunk chunk;
+	chunk.first_vector=m_header.num_vectors;
+	chunk.num_vectors=num_vectors;
+	chunk.nnz=nnz;
+	chunk.uncompressed_size=size;
+
+	uint8_t* compressed=NULL;
+	uint64_t compressed_size=size;
+	if (m_header.compression!=UNCOMPRESSED && size)
+		m_compressor->compress((uint8_t*) data, size, compressed, compressed_size);
+
+	// chunks that do not shrink are stored as they are, so they can be mapped
+	if (compressed && int64_t(compressed_size)<size)
+	{
+		chunk.offset=m_write_offset;
+		chunk.size=compressed_size;
+		append(compressed, compressed_size);
+	}
+	else
+	{
+		pad(alignment);
+		chunk.offset=m_write_offset;
+		chunk.size=size;
+		append(data, size);
+	}
+	SG_FREE(compressed);
+
+	m_chunks.push_back(chunk);
+	m_header.num_vectors+=num_vectors;
+	m_header.num_chunks=m_chunks.size();
+}
+
+template <class T>
+void CDatasetFile::write_dense(SGMatrix<T> vectors, SGVector<float64_t> labels)
+{
+	check_write(dataset_ptype<T>(), false, vectors.num_cols, labels);
+	if (m_header.num_vectors)
+	{
+		require(m_header.num_features==vectors.num_rows, "Dimension of the vectors ({}) "
+			"should be the dimension of the file ({})", vectors.num_rows, m_header.num_features);
+	}
+	m_header.num_features=vectors.num_rows;
+
+	for (index_t start=0; start<vectors.num_cols; start+=m_chunk_size)
+	{
+		const index_t n=std::min(m_chunk_size, vectors.num_cols-start);
+		write_chunk((const char*) (vectors.matrix+int64_t(start)*vectors.num_rows),
+			int64_t(n)*vectors.num_rows*sizeof(T), n, 0, sizeof(T));
+	}
+	m_labels.insert(m_labels.end(), labels.vector, labels.vector+labels.vlen);
+}
+
+template <class T>
+void CDatasetFile::write_sparse(SGSparseMatrix<T> vectors, SGVector<float64_t> labels)
+{
+	SGVector<index_t> offsets(vectors.num_vectors+1);
+	offsets[0]=0;
+	for (index_t i=0; i<vectors.num_vectors; ++i)
+		offsets[i+1]=offsets[i]+vectors[i].num_feat_entries;
+
+	SGVector<index_t> indices(offsets[vectors.num_vectors]);
+	SGVector<T> values(offsets[vectors.num_vectors]);
+	for (index_t i=0; i<vectors.num_vectors; ++i)
+	{
+		for (index_t j=0; j<vectors[i].num_feat_entries; ++j)
+		{
+			indices[offsets[i]+j]=vectors[i].features[j].feat_index;
+			values[offsets[i]+j]=vectors[i].features[j].entry;
+		}
+	}
+
+	write_sparse(offsets, indices, values, labels);
+	m_header.num_features=std::max(m_header.num_features, int64_t(vectors.num_features));
+}
+
+template <class T>
+void CDatasetFile::write_sparse(SGVector<index_t> offsets, SGVector<index_t> indices,
+		SGVector<T> values, SGVector<float64_t> labels)
+{
+	require(offsets.vlen>0, "Offsets should end with the number of entries");
+	const index_t num_vectors=offsets.vlen-1;
+	check_write(dataset_ptype<T>(), true, num_vectors, labels);
+	require(indices.vlen==values.vlen && offsets[num_vectors]<=indices.vlen,
+		"Number of indices ({}) and values ({}) should cover {} entries",
+		indices.vlen, values.vlen, offsets[num_vectors]);
+
+	std::vector<char> buffer;
+	for (index_t start=0; start<num_vectors; start+=m_chunk_size)
+	{
+		const index_t n=std::min(m_chunk_size, num_vectors-start);
+		const int64_t nnz=offsets[start+n]-offsets[start];
+		const int64_t entries_offset=sparse_entries_offset(n);
+		buffer.assign(entries_offset+nnz*sizeof(SGSparseVectorEntry<T>), 0);
+
+		int64_t* chunk_offsets=(int64_t*) buffer.data();
+		for (index_t i=0; i<=n; ++i)
+			chunk_offsets[i]=offsets[start+i]-offsets[start];
+
+		SGSparseVectorEntry<T>* entries=(SGSparseVectorEntry<T>*) (buffer.data()+entries_offset);
+		for (int64_t k=0; k<nnz; ++k)
+		{
+			const index_t feat_index=indices[offsets[start]+k];
+			entries[k].feat_index=feat_index;
+			entries[k].entry=values[offsets[start]+k];
+			m_header.num_features=std::max(m_header.num_features, int64_t(feat_index)+1);
+		}
+
+		write_chunk(buffer.data(), buffer.size(), n, nnz, dataset_alignment);
+	}
+	m_labels.insert(m_labels.end(), labels.vector, labels.vector+labels.vlen);
+}
+
+void CDatasetFile::close()
+{
+	require(m_writer, "File is not opened for writing");
+
+	if (!m_labels.empty())
+	{
+		pad(dataset_alignment);
+		m_header.labels_offset=m_write_offset;
+		append(m_labels.data(), m_labels.size()*sizeof(float64_t));
+	}
+
+	pad(sizeof(int64_t));
+	m_header.chunks_offset=m_write_offset;
+	append(m_chunks.data(), m_chunks.size()*sizeof(DatasetFileChunk));
+	append(&m_header, sizeof(m_header));
+
+	std::error_condition ec;
+	if ((ec=m_writer->close()))
+		throw io::to_system_error(ec);
+	m_writer.reset();
+}
+
+bool CDatasetFile::is_sparse() const
+{
+	return m_header.sparse;
+}
+
+EPrimitiveType CDatasetFile::get_primitive_type() const
+{
+	return (EPrimitiveType) m_header.ptype;
+}
+
+E_COMPRESSION_TYPE CDatasetFile::get_compression() const
+{
+	return (E_COMPRESSION_TYPE) m_header.compression;
+}
+
+int64_t CDatasetFile::get_num_features() const
+{
+	return m_header.num_features;
+}
+
+int64_t CDatasetFile::get_num_vectors() const
+{
+	return m_header.num_vectors;
+}
+
+int64_t CDatasetFile::get_num_chunks() const
+{
+	return m_header.num_chunks;
+}
+
+int64_t CDatasetFile::get_chunk_first_vector(int64_t chunk) const
+{
+	require(chunk>=0 && chunk<m_header.num_chunks, "Chunk {} out of bounds", chunk);
+	return m_chunks[chunk].first_vector;
+}
+
+int64_t CDatasetFile::get_chunk_num_vectors(int64_t chunk) const
+{
+	require(chunk>=0 && chunk<m_header.num_chunks, "Chunk {} out of bounds", chunk);
+	return m_chunks[chunk].num_vectors;
+}
+
+bool CDatasetFile::has_labels() const
+{
+	return m_header.labels_offset!=0;
+}
+
+SGVector<float64_t> CDatasetFile::get_labels() const
+{
+	require(m_file, "File is not opened for reading");
+	require(has_labels(), "File has no labels");
+
+	SGVector<float64_t> labels(m_header.num_vectors);
+	sg_memcpy(labels.vector, m_mapped_labels, labels.vlen*sizeof(float64_t));
+	return labels;
+}
+
+void CDatasetFile::check_read(EPrimitiveType ptype, bool sparse) const
+{
+	require(m_file, "File is not opened for reading");
+	require(m_header.sparse==uint32_t(sparse), "File holds {} vectors",
+		m_header.sparse ? "sparse" : "dense");
+	require(m_header.ptype==uint32_t(ptype), "File holds vectors of type {}, not {}",
+		ptype_name((EPrimitiveType) m_header.ptype), ptype_name(ptype));
+}
+
+const char* CDatasetFile::chunk_data(int64_t chunk, std::vector<char>& buffer) const
+{
+	const DatasetFileChunk& c=m_chunks[chunk];
+	const char* data=m_file->get_map()+c.offset;
+	if (c.size==c.uncompressed_size)
+		return data;
+
+	buffer.resize(c.uncompressed_size);
+	uint64_t size=c.uncompressed_size;
+	m_compressor->decompress((uint8_t*) data, c.size, (uint8_t*) buffer.data(), size);
+	require(int64_t(size)==c.uncompressed_size, "Chunk {} is corrupt", chunk);
+	return buffer.data();
+}
+
+template <class T>
+SGMatrix<T> CDatasetFile::get_dense_chunk(int64_t chunk) const
+{
+	check_read(dataset_ptype<T>(), false);
+	require(chunk>=0 && chunk<m_header.num_chunks, "Chunk {} out of bounds", chunk);
+
+	const DatasetFileChunk& c=m_chunks[chunk];
+	require(c.uncompressed_size==c.num_vectors*m_header.num_features*int64_t(sizeof(T)),
+		"Chunk {} is corrupt", chunk);
+
+	if (c.size==c.uncompressed_size)
+		return SGMatrix<T>((T*) (m_file->get_map()+c.offset), m_header.num_features, c.num_vectors, false);
+
+	std::vector<char> buffer;
+	SGMatrix<T> mat(m_header.num_features, c.num_vectors);
+	sg_memcpy(mat.matrix, chunk_data(chunk, buffer), c.uncompressed_size);
+	return mat;
+}
+
+template <class T>
+SGMatrix<T> CDatasetFile::read_dense_chunk(int64_t chunk, const io::RandomAccessFile* file) const
+{
+	check_read(dataset_ptype<T>(), false);
+	require(file, "No file given");
+	require(chunk>=0 && chunk<m_header.num_chunks, "Chunk {} out of bounds", chunk);
+
+	const DatasetFileChunk& c=m_chunks[chunk];
+	require(c.uncompressed_size==c.num_vectors*m_header.num_features*int64_t(sizeof(T)),
+		"Chunk {} is corrupt", chunk);
+
+	SGMatrix<T> mat(m_header.num_features, c.num_vectors);
+	const bool compressed=c.size!=c.uncompressed_size;
+	std::vector<char> buffer(compressed ? c.size : 0);
+	char* scratch=compressed ? buffer.data() : (char*) mat.matrix;
+
+	std::string_view result;
+	std::error_condition ec;
+	if ((ec=file->read(c.offset, c.size, &result, scratch)))
+		throw io::to_system_error(ec);
+
+	if (compressed)
+	{
+		uint64_t size=c.uncompressed_size;
+		m_compressor->decompress((uint8_t*) buffer.data(), c.size, (uint8_t*) mat.matrix, size);
+		require(int64_t(size)==c.uncompressed_size, "Chunk {} is corrupt", chunk);
+	}
+	return mat;
+}
+
+template <class T>
+SGMatrix<T> CDatasetFile::get_matrix() const
+{
+	check_read(dataset_ptype<T>(), false);
+	const int64_t bytes_per_vector=m_header.num_features*sizeof(T);
+
+	// stored chunks are adjacent, so the mapped data is the whole matrix
+	bool contiguous=true;
+	for (const auto& c : m_chunks)
+	{
+		if (c.size!=c.uncompressed_size || c.size!=c.num_vectors*bytes_per_vector
+			|| c.offset!=m_chunks[0].offset+c.first_vector*bytes_per_vector)
+			contiguous=false;
+	}
+
+	if (contiguous)
+	{
+		T* data=m_chunks.empty() ? NULL : (T*) (m_file->get_map()+m_chunks[0].offset);
+		return SGMatrix<T>(data, m_header.num_features, m_header.num_vectors, false);
+	}
+
+	SGMatrix<T> mat(m_header.num_features, m_header.num_vectors);
+	std::vector<char> buffer;
+	for (int64_t i=0; i<m_header.num_chunks; ++i)
+	{
+		const DatasetFileChunk& c=m_chunks[i];
+		require(c.uncompressed_size==c.num_vectors*bytes_per_vector, "Chunk {} is corrupt", i);
+		sg_memcpy(mat.matrix+c.first_vector*m_header.num_features,
+			chunk_data(i, buffer), c.uncompressed_size);
+	}
+	return mat;
+}
+
+template <class T>
+SGSparseMatrix<T> CDatasetFile::get_sparse_matrix() const
+{
+	check_read(dataset_ptype<T>(), true);
+
+	SGSparseMatrix<T> mat(m_header.num_features, m_header.num_vectors);
+	std::vector<char> buffer;
+	for (int64_t i=0; i<m_header.num_chunks; ++i)
+	{
+		const DatasetFileChunk& c=m_chunks[i];
+		const int64_t entries_offset=sparse_entries_offset(c.num_vectors);
+		require(c.uncompressed_size==entries_offset+c.nnz*int64_t(sizeof(SGSparseVectorEntry<T>)),
+			"Chunk {} is corrupt", i);
+
+		const char* data=chunk_data(i, buffer);
+		const bool mapped=c.size==c.uncompressed_size;
+		const int64_t* offsets=(const int64_t*) data;
+		SGSparseVectorEntry<T>* entries=(SGSparseVectorEntry<T>*) (data+entries_offset);
+
+		for (int64_t j=0; j<c.num_vectors; ++j)
+		{
+			const int64_t start=offsets[j];
+			const int64_t len=offsets[j+1]-start;
+			require(start>=0 && len>=0 && start+len<=c.nnz, "Chunk {} is corrupt", i);
+
+			if (mapped)
+				mat[c.first_vector+j]=SGSparseVector<T>(entries+start, len, false);
+			else
+			{
+				mat[c.first_vector+j]=SGSparseVector<T>(len);
+				sg_memcpy(mat[c.first_vector+j].features, entries+start, len*sizeof(SGSparseVectorEntry<T>));
+			}
+		}
+	}
+	return mat;
+}
+
+void CDatasetFile::convert_csv(const char* csv_fname, const char* fname,
+		bool labelled, char delimiter, E_COMPRESSION_TYPE compression, index_t chunk_size)
+{
+	auto input=some<CStreamingAsciiFile>(csv_fname);
+	input->set_delimiter(delimiter);
+	auto stream=some<CStreamingDenseFeatures<float64_t>>(input, labelled, chunk_size);
+	auto output=some<CDatasetFile>(fname, 'w', compression, chunk_size);
+
+	// every batch of the parser is written as a chunk
+	stream->start_parser();
+	while (stream->get_next_batch(chunk_size))
+	{
+		output->write_dense(stream->get_batch(),
+			labelled ? stream->get_batch_labels() : SGVector<float64_t>());
+	}
+	stream->end_parser();
+	output->close();
+}
+
+void CDatasetFile::convert_libsvm(const char* libsvm_fname, const char* fname,
+		E_COMPRESSION_TYPE compression, index_t chunk_size)
+{
+	auto input=some<CStreamingAsciiFile>(libsvm_fname);
+	auto stream=some<CStreamingSparseFeatures<float64_t>>(input, true, chunk_size);
+	auto output=some<CDatasetFile>(fname, 'w', compression, chunk_size);
+
+	stream->start_parser();
+	while (stream->get_next_batch(chunk_size))
+	{
+		output->write_sparse(stream->get_batch_offsets(), stream->get_batch_indices(),
+			stream->get_batch_values(), stream->get_batch_labels());
+	}
+	stream->end_parser();
+	output->close();
+}
+
+#define INSTANTIATE(T) \
+template void CDatasetFile::write_dense<T>(SGMatrix<T>, SGVector<float64_t>); \
+template void CDatasetFile::write_sparse<T>(SGSparseMatrix<T>, SGVector<float64_t>); \
+template void CDatasetFile::write_sparse<T>(SGVector<index_t>, SGVector<index_t>, \
+		SGVector<T>, SGVector<float64_t>); \
+template SGMatrix<T> CDatasetFile::get_matrix<T>() const; \
+template SGMatrix<T> CDatasetFile::get_dense_chunk<T>(int64_t) const; \
+template SGMatrix<T> CDatasetFile::read_dense_chunk<T>(int64_t, const io::RandomAccessFile*) const; \
+template SGSparseMatrix<T> CDatasetFile::get_sparse_matrix<T>() const;
+
+INSTANTIATE(bool)
+INSTANTIATE(char)
+INSTANTIATE(int8_t)
+INSTANTIATE(uint8_t)
+INSTANTIATE(int16_t)
+INSTANTIATE(uint16_t)
+INSTANTIATE(int32_t)
+INSTANTIATE(uint32_t)
+INSTANTIATE(int64_t)
+INSTANTIATE(uint64_t)
+INSTANTIATE(float32_t)
+INSTANTIATE(float64_t)
+INSTANTIATE(floatmax_t)
+#undef INSTANTIATE
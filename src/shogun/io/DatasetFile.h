@@ -0,0 +1,330 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef __DATASETFILE_H__
+#define __DATASETFILE_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/base/SGObject.h>
+#include <shogun/io/MemoryMappedFile.h>
+#include <shogun/io/fs/FileSystem.h>
+#include <shogun/lib/Compressor.h>
+#include <shogun/lib/DataType.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGSparseMatrix.h>
+#include <shogun/lib/SGVector.h>
+
+#include <memory>
+#include <vector>
+
+namespace shogun
+{
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/** header of a dataset file, stored at the end of the file */
+struct DatasetFileHeader
+{
+	/** file magic "SGDATA" */
+	char magic[8];
+	/** version of the format */
+	uint32_t version;
+	/** type of the values, EPrimitiveType */
+	uint32_t ptype;
+	/** whether the chunks are compressed sparse row blocks */
+	uint32_t sparse;
+	/** compression of the chunks, E_COMPRESSION_TYPE */
+	uint32_t compression;
+	/** dimension of the vectors */
+	int64_t num_features;
+	/** number of vectors */
+	int64_t num_vectors;
+	/** number of chunks */
+	int64_t num_chunks;
+	/** byte offset of the chunk table */
+	int64_t chunks_offset;
+	/** byte offset of the labels, 0 if unlabelled */
+	int64_t labels_offset;
+};
+
+/** entry of the chunk table of a dataset file */
+struct DatasetFileChunk
+{
+	/** index of the first vector of the chunk */
+	int64_t first_vector;
+	/** number of vectors */
+	int64_t num_vectors;
+	/** number of non-zero entries of a sparse chunk */
+	int64_t nnz;
+	/** byte offset of the chunk */
+	int64_t offset;
+	/** stored size of the chunk in bytes */
+	int64_t size;
+	/** size of the chunk in bytes after decompression */
+	int64_t uncompressed_size;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/** @brief Native binary dataset file, which is memory mapped for reading.
+ *
+ * The vectors are stored in chunks of up to a fixed number of vectors,
+ * each of which may be compressed with CCompressor. A dense chunk holds
+ * the vectors one after the other, in the column major layout of
+ * SGMatrix. A sparse chunk is a compressed sparse row block: the start of
+ * the entries of every vector, followed by the SGSparseVectorEntry array of
+ * all vectors. The labels, the table of chunks and the header follow the
+ * chunks, so files are written in one pass through io/fs.
+ *
+ * Uncompressed chunks are used where they are mapped: get_matrix() and
+ * get_sparse_matrix() then borrow the mapped memory without copying, and
+ * pages are only read when the vectors are accessed. Compressed chunks
+ * are decompressed on access.
+ *
+ * Files are written by opening them with 'w' and calling write_dense() or
+ * write_sparse() as often as needed; the file is complete after close().
+ * convert_csv() and convert_libsvm() convert text files chunk by chunk.
+ *
+ * The file uses the byte order of the machine that wrote it.
+ */
+class CDatasetFile : public CSGObject
+{
+public:
+	/** default constructor */
+	CDatasetFile();
+
+	/** constructor
+	 *
+	 * @param fname name of the file
+	 * @param rw 'r' to map the file for reading, 'w' to write it
+	 * @param compression compression of the chunks when writing
+	 * @param chunk_size maximum number of vectors of a chunk when writing
+	 */
+	CDatasetFile(const char* fname, char rw='r',
+		E_COMPRESSION_TYPE compression=UNCOMPRESSED, index_t chunk_size=65536);
+
+	/** destructor, closes the file if it is written; errors are only
+	 * logged, call close() to handle them
+	 */
+	virtual ~CDatasetFile();
+
+	/** get name
+	 * @return DatasetFile
+	 */
+	virtual const char* get_name() const { return "DatasetFile"; }
+
+	/** append dense vectors to a file opened for writing
+	 *
+	 * @param vectors num_features x num_vectors matrix
+	 * @param labels label of every vector, empty if unlabelled
+	 */
+	template <class T>
+	void write_dense(SGMatrix<T> vectors, SGVector<float64_t> labels=SGVector<float64_t>());
+
+	/** append sparse vectors to a file opened for writing
+	 *
+	 * @param vectors sparse vectors
+	 * @param labels label of every vector, empty if unlabelled
+	 */
+	template <class T>
+	void write_sparse(SGSparseMatrix<T> vectors, SGVector<float64_t> labels=SGVector<float64_t>());
+
+	/** append sparse vectors in compressed sparse row format to a file
+	 * opened for writing
+	 *
+	 * @param offsets start of the entries of every vector, followed by the end
+	 * @param indices feature index of every entry
+	 * @param values value of every entry
+	 * @param labels label of every vector, empty if unlabelled
+	 */
+	template <class T>
+	void write_sparse(SGVector<index_t> offsets, SGVector<index_t> indices,
+		SGVector<T> values, SGVector<float64_t> labels=SGVector<float64_t>());
+
+	/** write the labels, chunk table and header of a file opened for
+	 * writing and close it
+	 */
+	void close();
+
+	/** @return whether the chunks are sparse */
+	bool is_sparse() const;
+
+	/** @return type of the values */
+	EPrimitiveType get_primitive_type() const;
+
+	/** @return compression of the chunks */
+	E_COMPRESSION_TYPE get_compression() const;
+
+	/** @return dimension of the vectors */
+	int64_t get_num_features() const;
+
+	/** @return number of vectors */
+	int64_t get_num_vectors() const;
+
+	/** @return number of chunks */
+	int64_t get_num_chunks() const;
+
+	/** @return index of the first vector of a chunk
+	 * @param chunk index of the chunk
+	 */
+	int64_t get_chunk_first_vector(int64_t chunk) const;
+
+	/** @return number of vectors of a chunk
+	 * @param chunk index of the chunk
+	 */
+	int64_t get_chunk_num_vectors(int64_t chunk) const;
+
+	/** @return whether the file has labels */
+	bool has_labels() const;
+
+	/** @return label of every vector */
+	SGVector<float64_t> get_labels() const;
+
+	/** all dense vectors
+	 *
+	 * Without compression, the matrix borrows the mapped memory, and
+	 * must not be used after this object is destroyed.
+	 *
+	 * @return num_features x num_vectors matrix
+	 */
+	template <class T>
+	SGMatrix<T> get_matrix() const;
+
+	/** dense vectors of a chunk
+	 *
+	 * Without compression, the matrix borrows the mapped memory, and
+	 * must not be used after this object is destroyed.
+	 *
+	 * @param chunk index of the chunk
+	 * @return num_features x get_chunk_num_vectors() matrix
+	 */
+	template <class T>
+	SGMatrix<T> get_dense_chunk(int64_t chunk) const;
+
+	/** read the dense vectors of a chunk through io/fs instead of the
+	 * mapping, so that files larger than memory can be processed one chunk
+	 * at a time without growing the page cache of the process
+	 *
+	 * @param chunk index of the chunk
+	 * @param file this file opened for random access
+	 * @return num_features x get_chunk_num_vectors() matrix
+	 */
+	template <class T>
+	SGMatrix<T> read_dense_chunk(int64_t chunk, const io::RandomAccessFile* file) const;
+
+	/** all sparse vectors
+	 *
+	 * Without compression, the entries of the vectors borrow the mapped
+	 * memory, and must not be used after this object is destroyed.
+	 *
+	 * @return sparse matrix
+	 */
+	template <class T>
+	SGSparseMatrix<T> get_sparse_matrix() const;
+
+	/** convert a CSV file with one vector per line
+	 *
+	 * @param csv_fname CSV file to read
+	 * @param fname dataset file to write
+	 * @param labelled whether the first value of a line is the label
+	 * @param delimiter delimiter of the values
+	 * @param compression compression of the chunks
+	 * @param chunk_size maximum number of vectors of a chunk
+	 */
+	static void convert_csv(const char* csv_fname, const char* fname,
+		bool labelled=false, char delimiter=',',
+		E_COMPRESSION_TYPE compression=UNCOMPRESSED, index_t chunk_size=65536);
+
+	/** convert a file in LibSVM format
+	 *
+	 * @param libsvm_fname LibSVM file to read
+	 * @param fname dataset file to write
+	 * @param compression compression of the chunks
+	 * @param chunk_size maximum number of vectors of a chunk
+	 */
+	static void convert_libsvm(const char* libsvm_fname, const char* fname,
+		E_COMPRESSION_TYPE compression=UNCOMPRESSED, index_t chunk_size=65536);
+
+private:
+	/** initialize members */
+	void init();
+
+	/** check that the file is opened for writing vectors of a type
+	 *
+	 * @param ptype type of the values
+	 * @param sparse whether the vectors are sparse
+	 * @param num_vectors number of vectors to write
+	 * @param labels labels of the vectors
+	 */
+	void check_write(EPrimitiveType ptype, bool sparse, index_t num_vectors,
+		const SGVector<float64_t>& labels);
+
+	/** append bytes to the file
+	 *
+	 * @param data bytes to append
+	 * @param size number of bytes
+	 */
+	void append(const void* data, int64_t size);
+
+	/** append zeros until the file size is a multiple of alignment
+	 *
+	 * @param alignment alignment in bytes
+	 */
+	void pad(int64_t alignment);
+
+	/** compress and append a chunk, and add it to the chunk table
+	 *
+	 * @param data uncompressed chunk
+	 * @param size size of the chunk in bytes
+	 * @param num_vectors number of vectors of the chunk
+	 * @param nnz number of entries of a sparse chunk
+	 * @param alignment alignment of an uncompressed chunk
+	 */
+	void write_chunk(const char* data, int64_t size, int64_t num_vectors,
+		int64_t nnz, int64_t alignment);
+
+	/** check that the file is mapped and holds vectors of a type
+	 *
+	 * @param ptype type of the values
+	 * @param sparse whether the vectors are sparse
+	 */
+	void check_read(EPrimitiveType ptype, bool sparse) const;
+
+	/** uncompressed data of a chunk
+	 *
+	 * @param chunk index of the chunk
+	 * @param buffer holds the decompressed chunk if the chunk is compressed
+	 * @return mapped or decompressed chunk
+	 */
+	const char* chunk_data(int64_t chunk, std::vector<char>& buffer) const;
+
+private:
+	/** mapped file when reading */
+	CMemoryMappedFile<char>* m_file;
+
+	/** file being written */
+	std::unique_ptr<io::WritableFile> m_writer;
+
+	/** header, written at the end of the file */
+	DatasetFileHeader m_header;
+
+	/** chunk table */
+	std::vector<DatasetFileChunk> m_chunks;
+
+	/** labels of the vectors written so far */
+	std::vector<float64_t> m_labels;
+
+	/** mapped labels when reading */
+	const float64_t* m_mapped_labels;
+
+	/** number of bytes written so far */
+	int64_t m_write_offset;
+
+	/** maximum number of vectors of a chunk when writing */
+	index_t m_chunk_size;
+
+	/** compressor of the chunks */
+	CCompressor* m_compressor;
+};
+}
+#endif // __DATASETFILE_H__
@@ -17,6 +17,9 @@
 #include <shogun/io/IOBuffer.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/lib/v_array.h>
+#include <shogun/mathematics/Math.h>
+
+#include <string>
 
 using namespace shogun;
 
@@ -218,3 +221,48 @@ unsigned int CIOBuffer::buf_read(char* &pointer, int n)
 		}
 	}
 }
+
+size_t CIOBuffer::read_lines(std::vector<char>& chunk, size_t nbytes)
+{
+	// start with what is left in the buffer
+	chunk.assign(space.end, endloaded);
+	space.end = space.begin;
+	endloaded = space.begin;
+
+	const size_t block = space.end_array - space.begin;
+	size_t last_newline = std::string::npos;
+	size_t scanned = 0;
+	bool eof = false;
+	while (!eof)
+	{
+		for (; scanned < chunk.size(); scanned++)
+		{
+			if (chunk[scanned] == '\n')
+				last_newline = scanned;
+		}
+
+		if (chunk.size() >= nbytes && last_newline != std::string::npos)
+			break;
+
+		size_t old_size = chunk.size();
+		chunk.resize(old_size + block);
+		ssize_t num_read = read_file(chunk.data() + old_size, block);
+		chunk.resize(old_size + CMath::max(num_read, (ssize_t) 0));
+		eof = num_read <= 0;
+	}
+
+	if (!eof)
+	{
+		// keep the incomplete last line for the next read
+		size_t left = chunk.size() - last_newline - 1;
+		if (left > (size_t) (space.end_array - space.begin))
+			space.reserve(left);
+
+		sg_memcpy(space.begin, chunk.data() + last_newline + 1, left);
+		space.end = space.begin;
+		endloaded = space.begin + left;
+		chunk.resize(last_newline + 1);
+	}
+
+	return chunk.size();
+}
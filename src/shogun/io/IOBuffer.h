@@ -14,6 +14,8 @@
 #include <shogun/lib/common.h>
 #include <shogun/base/SGObject.h>
 
+#include <vector>
+
 #ifndef O_LARGEFILE //for OSX
 #define O_LARGEFILE 0
 #endif
@@ -165,6 +167,18 @@ namespace shogun
 	 */
 	unsigned int buf_read(char* &pointer, int n);
 
+	/**
+	 * Reads complete lines, at least nbytes unless the end of the
+	 * file is reached. The rest of the last line that was read is
+	 * kept in the buffer for the next read.
+	 *
+	 * @param chunk lines read, ending with a newline or the end of the file
+	 * @param nbytes minimum number of bytes to read
+	 *
+	 * @return number of bytes read, 0 at the end of the file
+	 */
+	size_t read_lines(std::vector<char>& chunk, size_t nbytes);
+
 	virtual const char* get_name() const
 	{
 		return "IOBuffer";
@@ -0,0 +1,76 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <shogun/base/some.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/io/serialization/BitseryDeserializer.h>
+#include <shogun/io/serialization/BitserySerializer.h>
+#include <shogun/io/serialization/JsonDeserializer.h>
+#include <shogun/io/serialization/JsonSerializer.h>
+#include <shogun/io/stream/ByteArrayInputStream.h>
+#include <shogun/io/stream/ByteArrayOutputStream.h>
+#include <shogun/util/benchmark_data.h>
+
+namespace shogun
+{
+
+class SerializationFixture : public benchmark::Fixture
+{
+public:
+	void SetUp(const ::benchmark::State& st)
+	{
+		feats = new CDenseFeatures<float64_t>(
+		    benchmark_gaussian_data(st.range(1), st.range(0)));
+		SG_REF(feats);
+	}
+
+	void TearDown(const ::benchmark::State&)
+	{
+		SG_UNREF(feats);
+	}
+
+	template <class Serializer, class Deserializer>
+	void round_trip(benchmark::State& state)
+	{
+		int64_t bytes = 0;
+		for (auto _ : state)
+		{
+			auto serializer = some<Serializer>();
+			auto output = some<io::CByteArrayOutputStream>();
+			serializer->attach(output);
+			serializer->write(wrap<CSGObject>(feats));
+
+			std::string content = output->as_string();
+			bytes += content.size();
+
+			auto deserializer = some<Deserializer>();
+			auto input = some<io::CByteArrayInputStream>(content);
+			deserializer->attach(input);
+			benchmark::DoNotOptimize(deserializer->read_object());
+		}
+
+		state.SetBytesProcessed(bytes);
+	}
+
+	CDenseFeatures<float64_t>* feats;
+};
+
+BENCHMARK_DEFINE_F(SerializationFixture, Json_round_trip)(benchmark::State& state)
+{
+	round_trip<io::CJsonSerializer, io::CJsonDeserializer>(state);
+}
+
+BENCHMARK_DEFINE_F(SerializationFixture, Bitsery_round_trip)(benchmark::State& state)
+{
+	round_trip<io::CBitserySerializer, io::CBitseryDeserializer>(state);
+}
+
+BENCHMARK_REGISTER_F(SerializationFixture, Json_round_trip)
+    ->RangeMultiplier(4)->Ranges(BENCHMARK_SMALL_SCALE)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(SerializationFixture, Bitsery_round_trip)
+    ->RangeMultiplier(4)->Ranges(BENCHMARK_SMALL_SCALE)->Unit(benchmark::kMillisecond);
+
+}
@@ -14,12 +14,18 @@
 #include <shogun/io/SGIO.h>
 #include <shogun/io/streaming/StreamingFile.h>
 #include <shogun/io/streaming/ParseBuffer.h>
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
+#include <exception>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #define PARSER_DEFAULT_BUFFSIZE 100
+#define PARSER_DEFAULT_CHUNKSIZE (1 << 20)
 
 namespace shogun
 {
@@ -71,6 +77,16 @@ namespace shogun
  * The parsing thread should be joined with a call to end_parser().
  * exit_parser() may be used to cancel the parse thread if needed.
  *
+ * If the input file supports it, parsing can be done by several
+ * threads (see set_num_parse_threads()). The file is then read in
+ * chunks of complete lines, which the threads parse independently
+ * through the function set by set_parse_line(). Examples are put into
+ * the ring in the order of the file, or as soon as they are parsed
+ * if set_ordered(false) is used. If a thread fails to parse its chunk,
+ * the chunks after it are dropped and the error is rethrown by
+ * get_next_example() or get_next_examples() once the examples of the
+ * chunks before it are fetched.
+ *
  * Options are provided for automatic SG_FREEing of example objects
  * after each finalize_example() and also on CInputParser destruction.
  * They are set through the set_free_vector* functions.
@@ -149,6 +165,52 @@ public:
      */
     void set_read_vector_and_label(void (CStreamingFile::*func_ptr)(T* &vec, int32_t &len, float64_t &label));
 
+    /**
+     * Sets the function used for parsing a line of a chunk
+     * when parsing with several threads.
+     *
+     * The function must be a const member of CStreamingFile,
+     * taking the start and end of the line, a std::vector<T>
+     * the entries are appended to, and a pointer to the label,
+     * which is NULL for unlabelled examples. It returns false
+     * for empty lines.
+     *
+     * The argument is a function pointer to that function.
+     */
+    void set_parse_line(bool (CStreamingFile::*func_ptr)(const char* begin, const char* end, std::vector<T>& vec, float64_t* label) const);
+
+    /**
+     * Sets the number of threads parsing the input.
+     *
+     * More than one thread is only used if the input file
+     * supports parallel parsing and set_parse_line() was called.
+     *
+     * @param num_threads number of parse threads
+     */
+    void set_num_parse_threads(int32_t num_threads);
+
+    /** @return number of parse threads */
+    int32_t get_num_parse_threads() const { return num_parse_threads; }
+
+    /**
+     * Sets whether examples parsed by several threads are
+     * returned in the order of the input. Otherwise the threads
+     * write into the ring concurrently as soon as their chunks
+     * are parsed, which avoids waiting for slow chunks, and the
+     * examples of different chunks are interleaved. Examples
+     * within a chunk always keep their order.
+     *
+     * @param in_order whether to keep the order of the input
+     */
+    void set_ordered(bool in_order) { ordered=in_order; }
+
+    /**
+     * Sets the size of the chunks read by the parse threads.
+     *
+     * @param size minimum chunk size in bytes
+     */
+    void set_chunk_size(int64_t size);
+
     /**
      * Gets feature vector, length and label.
      * Sets their values by reference.
@@ -261,6 +323,32 @@ public:
      */
     void finalize_example();
 
+    /**
+     * Gets the next num examples at once, waiting until as many
+     * are parsed or the input ends. This takes the locks once
+     * for all examples instead of once per example.
+     *
+     * The examples stay in the buffer and must be released with
+     * finalize_examples() before fetching more examples.
+     *
+     * @param examples array of at least num pointers, filled
+     * with the examples in the buffer
+     * @param num number of examples, at most the ring size
+     *
+     * @return number of examples fetched, which is less than num
+     * only at the end of the input or if the parser is cancelled,
+     * and 0 if no examples are left
+     */
+    int32_t get_next_examples(Example<T>** examples, int32_t num);
+
+    /**
+     * Finalize the examples returned by get_next_examples(),
+     * indicating that their buffer positions may be overwritten.
+     *
+     * @param num number of examples
+     */
+    void finalize_examples(int32_t num);
+
     /**
      * End the parser, waiting for the parse thread to complete.
      *
@@ -288,6 +376,24 @@ private:
      */
     static void* parse_loop_entry_point(void* params);
 
+    /**
+     * Parsing loop of each of several parse threads. Reads
+     * chunks of lines from the input and parses them.
+     */
+    void parallel_parse_loop();
+
+    /**
+     * Copies the examples of a parsed chunk into the ring.
+     *
+     * @param chunk_index position of the chunk in the input
+     * @param values entries of all examples of the chunk
+     * @param offsets start of every example in values, followed by the end
+     * @param labels label of every example
+     */
+    void emit_chunk(int64_t chunk_index, const std::vector<T>& values,
+                    const std::vector<index_t>& offsets,
+                    const std::vector<float64_t>& labels);
+
 public:
     bool parsing_done;	/**< true if all input is parsed */
     bool reading_done;	/**< true if all examples are fetched */
@@ -311,6 +417,14 @@ protected:
      */
     void (CStreamingFile::*read_vector_and_label) (T* &vec, int32_t &len, float64_t &label);
 
+    /**
+     * This is the function pointer to the function to
+     * parse a line of a chunk.
+     *
+     * It is called by the parse threads when parsing in parallel.
+     */
+    bool (CStreamingFile::*parse_line) (const char* begin, const char* end, std::vector<T>& vec, float64_t* label) const;
+
     /// Input source, CStreamingFile object
     CStreamingFile* input_source;
 
@@ -356,6 +470,42 @@ protected:
 	/// Flag that indicate that the parsing thread should continue reading
 	alignas(CPU_CACHE_LINE_SIZE) std::atomic_bool keep_running;
 
+    /// Number of threads parsing the input
+    int32_t num_parse_threads;
+
+    /// Whether examples parsed in parallel keep the order of the input
+    bool ordered;
+
+    /// Minimum size of the chunks read by the parse threads in bytes
+    int64_t chunk_size;
+
+    /// Threads parsing chunks in parallel
+    std::vector<std::thread> parse_workers;
+
+    /// Number of parse threads that did not finish yet
+    int32_t active_workers;
+
+    /// Mutex for reading chunks from the input
+    std::mutex chunk_lock;
+
+    /// Index of the next chunk read from the input
+    int64_t next_chunk;
+
+    /// Mutex for copying the examples of a chunk into the ring
+    std::mutex emit_lock;
+
+    /// Condition variable to indicate that a chunk was copied into the ring
+    std::condition_variable emit_turn;
+
+    /// Index of the next chunk to be copied into the ring, if ordered
+    int64_t next_emit_chunk;
+
+    /// Index of the first chunk that failed to parse, the chunks after
+    /// it are not copied into the ring
+    std::atomic<int64_t> failed_chunk;
+
+    /// Error of the failed parse thread, rethrown to the reader
+    std::exception_ptr parse_error;
 };
 
 template <class T>
@@ -372,6 +522,26 @@ template <class T>
     read_vector_and_label=func_ptr;
 }
 
+template <class T>
+    void CInputParser<T>::set_parse_line(bool (CStreamingFile::*func_ptr)(const char* begin, const char* end, std::vector<T>& vec, float64_t* label) const)
+{
+    parse_line=func_ptr;
+}
+
+template <class T>
+    void CInputParser<T>::set_num_parse_threads(int32_t num_threads)
+{
+    require(num_threads>0, "Number of parse threads ({}) must be positive", num_threads);
+    num_parse_threads=num_threads;
+}
+
+template <class T>
+    void CInputParser<T>::set_chunk_size(int64_t size)
+{
+    require(size>0, "Chunk size ({}) must be positive", size);
+    chunk_size=size;
+}
+
 template <class T>
     CInputParser<T>::CInputParser()
 {
@@ -379,6 +549,14 @@ template <class T>
 	parsing_done=true;
 	reading_done=true;
 	keep_running.store(false, std::memory_order_release);
+	parse_line=NULL;
+	num_parse_threads=1;
+	ordered=true;
+	chunk_size=PARSER_DEFAULT_CHUNKSIZE;
+	active_workers=0;
+	next_chunk=0;
+	next_emit_chunk=0;
+	failed_chunk.store(std::numeric_limits<int64_t>::max(), std::memory_order_release);
 }
 
 template <class T>
@@ -439,7 +617,20 @@ template <class T>
     if (examples_ring)
 		examples_ring->init_vector();
 	keep_running.store(true, std::memory_order_release);
-	parse_thread = std::thread(&parse_loop_entry_point, this);
+
+	if (num_parse_threads>1 && parse_line && input_source->supports_parallel_parsing())
+	{
+		SG_DEBUG("creating {} parse threads", num_parse_threads)
+		next_chunk=0;
+		next_emit_chunk=0;
+		failed_chunk.store(std::numeric_limits<int64_t>::max(), std::memory_order_release);
+		parse_error=nullptr;
+		active_workers=num_parse_threads;
+		for (int32_t i=0; i<num_parse_threads; i++)
+			parse_workers.emplace_back(&CInputParser::parallel_parse_loop, this);
+	}
+	else
+		parse_thread = std::thread(&parse_loop_entry_point, this);
 
     SG_DEBUG("leaving CInputParser::start_parser()")
 }
@@ -555,6 +746,137 @@ template <class T> void* CInputParser<T>::main_parse_loop(void* params)
     return NULL;
 }
 
+template <class T> void CInputParser<T>::parallel_parse_loop()
+{
+	std::vector<char> chunk;
+	std::vector<T> values;
+	std::vector<index_t> offsets;
+	std::vector<float64_t> labels;
+
+	int64_t chunk_index=-1;
+	try
+	{
+		while (keep_running.load(std::memory_order_acquire))
+		{
+			chunk_index=-1;
+			{
+				std::lock_guard<std::mutex> lock(chunk_lock);
+				if (next_chunk>failed_chunk.load(std::memory_order_acquire))
+					break;
+
+				if (input_source->read_chunk(chunk, chunk_size)==0)
+					break;
+
+				chunk_index=next_chunk++;
+			}
+			// terminate the chunk, so that number parsers stop at its end
+			chunk.push_back('\0');
+
+			values.clear();
+			offsets.assign(1, 0);
+			labels.clear();
+
+			const char* line=chunk.data();
+			const char* chunk_end=chunk.data()+chunk.size()-1;
+			while (line<chunk_end)
+			{
+				const char* line_end=std::find(line, chunk_end, '\n');
+				float64_t label=0;
+				if ((input_source->*parse_line)(line, line_end, values,
+						example_type==E_LABELLED ? &label : NULL))
+				{
+					offsets.push_back(values.size());
+					labels.push_back(label);
+				}
+				line=line_end+1;
+			}
+
+			emit_chunk(chunk_index, values, offsets, labels);
+		}
+	}
+	catch (...)
+	{
+		// failing to read a chunk fails the chunk that would have been next
+		if (chunk_index<0)
+		{
+			std::lock_guard<std::mutex> lock(chunk_lock);
+			chunk_index=next_chunk;
+		}
+
+		// keep the error of the first chunk for the reader and stop the
+		// threads of the chunks after it, including those waiting for
+		// their turn
+		{
+			std::lock_guard<std::mutex> lock(examples_state_lock);
+			if (chunk_index<failed_chunk.load(std::memory_order_acquire))
+			{
+				parse_error=std::current_exception();
+				failed_chunk.store(chunk_index, std::memory_order_release);
+			}
+		}
+		std::lock_guard<std::mutex> lock(emit_lock);
+		emit_turn.notify_all();
+	}
+
+	// the last thread to finish marks the end of the input
+	std::lock_guard<std::mutex> lock(examples_state_lock);
+	if (--active_workers==0)
+	{
+		parsing_done=true;
+		examples_state_changed.notify_one();
+	}
+}
+
+template <class T> void CInputParser<T>::emit_chunk(int64_t chunk_index,
+		const std::vector<T>& values, const std::vector<index_t>& offsets,
+		const std::vector<float64_t>& labels)
+{
+	std::unique_lock<std::mutex> lock(emit_lock, std::defer_lock);
+	if (ordered)
+	{
+		lock.lock();
+		emit_turn.wait(lock, [&]() {
+			return next_emit_chunk==chunk_index ||
+				!keep_running.load(std::memory_order_acquire) ||
+				chunk_index>failed_chunk.load(std::memory_order_acquire);
+		});
+	}
+
+	for (size_t i=0; i+1<offsets.size(); i++)
+	{
+		if (!keep_running.load(std::memory_order_acquire) ||
+				chunk_index>failed_chunk.load(std::memory_order_acquire))
+			break;
+
+		// without ordering, threads write into the ring concurrently
+		Example<T>* ex=ordered ? examples_ring->get_free_example() :
+			examples_ring->claim_free_example();
+
+		// reuse the vector of the ring position, like the parse functions
+		int32_t len=offsets[i+1]-offsets[i];
+		if (!ex->fv || len>ex->length)
+			ex->fv=SG_REALLOC(T, ex->fv, ex->length, len);
+
+		std::copy(values.begin()+offsets[i], values.begin()+offsets[i+1], ex->fv);
+		ex->length=len;
+		ex->label=labels[i];
+		if (ordered)
+			examples_ring->copy_example(ex);
+		else
+			examples_ring->publish_example(ex);
+
+		std::lock_guard<std::mutex> state_lock(examples_state_lock);
+		number_of_vectors_parsed++;
+		examples_state_changed.notify_one();
+	}
+
+	if (ordered)
+	{
+		next_emit_chunk++;
+		emit_turn.notify_all();
+	}
+}
+
 template <class T> Example<T>* CInputParser<T>::retrieve_example()
 {
     /* This function should be guarded by mutexes while calling  */
@@ -579,8 +901,10 @@ template <class T> Example<T>* CInputParser<T>::retrieve_example()
         return NULL;
     }
 
+    // with several parse threads, the next example may still be written
     ex = examples_ring->get_unused_example();
-    number_of_vectors_read++;
+    if (ex)
+        number_of_vectors_read++;
 
     return ex;
 }
@@ -605,6 +929,10 @@ template <class T> int32_t CInputParser<T>::get_next_example(T* &fv,
 
         if (ex == NULL)
         {
+            /* The examples before a parse error are fetched, rethrow it */
+            if (parse_error && parsing_done)
+                std::rethrow_exception(parse_error);
+
             if (reading_done)
             {
                 /* No more examples left, return */
@@ -624,6 +952,9 @@ template <class T> int32_t CInputParser<T>::get_next_example(T* &fv,
         }
     }
 
+    if (!keep_running.load(std::memory_order_acquire))
+        return 0;
+
     fv = ex->fv;
     length = ex->length;
     label = ex->label;
@@ -645,22 +976,80 @@ template <class T>
     examples_ring->finalize_example(free_after_release);
 }
 
+template <class T>
+    int32_t CInputParser<T>::get_next_examples(Example<T>** examples, int32_t num)
+{
+    require(num>0 && num<=ring_size, "Number of examples ({}) must be between "
+            "1 and the ring size ({})", num, ring_size);
+
+    std::unique_lock<std::mutex> lock(examples_state_lock);
+    examples_state_changed.wait(lock, [&]() {
+        return !keep_running.load(std::memory_order_acquire) || parsing_done ||
+            number_of_vectors_parsed-number_of_vectors_read>=num;
+    });
+
+    if (!keep_running.load(std::memory_order_acquire))
+        return 0;
+
+    int32_t available=CMath::min(num, number_of_vectors_parsed-number_of_vectors_read);
+    if (available==0 && parse_error)
+        std::rethrow_exception(parse_error);
+
+    if (available==0)
+    {
+        reading_done=true;
+        examples_state_changed.notify_one();
+        return 0;
+    }
+
+    // with several parse threads, some of the examples may still be written,
+    // if the parser is cancelled meanwhile the ready ones are returned
+    int32_t ready;
+    while ((ready=examples_ring->get_unused_examples(available, examples))<available &&
+            keep_running.load(std::memory_order_acquire))
+        examples_state_changed.wait(lock);
+    number_of_vectors_read+=ready;
+
+    return ready;
+}
+
+template <class T>
+    void CInputParser<T>::finalize_examples(int32_t num)
+{
+    examples_ring->finalize_examples(num, free_after_release);
+}
+
 template <class T> void CInputParser<T>::end_parser()
 {
 	SG_DEBUG("entering CInputParser::end_parser")
 	SG_DEBUG("joining parse thread")
 	if (parse_thread.joinable())
 		parse_thread.join();
+	for (auto& worker : parse_workers)
+		worker.join();
+	parse_workers.clear();
     SG_DEBUG("leaving CInputParser::end_parser")
 }
 
 template <class T> void CInputParser<T>::exit_parser()
 {
 	SG_DEBUG("cancelling parse thread")
-	keep_running.store(false, std::memory_order_release);
-	examples_state_changed.notify_one();
+	// under the locks, so that no thread misses the notification between
+	// checking keep_running and waiting
+	{
+		std::lock_guard<std::mutex> lock(emit_lock);
+		keep_running.store(false, std::memory_order_release);
+		emit_turn.notify_all();
+	}
+	{
+		std::lock_guard<std::mutex> lock(examples_state_lock);
+		examples_state_changed.notify_all();
+	}
 	if (parse_thread.joinable())
 		parse_thread.join();
+	for (auto& worker : parse_workers)
+		worker.join();
+	parse_workers.clear();
 }
 }
 
@@ -10,25 +10,17 @@
 #include <shogun/lib/config.h>
 
 #include <shogun/lib/common.h>
+#include <shogun/lib/cpu.h>
 #include <shogun/base/SGObject.h>
 #include <shogun/lib/DataType.h>
+#include <shogun/mathematics/Math.h>
+#include <atomic>
 #include <condition_variable>
-#include <memory>
 #include <mutex>
-#include <vector>
 
 namespace shogun
 {
 
-/// Specifies whether location is empty,
-/// contains an unused example or a used example.
-enum E_IS_EXAMPLE_USED
-{
-	E_EMPTY = 1,
-	E_NOT_USED = 2,
-	E_USED = 3
-};
-
 /** @brief Class Example is the container type for
  * the vector+label combination.
  *
@@ -62,8 +54,20 @@ public:
  * when the example is used to make room for another
  * example to take its place.
  *
- * Writing of examples is done into whichever position
- * in the ring is free to be overwritten, or empty.
+ * The ring is lock-free. Every slot holds its example in
+ * place together with a sequence number, which tells
+ * whether the slot is free to be written or ready to be
+ * read for a given position in the stream, so the writer
+ * and the reader only synchronize on the slot they use.
+ * Slots and positions are padded to cache lines. A writer
+ * waiting for a free slot spins for a while and then
+ * sleeps until the reader releases the slot.
+ *
+ * There is a single reader. Examples are written either by
+ * a single writer, through get_free_example() and
+ * copy_example(), or by several writers, through
+ * claim_free_example() and publish_example(). The two ways
+ * of writing must not be mixed.
  */
 template <class T> class CParseBuffer: public CSGObject
 {
@@ -83,19 +87,16 @@ public:
 
 	/**
 	 * Return the next position to write the example
-	 * into the ring.
+	 * into the ring, waiting for it to be free.
 	 *
 	 * @return pointer to example
 	 */
 	Example<T>* get_free_example()
 	{
-		std::unique_lock<std::mutex> write_lk(*write_mutex, std::defer_lock);
-		std::unique_lock<std::mutex> current_ex_lock(*ex_in_use_mutex[ex_write_index], std::defer_lock);
-		std::lock(write_lk, current_ex_lock);
-		while (ex_used[ex_write_index] == E_NOT_USED)
-			ex_in_use_cond[ex_write_index]->wait(current_ex_lock);
-		Example<T>* ex=&ex_ring[ex_write_index];
-		return ex;
+		int64_t position = write_position.load(std::memory_order_relaxed);
+		Slot& slot = slots[position % ring_size];
+		wait_for_turn(slot, position);
+		return &slot.ex;
 	}
 
 	/**
@@ -132,6 +133,25 @@ public:
 	 */
 	int32_t copy_example(Example<T>* ex);
 
+	/**
+	 * Claims the next position to write an example into the
+	 * ring, waiting for it to be free. Several threads may
+	 * claim positions at the same time. The example is
+	 * written in place and then made visible with
+	 * publish_example().
+	 *
+	 * @return pointer to example
+	 */
+	Example<T>* claim_free_example();
+
+	/**
+	 * Makes an example written in place after
+	 * claim_free_example() ready to be read.
+	 *
+	 * @param ex example returned by claim_free_example()
+	 */
+	void publish_example(Example<T>* ex);
+
 	/**
 	 * Mark the example in 'read' position as 'used'.
 	 *
@@ -141,6 +161,27 @@ public:
 	 */
 	void finalize_example(bool free_after_release);
 
+	/**
+	 * Returns the examples that should be read next from the
+	 * buffer, starting at the 'read' position, as long as they
+	 * are ready to be read.
+	 *
+	 * @param num maximum number of examples
+	 * @param examples array of at least num pointers, filled with
+	 * the examples
+	 *
+	 * @return number of examples returned
+	 */
+	int32_t get_unused_examples(int32_t num, Example<T>** examples);
+
+	/**
+	 * Mark num examples from the 'read' position as 'used'.
+	 *
+	 * @param num number of examples
+	 * @param free_after_release whether to SG_FREE() the vectors or not
+	 */
+	void finalize_examples(int32_t num, bool free_after_release);
+
 	/**
 	 * Set whether all vectors are to be freed
 	 * on destruction. This is true by default.
@@ -177,46 +218,58 @@ public:
 	void init_vector();
 
 protected:
+	/** A slot of the ring, padded to a cache line so that the
+	 * writer and the reader do not share the lines of
+	 * neighbouring examples.
+	 */
+	struct alignas(CPU_CACHE_LINE_SIZE) Slot
+	{
+		/// Example, stored in place
+		Example<T> ex;
+		/// The slot is free for writing the example at position
+		/// sequence, and ready for reading the example at
+		/// position sequence-1
+		std::atomic<int64_t> sequence;
+	};
+
 	/**
-	 * Increments the 'read' position in the buffer.
+	 * Waits until a slot is free for writing the example at a
+	 * position. Spins first, as the reader usually releases
+	 * the slot soon, and sleeps after that.
 	 *
+	 * @param slot slot of the position
+	 * @param position position in the stream
 	 */
-	virtual void inc_read_index()
-	{
-		ex_read_index=(ex_read_index + 1) % ring_size;
-	}
+	void wait_for_turn(Slot& slot, int64_t position);
 
 	/**
-	 * Increments the 'write' position in the buffer.
+	 * Frees the slot of a read position for writing.
 	 *
+	 * @param position position in the stream
+	 * @param free_after_release whether to SG_FREE() the vector or not
 	 */
-	virtual void inc_write_index()
-	{
-		ex_write_index=(ex_write_index + 1) % ring_size;
-	}
+	void release_example(int64_t position, bool free_after_release);
 
 protected:
+	/// Number of times a writer checks for a free slot before sleeping
+	static constexpr int32_t spin_count = 1 << 10;
 
 	/// Size of ring as number of examples
 	int32_t ring_size;
 	/// Ring of examples
-	Example<T>* ex_ring;
-
-	/// Enum used for representing used/unused/empty state of example
-	E_IS_EXAMPLE_USED* ex_used;
-	/// Lock on state of example - used or unused
-	std::vector<std::shared_ptr<std::mutex> > ex_in_use_mutex;
-	/// Condition variable triggered when example is being/not being used
-	std::vector<std::shared_ptr<std::condition_variable> > ex_in_use_cond;
-	/// Lock for reading examples from the ring
-	std::shared_ptr<std::mutex> read_mutex;
-	/// Lock for writing new examples
-	std::shared_ptr<std::mutex> write_mutex;
-
-	/// Write position for next example
-	int32_t ex_write_index;
-	/// Position of next example to be read
-	int32_t ex_read_index;
+	Slot* slots;
+
+	/// Position of the next example to be written
+	alignas(CPU_CACHE_LINE_SIZE) std::atomic<int64_t> write_position;
+	/// Position of the next example to be read
+	alignas(CPU_CACHE_LINE_SIZE) int64_t read_position;
+
+	/// Number of writers sleeping until a slot is free
+	alignas(CPU_CACHE_LINE_SIZE) std::atomic<int32_t> num_parked;
+	/// Lock for sleeping writers
+	std::mutex park_mutex;
+	/// Condition variable triggered when a slot is freed while writers sleep
+	std::condition_variable park_cond;
 
 	/// Whether examples on the ring will be freed on destruction
 	bool free_vectors_on_destruct;
@@ -229,33 +282,27 @@ template <class T> void CParseBuffer<T>::init_vector()
 		return;
 	for (int32_t i=0; i<ring_size; i++)
 	{
-		if(ex_ring[i].fv==NULL)
-			ex_ring[i].fv = new T();
+		if(slots[i].ex.fv==NULL)
+			slots[i].ex.fv = new T();
 	}
 }
 
 template <class T> CParseBuffer<T>::CParseBuffer(int32_t size)
 {
 	ring_size = size;
-	ex_ring = SG_CALLOC(Example<T>, ring_size);
-	ex_used = SG_MALLOC(E_IS_EXAMPLE_USED, ring_size);
-	read_mutex = std::make_shared<std::mutex>();
-	write_mutex = std::make_shared<std::mutex>();
+	slots = new Slot[ring_size];
 	io::info("Initialized with ring size: {}.", ring_size);
 
-	ex_write_index = 0;
-	ex_read_index = 0;
+	write_position = 0;
+	read_position = 0;
+	num_parked = 0;
 
 	for (int32_t i=0; i<ring_size; i++)
 	{
-		ex_used[i] = E_EMPTY;
-
-		ex_ring[i].fv = NULL;
-		ex_ring[i].length = 1;
-		ex_ring[i].label = FLT_MAX;
-
-		ex_in_use_mutex.push_back(std::make_shared<std::mutex>());
-		ex_in_use_cond.push_back(std::make_shared<std::condition_variable>());
+		slots[i].ex.fv = NULL;
+		slots[i].ex.length = 1;
+		slots[i].ex.label = FLT_MAX;
+		slots[i].sequence.store(i, std::memory_order_relaxed);
 	}
 	free_vectors_on_destruct = true;
 }
@@ -264,30 +311,69 @@ template <class T> CParseBuffer<T>::~CParseBuffer()
 {
 	for (int32_t i=0; i<ring_size; i++)
 	{
-		if (ex_ring[i].fv != NULL && free_vectors_on_destruct)
+		if (slots[i].ex.fv != NULL && free_vectors_on_destruct)
 		{
 			SG_DEBUG("{}::~{}(): destroying examples ring vector {} at {}",
-					get_name(), get_name(), i, fmt::ptr(ex_ring[i].fv));
-			delete ex_ring[i].fv;
+					get_name(), get_name(), i, fmt::ptr(slots[i].ex.fv));
+			delete slots[i].ex.fv;
 		}
 	}
-	SG_FREE(ex_ring);
-	SG_FREE(ex_used);
+	delete[] slots;
+}
 
-	ex_in_use_mutex.clear();
-	ex_in_use_cond.clear();
-	read_mutex.reset();
-	write_mutex.reset();
+template <class T>
+void CParseBuffer<T>::wait_for_turn(Slot& slot, int64_t position)
+{
+	for (int32_t i=0; slot.sequence.load(std::memory_order_acquire) != position; i++)
+	{
+		if (i < spin_count)
+		{
+			CpuRelax();
+			continue;
+		}
+
+		// the reader checks num_parked after freeing a slot, so either
+		// it sees this writer or this writer sees the free slot
+		std::unique_lock<std::mutex> lock(park_mutex);
+		num_parked.fetch_add(1);
+		park_cond.wait(lock, [&]() { return slot.sequence.load() == position; });
+		num_parked.fetch_sub(1);
+		break;
+	}
+}
+
+template <class T>
+void CParseBuffer<T>::release_example(int64_t position, bool free_after_release)
+{
+	Slot& slot = slots[position % ring_size];
+	if (free_after_release)
+	{
+		SG_DEBUG("Freeing object in ring at index {} and address: {}.",
+			 position % ring_size, fmt::ptr(slot.ex.fv));
+
+		SG_FREE(slot.ex.fv);
+		slot.ex.fv=NULL;
+	}
+
+	slot.sequence.store(position + ring_size);
+	if (num_parked.load())
+	{
+		std::lock_guard<std::mutex> lock(park_mutex);
+		park_cond.notify_all();
+	}
 }
 
 template <class T>
 int32_t CParseBuffer<T>::write_example(Example<T> *ex)
 {
-	ex_ring[ex_write_index].label = ex->label;
-	ex_ring[ex_write_index].fv = ex->fv;
-	ex_ring[ex_write_index].length = ex->length;
-	ex_used[ex_write_index] = E_NOT_USED;
-	inc_write_index();
+	int64_t position = write_position.load(std::memory_order_relaxed);
+	Slot& slot = slots[position % ring_size];
+
+	slot.ex.label = ex->label;
+	slot.ex.fv = ex->fv;
+	slot.ex.length = ex->length;
+	slot.sequence.store(position + 1, std::memory_order_release);
+	write_position.store(position + 1, std::memory_order_relaxed);
 
 	return 1;
 }
@@ -295,68 +381,78 @@ int32_t CParseBuffer<T>::write_example(Example<T> *ex)
 template <class T>
 Example<T>* CParseBuffer<T>::return_example_to_read()
 {
-	if (ex_read_index >= 0)
-		return &ex_ring[ex_read_index];
-	else
-		return NULL;
+	return &slots[read_position % ring_size].ex;
 }
 
 template <class T>
 Example<T>* CParseBuffer<T>::get_unused_example()
 {
-	std::lock_guard<std::mutex> read_lk(*read_mutex);
-
-	Example<T> *ex;
-	int32_t current_index = ex_read_index;
-	// Because read index will change after return_example_to_read
-
-	std::lock_guard<std::mutex> current_ex_lk(*ex_in_use_mutex[current_index]);
-
-	if (ex_used[current_index] == E_NOT_USED)
-		ex = return_example_to_read();
-	else
-		ex = NULL;
+	Slot& slot = slots[read_position % ring_size];
+	if (slot.sequence.load(std::memory_order_acquire) == read_position + 1)
+		return &slot.ex;
 
-	return ex;
+	return NULL;
 }
 
 template <class T>
 int32_t CParseBuffer<T>::copy_example(Example<T> *ex)
 {
-	std::lock_guard<std::mutex> write_lk(*write_mutex);
-	int32_t ret;
-	int32_t current_index = ex_write_index;
+	int64_t position = write_position.load(std::memory_order_relaxed);
+	wait_for_turn(slots[position % ring_size], position);
 
-	std::unique_lock<std::mutex> current_ex_lock(*ex_in_use_mutex[current_index]);
-	while (ex_used[ex_write_index] == E_NOT_USED)
-	{
-		ex_in_use_cond[ex_write_index]->wait(current_ex_lock);
-	}
+	return write_example(ex);
+}
+
+template <class T>
+Example<T>* CParseBuffer<T>::claim_free_example()
+{
+	int64_t position = write_position.fetch_add(1, std::memory_order_relaxed);
+	Slot& slot = slots[position % ring_size];
+	wait_for_turn(slot, position);
 
-	ret = write_example(ex);
+	return &slot.ex;
+}
 
-	return ret;
+template <class T>
+void CParseBuffer<T>::publish_example(Example<T>* ex)
+{
+	// the example is the first member of its slot
+	Slot* slot = reinterpret_cast<Slot*>(ex);
+	int64_t position = slot->sequence.load(std::memory_order_relaxed);
+	slot->sequence.store(position + 1, std::memory_order_release);
 }
 
 template <class T>
 void CParseBuffer<T>::finalize_example(bool free_after_release)
 {
-	std::lock_guard<std::mutex> read_lk(*read_mutex);
-	std::unique_lock<std::mutex> current_ex_lock(*ex_in_use_mutex[ex_read_index]);
-	ex_used[ex_read_index] = E_USED;
+	release_example(read_position, free_after_release);
+	read_position++;
+}
 
-	if (free_after_release)
+template <class T>
+int32_t CParseBuffer<T>::get_unused_examples(int32_t num, Example<T>** examples)
+{
+	int32_t i;
+	for (i = 0; i < CMath::min(num, ring_size); i++)
 	{
-		SG_DEBUG("Freeing object in ring at index {} and address: {}.",
-			 ex_read_index, fmt::ptr(ex_ring[ex_read_index].fv));
+		int64_t position = read_position + i;
+		Slot& slot = slots[position % ring_size];
+		if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+			break;
 
-		SG_FREE(ex_ring[ex_read_index].fv);
-		ex_ring[ex_read_index].fv=NULL;
+		examples[i] = &slot.ex;
 	}
 
-	ex_in_use_cond[ex_read_index]->notify_one();
-	current_ex_lock.unlock();
-	inc_read_index();
+	return i;
+}
+
+template <class T>
+void CParseBuffer<T>::finalize_examples(int32_t num, bool free_after_release)
+{
+	for (int32_t i = 0; i < num; i++)
+		release_example(read_position + i, free_after_release);
+
+	read_position += num;
 }
 
 }
@@ -10,7 +10,11 @@
 #include <shogun/lib/SGSparseVector.h>
 #include <shogun/base/DynArray.h>
 
+#include <algorithm>
+#include <charconv>
 #include <ctype.h>
+#include <string>
+#include <type_traits>
 
 using namespace shogun;
 
@@ -605,6 +609,163 @@ GET_SPARSE_VECTOR_AND_LABEL(get_ulong_sparse_vector_and_label, atoi, uint64_t)
 GET_SPARSE_VECTOR_AND_LABEL(get_longreal_sparse_vector_and_label, atoi, floatmax_t)
 #undef GET_SPARSE_VECTOR_AND_LABEL
 
+/* Methods for parsing the lines of a chunk, used by parallel parsing */
+
+/** parse a number at the start of [begin, end)
+ *
+ * @return position after the number, NULL if there is none
+ */
+template <class T>
+static const char* parse_number(const char* begin, const char* end, T& value)
+{
+	if (begin != end && *begin == '+')
+		begin++;
+
+	if constexpr (std::is_same<T, bool>::value)
+	{
+		int64_t integer = 0;
+		auto result = std::from_chars(begin, end, integer);
+		value = integer != 0;
+		return result.ec == std::errc() ? result.ptr : NULL;
+	}
+	else if constexpr (std::is_integral<T>::value)
+	{
+		auto result = std::from_chars(begin, end, value);
+		return result.ec == std::errc() ? result.ptr : NULL;
+	}
+	else
+	{
+#ifdef __cpp_lib_to_chars
+		auto result = std::from_chars(begin, end, value);
+		if (result.ec == std::errc())
+			return result.ptr;
+#endif
+		// chunks are NUL terminated, so strtod stops at their end
+		char* ptr = NULL;
+		if constexpr (std::is_same<T, floatmax_t>::value)
+			value = strtold(begin, &ptr);
+		else
+			value = strtod(begin, &ptr);
+
+		return ptr == begin ? NULL : ptr;
+	}
+}
+
+/** parse a number token, anything after the number is ignored like atoi */
+template <class T>
+static T parse_token(const char* begin, const char* end)
+{
+	T value;
+	if (!parse_number(begin, end, value))
+		error("{} is not a number!", std::string(begin, end));
+
+	return value;
+}
+
+template <class T>
+static bool parse_dense_line(const char* begin, const char* end,
+		char delimiter, std::vector<T>& vector, float64_t* label)
+{
+	auto is_separator = [delimiter](char c) {
+		return c == delimiter || isblank(c) || c == '\r';
+	};
+
+	bool empty = true;
+	for (const char* ptr = begin; ptr < end; )
+	{
+		if (is_separator(*ptr))
+		{
+			ptr++;
+			continue;
+		}
+
+		const char* token_end = ptr;
+		while (token_end < end && !is_separator(*token_end))
+			token_end++;
+
+		/* The first element is the label */
+		if (empty && label)
+			*label = parse_token<float64_t>(ptr, token_end);
+		else
+			vector.push_back(parse_token<T>(ptr, token_end));
+
+		empty = false;
+		ptr = token_end;
+	}
+
+	return !empty;
+}
+
+template <class T>
+static bool parse_sparse_line(const char* begin, const char* end,
+		std::vector<SGSparseVectorEntry<T>>& vector, float64_t* label)
+{
+	auto is_separator = [](char c) { return isblank(c) || c == '\r'; };
+
+	bool empty = true;
+	for (const char* ptr = begin; ptr < end; )
+	{
+		if (is_separator(*ptr))
+		{
+			ptr++;
+			continue;
+		}
+
+		const char* token_end = ptr;
+		while (token_end < end && !is_separator(*token_end))
+			token_end++;
+
+		/* The first element is the label, then index:value pairs */
+		if (empty && label)
+			*label = parse_token<float64_t>(ptr, token_end);
+		else
+		{
+			const char* colon = std::find(ptr, token_end, ':');
+			if (colon == token_end)
+				error("{} is not an index:value pair!", std::string(ptr, token_end));
+
+			SGSparseVectorEntry<T> entry;
+			entry.feat_index = parse_token<int32_t>(ptr, colon) - 1;
+			entry.entry = parse_token<T>(colon + 1, token_end);
+			vector.push_back(entry);
+		}
+
+		empty = false;
+		ptr = token_end;
+	}
+
+	return !empty;
+}
+
+#define PARSE_LINE(sg_type)											\
+bool CStreamingAsciiFile::parse_line(const char* begin, const char* end,	\
+		std::vector<sg_type>& vector, float64_t* label) const				\
+{																			\
+		return parse_dense_line(begin, end, m_delimiter, vector, label);	\
+}																			\
+																			\
+bool CStreamingAsciiFile::parse_line(const char* begin, const char* end,	\
+		std::vector<SGSparseVectorEntry<sg_type>>& vector,					\
+		float64_t* label) const												\
+{																			\
+		return parse_sparse_line(begin, end, vector, label);				\
+}
+
+PARSE_LINE(bool)
+PARSE_LINE(uint8_t)
+PARSE_LINE(char)
+PARSE_LINE(int32_t)
+PARSE_LINE(float32_t)
+PARSE_LINE(float64_t)
+PARSE_LINE(int16_t)
+PARSE_LINE(uint16_t)
+PARSE_LINE(int8_t)
+PARSE_LINE(uint32_t)
+PARSE_LINE(int64_t)
+PARSE_LINE(uint64_t)
+PARSE_LINE(floatmax_t)
+#undef PARSE_LINE
+
 template <class T>
 void CStreamingAsciiFile::append_item(
 		DynArray<T>* items, char* ptr_data, char* ptr_item)
@@ -99,6 +99,36 @@ public:
 	GET_VECTOR_DECL(floatmax_t)
 #undef GET_VECTOR_DECL
 
+	/**
+	 * Lines can be parsed in parallel
+	 *
+	 * @return true
+	 */
+	virtual bool supports_parallel_parsing() const { return true; }
+
+#define PARSE_LINE_DECL(sg_type)					\
+	virtual bool parse_line(const char* begin, const char* end,	\
+		std::vector<sg_type>& vector, float64_t* label) const;	\
+									\
+	virtual bool parse_line(const char* begin, const char* end,	\
+		std::vector<SGSparseVectorEntry<sg_type>>& vector,	\
+		float64_t* label) const;
+
+	PARSE_LINE_DECL(bool)
+	PARSE_LINE_DECL(uint8_t)
+	PARSE_LINE_DECL(char)
+	PARSE_LINE_DECL(int32_t)
+	PARSE_LINE_DECL(float32_t)
+	PARSE_LINE_DECL(float64_t)
+	PARSE_LINE_DECL(int16_t)
+	PARSE_LINE_DECL(uint16_t)
+	PARSE_LINE_DECL(int8_t)
+	PARSE_LINE_DECL(uint32_t)
+	PARSE_LINE_DECL(int64_t)
+	PARSE_LINE_DECL(uint64_t)
+	PARSE_LINE_DECL(floatmax_t)
+#undef PARSE_LINE_DECL
+
 #endif // #ifndef SWIG // SWIG should skip this
 
 	/** @return object name */
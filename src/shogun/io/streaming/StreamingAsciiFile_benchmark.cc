@@ -0,0 +1,64 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <shogun/base/some.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/features/streaming/StreamingDenseFeatures.h>
+#include <shogun/io/CSVFile.h>
+#include <shogun/io/streaming/StreamingAsciiFile.h>
+#include <shogun/util/benchmark_data.h>
+
+#include <cstdio>
+
+namespace shogun
+{
+
+class StreamingAsciiFileFixture : public benchmark::Fixture
+{
+public:
+	void SetUp(const ::benchmark::State& st)
+	{
+		auto feats = some<CDenseFeatures<float64_t>>(
+		    benchmark_gaussian_data(st.range(1), st.range(0)));
+		auto file = some<CCSVFile>(fname, 'w');
+		feats->save(file);
+		file->close();
+	}
+
+	void TearDown(const ::benchmark::State&)
+	{
+		std::remove(fname);
+	}
+
+	const char* fname = "StreamingAsciiFile_benchmark.csv";
+};
+
+BENCHMARK_DEFINE_F(StreamingAsciiFileFixture, StreamingDenseFeatures_parse)(benchmark::State& state)
+{
+	for (auto _ : state)
+	{
+		auto input = new CStreamingAsciiFile(fname);
+		input->set_delimiter(',');
+		auto feats = some<CStreamingDenseFeatures<float64_t>>(input, false, 1024);
+
+		index_t num_vecs = 0;
+		feats->start_parser();
+		while (feats->get_next_example())
+		{
+			num_vecs++;
+			feats->release_example();
+		}
+		feats->end_parser();
+		benchmark::DoNotOptimize(num_vecs);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(StreamingAsciiFileFixture, StreamingDenseFeatures_parse)
+    ->RangeMultiplier(4)->Ranges(BENCHMARK_LARGE_SCALE)->Unit(benchmark::kMillisecond);
+
+}
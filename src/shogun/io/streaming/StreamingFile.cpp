@@ -7,6 +7,7 @@
 
 #include <shogun/lib/memory.h>
 #include <shogun/io/streaming/StreamingFile.h>
+#include <shogun/lib/SGSparseVector.h>
 #include <fcntl.h>
 #ifdef _WIN32
 #include <io.h>
@@ -178,6 +179,46 @@ GET_SPARSE_VECTOR_AND_LABEL(get_long_sparse_vector_and_label, atoi, int64_t)
 GET_SPARSE_VECTOR_AND_LABEL(get_ulong_sparse_vector_and_label, atoi, uint64_t)
 GET_SPARSE_VECTOR_AND_LABEL(get_longreal_sparse_vector_and_label, atoi, floatmax_t)
 #undef GET_SPARSE_VECTOR_AND_LABEL
+
+/* For parallel parsing */
+#define PARSE_LINE(sg_type)						\
+	bool CStreamingFile::parse_line					\
+	(const char* begin, const char* end,				\
+	 std::vector<sg_type>& vector, float64_t* label) const		\
+	{								\
+		error("Parallel parsing not supported by {}!", get_name()); \
+		return false;						\
+	}								\
+									\
+	bool CStreamingFile::parse_line					\
+	(const char* begin, const char* end,				\
+	 std::vector<SGSparseVectorEntry<sg_type>>& vector,		\
+	 float64_t* label) const					\
+	{								\
+		error("Parallel parsing not supported by {}!", get_name()); \
+		return false;						\
+	}
+
+PARSE_LINE(bool)
+PARSE_LINE(uint8_t)
+PARSE_LINE(char)
+PARSE_LINE(int32_t)
+PARSE_LINE(float32_t)
+PARSE_LINE(float64_t)
+PARSE_LINE(int16_t)
+PARSE_LINE(uint16_t)
+PARSE_LINE(int8_t)
+PARSE_LINE(uint32_t)
+PARSE_LINE(int64_t)
+PARSE_LINE(uint64_t)
+PARSE_LINE(floatmax_t)
+#undef PARSE_LINE
+
+int64_t CStreamingFile::read_chunk(std::vector<char>& chunk, int64_t size)
+{
+	require(buf, "No file to read from!");
+	return buf->read_lines(chunk, size);
+}
 	
 }
 
@@ -13,6 +13,8 @@
 #include <shogun/base/SGObject.h>
 #include <shogun/io/IOBuffer.h>
 
+#include <vector>
+
 namespace shogun
 {
 template <class ST> struct SGSparseVectorEntry;
@@ -262,6 +264,96 @@ template <class ST> struct SGSparseVectorEntry;
 
 		//@}
 
+		/** @name Parallel Parsing Functions
+		 *
+		 * Files whose examples are stored one per line can be
+		 * parsed by several threads: the file is read in chunks
+		 * of complete lines by read_chunk(), and each line of a
+		 * chunk is parsed independently by parse_line().
+		 */
+		//@{
+		/**
+		 * Whether the file supports read_chunk() and parse_line()
+		 *
+		 * @return false by default, unless overloaded
+		 */
+		virtual bool supports_parallel_parsing() const { return false; }
+
+		/**
+		 * Reads the next chunk of complete lines
+		 *
+		 * @param chunk lines read, ending with a newline or the end of the file
+		 * @param size minimum size of the chunk in bytes
+		 *
+		 * @return number of bytes read, 0 at the end of the file
+		 */
+		virtual int64_t read_chunk(std::vector<char>& chunk, int64_t size);
+
+		/**
+		 * Parses the dense or sparse vector of a line and appends its
+		 * entries. Must be safe to call from several threads.
+		 *
+		 * @param begin start of the line
+		 * @param end end of the line, excluding the newline
+		 * @param vector entries are appended to this vector
+		 * @param label label of the line is stored here, NULL if unlabelled
+		 *
+		 * @return false if the line is empty
+		 */
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<bool>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<uint8_t>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<char>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<int32_t>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<float32_t>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<float64_t>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<int16_t>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<uint16_t>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<int8_t>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<uint32_t>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<int64_t>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<uint64_t>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<floatmax_t>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<SGSparseVectorEntry<bool>>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<SGSparseVectorEntry<uint8_t>>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<SGSparseVectorEntry<char>>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<SGSparseVectorEntry<int32_t>>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<SGSparseVectorEntry<float32_t>>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<SGSparseVectorEntry<float64_t>>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<SGSparseVectorEntry<int16_t>>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<SGSparseVectorEntry<uint16_t>>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<SGSparseVectorEntry<int8_t>>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<SGSparseVectorEntry<uint32_t>>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<SGSparseVectorEntry<int64_t>>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<SGSparseVectorEntry<uint64_t>>& vector, float64_t* label) const;
+		virtual bool parse_line(const char* begin, const char* end,
+			std::vector<SGSparseVectorEntry<floatmax_t>>& vector, float64_t* label) const;
+		//@}
+
 #endif // #ifndef SWIG // SWIG should skip this
 
 
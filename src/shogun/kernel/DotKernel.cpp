@@ -0,0 +1,27 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/kernel/DotKernel.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
+
+using namespace shogun;
+
+void CDotKernel::compute_dot_block(
+	index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block)
+{
+	SGMatrix<float64_t> lhs_matrix=get_dense_feature_matrix(lhs);
+	SGMatrix<float64_t> rhs_matrix=get_dense_feature_matrix(rhs);
+	ASSERT(lhs_matrix.matrix && rhs_matrix.matrix)
+
+	const index_t dim=lhs_matrix.num_rows;
+
+	// the vectors of a block are contiguous columns of the feature matrix
+	SGMatrix<float64_t> lhs_block(lhs_matrix.matrix+int64_t(row_begin)*dim,
+		dim, block.num_rows, false);
+	SGMatrix<float64_t> rhs_block(rhs_matrix.matrix+int64_t(col_begin)*dim,
+		dim, block.num_cols, false);
+
+	linalg::matrix_prod(lhs_block, rhs_block, block, true, false);
+}
@@ -132,6 +132,18 @@ class CDotKernel : public CKernel
 		{
 			return ((CDotFeatures*) lhs)->dot(idx_a, ((CDotFeatures*) rhs), idx_b);
 		}
+
+		/** compute a block of dot products as one matrix product
+		 * block(i,j)=<lhs_{row_begin+i}, rhs_{col_begin+j}>
+		 *
+		 * requires has_dense_real_features(lhs, rhs)
+		 *
+		 * @param row_begin index of the first left-hand side vector
+		 * @param col_begin index of the first right-hand side vector
+		 * @param block pre-allocated output block
+		 */
+		void compute_dot_block(
+			index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block);
 };
 }
 #endif /* _DOTKERNEL_H__ */
@@ -8,11 +8,14 @@
 
 #include <shogun/lib/common.h>
 #include <shogun/kernel/GaussianKernel.h>
+#include <shogun/features/DenseFeatures.h>
 #include <shogun/features/DotFeatures.h>
 #include <shogun/distance/EuclideanDistance.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/eigen3.h>
 
 using namespace shogun;
+using namespace Eigen;
 
 CGaussianKernel::CGaussianKernel() : CShiftInvariantKernel()
 {
@@ -120,6 +123,43 @@ float64_t CGaussianKernel::compute(int32_t idx_a, int32_t idx_b)
 	return std::exp(-result);
 }
 
+bool CGaussianKernel::supports_kernel_block()
+{
+	// subclasses modify compute(), a precomputed distance replaces it
+	return get_kernel_type()==K_GAUSSIAN && !has_precomputed_distance() &&
+		get_distance_type()==D_EUCLIDEAN &&
+		has_dense_real_features(lhs, rhs);
+}
+
+void CGaussianKernel::compute_kernel_block(
+	index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block)
+{
+	SGMatrix<float64_t> lhs_matrix=get_dense_feature_matrix(lhs);
+	SGMatrix<float64_t> rhs_matrix=get_dense_feature_matrix(rhs);
+	ASSERT(lhs_matrix.matrix && rhs_matrix.matrix)
+
+	const index_t dim=lhs_matrix.num_rows;
+	Map<MatrixXd> x(lhs_matrix.matrix+int64_t(row_begin)*dim,
+		dim, block.num_rows);
+	Map<MatrixXd> y(rhs_matrix.matrix+int64_t(col_begin)*dim,
+		dim, block.num_cols);
+	Map<MatrixXd> values(block.matrix, block.num_rows, block.num_cols);
+
+	VectorXd x_norms=x.colwise().squaredNorm();
+	VectorXd y_norms=y.colwise().squaredNorm();
+	values.noalias()=x.transpose()*y;
+
+	// ||x-y||^2 = ||x||^2 + ||y||^2 - 2 x'y, as in CEuclideanDistance
+	for (index_t j=0; j<block.num_cols; j++)
+	{
+		for (index_t i=0; i<block.num_rows; i++)
+			values(i, j)=x_norms[i]+y_norms[j]-2*values(i, j);
+	}
+
+	// rounding may leave tiny negative distances
+	values=(-values.array().max(0.0)/get_width()).exp().matrix();
+}
+
 void CGaussianKernel::load_serializable_post() noexcept(false)
 {
 	CKernel::load_serializable_post();
@@ -151,6 +151,21 @@ protected:
 	 */
 	virtual float64_t compute(int32_t idx_a, int32_t idx_b);
 
+	/** @return whether blocks of the kernel matrix can be computed from
+	 * squared norms and a matrix product (dense real valued features on
+	 * both sides, no precomputed distance)
+	 */
+	virtual bool supports_kernel_block();
+
+	/** compute a block of kernel values as exp(-(||x||^2+||y||^2-2x'y)/width)
+	 *
+	 * @param row_begin index of the first left-hand side vector
+	 * @param col_begin index of the first right-hand side vector
+	 * @param block pre-allocated output block
+	 */
+	virtual void compute_kernel_block(
+		index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block);
+
 	/** compute the distance between features a and b
 	 * idx_{a,b} denote the index of the feature vectors
 	 * in the corresponding feature object
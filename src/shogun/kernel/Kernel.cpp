@@ -17,15 +17,18 @@
 #include <shogun/lib/config.h>
 
 #include <shogun/base/Parallel.h>
+#include <shogun/base/TaskScheduler.h>
 
 #include <shogun/kernel/Kernel.h>
 #include <shogun/kernel/normalizer/IdentityKernelNormalizer.h>
+#include <shogun/features/DenseFeatures.h>
 #include <shogun/features/Features.h>
 #include <shogun/base/Parameter.h>
 
 #include <shogun/classifier/svm/SVM.h>
 
 #include <string.h>
+#include <type_traits>
 #ifndef _WIN32
 #include <unistd.h>
 #endif
@@ -126,6 +129,7 @@ bool CKernel::init(CFeatures* l, CFeatures* r)
 
 	num_lhs=l->get_num_vectors();
 	num_rhs=r->get_num_vectors();
+	init_row_cache();
 
 	SG_DEBUG("leaving CKernel::init({}, {})", fmt::ptr(l), fmt::ptr(r))
 	return true;
@@ -139,6 +143,7 @@ bool CKernel::set_normalizer(CKernelNormalizer* n)
 
 	SG_UNREF(normalizer);
 	normalizer=n;
+	reset_row_cache();
 
 	return (normalizer!=NULL);
 }
@@ -151,6 +156,7 @@ CKernelNormalizer* CKernel::get_normalizer() const
 
 bool CKernel::init_normalizer()
 {
+	reset_row_cache();
 	return normalizer->init(this);
 }
 
@@ -159,6 +165,127 @@ void CKernel::cleanup()
 	remove_lhs_and_rhs();
 }
 
+/**************************** Row cache handling *****************************/
+
+void CKernel::init_row_cache()
+{
+	row_cache64.reset();
+	row_cache32.reset();
+
+	if (num_lhs>0 && num_rhs>0)
+	{
+		if (float32_row_cache)
+		{
+			row_cache32=std::make_unique<KernelRowCache<float32_t>>(
+				num_lhs, num_rhs, cache_size);
+		}
+		else
+		{
+			row_cache64=std::make_unique<KernelRowCache<float64_t>>(
+				num_lhs, num_rhs, cache_size);
+		}
+	}
+}
+
+namespace shogun
+{
+template <>
+KernelRowCache<float64_t>* CKernel::get_row_cache<float64_t>() const
+{
+	return row_cache64.get();
+}
+
+template <>
+KernelRowCache<float32_t>* CKernel::get_row_cache<float32_t>() const
+{
+	return row_cache32.get();
+}
+
+template <class T>
+typename KernelRowCache<T>::Row CKernel::get_cached_kernel_row(int32_t i)
+{
+	require(num_lhs>0 && num_rhs>0, "{}::get_cached_kernel_row(): No "
+			"features assigned to kernel", get_name());
+	require(float32_row_cache==std::is_same<T, float32_t>::value,
+			"{}::get_cached_kernel_row(): The row cache holds {} rows",
+			get_name(), float32_row_cache ? "float32" : "float64");
+
+	return get_row_cache<T>()->get_row(i, [this](index_t row, T* data)
+	{
+		for (int32_t j=0; j<num_rhs; j++)
+			data[j]=(T) kernel(row, j);
+	});
+}
+
+template KernelRowCache<float32_t>::Row CKernel::get_cached_kernel_row<float32_t>(int32_t i);
+template KernelRowCache<float64_t>::Row CKernel::get_cached_kernel_row<float64_t>(int32_t i);
+}
+
+void CKernel::set_float32_row_cache(bool float32)
+{
+	if (float32_row_cache==float32)
+		return;
+
+	float32_row_cache=float32;
+	init_row_cache();
+}
+
+bool CKernel::get_float32_row_cache() const
+{
+	return float32_row_cache;
+}
+
+void CKernel::cache_kernel_rows(SGVector<index_t> rows)
+{
+	for (index_t i=0; i<rows.vlen; i++)
+	{
+		require(rows[i]>=0 && rows[i]<num_lhs,
+			"{}::cache_kernel_rows(): Row index {} out of range [0, {})",
+			get_name(), rows[i], num_lhs);
+	}
+	require(num_lhs>0 && num_rhs>0, "{}::cache_kernel_rows(): No features "
+			"assigned to kernel", get_name());
+
+	parallel_for(0, rows.vlen, [this, &rows](index_t start, index_t end) {
+		for (index_t i=start; i<end; i++)
+		{
+			if (float32_row_cache)
+				get_cached_kernel_row<float32_t>(rows[i]);
+			else
+				get_cached_kernel_row<float64_t>(rows[i]);
+		}
+	}, 1);
+}
+
+void CKernel::reset_row_cache()
+{
+	if (row_cache64)
+		row_cache64->clear();
+	if (row_cache32)
+		row_cache32->clear();
+}
+
+int64_t CKernel::get_row_cache_hits() const
+{
+	if (row_cache32)
+		return row_cache32->get_hits();
+	return row_cache64 ? row_cache64->get_hits() : 0;
+}
+
+int64_t CKernel::get_row_cache_misses() const
+{
+	if (row_cache32)
+		return row_cache32->get_misses();
+	return row_cache64 ? row_cache64->get_misses() : 0;
+}
+
+int64_t CKernel::get_row_cache_evictions() const
+{
+	if (row_cache32)
+		return row_cache32->get_evictions();
+	return row_cache64 ? row_cache64->get_evictions() : 0;
+}
+
 #ifdef USE_SVMLIGHT
 /****************************** Cache handling *******************************/
 
@@ -222,63 +349,43 @@ void CKernel::kernel_cache_init(int32_t buffsize, bool regression_hack)
 void CKernel::get_kernel_row(
 	int32_t docnum, int32_t *active2dnum, float64_t *buffer, bool full_line)
 {
-	int32_t i,j;
-	KERNELCACHE_IDX start;
-
 	int32_t num_vectors = get_num_vec_lhs();
 	if (docnum>=num_vectors)
 		docnum=2*num_vectors-1-docnum;
 
+	int32_t num_entries=num_vectors;
+	if (!full_line)
+	{
+		num_entries=0;
+		while (active2dnum[num_entries]>=0)
+			num_entries++;
+	}
+
 	/* is cached? */
+	KERNELCACHE_IDX start=-1;
 	if(kernel_cache.index[docnum] != -1)
 	{
 		kernel_cache.lru[kernel_cache.index[docnum]]=kernel_cache.time; /* lru */
 		start=((KERNELCACHE_IDX) kernel_cache.activenum)*kernel_cache.index[docnum];
-
-		if (full_line)
-		{
-			for(j=0;j<get_num_vec_lhs();j++)
-			{
-				if(kernel_cache.totdoc2active[j] >= 0)
-					buffer[j]=kernel_cache.buffer[start+kernel_cache.totdoc2active[j]];
-				else
-					buffer[j]=(float64_t) kernel(docnum, j);
-			}
-		}
-		else
-		{
-			for(i=0;(j=active2dnum[i])>=0;i++)
-			{
-				if(kernel_cache.totdoc2active[j] >= 0)
-					buffer[j]=kernel_cache.buffer[start+kernel_cache.totdoc2active[j]];
-				else
-				{
-					int32_t k=j;
-					if (k>=num_vectors)
-						k=2*num_vectors-1-k;
-					buffer[j]=(float64_t) kernel(docnum, k);
-				}
-			}
-		}
 	}
-	else
-	{
-		if (full_line)
-		{
-			for(j=0;j<get_num_vec_lhs();j++)
-				buffer[j]=(KERNELCACHE_ELEM) kernel(docnum, j);
-		}
-		else
+
+	/* entries are independent, the cache is only read */
+	parallel_for(0, num_entries, [&](index_t first, index_t last) {
+		for (index_t i=first; i<last; i++)
 		{
-			for(i=0;(j=active2dnum[i])>=0;i++)
-			{
-				int32_t k=j;
-				if (k>=num_vectors)
-					k=2*num_vectors-1-k;
+			int32_t j=full_line ? i : active2dnum[i];
+			int32_t k=j;
+			if (k>=num_vectors)
+				k=2*num_vectors-1-k;
+
+			if (start<0)
 				buffer[j]=(KERNELCACHE_ELEM) kernel(docnum, k);
-			}
+			else if (kernel_cache.totdoc2active[j] >= 0)
+				buffer[j]=kernel_cache.buffer[start+kernel_cache.totdoc2active[j]];
+			else
+				buffer[j]=(float64_t) kernel(docnum, k);
 		}
-	}
+	}, 512);
 }
 
 
@@ -349,9 +456,6 @@ void* CKernel::cache_multiple_kernel_row_helper(void* p)
 					cache[j]=params->kernel->kernel(m, k);
 				}
 		}
-
-		//now line m is cached
-		params->needs_computation[m]=0;
 	}
 	return NULL;
 }
@@ -371,15 +475,11 @@ void CKernel::cache_multiple_kernel_rows(int32_t* rows, int32_t num_rows)
 		// fill up kernel cache
 		int32_t* uncached_rows = SG_MALLOC(int32_t, num_rows);
 		KERNELCACHE_ELEM** cache = SG_MALLOC(KERNELCACHE_ELEM*, num_rows);
-		S_KTHREAD_PARAM params;
-		int32_t num_threads=nthreads-1;
 		int32_t num_vec=get_num_vec_lhs();
 		ASSERT(num_vec>0)
 		uint8_t* needs_computation=SG_CALLOC(uint8_t, num_vec);
 
-		int32_t step=0;
 		int32_t num=0;
-		int32_t end=0;
 
 		// allocate cachelines if necessary
 		for (int32_t i=0; i<num_rows; i++)
@@ -401,49 +501,22 @@ void CKernel::cache_multiple_kernel_rows(int32_t* rows, int32_t num_rows)
 			num++;
 		}
 
-		if (num>0)
-		{
-			step = num/nthreads;
-
-			if (step<1)
-			{
-				num_threads=num-1;
-				step=1;
-			}
-
-			#pragma omp parallel for private(params)
-			for (int32_t t=0; t<num_threads; t++)
-			{
-				params.kernel = this;
-				params.kernel_cache = &kernel_cache;
-				params.cache = cache;
-				params.uncached_rows = uncached_rows;
-				params.needs_computation = needs_computation;
-				params.num_uncached = num;
-				params.start = t*step;
-				params.end = (t+1)*step;
-				params.num_vectors = get_num_vec_lhs();
-				end=params.end;
-
-				cache_multiple_kernel_row_helper(&params);
-			}
-		}
-		else
-			num_threads=-1;
-
-
-		S_KTHREAD_PARAM last_param;
-		last_param.kernel = this;
-		last_param.kernel_cache = &kernel_cache;
-		last_param.cache = cache;
-		last_param.uncached_rows = uncached_rows;
-		last_param.needs_computation = needs_computation;
-		last_param.start = end;
-		last_param.num_uncached = num;
-		last_param.end = num;
-		last_param.num_vectors = get_num_vec_lhs();
-
-		cache_multiple_kernel_row_helper(&last_param);
+		// rows are filled concurrently, so none of them is read from the
+		// cache before all of them are done
+		parallel_for(0, num, [&](index_t start, index_t end) {
+			S_KTHREAD_PARAM params;
+			params.kernel = this;
+			params.kernel_cache = &kernel_cache;
+			params.cache = cache;
+			params.uncached_rows = uncached_rows;
+			params.needs_computation = needs_computation;
+			params.num_uncached = num;
+			params.start = start;
+			params.end = end;
+			params.num_vectors = num_vec;
+
+			cache_multiple_kernel_row_helper(&params);
+		}, 1);
 
 		SG_FREE(needs_computation);
 		SG_FREE(cache);
@@ -629,6 +702,8 @@ void CKernel::remove_lhs_and_rhs()
 	lhs = NULL;
 	num_lhs=0;
 	lhs_equals_rhs=false;
+	row_cache64.reset();
+	row_cache32.reset();
 
 #ifdef USE_SVMLIGHT
 	cache_reset();
@@ -643,6 +718,8 @@ void CKernel::remove_lhs()
 	lhs = NULL;
 	num_lhs=0;
 	lhs_equals_rhs=false;
+	row_cache64.reset();
+	row_cache32.reset();
 #ifdef USE_SVMLIGHT
 	cache_reset();
 #endif //USE_SVMLIGHT
@@ -656,6 +733,8 @@ void CKernel::remove_rhs()
 	rhs = NULL;
 	num_rhs=0;
 	lhs_equals_rhs=false;
+	row_cache64.reset();
+	row_cache32.reset();
 
 #ifdef USE_SVMLIGHT
 	cache_reset();
@@ -759,6 +838,7 @@ void CKernel::list_kernel()
 		ENUM_CASE(C_MATRIX)
 		ENUM_CASE(C_FACTOR_GRAPH)
 		ENUM_CASE(C_INDEX)
+		ENUM_CASE(C_DISK_DENSE)
 		ENUM_CASE(C_SUB_SAMPLES_DENSE)
 		ENUM_CASE(C_ANY)
 	}
@@ -929,6 +1009,8 @@ void CKernel::register_params()
 	    &optimization_initialized, "optimization_initialized",
 	    "Optimization is initialized.");
 	SG_ADD(&properties, "properties", "Kernel properties.");
+	SG_ADD(&float32_row_cache, "float32_row_cache",
+		"If kernel rows are cached in single precision.");
 	SG_ADD(
 	    &normalizer, "normalizer", "Normalize the kernel.",
 	    ParameterProperties::HYPER);
@@ -954,6 +1036,11 @@ void CKernel::init()
 	opt_type=FASTBUTMEMHUNGRY;
 	properties=KP_NONE;
 	normalizer=NULL;
+#ifdef USE_SHORTREAL_KERNELCACHE
+	float32_row_cache=true;
+#else
+	float32_row_cache=false;
+#endif
 
 #ifdef USE_SVMLIGHT
 	memset(&kernel_cache, 0x0, sizeof(KERNEL_CACHE));
@@ -1303,6 +1390,68 @@ template <class T> void* CKernel::get_kernel_matrix_helper(void* p)
 	return NULL;
 }
 
+void CKernel::compute_kernel_block(
+	index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block)
+{
+	for (index_t j=0; j<block.num_cols; j++)
+	{
+		for (index_t i=0; i<block.num_rows; i++)
+			block(i, j)=compute(row_begin+i, col_begin+j);
+	}
+}
+
+template <class T>
+void CKernel::get_kernel_matrix_blocked(
+	T* result, int32_t m, int32_t n, bool symmetric)
+{
+	const index_t block_size=256;
+	const index_t num_row_blocks=(m+block_size-1)/block_size;
+	const index_t num_col_blocks=(n+block_size-1)/block_size;
+	const index_t num_blocks=num_row_blocks*num_col_blocks;
+	const bool normalize=
+		dynamic_cast<CIdentityKernelNormalizer*>(normalizer)==NULL;
+
+	SG_DEBUG("computing kernel matrix in {} blocks", num_blocks)
+
+	parallel_for(0, num_blocks, [&](index_t start, index_t end) {
+		SGMatrix<float64_t> buffer(block_size, block_size);
+
+		for (index_t b=start; b<end; b++)
+		{
+			index_t row_block=b%num_row_blocks;
+			index_t col_block=b/num_row_blocks;
+
+			// the lower triangle is mirrored from the upper one
+			if (symmetric && row_block>col_block)
+				continue;
+
+			index_t row_begin=row_block*block_size;
+			index_t col_begin=col_block*block_size;
+			SGMatrix<float64_t> block(buffer.matrix,
+				CMath::min(block_size, m-row_begin),
+				CMath::min(block_size, n-col_begin), false);
+
+			compute_kernel_block(row_begin, col_begin, block);
+
+			for (index_t j=0; j<block.num_cols; j++)
+			{
+				for (index_t i=0; i<block.num_rows; i++)
+				{
+					index_t r=row_begin+i;
+					index_t c=col_begin+j;
+					float64_t v=block(i, j);
+					if (normalize)
+						v=normalizer->normalize(v, r, c);
+
+					result[r+int64_t(c)*m]=v;
+					if (symmetric && row_block!=col_block)
+						result[c+int64_t(r)*m]=v;
+				}
+			}
+		}
+	}, 1);
+}
+
 template <class T>
 SGMatrix<T> CKernel::get_kernel_matrix()
 {
@@ -1322,41 +1471,29 @@ SGMatrix<T> CKernel::get_kernel_matrix()
 
 	result=SG_MALLOC(T, total_num);
 
-	int32_t num_threads=env()->get_num_threads();
-	K_THREAD_PARAM<T> params;
-	int64_t step = total_num/num_threads;
-	index_t t = 0;
-	auto pb = SG_PROGRESS(range(total_num));
-#pragma omp parallel for lastprivate(t) private(params)
-	for (t = 0; t < num_threads; ++t)
+	if (supports_kernel_block())
 	{
-		params.kernel = this;
-		params.result = result;
-		params.start = compute_row_start(t*step, n, symmetric);
-		params.end = compute_row_start((t+1)*step, n, symmetric);
-		params.total_start=t*step;
-		params.n=n;
-		params.m=m;
-		params.symmetric=symmetric;
-		params.verbose=false;
-		params.pb = &pb;
-		CKernel::get_kernel_matrix_helper<T>((void*)&params);
+		get_kernel_matrix_blocked<T>(result, m, n, symmetric);
+		return SGMatrix<T>(result,m,n,true);
 	}
 
-	if (total_num % num_threads != 0)
-	{
+	auto pb = SG_PROGRESS(range(total_num));
+	// rows of the symmetric case differ in length, small chunks let the
+	// scheduler balance them
+	parallel_for(0, m, [&](index_t start, index_t end) {
+		K_THREAD_PARAM<T> params;
 		params.kernel = this;
 		params.result = result;
-		params.start = compute_row_start(t*step, n, symmetric);
-		params.end = m;
-		params.total_start=t*step;
+		params.start = start;
+		params.end = end;
+		params.total_start = 0;
 		params.n=n;
 		params.m=m;
 		params.symmetric=symmetric;
 		params.verbose=false;
 		params.pb = &pb;
 		CKernel::get_kernel_matrix_helper<T>((void*)&params);
-	}
+	}, 16);
 
 	pb.complete();
 
@@ -21,8 +21,11 @@
 #include <shogun/base/SGObject.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/features/Features.h>
+#include <shogun/kernel/KernelRowCache.h>
 #include <shogun/kernel/normalizer/KernelNormalizer.h>
 
+#include <memory>
+
 namespace shogun
 {
 	class CFile;
@@ -146,6 +149,17 @@ class CSVM;
  * size of the kernel cache) that is used to efficiently train kernel-machines
  * like e.g. SVMs.
  *
+ * The kernel keeps rows of the kernel matrix in one of two caches:
+ * - the row cache (get_cached_kernel_row()) holds full rows, and is sharded
+ *   and safe for concurrent use. The LibSVM based solvers use it with
+ *   CLibSVM::set_use_kernel_row_cache().
+ * - the SVMLight kernel cache (USE_SVMLIGHT) holds the rows of SVMLight,
+ *   SVRLight and their MKL users, restricted to the active set, which
+ *   shrinks during training. Looking up and allocating its rows is not
+ *   thread-safe and is done by the solver's thread. Only the entries of
+ *   rows are computed in parallel, by cache_multiple_kernel_rows() and
+ *   get_kernel_row(). It is not backed by the row cache.
+ *
  * In case you would like to define your own kernel, you only have to define a
  * new compute() function (and the kernel name via get_name() and
  * the kernel type get_kernel_type()). A good example to look at is the
@@ -582,6 +596,7 @@ class CKernel : public CSGObject
 		inline void set_cache_size(int32_t size)
 		{
 			cache_size = size;
+			init_row_cache();
 #ifdef USE_SVMLIGHT
 			cache_reset();
 #endif //USE_SVMLIGHT
@@ -593,6 +608,63 @@ class CKernel : public CSGObject
 		 */
 		inline int32_t get_cache_size() { return cache_size; }
 
+#ifndef SWIG
+		/** get row i of the kernel matrix, i.e. kernel(i, j) for all
+		 * right-hand side vectors j, through the row cache.
+		 *
+		 * The row cache is sharded and safe for concurrent use, so several
+		 * threads may fetch (and compute) rows at the same time. The
+		 * returned handle keeps the row from being evicted while it is
+		 * alive.
+		 *
+		 * The element type has to match the precision of the row cache,
+		 * see set_float32_row_cache().
+		 *
+		 * SVMLight and the solvers based on it do not use this cache, see
+		 * the class documentation.
+		 *
+		 * @param i index of the left-hand side vector
+		 * @return handle to the cached row
+		 */
+		template <class T = KERNELCACHE_ELEM>
+		typename KernelRowCache<T>::Row get_cached_kernel_row(int32_t i);
+#endif // SWIG
+
+		/** choose the precision of the row cache of this kernel. A float32
+		 * cache holds twice as many rows in the same cache size, at the
+		 * cost of rounding the kernel values. Changing the precision drops
+		 * all cached rows. The LibSVM based solvers use the same precision
+		 * for their cache of Q rows. The default is float32 if shogun was
+		 * built with USE_SHORTREAL_KERNELCACHE.
+		 *
+		 * @param float32_row_cache whether rows are cached in single
+		 * precision
+		 */
+		void set_float32_row_cache(bool float32_row_cache);
+
+		/** @return whether rows are cached in single precision */
+		bool get_float32_row_cache() const;
+
+		/** compute and cache several kernel rows in parallel
+		 *
+		 * @param rows indices of the left-hand side vectors
+		 */
+		void cache_kernel_rows(SGVector<index_t> rows);
+
+		/** drop all rows from the row cache, e.g. after changing kernel
+		 * parameters
+		 */
+		void reset_row_cache();
+
+		/** @return number of row requests served from the row cache */
+		int64_t get_row_cache_hits() const;
+
+		/** @return number of row requests that required computing a row */
+		int64_t get_row_cache_misses() const;
+
+		/** @return number of rows evicted from the row cache */
+		int64_t get_row_cache_evictions() const;
+
 #ifdef USE_SVMLIGHT
 		/** cache reset */
 		inline void cache_reset() { resize_kernel_cache(cache_size); }
@@ -626,7 +698,8 @@ class CKernel : public CSGObject
 		 */
 		void cache_kernel_row(int32_t x);
 
-		/** cache multiple kernel rows
+		/** cache multiple kernel rows, computing their entries in parallel.
+		 * Must not be called concurrently with other kernel cache methods.
 		 *
 		 * @param key key
 		 * @param varnum
@@ -935,6 +1008,28 @@ class CKernel : public CSGObject
 		 */
 		template <class T> static void* get_kernel_matrix_helper(void* p);
 
+		/** whether the kernel can compute whole blocks of kernel values at
+		 * once through compute_kernel_block(), e.g. as a matrix product. If
+		 * so, get_kernel_matrix() builds the matrix tile by tile instead of
+		 * calling compute() for every entry.
+		 *
+		 * @return false, override in kernels that provide a block path
+		 */
+		virtual bool supports_kernel_block() { return false; }
+
+		/** compute a block of unnormalized kernel values
+		 * block(i,j)=compute(row_begin+i, col_begin+j)
+		 *
+		 * The base method calls compute() for every entry.
+		 *
+		 * @param row_begin index of the first left-hand side vector
+		 * @param col_begin index of the first right-hand side vector
+		 * @param block pre-allocated block, its size determines the number
+		 * of vectors on both sides
+		 */
+		virtual void compute_kernel_block(
+			index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block);
+
 		/** Can (optionally) be overridden to post-initialize some member
 		 *  variables which are not PARAMETER::ADD'ed.  Make sure that at
 		 *  first the overridden method BASE_CLASS::LOAD_SERIALIZABLE_POST
@@ -976,6 +1071,26 @@ class CKernel : public CSGObject
 		 * and registering parameters */
 		void init();
 
+		/** (re)create the row cache for the current features */
+		void init_row_cache();
+
+		/** @return the row cache of the given precision, nullptr if the
+		 * cache has the other precision or there are no features
+		 */
+		template <class T>
+		KernelRowCache<T>* get_row_cache() const;
+
+		/** compute the kernel matrix tile by tile via compute_kernel_block()
+		 *
+		 * @param result pre-allocated m x n matrix
+		 * @param m number of rows
+		 * @param n number of columns
+		 * @param symmetric whether k(i,j)=k(j,i) can be assumed
+		 */
+		template <class T>
+		void get_kernel_matrix_blocked(
+			T* result, int32_t m, int32_t n, bool symmetric);
+
 
 #ifdef USE_SVMLIGHT
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -1052,6 +1167,15 @@ class CKernel : public CSGObject
 		KERNEL_CACHE kernel_cache;
 #endif //USE_SVMLIGHT
 
+		/// whether the row cache holds float32 rows
+		bool float32_row_cache;
+
+		/// concurrent cache of kernel rows in double precision
+		std::unique_ptr<KernelRowCache<float64_t>> row_cache64;
+
+		/// concurrent cache of kernel rows in single precision
+		std::unique_ptr<KernelRowCache<float32_t>> row_cache32;
+
 		/// this *COULD* store the whole kernel matrix
 		/// usually not applicable / necessary to compute the whole matrix
 		KERNELCACHE_ELEM* kernel_matrix;
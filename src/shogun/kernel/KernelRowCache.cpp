@@ -0,0 +1,212 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/io/SGIO.h>
+#include <shogun/kernel/KernelRowCache.h>
+
+#include <algorithm>
+
+using namespace shogun;
+
+template <class T>
+KernelRowCache<T>::KernelRowCache(
+    index_t num_rows, index_t row_length, int64_t cache_size,
+    int32_t num_shards)
+    : m_num_rows(num_rows), m_row_length(row_length), m_hits(0),
+      m_misses(0), m_evictions(0)
+{
+	require(num_rows > 0, "Number of rows ({}) must be positive", num_rows);
+	require(
+	    row_length > 0, "Row length ({}) must be positive", row_length);
+
+	if (num_shards <= 0)
+		num_shards = 4 * env()->get_num_threads();
+
+	int64_t num_slots =
+	    cache_size * 1024 * 1024 / (int64_t(row_length) * sizeof(T));
+	num_slots = std::min(num_slots, int64_t(num_rows));
+	num_slots = std::max(num_slots, int64_t(1));
+
+	// every shard needs at least one slot
+	m_num_shards = int32_t(std::min(int64_t(num_shards), num_slots));
+
+	// rows are assigned round-robin, so does the remainder of slots
+	std::vector<int32_t> shard_slots(m_num_shards);
+	for (int32_t i = 0; i < m_num_shards; ++i)
+		shard_slots[i] =
+		    int32_t(num_slots / m_num_shards + (i < num_slots % m_num_shards));
+	m_shards = create_shards(shard_slots);
+
+	SG_DEBUG(
+	    "Kernel row cache with {} rows of length {} in {} shards", num_slots,
+	    row_length, m_num_shards);
+}
+
+template <class T>
+std::shared_ptr<typename KernelRowCache<T>::Shard[]>
+KernelRowCache<T>::create_shards(const std::vector<int32_t>& num_slots)
+{
+	std::shared_ptr<Shard[]> shards(new Shard[num_slots.size()]);
+	for (size_t i = 0; i < num_slots.size(); ++i)
+	{
+		Shard& shard = shards[i];
+		shard.num_slots = num_slots[i];
+		shard.slots = std::make_unique<Slot[]>(shard.num_slots);
+		shard.lookup.reserve(shard.num_slots);
+	}
+	return shards;
+}
+
+template <class T>
+typename KernelRowCache<T>::Row
+KernelRowCache<T>::get_row(index_t row, const RowFunction& compute)
+{
+	require(
+	    row >= 0 && row < m_num_rows, "Row index {} out of range [0, {})", row,
+	    m_num_rows);
+
+	Shard& shard = shard_of(row);
+	std::unique_lock<std::mutex> lock(shard.mutex);
+
+	// wait while another thread computes the row
+	for (auto it = shard.lookup.find(row); it != shard.lookup.end();
+	     it = shard.lookup.find(row))
+	{
+		Slot& slot = shard.slots[it->second];
+		if (slot.ready)
+		{
+			slot.referenced = true;
+			slot.pins.fetch_add(1, std::memory_order_acquire);
+			m_hits.fetch_add(1, std::memory_order_relaxed);
+			return Row(slot.data.get(), m_row_length, &slot.pins, m_shards);
+		}
+		shard.row_ready.wait(lock);
+	}
+
+	m_misses.fetch_add(1, std::memory_order_relaxed);
+
+	int32_t victim = find_victim(shard);
+	if (victim < 0)
+	{
+		// every slot is pinned, hand out a private copy
+		lock.unlock();
+		SGVector<T> owned(m_row_length);
+		compute(row, owned.vector);
+		return Row(owned);
+	}
+
+	Slot& slot = shard.slots[victim];
+	if (slot.row >= 0)
+	{
+		shard.lookup.erase(slot.row);
+		m_evictions.fetch_add(1, std::memory_order_relaxed);
+	}
+	if (!slot.data)
+		slot.data.reset(new T[m_row_length]);
+
+	slot.row = row;
+	slot.ready = false;
+	slot.referenced = true;
+	slot.pins.store(1, std::memory_order_relaxed);
+	shard.lookup[row] = victim;
+	lock.unlock();
+
+	try
+	{
+		compute(row, slot.data.get());
+	}
+	catch (...)
+	{
+		// free the slot again, find_victim() hands it out first
+		lock.lock();
+		shard.lookup.erase(row);
+		slot.row = -1;
+		slot.referenced = false;
+		slot.pins.store(0, std::memory_order_relaxed);
+		lock.unlock();
+		shard.row_ready.notify_all();
+		throw;
+	}
+
+	lock.lock();
+	slot.ready = true;
+	lock.unlock();
+	shard.row_ready.notify_all();
+
+	return Row(slot.data.get(), m_row_length, &slot.pins, m_shards);
+}
+
+template <class T>
+int32_t KernelRowCache<T>::find_victim(Shard& shard)
+{
+	if (shard.num_used < shard.num_slots)
+		return shard.num_used++;
+
+	// two sweeps: the first one may only clear reference bits
+	for (int32_t i = 0; i < 2 * shard.num_slots; ++i)
+	{
+		int32_t candidate = shard.hand;
+		shard.hand = (shard.hand + 1) % shard.num_slots;
+
+		Slot& slot = shard.slots[candidate];
+		if (slot.row < 0)
+			return candidate;
+
+		if (!slot.ready || slot.pins.load(std::memory_order_acquire) > 0)
+			continue;
+
+		if (slot.referenced)
+		{
+			slot.referenced = false;
+			continue;
+		}
+
+		return candidate;
+	}
+
+	return -1;
+}
+
+template <class T>
+bool KernelRowCache<T>::contains(index_t row)
+{
+	if (row < 0 || row >= m_num_rows)
+		return false;
+
+	Shard& shard = shard_of(row);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	auto it = shard.lookup.find(row);
+	return it != shard.lookup.end() && shard.slots[it->second].ready;
+}
+
+template <class T>
+void KernelRowCache<T>::clear()
+{
+	// pinned rows keep the old shards alive until they are released
+	std::vector<int32_t> shard_slots(m_num_shards);
+	for (int32_t i = 0; i < m_num_shards; ++i)
+		shard_slots[i] = m_shards[i].num_slots;
+	m_shards = create_shards(shard_slots);
+}
+
+template <class T>
+int64_t KernelRowCache<T>::get_capacity() const
+{
+	int64_t capacity = 0;
+	for (int32_t i = 0; i < m_num_shards; ++i)
+		capacity += m_shards[i].num_slots;
+	return capacity;
+}
+
+template <class T>
+void KernelRowCache<T>::reset_statistics()
+{
+	m_hits.store(0, std::memory_order_relaxed);
+	m_misses.store(0, std::memory_order_relaxed);
+	m_evictions.store(0, std::memory_order_relaxed);
+}
+
+template class shogun::KernelRowCache<float32_t>;
+template class shogun::KernelRowCache<float64_t>;
@@ -0,0 +1,307 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef _KERNEL_ROW_CACHE_H__
+#define _KERNEL_ROW_CACHE_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/base/macros.h>
+#include <shogun/lib/SGVector.h>
+#include <shogun/lib/common.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace shogun
+{
+/** @brief Thread-safe cache of kernel matrix rows.
+ *
+ * The rows are distributed over a number of independent shards by their
+ * index (row modulo number of shards). Every shard has its own lock and
+ * its own fixed number of row slots, and evicts using the CLOCK (second
+ * chance) policy, so threads requesting rows of different shards never
+ * contend.
+ *
+ * Rows are handed out as Row handles which pin the underlying slot: a
+ * pinned row is never evicted, so the data stays valid for as long as
+ * the handle lives. If several threads request the same missing row at
+ * the same time, it is computed only once and the other threads wait for
+ * the result.
+ *
+ * Memory for a slot is only allocated when the slot is used for the first
+ * time, so creating a cache is cheap. The handles share the ownership of
+ * the rows, so they stay valid after the cache is cleared or destroyed.
+ */
+template <class T>
+class KernelRowCache
+{
+private:
+	/** a cache line holding one row */
+	struct Slot
+	{
+		/** index of the cached row, -1 if unused */
+		index_t row = -1;
+		/** whether the row has been computed */
+		bool ready = false;
+		/** CLOCK reference bit */
+		bool referenced = false;
+		/** number of handles currently reading the row */
+		std::atomic<int32_t> pins = {0};
+		/** row data */
+		std::unique_ptr<T[]> data;
+	};
+
+	/** independently locked part of the cache */
+	struct Shard
+	{
+		/** guards all members but the slots' pin counts */
+		std::mutex mutex;
+		/** signalled whenever a row of this shard has been computed */
+		std::condition_variable row_ready;
+		/** maps row index to slot index */
+		std::unordered_map<index_t, int32_t> lookup;
+		/** row slots */
+		std::unique_ptr<Slot[]> slots;
+		/** number of slots */
+		int32_t num_slots = 0;
+		/** number of slots that have been handed out at least once */
+		int32_t num_used = 0;
+		/** CLOCK hand */
+		int32_t hand = 0;
+	};
+
+public:
+	/** function that writes row (first argument) to the buffer (second
+	 * argument) of length get_row_length()
+	 */
+	typedef std::function<void(index_t, T*)> RowFunction;
+
+	/** @brief Handle to a row of the cache.
+	 *
+	 * The row can not be evicted from the cache while a handle to it
+	 * exists. If the cache had no evictable slot left, the handle owns a
+	 * private copy of the row instead.
+	 */
+	class Row
+	{
+	public:
+		/** empty handle */
+		Row() : m_data(nullptr), m_length(0), m_pins(nullptr)
+		{
+		}
+
+		/** move constructor */
+		Row(Row&& other) noexcept
+		    : m_data(other.m_data), m_length(other.m_length),
+		      m_pins(other.m_pins), m_shards(std::move(other.m_shards)),
+		      m_owned(other.m_owned)
+		{
+			other.m_data = nullptr;
+			other.m_length = 0;
+			other.m_pins = nullptr;
+			other.m_owned = SGVector<T>();
+		}
+
+		/** move assignment */
+		Row& operator=(Row&& other) noexcept
+		{
+			if (this != &other)
+			{
+				release();
+				std::swap(m_data, other.m_data);
+				std::swap(m_length, other.m_length);
+				std::swap(m_pins, other.m_pins);
+				std::swap(m_shards, other.m_shards);
+				std::swap(m_owned, other.m_owned);
+			}
+			return *this;
+		}
+
+		SG_DELETE_COPY_AND_ASSIGN(Row);
+
+		/** destructor, unpins the row */
+		~Row()
+		{
+			release();
+		}
+
+		/** @return pointer to the row's elements */
+		const T* data() const
+		{
+			return m_data;
+		}
+
+		/** @return number of elements in the row */
+		index_t size() const
+		{
+			return m_length;
+		}
+
+		/** @return element j of the row */
+		T operator[](index_t j) const
+		{
+			return m_data[j];
+		}
+
+		/** @return whether the row lives in the cache (rather than being
+		 * a private copy because the cache was exhausted)
+		 */
+		bool is_cached() const
+		{
+			return m_pins != nullptr;
+		}
+
+	private:
+		friend class KernelRowCache<T>;
+
+		/** pinned cache row, which keeps the shards alive */
+		Row(const T* data, index_t length, std::atomic<int32_t>* pins,
+		    std::shared_ptr<Shard[]> shards)
+		    : m_data(data), m_length(length), m_pins(pins),
+		      m_shards(std::move(shards))
+		{
+		}
+
+		/** private copy of a row */
+		Row(SGVector<T> owned)
+		    : m_data(owned.vector), m_length(owned.vlen), m_pins(nullptr),
+		      m_owned(owned)
+		{
+		}
+
+		void release()
+		{
+			if (m_pins)
+				m_pins->fetch_sub(1, std::memory_order_release);
+			m_pins = nullptr;
+			m_shards.reset();
+			m_data = nullptr;
+			m_length = 0;
+			m_owned = SGVector<T>();
+		}
+
+		const T* m_data;
+		index_t m_length;
+		std::atomic<int32_t>* m_pins;
+		std::shared_ptr<Shard[]> m_shards;
+		SGVector<T> m_owned;
+	};
+
+	/** constructor
+	 *
+	 * @param num_rows number of distinct rows that may be requested
+	 * @param row_length number of elements in a row
+	 * @param cache_size size of the cache in MB
+	 * @param num_shards number of shards; 0 picks a number based on the
+	 * number of threads
+	 */
+	KernelRowCache(
+	    index_t num_rows, index_t row_length, int64_t cache_size,
+	    int32_t num_shards = 0);
+
+	SG_DELETE_COPY_AND_ASSIGN(KernelRowCache);
+
+	/** get a row, computing it via the passed function if it is not
+	 * cached. Safe to be called from several threads at the same time.
+	 *
+	 * @param row index of the row
+	 * @param compute function that computes the row if necessary
+	 * @return handle to the row
+	 */
+	Row get_row(index_t row, const RowFunction& compute);
+
+	/** @param row index of the row
+	 * @return whether the row is currently cached
+	 */
+	bool contains(index_t row);
+
+	/** drop all cached rows. Handles to rows stay valid. Must not be
+	 * called concurrently with get_row().
+	 */
+	void clear();
+
+	/** @return number of distinct rows */
+	index_t get_num_rows() const
+	{
+		return m_num_rows;
+	}
+
+	/** @return number of elements in a row */
+	index_t get_row_length() const
+	{
+		return m_row_length;
+	}
+
+	/** @return number of rows that fit into the cache */
+	int64_t get_capacity() const;
+
+	/** @return number of shards */
+	int32_t get_num_shards() const
+	{
+		return m_num_shards;
+	}
+
+	/** @return number of requests served from the cache */
+	int64_t get_hits() const
+	{
+		return m_hits.load(std::memory_order_relaxed);
+	}
+
+	/** @return number of requests that required computing a row */
+	int64_t get_misses() const
+	{
+		return m_misses.load(std::memory_order_relaxed);
+	}
+
+	/** @return number of rows that have been evicted */
+	int64_t get_evictions() const
+	{
+		return m_evictions.load(std::memory_order_relaxed);
+	}
+
+	/** reset hit, miss and eviction counters */
+	void reset_statistics();
+
+private:
+	/** @return shard responsible for the row */
+	Shard& shard_of(index_t row)
+	{
+		return m_shards[row % m_num_shards];
+	}
+
+	/** find a slot to (re)use with the CLOCK policy, shard must be locked
+	 *
+	 * @return slot index or -1 if all slots are pinned
+	 */
+	int32_t find_victim(Shard& shard);
+
+	/** @return new shards without rows, with the given number of slots
+	 * @param num_slots number of slots of every shard
+	 */
+	std::shared_ptr<Shard[]> create_shards(const std::vector<int32_t>& num_slots);
+
+	/** number of distinct rows */
+	index_t m_num_rows;
+	/** elements per row */
+	index_t m_row_length;
+	/** number of shards */
+	int32_t m_num_shards;
+	/** shards, shared with the pinned rows */
+	std::shared_ptr<Shard[]> m_shards;
+
+	/** cache hits */
+	std::atomic<int64_t> m_hits;
+	/** cache misses */
+	std::atomic<int64_t> m_misses;
+	/** evictions */
+	std::atomic<int64_t> m_evictions;
+};
+}
+#endif /* _KERNEL_ROW_CACHE_H__ */
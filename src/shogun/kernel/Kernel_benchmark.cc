@@ -0,0 +1,57 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <shogun/base/some.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/LinearKernel.h>
+#include <shogun/util/benchmark_data.h>
+
+namespace shogun
+{
+
+class KernelFixture : public benchmark::Fixture
+{
+public:
+	void SetUp(const ::benchmark::State& st)
+	{
+		feats = new CDenseFeatures<float64_t>(
+		    benchmark_gaussian_data(st.range(1), st.range(0)));
+		SG_REF(feats);
+	}
+
+	void TearDown(const ::benchmark::State&)
+	{
+		SG_UNREF(feats);
+	}
+
+	CDenseFeatures<float64_t>* feats;
+};
+
+BENCHMARK_DEFINE_F(KernelFixture, GaussianKernel_matrix)(benchmark::State& state)
+{
+	auto kernel = some<CGaussianKernel>(feats, feats, 1.0);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(kernel->get_kernel_matrix());
+
+	state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+}
+
+BENCHMARK_DEFINE_F(KernelFixture, LinearKernel_matrix)(benchmark::State& state)
+{
+	auto kernel = some<CLinearKernel>(feats, feats);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(kernel->get_kernel_matrix());
+
+	state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(KernelFixture, GaussianKernel_matrix)
+    ->RangeMultiplier(4)->Ranges(BENCHMARK_SMALL_SCALE)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(KernelFixture, LinearKernel_matrix)
+    ->RangeMultiplier(4)->Ranges(BENCHMARK_SMALL_SCALE)->Unit(benchmark::kMillisecond);
+
+}
@@ -7,6 +7,7 @@
 #include <shogun/lib/common.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/features/Features.h>
+#include <shogun/features/DenseFeatures.h>
 #include <shogun/features/DotFeatures.h>
 #include <shogun/kernel/LinearKernel.h>
 
@@ -44,6 +45,18 @@ void CLinearKernel::cleanup()
 	CKernel::cleanup();
 }
 
+bool CLinearKernel::supports_kernel_block()
+{
+	// subclasses may compute something else than a plain dot product
+	return get_kernel_type()==K_LINEAR && has_dense_real_features(lhs, rhs);
+}
+
+void CLinearKernel::compute_kernel_block(
+	index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block)
+{
+	compute_dot_block(row_begin, col_begin, block);
+}
+
 void CLinearKernel::add_to_normal(int32_t idx, float64_t weight)
 {
 	((CDotFeatures*) lhs)->add_to_dense_vec(
@@ -129,6 +129,21 @@ class CLinearKernel: public CDotKernel
 			this->normal = w;
 		}
 
+	protected:
+		/** @return whether blocks of the kernel matrix can be computed as
+		 * matrix products (dense real valued features on both sides)
+		 */
+		virtual bool supports_kernel_block();
+
+		/** compute a block of kernel values from one matrix product
+		 *
+		 * @param row_begin index of the first left-hand side vector
+		 * @param col_begin index of the first right-hand side vector
+		 * @param block pre-allocated output block
+		 */
+		virtual void compute_kernel_block(
+			index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block);
+
 	protected:
 		/** normal vector (used in case of optimized kernel) */
 		SGVector<float64_t> normal;
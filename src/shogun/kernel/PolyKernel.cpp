@@ -12,8 +12,10 @@
 #include <shogun/lib/auto_initialiser.h>
 #include <shogun/lib/common.h>
 #include <shogun/lib/config.h>
+#include <shogun/mathematics/eigen3.h>
 
 using namespace shogun;
+using namespace Eigen;
 
 CPolyKernel::CPolyKernel() : CDotKernel(0)
 {
@@ -66,6 +68,20 @@ float64_t CPolyKernel::compute(int32_t idx_a, int32_t idx_b)
 	return CMath::pow(result, degree);
 }
 
+bool CPolyKernel::supports_kernel_block()
+{
+	return get_kernel_type()==K_POLY && has_dense_real_features(lhs, rhs);
+}
+
+void CPolyKernel::compute_kernel_block(
+	index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block)
+{
+	compute_dot_block(row_begin, col_begin, block);
+
+	Map<ArrayXXd> values(block.matrix, block.num_rows, block.num_cols);
+	values=(m_gamma*values+m_c).pow(float64_t(degree));
+}
+
 void CPolyKernel::init()
 {
 	degree = 0;
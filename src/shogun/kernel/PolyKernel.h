@@ -95,6 +95,20 @@ class CPolyKernel: public CDotKernel
 		 */
 		virtual float64_t compute(int32_t idx_a, int32_t idx_b);
 
+		/** @return whether blocks of the kernel matrix can be computed as
+		 * matrix products (dense real valued features on both sides)
+		 */
+		virtual bool supports_kernel_block();
+
+		/** compute a block of kernel values from one matrix product
+		 *
+		 * @param row_begin index of the first left-hand side vector
+		 * @param col_begin index of the first right-hand side vector
+		 * @param block pre-allocated output block
+		 */
+		virtual void compute_kernel_block(
+			index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block);
+
 	private:
 		void init();
 
@@ -8,8 +8,10 @@
 #include <shogun/kernel/SigmoidKernel.h>
 #include <shogun/lib/auto_initialiser.h>
 #include <shogun/lib/common.h>
+#include <shogun/mathematics/eigen3.h>
 
 using namespace shogun;
+using namespace Eigen;
 
 CSigmoidKernel::CSigmoidKernel() : CDotKernel()
 {
@@ -52,6 +54,20 @@ bool CSigmoidKernel::init(CFeatures* l, CFeatures* r)
 	return init_normalizer();
 }
 
+bool CSigmoidKernel::supports_kernel_block()
+{
+	return get_kernel_type()==K_SIGMOID && has_dense_real_features(lhs, rhs);
+}
+
+void CSigmoidKernel::compute_kernel_block(
+	index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block)
+{
+	compute_dot_block(row_begin, col_begin, block);
+
+	Map<ArrayXXd> values(block.matrix, block.num_rows, block.num_cols);
+	values=(gamma*values+coef0).tanh();
+}
+
 void CSigmoidKernel::init()
 {
 	gamma = 0.0;
@@ -87,6 +87,20 @@ class CSigmoidKernel: public CDotKernel
 			return tanh(gamma*CDotKernel::compute(idx_a,idx_b)+coef0);
 		}
 
+		/** @return whether blocks of the kernel matrix can be computed as
+		 * matrix products (dense real valued features on both sides)
+		 */
+		virtual bool supports_kernel_block();
+
+		/** compute a block of kernel values from one matrix product
+		 *
+		 * @param row_begin index of the first left-hand side vector
+		 * @param col_begin index of the first right-hand side vector
+		 * @param block pre-allocated output block
+		 */
+		virtual void compute_kernel_block(
+			index_t row_begin, index_t col_begin, SGMatrix<float64_t>& block);
+
 	private:
 		void init();
 
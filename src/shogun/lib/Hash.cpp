@@ -10,8 +10,73 @@
 #include <shogun/lib/external/PMurHash.h>
 #include <ctype.h>
 
+#include <algorithm>
+#include <limits>
+
 using namespace shogun;
 
+namespace
+{
+const uint32_t murmur_c1=0xcc9e2d51;
+const uint32_t murmur_c2=0x1b873593;
+/** number of strings hashed in lockstep by BatchMurmurHash3 */
+const int32_t murmur_lanes=8;
+
+inline uint32_t murmur_rotl(uint32_t x, int32_t r)
+{
+	return (x << r) | (x >> (32 - r));
+}
+
+inline uint32_t murmur_read_block(const uint8_t* p)
+{
+	return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+inline uint32_t murmur_mix_block(uint32_t h, uint32_t k)
+{
+	k*=murmur_c1;
+	k=murmur_rotl(k, 15);
+	k*=murmur_c2;
+	h^=k;
+	h=murmur_rotl(h, 13);
+	return h*5+0xe6546b64;
+}
+
+/** hash the blocks from first_block on, the tail and finalize */
+uint32_t murmur_finish(uint32_t h, const uint8_t* data, int32_t len, int32_t first_block)
+{
+	const int32_t num_blocks=len/4;
+	for (int32_t b=first_block; b<num_blocks; b++)
+		h=murmur_mix_block(h, murmur_read_block(data+4*b));
+
+	const uint8_t* tail=data+4*num_blocks;
+	uint32_t k=0;
+	switch (len & 3)
+	{
+		case 3:
+			k^=uint32_t(tail[2]) << 16;
+			/* fall through */
+		case 2:
+			k^=uint32_t(tail[1]) << 8;
+			/* fall through */
+		case 1:
+			k^=tail[0];
+			k*=murmur_c1;
+			k=murmur_rotl(k, 15);
+			k*=murmur_c2;
+			h^=k;
+	}
+
+	h^=uint32_t(len);
+	h^=h >> 16;
+	h*=0x85ebca6b;
+	h^=h >> 13;
+	h*=0xc2b2ae35;
+	h^=h >> 16;
+	return h;
+}
+}
+
 uint32_t CHash::crc32(uint8_t *data, int32_t len)
 {
 	uint32_t result;
@@ -345,6 +410,40 @@ uint32_t CHash::MurmurHash3(uint8_t* data, int32_t len, uint32_t seed)
 	return PMurHash32(seed, data, len);
 }
 
+void CHash::BatchMurmurHash3(const uint8_t* data, const index_t* starts,
+		const index_t* ends, int32_t num, uint32_t seed, uint32_t* hashes)
+{
+	int32_t i=0;
+	for (; i+murmur_lanes<=num; i+=murmur_lanes)
+	{
+		uint32_t h[murmur_lanes];
+		uint32_t k[murmur_lanes];
+		const uint8_t* p[murmur_lanes];
+		int32_t common_blocks=std::numeric_limits<int32_t>::max();
+		for (int32_t l=0; l<murmur_lanes; l++)
+		{
+			h[l]=seed;
+			p[l]=data+starts[i+l];
+			common_blocks=std::min(common_blocks, int32_t(ends[i+l]-starts[i+l])/4);
+		}
+
+		// the blocks all strings of the group have, in lockstep
+		for (int32_t b=0; b<common_blocks; b++)
+		{
+			for (int32_t l=0; l<murmur_lanes; l++)
+				k[l]=murmur_read_block(p[l]+4*b);
+			for (int32_t l=0; l<murmur_lanes; l++)
+				h[l]=murmur_mix_block(h[l], k[l]);
+		}
+
+		for (int32_t l=0; l<murmur_lanes; l++)
+			hashes[i+l]=murmur_finish(h[l], p[l], ends[i+l]-starts[i+l], common_blocks);
+	}
+
+	for (; i<num; i++)
+		hashes[i]=murmur_finish(seed, data+starts[i], ends[i]-starts[i], 0);
+}
+
 void CHash::IncrementalMurmurHash3(uint32_t *ph1, uint32_t *pcarry, uint8_t* data, int32_t len)
 {
 	PMurHash32_Process(ph1, pcarry, data, len);
@@ -58,6 +58,23 @@ class CHash : public CSGObject
 		 */
 		static uint32_t MurmurHash3(uint8_t* data, int32_t len, uint32_t seed);
 
+		/** Murmur Hash3 of many byte strings of one buffer at once, equal
+		 * to calling MurmurHash3() on every string.
+		 *
+		 * The strings are hashed in groups, which run the block loops of
+		 * all strings of a group in lockstep, so that the arithmetic of
+		 * the group is done in SIMD lanes.
+		 *
+		 * @param data buffer holding the strings
+		 * @param starts index of the first byte of every string in data
+		 * @param ends index after the last byte of every string in data
+		 * @param num number of strings
+		 * @param seed initial seed
+		 * @param hashes array to store the num hashes in
+		 */
+		static void BatchMurmurHash3(const uint8_t* data, const index_t* starts,
+				const index_t* ends, int32_t num, uint32_t seed, uint32_t* hashes);
+
 		/** Incremental Murmur3 Hash. Wrapper for function in PMurHash.c
 		 * FinalizeIncrementalMurmurHash3 must be called
 		 * at the end of all incremental hashing to
@@ -19,6 +19,21 @@ void CTokenizer::set_text(SGVector<char> txt)
 	text = txt;
 }
 
+index_t CTokenizer::next_token_spans(std::vector<index_t>& starts,
+	std::vector<index_t>& ends)
+{
+	index_t num_tokens = 0;
+	while (has_next())
+	{
+		index_t start = 0;
+		index_t end = next_token_idx(start);
+		starts.push_back(start);
+		ends.push_back(end);
+		num_tokens++;
+	}
+	return num_tokens;
+}
+
 void CTokenizer::init()
 {
 	SG_ADD(&text, "text", "The text");
@@ -12,6 +12,8 @@
 #include <shogun/base/SGObject.h>
 #include <shogun/lib/SGVector.h>
 
+#include <vector>
+
 namespace shogun
 {
 class CSGObject;
@@ -54,6 +56,19 @@ public:
 	 */
 	virtual index_t next_token_idx(index_t& start)=0;
 
+#ifndef SWIG
+	/** Tokenizes the rest of the text at once, appending the indices
+	 * of every token, as returned by next_token_idx(), to starts and
+	 * ends. The tokens are not copied.
+	 *
+	 * @param starts tokens' starting indices
+	 * @param ends tokens' ending indices
+	 * @return number of tokens appended
+	 */
+	virtual index_t next_token_spans(std::vector<index_t>& starts,
+		std::vector<index_t>& ends);
+#endif // SWIG
+
 	/** Creates a copy of the appropriate runtime
 	 * instance of a CTokenizer subclass
 	 * Needs to be overriden
@@ -36,6 +36,7 @@
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
 #include <shogun/base/ShogunEnv.h>
+#include <shogun/base/TaskScheduler.h>
 #include <shogun/base/progress.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/kernel/Kernel.h>
@@ -52,12 +53,18 @@
 #include <string.h>
 #include <stdarg.h>
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include <rxcpp/rx.hpp>
 
 namespace shogun
 {
 
-typedef KERNELCACHE_ELEM Qfloat;
+// the solvers work on double precision rows, the cache may hold them in
+// single precision, see LibSVMKernel
+typedef float64_t Qfloat;
 typedef float64_t schar;
 
 template <class S, class T> inline void clone(T*& dst, S* src, int32_t n)
@@ -68,6 +75,32 @@ template <class S, class T> inline void clone(T*& dst, S* src, int32_t n)
 #define INF HUGE_VAL
 #define TAU 1e-12
 
+// Splits [0, n) into blocks of grain entries that are reduced in parallel
+// and combines the results of the blocks in index order, so that ties are
+// resolved exactly as by a serial loop
+template <class T, class Body, class Combine>
+static T ordered_reduce(
+	int32_t n, int32_t grain, const T& init, Body body, Combine combine)
+{
+	T result = init;
+	if (n <= grain)
+	{
+		body(0, n, result);
+		return result;
+	}
+
+	const int32_t num_blocks = (n+grain-1)/grain;
+	std::vector<T> results(num_blocks, init);
+	parallel_for(0, num_blocks, [&](index_t first, index_t last) {
+		for (index_t b=first; b<last; b++)
+			body(b*grain, std::min(n, (int32_t) (b+1)*grain), results[b]);
+	}, 1);
+
+	for (const auto& block : results)
+		combine(result, block);
+	return result;
+}
+
 class QMatrix;
 class SVC_QMC;
 
@@ -76,7 +109,9 @@ class SVC_QMC;
 //
 // l is the number of total data items
 // size is the cache size limit in bytes
+// T is the type of the cached entries
 //
+template <class T>
 class Cache
 {
 public:
@@ -86,7 +121,7 @@ public:
 	// request data [0,len)
 	// return some position p where [p,len) need to be filled
 	// (p >= len if nothing needs to be filled)
-	int32_t get_data(const int32_t index, Qfloat **data, int32_t len);
+	int32_t get_data(const int32_t index, T **data, int32_t len);
 	void swap_index(int32_t i, int32_t j);	// future_option
 
 private:
@@ -95,7 +130,7 @@ private:
 	struct head_t
 	{
 		head_t *prev, *next;	// a circular list
-		Qfloat *data;
+		T *data;
 		int32_t len;		// data[0,len) is cached in this entry
 	};
 
@@ -105,30 +140,34 @@ private:
 	void lru_insert(head_t *h);
 };
 
-Cache::Cache(int32_t l_, int64_t size_):l(l_),size(size_)
+template <class T>
+Cache<T>::Cache(int32_t l_, int64_t size_):l(l_),size(size_)
 {
 	head = (head_t *)SG_CALLOC(head_t, l);	// initialized to 0
-	size /= sizeof(Qfloat);
-	size -= l * sizeof(head_t) / sizeof(Qfloat);
+	size /= sizeof(T);
+	size -= l * sizeof(head_t) / sizeof(T);
 	size = CMath::max(size, (int64_t) 2*l);	// cache must be large enough for two columns
 	lru_head.next = lru_head.prev = &lru_head;
 }
 
-Cache::~Cache()
+template <class T>
+Cache<T>::~Cache()
 {
 	for(head_t *h = lru_head.next; h != &lru_head; h=h->next)
 		SG_FREE(h->data);
 	SG_FREE(head);
 }
 
-void Cache::lru_delete(head_t *h)
+template <class T>
+void Cache<T>::lru_delete(head_t *h)
 {
 	// delete from current location
 	h->prev->next = h->next;
 	h->next->prev = h->prev;
 }
 
-void Cache::lru_insert(head_t *h)
+template <class T>
+void Cache<T>::lru_insert(head_t *h)
 {
 	// insert to last position
 	h->next = &lru_head;
@@ -137,7 +176,8 @@ void Cache::lru_insert(head_t *h)
 	h->next->prev = h;
 }
 
-int32_t Cache::get_data(const int32_t index, Qfloat **data, int32_t len)
+template <class T>
+int32_t Cache<T>::get_data(const int32_t index, T **data, int32_t len)
 {
 	head_t *h = &head[index];
 	if(h->len) lru_delete(h);
@@ -157,7 +197,7 @@ int32_t Cache::get_data(const int32_t index, Qfloat **data, int32_t len)
 		}
 
 		// allocate new space
-		h->data = SG_REALLOC(Qfloat, h->data, h->len, len);
+		h->data = SG_REALLOC(T, h->data, h->len, len);
 		size -= more;
 		CMath::swap(h->len,len);
 	}
@@ -167,7 +207,8 @@ int32_t Cache::get_data(const int32_t index, Qfloat **data, int32_t len)
 	return len;
 }
 
-void Cache::swap_index(int32_t i, int32_t j)
+template <class T>
+void Cache<T>::swap_index(int32_t i, int32_t j)
 {
 	if(i==j) return;
 
@@ -232,17 +273,26 @@ public:
 
 	void compute_Q_parallel(Qfloat* data, float64_t* lab, int32_t i, int32_t start, int32_t len) const
 	{
-		if (lab) // two class
+		if (use_kernel_row_cache)
 		{
-			#pragma omp parallel for
-			for(int32_t j=start;j<len;j++)
-				data[j] = (Qfloat) lab[i]*lab[j]*this->kernel_function(i,j);
+			if (kernel->get_float32_row_cache())
+				gather_Q<float32_t>(data, lab, i, start, len);
+			else
+				gather_Q<float64_t>(data, lab, i, start, len);
+		}
+		else if (lab) // two class
+		{
+			parallel_for(start, len, [&](index_t first, index_t last) {
+				for(index_t j=first;j<last;j++)
+					data[j] = (Qfloat) lab[i]*lab[j]*this->kernel_function(i,j);
+			}, 256);
 		}
 		else // one class, eps svr
 		{
-			#pragma omp parallel for
-			for(int32_t j=start;j<len;j++)
-				data[j] = (Qfloat) this->kernel_function(i,j);
+			parallel_for(start, len, [&](index_t first, index_t last) {
+				for(index_t j=first;j<last;j++)
+					data[j] = (Qfloat) this->kernel_function(i,j);
+			}, 256);
 		}
 	}
 
@@ -251,10 +301,97 @@ public:
 		return kernel->kernel(x[i]->index,x[j]->index);
 	}
 
+	// entries [start,len) of Q row i from the kernel's shared row cache,
+	// which other solvers using the same kernel fill as well
+	template <class T>
+	void gather_Q(Qfloat* data, float64_t* lab, int32_t i, int32_t start, int32_t len) const
+	{
+		auto row = kernel->get_cached_kernel_row<T>(x[i]->index);
+		for(int32_t j=start;j<len;j++)
+		{
+			data[j] = row[x[j]->index];
+			if (lab)
+				data[j] *= lab[i]*lab[j];
+		}
+	}
+
+protected:
+	// create the cache of the rows, in single precision if the kernel's
+	// row cache is, see CKernel::set_float32_row_cache()
+	void init_cache(int32_t l, int64_t size);
+
+	// row i of the cache with [0,len) valid, compute(data, start, len)
+	// fills the entries [start,len) that are not cached yet. float32 rows
+	// are returned as a copy in one of two buffers, so that two rows may
+	// be used at the same time as with the double precision cache. A
+	// buffer that still holds the row only gets the entries it misses
+	template <class F>
+	Qfloat* get_cached_row(int32_t i, int32_t len, F compute) const
+	{
+		Qfloat* data;
+		int32_t start;
+		if (!cache32)
+		{
+			if((start = cache64->get_data(i,&data,len)) < len)
+				compute(data, start, len);
+			return data;
+		}
+
+		int32_t b = row_buffer_row[0] == i ? 0 :
+			(row_buffer_row[1] == i ? 1 : next_row_buffer);
+		if (row_buffer_row[b] != i)
+		{
+			row_buffer_row[b] = i;
+			row_buffer_len[b] = 0;
+		}
+		next_row_buffer = 1 - b;
+		data = row_buffer[b];
+
+		float32_t* data32;
+		if((start = cache32->get_data(i,&data32,len)) < len)
+		{
+			compute(data, start, len);
+			for(int32_t j=start;j<len;j++)
+				data32[j] = (float32_t) data[j];
+		}
+		for(int32_t j=CMath::min(start, row_buffer_len[b]);j<len;j++)
+			data[j] = data32[j];
+		row_buffer_len[b] = CMath::max(row_buffer_len[b], len);
+		return data;
+	}
+
+	void swap_cache_index(int32_t i, int32_t j) const
+	{
+		if (cache32)
+		{
+			cache32->swap_index(i,j);
+			// the buffered rows have their entries in the old order
+			row_buffer_row[0] = -1;
+			row_buffer_row[1] = -1;
+		}
+		else
+			cache64->swap_index(i,j);
+	}
+
+	// a value rounded to the precision of the cache
+	inline Qfloat to_cache_precision(float64_t value) const
+	{
+		return cache32 ? (Qfloat) (float32_t) value : value;
+	}
+
 private:
 	CKernel* kernel;
 	const svm_node **x;
 	float64_t *x_square;
+
+	Cache<Qfloat>* cache64;
+	Cache<float32_t>* cache32;
+	Qfloat* row_buffer[2];
+	// row held by each buffer, -1 if none, and its number of valid entries
+	mutable int32_t row_buffer_row[2];
+	mutable int32_t row_buffer_len[2];
+	mutable int32_t next_row_buffer;
+	bool use_kernel_row_cache;
 };
 
 LibSVMKernel::LibSVMKernel(int32_t l, svm_node * const * x_, const svm_parameter& param)
@@ -263,12 +400,44 @@ LibSVMKernel::LibSVMKernel(int32_t l, svm_node * const * x_, const svm_parameter
 	x_square = 0;
 	kernel=param.kernel;
 	max_train_time=param.max_train_time;
+	use_kernel_row_cache=param.use_kernel_row_cache;
+	cache64 = NULL;
+	cache32 = NULL;
+	row_buffer[0] = NULL;
+	row_buffer[1] = NULL;
+	for (int32_t b=0; b<2; b++)
+	{
+		row_buffer_row[b] = -1;
+		row_buffer_len[b] = 0;
+	}
+	next_row_buffer = 0;
 }
 
 LibSVMKernel::~LibSVMKernel()
 {
 	SG_FREE(x);
 	SG_FREE(x_square);
+	delete cache64;
+	delete cache32;
+	SG_FREE(row_buffer[0]);
+	SG_FREE(row_buffer[1]);
+}
+
+void LibSVMKernel::init_cache(int32_t l, int64_t size)
+{
+	// the rows come from the kernel's row cache, which has the memory
+	// budget for all solvers, so only keep the two columns used at a time
+	if (use_kernel_row_cache)
+		size = 0;
+
+	if (kernel->get_float32_row_cache())
+	{
+		cache32 = new Cache<float32_t>(l, size);
+		row_buffer[0] = SG_MALLOC(Qfloat, l);
+		row_buffer[1] = SG_MALLOC(Qfloat, l);
+	}
+	else
+		cache64 = new Cache<Qfloat>(l, size);
 }
 
 // Generalized SMO+SVMlight algorithm
@@ -291,9 +460,15 @@ LibSVMKernel::~LibSVMKernel()
 //
 class Solver {
 public:
-	Solver() : m_cancel_computation(false){};
+	Solver() : m_cancel_computation(false), grain(LIBSVM_PARALLEL_GRAIN) {};
 	virtual ~Solver() {};
 
+	/** set the minimum number of examples per task of the parallel loops */
+	void set_parallel_grain(int32_t p_grain)
+	{
+		grain = p_grain;
+	}
+
 	struct SolutionInfo {
 		float64_t obj;
 		float64_t rho;
@@ -324,6 +499,7 @@ protected:
 	int32_t l;
 	bool unshrink;	// XXX
 	std::atomic<bool> m_cancel_computation;
+	int32_t grain;	// minimum number of examples per parallel task
 
 	float64_t get_C(int32_t i)
 	{
@@ -435,8 +611,10 @@ void Solver::reconstruct_gradient()
 			{
 				const Qfloat *Q_i = Q->get_Q(i,l);
 				float64_t alpha_i = alpha[i];
-				for(j=active_size;j<l;j++)
-					G[j] += alpha_i * Q_i[j];
+				parallel_for(active_size, l, [&](index_t start, index_t end) {
+					for(index_t k=start;k<end;k++)
+						G[k] += alpha_i * Q_i[k];
+				}, grain);
 			}
 	}
 }
@@ -494,12 +672,15 @@ void Solver::Solve(
 			{
 				const Qfloat *Q_i = Q->get_Q(i,l);
 				float64_t alpha_i = alpha[i];
-				int32_t j;
-				for(j=0;j<l;j++)
-					G[j] += alpha_i*Q_i[j];
-				if(is_upper_bound(i))
-					for(j=0;j<l;j++)
-						G_bar[j] += get_C(i) * Q_i[j];
+				bool upper_bound_i = is_upper_bound(i);
+				float64_t C_i = get_C(i);
+				parallel_for(0, l, [&](index_t start, index_t end) {
+					for(index_t j=start;j<end;j++)
+						G[j] += alpha_i*Q_i[j];
+					if(upper_bound_i)
+						for(index_t j=start;j<end;j++)
+							G_bar[j] += C_i * Q_i[j];
+				}, grain);
 			}
 			pb.print_progress();
 		}
@@ -668,10 +849,10 @@ void Solver::Solve(
 		float64_t delta_alpha_i = alpha[i] - old_alpha_i;
 		float64_t delta_alpha_j = alpha[j] - old_alpha_j;
 
-		for(int32_t k=0;k<active_size;k++)
-		{
-			G[k] += Q_i[k]*delta_alpha_i + Q_j[k]*delta_alpha_j;
-		}
+		parallel_for(0, active_size, [&](index_t start, index_t end) {
+			for(index_t k=start;k<end;k++)
+				G[k] += Q_i[k]*delta_alpha_i + Q_j[k]*delta_alpha_j;
+		}, grain);
 
 		// update alpha_status and G_bar
 
@@ -680,27 +861,24 @@ void Solver::Solve(
 			bool uj = is_upper_bound(j);
 			update_alpha_status(i);
 			update_alpha_status(j);
-			int32_t k;
 			if(ui != is_upper_bound(i))
 			{
 				Q_i = Q->get_Q(i,l);
-				if(ui)
-					for(k=0;k<l;k++)
-						G_bar[k] -= C_i * Q_i[k];
-				else
-					for(k=0;k<l;k++)
-						G_bar[k] += C_i * Q_i[k];
+				float64_t delta_C_i = ui ? -C_i : C_i;
+				parallel_for(0, l, [&](index_t start, index_t end) {
+					for(index_t k=start;k<end;k++)
+						G_bar[k] += delta_C_i * Q_i[k];
+				}, grain);
 			}
 
 			if(uj != is_upper_bound(j))
 			{
 				Q_j = Q->get_Q(j,l);
-				if(uj)
-					for(k=0;k<l;k++)
-						G_bar[k] -= C_j * Q_j[k];
-				else
-					for(k=0;k<l;k++)
-						G_bar[k] += C_j * Q_j[k];
+				float64_t delta_C_j = uj ? -C_j : C_j;
+				parallel_for(0, l, [&](index_t start, index_t end) {
+					for(index_t k=start;k<end;k++)
+						G_bar[k] += delta_C_j * Q_j[k];
+				}, grain);
 			}
 		}
 
@@ -771,88 +949,110 @@ int32_t Solver::select_working_set(
 	//    (if quadratic coefficient <= 0, replace it with tau)
 	//    -y_j*grad(f)_j < -y_i*grad(f)_i, j in I_low(\alpha)
 
-	float64_t Gmax = -INF;
-	float64_t Gmax2 = -INF;
-	int32_t Gmax_idx = -1;
-	int32_t Gmin_idx = -1;
-	float64_t obj_diff_min = INF;
-
-	for(int32_t t=0;t<active_size;t++)
-		if(y[t]==+1)
-		{
-			if(!is_upper_bound(t))
-				if(-G[t] >= Gmax)
+	// both loops are reductions over the active set, which run in
+	// parallel for large active sets
+	struct max_violation { float64_t Gmax; int32_t idx; };
+	max_violation up = ordered_reduce(active_size, grain, max_violation{-INF, -1},
+		[&](int32_t start, int32_t end, max_violation& r) {
+			for(int32_t t=start;t<end;t++)
+				if(y[t]==+1)
 				{
-					Gmax = -G[t];
-					Gmax_idx = t;
+					if(!is_upper_bound(t))
+						if(-G[t] >= r.Gmax)
+						{
+							r.Gmax = -G[t];
+							r.idx = t;
+						}
 				}
-		}
-		else
-		{
-			if(!is_lower_bound(t))
-				if(G[t] >= Gmax)
+				else
 				{
-					Gmax = G[t];
-					Gmax_idx = t;
+					if(!is_lower_bound(t))
+						if(G[t] >= r.Gmax)
+						{
+							r.Gmax = G[t];
+							r.idx = t;
+						}
 				}
-		}
+		},
+		[](max_violation& r, const max_violation& block) {
+			if(block.idx != -1 && block.Gmax >= r.Gmax)
+				r = block;
+		});
+
+	float64_t Gmax = up.Gmax;
+	int32_t Gmax_idx = up.idx;
 
 	int32_t i = Gmax_idx;
 	const Qfloat *Q_i = NULL;
 	if(i != -1) // NULL Q_i not accessed: Gmax=-INF if i=-1
 		Q_i = Q->get_Q(i,active_size);
 
-	for(int32_t j=0;j<active_size;j++)
-	{
-		if(y[j]==+1)
-		{
-			if (!is_lower_bound(j))
+	struct min_obj_diff { float64_t Gmax2; float64_t obj_diff_min; int32_t idx; };
+	min_obj_diff low = ordered_reduce(active_size, grain, min_obj_diff{-INF, INF, -1},
+		[&](int32_t start, int32_t end, min_obj_diff& r) {
+			for(int32_t j=start;j<end;j++)
 			{
-				float64_t grad_diff=Gmax+G[j];
-				if (G[j] >= Gmax2)
-					Gmax2 = G[j];
-				if (grad_diff > 0)
+				if(y[j]==+1)
 				{
-					float64_t obj_diff;
-					float64_t quad_coef=Q_i[i]+QD[j]-2.0*y[i]*Q_i[j];
-					if (quad_coef > 0)
-						obj_diff = -(grad_diff*grad_diff)/quad_coef;
-					else
-						obj_diff = -(grad_diff*grad_diff)/TAU;
-
-					if (obj_diff <= obj_diff_min)
+					if (!is_lower_bound(j))
 					{
-						Gmin_idx=j;
-						obj_diff_min = obj_diff;
+						float64_t grad_diff=Gmax+G[j];
+						if (G[j] >= r.Gmax2)
+							r.Gmax2 = G[j];
+						if (grad_diff > 0)
+						{
+							float64_t obj_diff;
+							float64_t quad_coef=Q_i[i]+QD[j]-2.0*y[i]*Q_i[j];
+							if (quad_coef > 0)
+								obj_diff = -(grad_diff*grad_diff)/quad_coef;
+							else
+								obj_diff = -(grad_diff*grad_diff)/TAU;
+
+							if (obj_diff <= r.obj_diff_min)
+							{
+								r.idx=j;
+								r.obj_diff_min = obj_diff;
+							}
+						}
 					}
 				}
-			}
-		}
-		else
-		{
-			if (!is_upper_bound(j))
-			{
-				float64_t grad_diff= Gmax-G[j];
-				if (-G[j] >= Gmax2)
-					Gmax2 = -G[j];
-				if (grad_diff > 0)
+				else
 				{
-					float64_t obj_diff;
-					float64_t quad_coef=Q_i[i]+QD[j]+2.0*y[i]*Q_i[j];
-					if (quad_coef > 0)
-						obj_diff = -(grad_diff*grad_diff)/quad_coef;
-					else
-						obj_diff = -(grad_diff*grad_diff)/TAU;
-
-					if (obj_diff <= obj_diff_min)
+					if (!is_upper_bound(j))
 					{
-						Gmin_idx=j;
-						obj_diff_min = obj_diff;
+						float64_t grad_diff= Gmax-G[j];
+						if (-G[j] >= r.Gmax2)
+							r.Gmax2 = -G[j];
+						if (grad_diff > 0)
+						{
+							float64_t obj_diff;
+							float64_t quad_coef=Q_i[i]+QD[j]+2.0*y[i]*Q_i[j];
+							if (quad_coef > 0)
+								obj_diff = -(grad_diff*grad_diff)/quad_coef;
+							else
+								obj_diff = -(grad_diff*grad_diff)/TAU;
+
+							if (obj_diff <= r.obj_diff_min)
+							{
+								r.idx=j;
+								r.obj_diff_min = obj_diff;
+							}
+						}
 					}
 				}
 			}
-		}
-	}
+		},
+		[](min_obj_diff& r, const min_obj_diff& block) {
+			r.Gmax2 = CMath::max(r.Gmax2, block.Gmax2);
+			if(block.idx != -1 && block.obj_diff_min <= r.obj_diff_min)
+			{
+				r.idx = block.idx;
+				r.obj_diff_min = block.obj_diff_min;
+			}
+		});
+
+	float64_t Gmax2 = low.Gmax2;
+	int32_t Gmin_idx = low.idx;
 
 	gap=Gmax+Gmax2;
 	if(gap < eps)
@@ -1287,31 +1487,28 @@ public:
 		nr_class=n_class;
 		factor=fac;
 		clone(y,y_,prob.l);
-		cache = new Cache(prob.l,(int64_t)(param.cache_size*(1l<<20)));
+		init_cache(prob.l,(int64_t)(param.cache_size*(1l<<20)));
 		QD = SG_MALLOC(Qfloat, prob.l);
 		for(int32_t i=0;i<prob.l;i++)
 		{
-			QD[i]= factor*(nr_class-1)*kernel_function(i,i);
+			QD[i]= to_cache_precision(factor*(nr_class-1)*kernel_function(i,i));
 		}
 	}
 
 	Qfloat *get_Q(int32_t i, int32_t len) const
 	{
-		Qfloat *data;
-		int32_t start;
-		if((start = cache->get_data(i,&data,len)) < len)
-		{
-			compute_Q_parallel(data, NULL, i, start, len);
+		return get_cached_row(i, len, [&](Qfloat* data, int32_t start, int32_t end) {
+			compute_Q_parallel(data, NULL, i, start, end);
 
-			for(int32_t j=start;j<len;j++)
+			for(int32_t j=start;j<end;j++)
 			{
+				data[j] = to_cache_precision(data[j]);
 				if (y[i]==y[j])
 					data[j] *= (factor*(nr_class-1));
 				else
 					data[j] *= (-factor);
 			}
-		}
-		return data;
+		});
 	}
 
 	inline Qfloat get_orig_Qij(Qfloat Q, int32_t i, int32_t j)
@@ -1329,7 +1526,7 @@ public:
 
 	void swap_index(int32_t i, int32_t j) const
 	{
-		cache->swap_index(i,j);
+		swap_cache_index(i,j);
 		LibSVMKernel::swap_index(i,j);
 		CMath::swap(y[i],y[j]);
 		CMath::swap(QD[i],QD[j]);
@@ -1338,14 +1535,12 @@ public:
 	~SVC_QMC()
 	{
 		SG_FREE(y);
-		delete cache;
 		SG_FREE(QD);
 	}
 private:
 	float64_t factor;
 	float64_t nr_class;
 	schar *y;
-	Cache *cache;
 	Qfloat *QD;
 };
 
@@ -1667,20 +1862,17 @@ public:
 	:LibSVMKernel(prob.l, prob.x, param)
 	{
 		clone(y,y_,prob.l);
-		cache = new Cache(prob.l,(int64_t)(param.cache_size*(1l<<20)));
+		init_cache(prob.l,(int64_t)(param.cache_size*(1l<<20)));
 		QD = SG_MALLOC(Qfloat, prob.l);
 		for(int32_t i=0;i<prob.l;i++)
-			QD[i]= (Qfloat)kernel_function(i,i);
+			QD[i]= to_cache_precision(kernel_function(i,i));
 	}
 
 	Qfloat *get_Q(int32_t i, int32_t len) const
 	{
-		Qfloat *data;
-		int32_t start;
-		if((start = cache->get_data(i,&data,len)) < len)
-			compute_Q_parallel(data, y, i, start, len);
-
-		return data;
+		return get_cached_row(i, len, [&](Qfloat* data, int32_t start, int32_t end) {
+			compute_Q_parallel(data, y, i, start, end);
+		});
 	}
 
 	Qfloat *get_QD() const
@@ -1690,7 +1882,7 @@ public:
 
 	void swap_index(int32_t i, int32_t j) const
 	{
-		cache->swap_index(i,j);
+		swap_cache_index(i,j);
 		LibSVMKernel::swap_index(i,j);
 		CMath::swap(y[i],y[j]);
 		CMath::swap(QD[i],QD[j]);
@@ -1699,12 +1891,10 @@ public:
 	~SVC_Q()
 	{
 		SG_FREE(y);
-		delete cache;
 		SG_FREE(QD);
 	}
 private:
 	schar *y;
-	Cache *cache;
 	Qfloat *QD;
 };
 
@@ -1715,20 +1905,17 @@ public:
 	ONE_CLASS_Q(const svm_problem& prob, const svm_parameter& param)
 	:LibSVMKernel(prob.l, prob.x, param)
 	{
-		cache = new Cache(prob.l,(int64_t)(param.cache_size*(1l<<20)));
+		init_cache(prob.l,(int64_t)(param.cache_size*(1l<<20)));
 		QD = SG_MALLOC(Qfloat, prob.l);
 		for(int32_t i=0;i<prob.l;i++)
-			QD[i]= (Qfloat)kernel_function(i,i);
+			QD[i]= to_cache_precision(kernel_function(i,i));
 	}
 
 	Qfloat *get_Q(int32_t i, int32_t len) const
 	{
-		Qfloat *data;
-		int32_t start;
-		if((start = cache->get_data(i,&data,len)) < len)
-			compute_Q_parallel(data, NULL, i, start, len);
-
-		return data;
+		return get_cached_row(i, len, [&](Qfloat* data, int32_t start, int32_t end) {
+			compute_Q_parallel(data, NULL, i, start, end);
+		});
 	}
 
 	Qfloat *get_QD() const
@@ -1738,18 +1925,16 @@ public:
 
 	void swap_index(int32_t i, int32_t j) const
 	{
-		cache->swap_index(i,j);
+		swap_cache_index(i,j);
 		LibSVMKernel::swap_index(i,j);
 		CMath::swap(QD[i],QD[j]);
 	}
 
 	~ONE_CLASS_Q()
 	{
-		delete cache;
 		SG_FREE(QD);
 	}
 private:
-	Cache *cache;
 	Qfloat *QD;
 };
 
@@ -1760,7 +1945,7 @@ public:
 	:LibSVMKernel(prob.l, prob.x, param)
 	{
 		l = prob.l;
-		cache = new Cache(l,(int64_t)(param.cache_size*(1l<<20)));
+		init_cache(l,(int64_t)(param.cache_size*(1l<<20)));
 		QD = SG_MALLOC(Qfloat, 2*l);
 		sign = SG_MALLOC(schar, 2*l);
 		index = SG_MALLOC(int32_t, 2*l);
@@ -1770,7 +1955,7 @@ public:
 			sign[k+l] = -1;
 			index[k] = k;
 			index[k+l] = k;
-			QD[k]= (Qfloat)kernel_function(k,k);
+			QD[k]= to_cache_precision(kernel_function(k,k));
 			QD[k+l]=QD[k];
 		}
 		buffer[0] = SG_MALLOC(Qfloat, 2*l);
@@ -1787,10 +1972,10 @@ public:
 
 	Qfloat *get_Q(int32_t i, int32_t len) const
 	{
-		Qfloat *data;
 		int32_t real_i = index[i];
-		if(cache->get_data(real_i,&data,l) < l)
-			compute_Q_parallel(data, NULL, real_i, 0, l);
+		Qfloat *data = get_cached_row(real_i, l, [&](Qfloat* row, int32_t start, int32_t end) {
+			compute_Q_parallel(row, NULL, real_i, start, end);
+		});
 
 		// reorder and copy
 		Qfloat *buf = buffer[next_buffer];
@@ -1808,7 +1993,6 @@ public:
 
 	~SVR_Q()
 	{
-		delete cache;
 		SG_FREE(sign);
 		SG_FREE(index);
 		SG_FREE(buffer[0]);
@@ -1818,7 +2002,6 @@ public:
 
 private:
 	int32_t l;
-	Cache *cache;
 	schar *sign;
 	int32_t *index;
 	mutable int32_t next_buffer;
@@ -1845,6 +2028,7 @@ static void solve_c_svc(
 	}
 
 	Solver s;
+	s.set_parallel_grain(param->parallel_grain);
 	s.Solve(l, SVC_Q(*prob,*param,y), prob->pv, y,
 		alpha, Cp, Cn, param->eps, si, param->shrinking, param->use_bias);
 
@@ -1881,6 +2065,7 @@ void solve_c_svc_weighted(
 	}
 
 	WeightedSolver s{prob->C};
+	s.set_parallel_grain(param->parallel_grain);
 	s.Solve(l, SVC_Q(*prob,*param,y), minus_ones, y,
 		alpha, Cp, Cn, param->eps, si, param->shrinking, param->use_bias);
 
@@ -1935,6 +2120,7 @@ static void solve_nu_svc(
 		zeros[i] = 0;
 
 	Solver_NU s;
+	s.set_parallel_grain(param->parallel_grain);
 	s.Solve(l, SVC_Q(*prob,*param,y), zeros, y,
 		alpha, 1.0, 1.0, param->eps, si,  param->shrinking, param->use_bias);
 	float64_t r = si->r;
@@ -1990,6 +2176,7 @@ static void solve_nu_multiclass_svc(const svm_problem *prob,
 	Solver_NUMC s(nr_class, nu);
 	SVC_QMC Q(*prob,*param,y, nr_class, ((float64_t) nr_class)/CMath::sq(nu*l));
 
+	s.set_parallel_grain(param->parallel_grain);
 	s.Solve(l, Q, zeros, y,
 		alpha, 1.0, 1.0, param->eps, si,  param->shrinking, param->use_bias);
 
@@ -2076,6 +2263,7 @@ static void solve_one_class(
 	}
 
 	Solver s;
+	s.set_parallel_grain(param->parallel_grain);
 	s.Solve(l, ONE_CLASS_Q(*prob,*param), zeros, ones,
 		alpha, 1.0, 1.0, param->eps, si, param->shrinking, param->use_bias);
 
@@ -2105,6 +2293,7 @@ static void solve_epsilon_svr(
 	}
 
 	Solver s;
+	s.set_parallel_grain(param->parallel_grain);
 	s.Solve(2*l, SVR_Q(*prob,*param), linear_term, y,
 		alpha2, param->C, param->C, param->eps, si, param->shrinking, param->use_bias);
 
@@ -2146,6 +2335,7 @@ static void solve_nu_svr(
 	}
 
 	Solver_NU s;
+	s.set_parallel_grain(param->parallel_grain);
 	s.Solve(2*l, SVR_Q(*prob,*param), linear_term, y,
 		alpha2, C, C, param->eps, si, param->shrinking, param->use_bias);
 
@@ -2398,10 +2588,21 @@ svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
 			nonzero[i] = false;
 		decision_function *f = SG_MALLOC(decision_function,nr_class*(nr_class-1)/2);
 
-		int32_t p = 0;
+		// the pairs are independent problems, trained at the same time
+		std::vector<std::pair<int32_t, int32_t>> pairs;
 		for(i=0;i<nr_class;i++)
 			for(int32_t j=i+1;j<nr_class;j++)
+				pairs.emplace_back(i,j);
+
+		// the solvers running at the same time share the cache budget
+		svm_parameter pair_param = *param;
+		pair_param.cache_size /= CMath::max(1, CMath::min(
+			env()->get_num_threads(), (int32_t) pairs.size()));
+
+		parallel_for(0, (index_t) pairs.size(), [&](index_t first, index_t last) {
+			for(index_t p=first;p<last;p++)
 			{
+				int32_t i = pairs[p].first, j = pairs[p].second;
 				svm_problem sub_prob;
 				int32_t si = start[i], sj = start[j];
 				int32_t ci = count[i], cj = count[j];
@@ -2416,34 +2617,40 @@ svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
 				{
 					sub_prob.x[k] = x[si+k];
 					sub_prob.y[k] = +1;
-                    sub_prob.C[k] = C[si+k];
-                    sub_prob.pv[k] = pv[si+k];
+					sub_prob.C[k] = C[si+k];
+					sub_prob.pv[k] = pv[si+k];
 
 				}
 				for(k=0;k<cj;k++)
 				{
 					sub_prob.x[ci+k] = x[sj+k];
 					sub_prob.y[ci+k] = -1;
-                    sub_prob.C[ci+k] = C[sj+k];
-                    sub_prob.pv[ci+k] = pv[sj+k];
+					sub_prob.C[ci+k] = C[sj+k];
+					sub_prob.pv[ci+k] = pv[sj+k];
 				}
 				sub_prob.y[sub_prob.l]=-1; //dirty hack to surpress valgrind err
 				sub_prob.C[sub_prob.l]=-1;
 				sub_prob.pv[sub_prob.l]=-1;
 
-				f[p] = svm_train_one(&sub_prob,param,weighted_C[i],weighted_C[j]);
-				for(k=0;k<ci;k++)
-					if(!nonzero[si+k] && fabs(f[p].alpha[k]) > 0)
-						nonzero[si+k] = true;
-				for(k=0;k<cj;k++)
-					if(!nonzero[sj+k] && fabs(f[p].alpha[ci+k]) > 0)
-						nonzero[sj+k] = true;
+				f[p] = svm_train_one(&sub_prob,&pair_param,weighted_C[i],weighted_C[j]);
 				SG_FREE(sub_prob.x);
 				SG_FREE(sub_prob.y);
 				SG_FREE(sub_prob.C);
 				SG_FREE(sub_prob.pv);
-				++p;
 			}
+		}, 1);
+
+		for(int32_t p=0;p<(int32_t) pairs.size();p++)
+		{
+			int32_t si = start[pairs[p].first], sj = start[pairs[p].second];
+			int32_t ci = count[pairs[p].first], cj = count[pairs[p].second];
+			for(int32_t k=0;k<ci;k++)
+				if(!nonzero[si+k] && fabs(f[p].alpha[k]) > 0)
+					nonzero[si+k] = true;
+			for(int32_t k=0;k<cj;k++)
+				if(!nonzero[sj+k] && fabs(f[p].alpha[ci+k]) > 0)
+					nonzero[sj+k] = true;
+		}
 
 		// build output
 
@@ -2478,7 +2685,7 @@ svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
 
 		model->l = total_sv;
 		model->SV = SG_MALLOC(svm_node *,total_sv);
-		p = 0;
+		int32_t p = 0;
 		for(i=0;i<l;i++)
 			if(nonzero[i]) model->SV[p++] = x[i];
 
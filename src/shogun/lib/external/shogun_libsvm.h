@@ -80,6 +80,11 @@ public:
 
 };
 
+/** default minimum number of examples per task of the parallel loops of
+ * the solvers
+ */
+#define LIBSVM_PARALLEL_GRAIN 16384
+
 enum { C_SVC=1, NU_SVC=2, NU_MULTICLASS_SVC=3, ONE_CLASS=4, EPSILON_SVR=5, NU_SVR=6 };	/* svm_type */
 enum { LINEAR, POLY, RBF, SIGMOID, PRECOMPUTED }; /* kernel_type */
 
@@ -124,6 +129,15 @@ struct svm_parameter
 	int32_t shrinking;
 	/** compute bias */
 	bool use_bias;
+	/** read kernel rows from the shared row cache of the kernel, see
+	 * CKernel::get_cached_kernel_row(), rather than computing them for
+	 * every solver
+	 */
+	bool use_kernel_row_cache;
+	/** minimum number of examples per task of the parallel loops over the
+	 * examples, LIBSVM_PARALLEL_GRAIN by default
+	 */
+	int32_t parallel_grain;
 };
 
 /** svm_model */
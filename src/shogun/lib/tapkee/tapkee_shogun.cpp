@@ -65,6 +65,26 @@ struct ShogunFeatureVectorCallback
 	CDotFeatures* features;
 };
 
+struct ShogunDistanceCallback
+{
+	ShogunDistanceCallback(CDistance* d, bool precompute) : impl(d)
+	{
+		// methods that use every pairwise distance get them computed
+		// in blocks rather than one by one
+		if (impl && precompute)
+			distances = impl->get_distance_matrix();
+	}
+	inline tapkee::ScalarType distance(int a, int b) const
+	{
+		if (distances.matrix)
+			return distances(a,b);
+
+		return impl->distance(a,b);
+	}
+	CDistance* impl;
+	SGMatrix<float64_t> distances;
+};
+
 
 CDenseFeatures<float64_t>* shogun::tapkee_embed(const shogun::TAPKEE_PARAMETERS_FOR_SHOGUN& parameters)
 {
@@ -73,7 +93,6 @@ CDenseFeatures<float64_t>* shogun::tapkee_embed(const shogun::TAPKEE_PARAMETERS_
 	tapkee::LoggingSingleton::instance().enable_info();
 
 	pimpl_kernel_callback<CKernel> kernel_callback(parameters.kernel);
-	pimpl_distance_callback<CDistance> distance_callback(parameters.distance);
 	ShogunFeatureVectorCallback features_callback(parameters.features);
 
 	tapkee::DimensionReductionMethod method = tapkee::PCA;
@@ -158,6 +177,10 @@ CDenseFeatures<float64_t>* shogun::tapkee_embed(const shogun::TAPKEE_PARAMETERS_
 			break;
 	}
 
+	ShogunDistanceCallback distance_callback(parameters.distance,
+		method==tapkee::MultidimensionalScaling ||
+		method==tapkee::DiffusionMap);
+
 	std::vector<int32_t> indices(N);
 	for (size_t i=0; i<N; i++)
 		indices[i] = i;
@@ -7,6 +7,7 @@
 
 #include <shogun/base/ShogunEnv.h>
 #include <shogun/base/progress.h>
+#include <shogun/base/TaskScheduler.h>
 #include <shogun/ensemble/CombinationRule.h>
 #include <shogun/ensemble/MeanRule.h>
 #include <shogun/machine/BaggingMachine.h>
@@ -15,6 +16,8 @@
 
 #include <shogun/evaluation/Evaluation.h>
 
+#include <mutex>
+
 using namespace shogun;
 
 CBaggingMachine::CBaggingMachine() : RandomMixin<CMachine>()
@@ -126,23 +129,24 @@ CBaggingMachine::apply_outputs_without_combination(CFeatures* data)
 	SGMatrix<float64_t> output(data->get_num_vectors(), m_num_bags);
 	output.zero();
 
-#pragma omp parallel for
-	for (int32_t i = 0; i < m_num_bags; ++i)
-	{
-		CMachine* m = dynamic_cast<CMachine*>(m_bags->get_element(i));
-		CLabels* l = m->apply(data);
-		SGVector<float64_t> lv;
-		if (l != NULL)
-			lv = dynamic_cast<CDenseLabels*>(l)->get_labels();
-		else
-			error("NULL returned by apply method");
-
-		float64_t* bag_results = output.get_column_vector(i);
-		sg_memcpy(bag_results, lv.vector, lv.vlen * sizeof(float64_t));
-
-		SG_UNREF(l);
-		SG_UNREF(m);
-	}
+	parallel_for(0, m_num_bags, [&](index_t start, index_t end) {
+		for (index_t i = start; i < end; ++i)
+		{
+			CMachine* m = dynamic_cast<CMachine*>(m_bags->get_element(i));
+			CLabels* l = m->apply(data);
+			SGVector<float64_t> lv;
+			if (l != NULL)
+				lv = dynamic_cast<CDenseLabels*>(l)->get_labels();
+			else
+				error("NULL returned by apply method");
+
+			float64_t* bag_results = output.get_column_vector(i);
+			sg_memcpy(bag_results, lv.vector, lv.vlen * sizeof(float64_t));
+
+			SG_UNREF(l);
+			SG_UNREF(m);
+		}
+	}, 1);
 
 	return output;
 }
@@ -179,71 +183,73 @@ bool CBaggingMachine::train_machine(CFeatures* data)
 	random::fill_array(rnd_indicies, 0, m_bag_size - 1, m_prng);
 
 	auto pb = SG_PROGRESS(range(m_num_bags));
-#pragma omp parallel for
-	for (int32_t i = 0; i < m_num_bags; ++i)
-	{
-		CMachine* c = dynamic_cast<CMachine*>(m_machine->clone());
-		ASSERT(c != NULL);
-		SGVector<index_t> idx(
-		    rnd_indicies.get_column_vector(i), m_bag_size, false);
-
-		CFeatures* features;
-		CLabels* labels;
-
-		if (env()->get_num_threads() == 1)
-		{
-			features = m_features;
-			labels = m_labels;
-		}
-		else
-		{
-			features = m_features->shallow_subset_copy();
-			labels = m_labels->shallow_subset_copy();
-		}
-
-		labels->add_subset(idx);
-		/* TODO:
-		   if it's a binary labeling ensure that
-		   there's always samples of both classes
-		if ((m_labels->get_label_type() == LT_BINARY))
+	std::mutex bags_mutex;
+	parallel_for(0, m_num_bags, [&](index_t start, index_t end) {
+		for (index_t i = start; i < end; ++i)
 		{
-		    while (true) {
-		        if (!m_labels->ensure_valid()) {
-		            m_labels->remove_subset();
-		            idx.random(0, m_features->get_num_vectors());
-		            m_labels->add_subset(idx);
-		            continue;
-		        }
-		        break;
-		    }
+			CMachine* c = dynamic_cast<CMachine*>(m_machine->clone());
+			ASSERT(c != NULL);
+			SGVector<index_t> idx(
+			    rnd_indicies.get_column_vector(i), m_bag_size, false);
+
+			CFeatures* features;
+			CLabels* labels;
+
+			if (env()->get_num_threads() == 1)
+			{
+				features = m_features;
+				labels = m_labels;
+			}
+			else
+			{
+				features = m_features->shallow_subset_copy();
+				labels = m_labels->shallow_subset_copy();
+			}
+
+			labels->add_subset(idx);
+			/* TODO:
+			   if it's a binary labeling ensure that
+			   there's always samples of both classes
+			if ((m_labels->get_label_type() == LT_BINARY))
+			{
+			    while (true) {
+			        if (!m_labels->ensure_valid()) {
+			            m_labels->remove_subset();
+			            idx.random(0, m_features->get_num_vectors());
+			            m_labels->add_subset(idx);
+			            continue;
+			        }
+			        break;
+			    }
+			}
+			*/
+			features->add_subset(idx);
+			set_machine_parameters(c, idx);
+			c->set_labels(labels);
+			c->train(features);
+			features->remove_subset();
+			labels->remove_subset();
+
+			{
+				std::lock_guard<std::mutex> lock(bags_mutex);
+				// get out of bag indexes
+				CDynamicArray<index_t>* oob = get_oob_indices(idx);
+				m_oob_indices->push_back(oob);
+
+				// add trained machine to bag array
+				m_bags->push_back(c);
+			}
+
+			if (env()->get_num_threads() != 1)
+			{
+				SG_UNREF(features);
+				SG_UNREF(labels);
+			}
+
+			SG_UNREF(c);
+			pb.print_progress();
 		}
-		*/
-		features->add_subset(idx);
-		set_machine_parameters(c, idx);
-		c->set_labels(labels);
-		c->train(features);
-		features->remove_subset();
-		labels->remove_subset();
-
-#pragma omp critical
-		{
-			// get out of bag indexes
-			CDynamicArray<index_t>* oob = get_oob_indices(idx);
-			m_oob_indices->push_back(oob);
-
-			// add trained machine to bag array
-			m_bags->push_back(c);
-		}
-
-		if (env()->get_num_threads() != 1)
-		{
-			SG_UNREF(features);
-			SG_UNREF(labels);
-		}
-
-		SG_UNREF(c);
-		pb.print_progress();
-	}
+	}, 1);
 	pb.complete();
 
 	return true;
@@ -151,7 +151,7 @@ namespace shogun
 		 * @param data the data to compute the output for
 		 * @return predictions
 		 */
-		SGMatrix<float64_t> apply_outputs_without_combination(CFeatures* data);
+		virtual SGMatrix<float64_t> apply_outputs_without_combination(CFeatures* data);
 
 		/** Register paramaters */
 		void register_parameters();
@@ -8,10 +8,7 @@
 #include <shogun/machine/DistanceMachine.h>
 #include <shogun/distance/Distance.h>
 #include <shogun/base/Parameter.h>
-
-#ifdef HAVE_OPENMP
-#include <omp.h>
-#endif
+#include <shogun/base/TaskScheduler.h>
 
 using namespace shogun;
 
@@ -34,66 +31,22 @@ void CDistanceMachine::init()
 
 void CDistanceMachine::distances_lhs(SGVector<float64_t>& result, index_t idx_a1, index_t idx_a2, index_t idx_b)
 {
-    int32_t num_threads;
-    int32_t num_vec;
-    int32_t step;
-
-    ASSERT(result)
-
-    #pragma omp parallel shared(num_threads, step)
-    {
-#ifdef HAVE_OPENMP
-        #pragma omp single
-        {
-            num_threads=omp_get_num_threads();
-            num_vec=idx_a2-idx_a1+1;
-            step=num_vec/num_threads;
-        }
-        int32_t thread_num=omp_get_thread_num();
-
-        index_t idx_r_start = thread_num * step;
-        index_t idx_start = (thread_num * step) + idx_a1;
-        index_t idx_stop = (thread_num==(num_threads - 1)) ? (idx_a2 + 1) : ((thread_num + 1) * step) + idx_a1;
-        distance->run_distance_lhs(result, idx_r_start, idx_start, idx_stop, idx_b);
-#else
-        index_t idx_r_start = idx_a1;
-        index_t idx_start = idx_a1;
-        index_t idx_stop = idx_a2  + 1;
-        distance->run_distance_lhs(result, idx_r_start, idx_start, idx_stop, idx_b);
-#endif
-    }
+	ASSERT(result)
+
+	parallel_for(idx_a1, idx_a2+1, [&](index_t start, index_t end) {
+		SGMatrix<float64_t> block(result.vector+start-idx_a1, end-start, 1, false);
+		distance->get_distance_block(start, idx_b, block);
+	});
 }
 
 void CDistanceMachine::distances_rhs(SGVector<float64_t>& result, index_t idx_b1, index_t idx_b2, index_t idx_a)
 {
-    int32_t num_threads;
-    int32_t num_vec;
-    int32_t step;
-
-    ASSERT(result)
-
-    #pragma omp parallel shared(num_threads, step)
-    {
-#ifdef HAVE_OPENMP
-        #pragma omp single
-        {
-            num_threads=omp_get_num_threads();
-            num_vec=idx_b2-idx_b1+1;
-            step=num_vec/num_threads;
-        }
-        int32_t thread_num=omp_get_thread_num();
-
-        index_t idx_r_start = thread_num * step;
-        index_t idx_start = (thread_num * step) + idx_b1;
-        index_t idx_stop = (thread_num==(num_threads - 1)) ? (idx_b2 + 1) : ((thread_num + 1) * step) + idx_b1;
-        distance->run_distance_rhs(result, idx_r_start, idx_start, idx_stop, idx_a);
-#else
-        index_t idx_r_start = idx_b1;
-        index_t idx_start = idx_b1;
-        index_t idx_stop = idx_b2  + 1;
-        distance->run_distance_rhs(result, idx_r_start, idx_start, idx_stop, idx_a);
-#endif
-    }
+	ASSERT(result)
+
+	parallel_for(idx_b1, idx_b2+1, [&](index_t start, index_t end) {
+		SGMatrix<float64_t> block(result.vector+start-idx_b1, 1, end-start, false);
+		distance->get_distance_block(idx_a, start, block);
+	});
 }
 
 CMulticlassLabels* CDistanceMachine::apply_multiclass(CFeatures* data)
@@ -106,9 +59,26 @@ CMulticlassLabels* CDistanceMachine::apply_multiclass(CFeatures* data)
 		SG_UNREF(lhs);
 
 		/* build result labels and classify all elements of procedure */
-		CMulticlassLabels* result=new CMulticlassLabels(data->get_num_vectors());
-		for (index_t i=0; i<data->get_num_vectors(); ++i)
-			result->set_label(i, apply_one(i));
+		const index_t num_vectors=data->get_num_vectors();
+		const index_t num_clusters=distance->get_num_vec_lhs();
+		CMulticlassLabels* result=new CMulticlassLabels(num_vectors);
+		parallel_for(0, num_vectors, [&](index_t start, index_t end) {
+			/* distances of a block of elements to all cluster centers */
+			SGMatrix<float64_t> dists=
+				distance->get_distance_block(0, num_clusters, start, end);
+
+			for (index_t i=start; i<end; ++i)
+			{
+				const float64_t* dists_i=dists.get_column_vector(i-start);
+				index_t best_index=0;
+				for (index_t j=1; j<num_clusters; ++j)
+				{
+					if (dists_i[j]<dists_i[best_index])
+						best_index=j;
+				}
+				result->set_label(i, best_index);
+			}
+		}, 256);
 		return result;
 	}
 	else
@@ -8,6 +8,7 @@
 
 #include <rxcpp/rx-lite.hpp>
 #include <shogun/base/progress.h>
+#include <shogun/base/TaskScheduler.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/kernel/CustomKernel.h>
 #include <shogun/kernel/Kernel.h>
@@ -15,11 +16,6 @@
 #include <shogun/labels/RegressionLabels.h>
 #include <shogun/machine/KernelMachine.h>
 
-#ifdef HAVE_OPENMP
-#include <omp.h>
-
-#endif
-
 using namespace shogun;
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -332,29 +328,7 @@ SGVector<float64_t> CKernelMachine::apply_get_outputs(CFeatures* data)
 		else
 		{
 			auto pb = SG_PROGRESS(range(num_vectors));
-			int32_t num_threads;
-			int64_t step;
-#pragma omp parallel shared(num_threads, step)
-			{
-
-#ifdef HAVE_OPENMP
-#pragma omp single
-				{
-					num_threads = omp_get_num_threads();
-					step = num_vectors / num_threads;
-					num_threads--;
-				}
-				int32_t thread_num = omp_get_thread_num();
-#else
-				num_threads = 0;
-				step = num_vectors;
-				int32_t thread_num = 0;
-#endif
-				int32_t start = thread_num * step;
-				int32_t end = (thread_num == num_threads)
-				                  ? num_vectors
-				                  : (thread_num + 1) * step;
-
+			parallel_for(0, num_vectors, [&](index_t start, index_t end) {
 				for (int32_t vec = start; vec < end; vec++)
 				{
 					COMPUTATION_CONTROLLERS
@@ -377,7 +351,7 @@ SGVector<float64_t> CKernelMachine::apply_get_outputs(CFeatures* data)
 						output[vec] = score + get_bias();
 					}
 				}
-			}
+			});
 			pb.complete();
 		}
 	}
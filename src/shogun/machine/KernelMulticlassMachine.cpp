@@ -5,11 +5,18 @@
  *          Soeren Sonnenburg
  */
 
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/base/TaskScheduler.h>
 #include <shogun/lib/Set.h>
+#include <shogun/labels/BinaryLabels.h>
 #include <shogun/machine/KernelMulticlassMachine.h>
 #include <shogun/features/Features.h>
 #include <shogun/kernel/Kernel.h>
 #include <shogun/machine/KernelMachine.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
+
+#include <algorithm>
+#include <vector>
 
 using namespace shogun;
 
@@ -181,3 +188,135 @@ void CKernelMulticlassMachine::remove_machine_subset()
 }
 
 
+
+CMachine* CKernelMulticlassMachine::get_machine_for_parallel_train(SGVector<index_t> subset)
+{
+	if (subset.vlen)
+		return NULL;
+
+	switch (m_machine->get_classifier_type())
+	{
+		case CT_LIGHT:
+		case CT_LIGHTONECLASS:
+		case CT_SVRLIGHT:
+		case CT_MKLMULTICLASS:
+		case CT_MKLCLASSIFICATION:
+		case CT_MKLONECLASS:
+		case CT_MKLREGRESSION:
+			return NULL;
+		default:
+			break;
+	}
+
+	// the kernel is shared rather than cloned with the hyperparameters
+	auto machine=m_machine->as<CKernelMachine>();
+	machine->set_kernel(NULL);
+	auto copy=make_clone(machine,
+		ParameterProperties::HYPER | ParameterProperties::SETTING)->as<CKernelMachine>();
+	machine->set_kernel(m_kernel);
+
+	copy->set_kernel(m_kernel);
+	if (copy->has("use_kernel_row_cache"))
+		copy->put("use_kernel_row_cache", true);
+
+	return copy;
+}
+
+void CKernelMulticlassMachine::get_all_submachine_outputs(CBinaryLabels** outputs)
+{
+	const int32_t num_machines=m_machines->get_num_elements();
+	const int32_t num_lhs=m_kernel ? m_kernel->get_num_vec_lhs() : 0;
+	const int32_t num_vectors=m_kernel ? m_kernel->get_num_vec_rhs() : 0;
+
+	// all submachines have to be kernel machines using the kernel
+	bool batched=num_machines>1 && num_lhs>0 && num_vectors>0;
+	std::vector<CKernelMachine*> machines;
+	for (int32_t i=0; batched && i<num_machines; ++i)
+	{
+		auto machine=dynamic_cast<CKernelMachine*>(get_machine(i));
+		if (!machine)
+		{
+			batched=false;
+			break;
+		}
+
+		machines.push_back(machine);
+		CKernel* kernel=machine->get_kernel();
+		batched=kernel==m_kernel;
+		SG_UNREF(kernel);
+	}
+
+	if (!batched)
+	{
+		for (auto machine : machines)
+			SG_UNREF(machine);
+
+		CMulticlassMachine::get_all_submachine_outputs(outputs);
+		return;
+	}
+
+	// union of the support vectors, in the order of the lhs vectors
+	std::vector<index_t> sv_pos(num_lhs, -1);
+	for (auto machine : machines)
+	{
+		for (int32_t j=0; j<machine->get_num_support_vectors(); ++j)
+			sv_pos[machine->get_support_vector(j)]=0;
+	}
+
+	std::vector<index_t> svs;
+	for (index_t i=0; i<num_lhs; ++i)
+	{
+		if (sv_pos[i]>=0)
+		{
+			sv_pos[i]=svs.size();
+			svs.push_back(i);
+		}
+	}
+	const index_t num_svs=svs.size();
+
+	// coefficients of all submachines as the columns of one matrix
+	SGMatrix<float64_t> alphas(std::max<index_t>(num_svs, 1), num_machines);
+	alphas.zero();
+	for (int32_t i=0; i<num_machines; ++i)
+	{
+		for (int32_t j=0; j<machines[i]->get_num_support_vectors(); ++j)
+			alphas(sv_pos[machines[i]->get_support_vector(j)], i)+=machines[i]->get_alpha(j);
+	}
+
+	// classes x vectors, computed in blocks of vectors to bound the memory
+	// of the kernel values
+	const index_t block_size=64;
+	SGMatrix<float64_t> scores(num_machines, num_vectors);
+	scores.zero();
+	if (num_svs>0)
+	{
+		parallel_for(0, num_vectors, [&](index_t start, index_t end) {
+			SGMatrix<float64_t> kernel_values(num_svs, block_size);
+			for (index_t first=start; first<end; first+=block_size)
+			{
+				const index_t len=std::min(block_size, end-first);
+				SGMatrix<float64_t> block_values(kernel_values.matrix, num_svs, len, false);
+				for (index_t j=0; j<len; ++j)
+				{
+					for (index_t k=0; k<num_svs; ++k)
+						block_values(k, j)=m_kernel->kernel(svs[k], first+j);
+				}
+
+				SGMatrix<float64_t> block(scores.matrix+int64_t(first)*num_machines,
+					num_machines, len, false);
+				linalg::matrix_prod(alphas, block_values, block, true, false);
+			}
+		}, block_size);
+	}
+
+	for (int32_t i=0; i<num_machines; ++i)
+	{
+		const float64_t bias=machines[i]->get_bias();
+		SGVector<float64_t> values(num_vectors);
+		for (int32_t j=0; j<num_vectors; ++j)
+			values[j]=scores(i, j)+bias;
+
+		outputs[i]=new CBinaryLabels(values);
+		SG_UNREF(machines[i]);
+	}
+}
@@ -63,6 +63,16 @@ class CKernelMulticlassMachine : public CMulticlassMachine
 		 */
 		virtual void store_model_features();
 
+		/** get outputs of all submachines. The kernel values between the
+		 * vectors and the union of the support vectors of all submachines
+		 * are computed once and the outputs of all submachines follow as
+		 * one matrix product with their coefficients.
+		 *
+		 * @param outputs array with one entry per submachine to store the
+		 * outputs in
+		 */
+		virtual void get_all_submachine_outputs(CBinaryLabels** outputs);
+
 	protected:
 
 		/** init machine for training with kernel init */
@@ -89,6 +99,18 @@ class CKernelMulticlassMachine : public CMulticlassMachine
 		/** deletes any subset set to the features of the machine */
 		virtual void remove_machine_subset();
 
+		/** copy of the machine for training one submachine at the same
+		 * time as others. All copies share the kernel, and machines that
+		 * can read rows from the shared row cache of the kernel do so.
+		 * SVMLight and MKL keep training state in the kernel and are
+		 * trained one after the other.
+		 *
+		 * @param subset indices of the training vectors, which have to be
+		 * empty as kernel machines do not support subsets
+		 * @return untrained copy of the machine, or NULL
+		 */
+		virtual CMachine* get_machine_for_parallel_train(SGVector<index_t> subset);
+
 	protected:
 
 		/** kernel */
@@ -7,11 +7,14 @@
  */
 
 #include <rxcpp/rx-lite.hpp>
+#include <shogun/features/DenseFeatures.h>
 #include <shogun/features/DotFeatures.h>
 #include <shogun/labels/Labels.h>
 #include <shogun/labels/RegressionLabels.h>
 #include <shogun/machine/LinearMachine.h>
 
+#include <algorithm>
+
 using namespace shogun;
 
 CLinearMachine::CLinearMachine(): CMachine()
@@ -24,6 +27,7 @@ CLinearMachine::CLinearMachine(CLinearMachine* machine) : CMachine()
 	init();
 	require(machine, "No machine provided.");
 
+	m_float32_weights = machine->get_float32_weights();
 	auto w = machine->get_w();
 	auto w_clone = w.clone();
 	set_w(w_clone);
@@ -34,9 +38,12 @@ void CLinearMachine::init()
 {
 	bias = 0;
 	features = NULL;
+	m_float32_weights = false;
 
 	SG_ADD(&m_w, "w", "Parameter vector w.", ParameterProperties::MODEL);
 	SG_ADD(&bias, "bias", "Bias b.", ParameterProperties::MODEL);
+	SG_ADD(&m_float32_weights, "float32_weights",
+		"Whether float32 dense features are applied in single precision.");
 	SG_ADD(
 	    (CFeatures**)&features, "features", "Feature object.");
 }
@@ -81,11 +88,49 @@ SGVector<float64_t> CLinearMachine::apply_get_outputs(CFeatures* data)
 	ASSERT(num>0)
 	ASSERT(m_w.vlen==features->get_dim_feature_space())
 
+	if (use_float32_weights())
+	{
+		auto dense = (CDenseFeatures<float32_t>*)features;
+		SGVector<float32_t> out32 =
+		    dense->dot_range(0, num, get_w_float32(), bias);
+		SGVector<float64_t> out(num);
+		std::copy(out32.vector, out32.vector + num, out.vector);
+		return out;
+	}
+
 	float64_t* out=SG_MALLOC(float64_t, num);
 	features->dense_dot_range(out, 0, num, NULL, m_w.vector, m_w.vlen, bias);
 	return SGVector<float64_t>(out,num);
 }
 
+bool CLinearMachine::use_float32_weights() const
+{
+	return m_float32_weights && features &&
+	       features->get_feature_class() == C_DENSE &&
+	       features->get_feature_type() == F_SHORTREAL &&
+	       m_w.vlen == features->get_dim_feature_space();
+}
+
+void CLinearMachine::set_float32_weights(bool float32_weights)
+{
+	m_float32_weights = float32_weights;
+}
+
+bool CLinearMachine::get_float32_weights() const
+{
+	return m_float32_weights;
+}
+
+SGVector<float32_t> CLinearMachine::get_w_float32() const
+{
+	if (!m_float32_weights)
+		return SGVector<float32_t>();
+
+	SGVector<float32_t> w32(m_w.vlen);
+	std::copy(m_w.vector, m_w.vector + m_w.vlen, w32.vector);
+	return w32;
+}
+
 SGVector<float64_t> CLinearMachine::get_w() const
 {
 	return m_w;
@@ -58,6 +58,13 @@ class CRegressionLabels;
  *
  *	\sa CDotFeatures
  *
+ * Training always computes \f${\bf w}\f$ in double precision. With
+ * set_float32_weights(), apply() converts \f${\bf w}\f$ to single
+ * precision and applies float32 dense features (CDenseFeatures<float32_t>)
+ * in single precision, which halves the memory traffic of the weights and
+ * doubles the width of the vector instructions. The conversion is done on
+ * every apply(), as solvers may change \f${\bf w}\f$ in place after
+ * set_w(); apply_one() always uses the double precision weights.
  * */
 class CLinearMachine : public CMachine
 {
@@ -83,6 +90,23 @@ class CLinearMachine : public CMachine
 		 */
 		virtual void set_w(const SGVector<float64_t> src_w);
 
+		/** enable or disable applying float32 dense features with single
+		 * precision weights
+		 *
+		 * @param float32_weights whether to use float32 weights
+		 */
+		void set_float32_weights(bool float32_weights);
+
+		/** @return whether float32 weights are used */
+		bool get_float32_weights() const;
+
+		/** get w converted to single precision
+		 *
+		 * @return float32 weight vector, empty if float32 weights are not
+		 * used
+		 */
+		SGVector<float32_t> get_w_float32() const;
+
 		/** set bias
 		 *
 		 * @param b new bias
@@ -142,6 +166,11 @@ class CLinearMachine : public CMachine
 		 */
 		virtual SGVector<float64_t> apply_get_outputs(CFeatures* data);
 
+		/** @return whether the features are applied with the float32
+		 * weights
+		 */
+		bool use_float32_weights() const;
+
 	private:
 
 		void init();
@@ -153,6 +182,9 @@ class CLinearMachine : public CMachine
 		/** bias */
 		float64_t bias;
 
+		/** whether float32 dense features are applied in single precision */
+		bool m_float32_weights;
+
 		/** features */
 		CDotFeatures* features;
 };
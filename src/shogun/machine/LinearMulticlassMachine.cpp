@@ -0,0 +1,126 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/base/TaskScheduler.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/features/SparseFeatures.h>
+#include <shogun/features/SubsetStack.h>
+#include <shogun/labels/BinaryLabels.h>
+#include <shogun/machine/LinearMulticlassMachine.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
+
+#include <algorithm>
+
+using namespace shogun;
+
+void CLinearMulticlassMachine::get_all_submachine_outputs(CBinaryLabels** outputs)
+{
+	const int32_t num_machines=m_machines->get_num_elements();
+	if (!m_features || num_machines==0 || m_features->get_feature_type()!=F_DREAL)
+	{
+		CMulticlassMachine::get_all_submachine_outputs(outputs);
+		return;
+	}
+
+	CSubsetStack* subsets=m_features->get_subset_stack();
+	const bool has_subsets=subsets->has_subsets();
+	SG_UNREF(subsets);
+
+	CDenseFeatures<float64_t>* dense=NULL;
+	CSparseFeatures<float64_t>* sparse=NULL;
+	if (m_features->get_feature_class()==C_DENSE)
+		dense=(CDenseFeatures<float64_t>*) m_features;
+	else if (m_features->get_feature_class()==C_SPARSE)
+		sparse=(CSparseFeatures<float64_t>*) m_features;
+
+	SGMatrix<float64_t> feature_matrix;
+	SGSparseMatrix<float64_t> sparse_matrix;
+	if (dense && !has_subsets && !dense->get_num_preprocessors())
+		feature_matrix=dense->get_feature_matrix();
+	else if (sparse && !has_subsets && !sparse->is_csr())
+		sparse_matrix=sparse->get_sparse_feature_matrix();
+
+	if (!feature_matrix.matrix && !sparse_matrix.sparse_matrix)
+	{
+		CMulticlassMachine::get_all_submachine_outputs(outputs);
+		return;
+	}
+
+	// weight vectors of all classes as the columns of one matrix
+	const int32_t dim=m_features->get_dim_feature_space();
+	SGMatrix<float64_t> W(dim, num_machines);
+	SGVector<float64_t> biases(num_machines);
+	for (int32_t i=0; i<num_machines; ++i)
+	{
+		auto machine=m_machines->get_element(i)->as<CLinearMachine>();
+		SGVector<float64_t> w=machine->get_w();
+		biases[i]=machine->get_bias();
+		SG_UNREF(machine);
+
+		if (w.vlen!=dim)
+		{
+			CMulticlassMachine::get_all_submachine_outputs(outputs);
+			return;
+		}
+		std::copy(w.vector, w.vector+dim, W.get_column_vector(i));
+	}
+
+	const int32_t num_vectors=m_features->get_num_vectors();
+	SGMatrix<float64_t> scores;
+	// distance between the outputs of one class for consecutive vectors
+	index_t stride;
+	if (feature_matrix.matrix)
+	{
+		// classes x vectors, so that every thread writes a contiguous block
+		scores=SGMatrix<float64_t>(num_machines, num_vectors);
+		stride=num_machines;
+
+		const index_t num_threads=env()->get_num_threads();
+		const index_t grain=std::max<index_t>(
+			(num_vectors+num_threads-1)/num_threads, 256);
+		parallel_for(0, num_vectors, [&](index_t start, index_t end) {
+			SGMatrix<float64_t> vectors(feature_matrix.matrix+int64_t(start)*dim,
+				dim, end-start, false);
+			SGMatrix<float64_t> block(scores.matrix+int64_t(start)*num_machines,
+				num_machines, end-start, false);
+			linalg::matrix_prod(W, vectors, block, true, false);
+		}, grain);
+	}
+	else
+	{
+		scores=linalg::matrix_prod(sparse_matrix, W, true);
+		stride=1;
+	}
+
+	for (int32_t i=0; i<num_machines; ++i)
+	{
+		const float64_t* class_scores=stride==1 ?
+			scores.matrix+int64_t(i)*num_vectors : scores.matrix+i;
+
+		SGVector<float64_t> values(num_vectors);
+		for (int32_t j=0; j<num_vectors; ++j)
+			values[j]=class_scores[int64_t(j)*stride]+biases[i];
+
+		outputs[i]=new CBinaryLabels(values);
+	}
+}
+
+CMachine* CLinearMulticlassMachine::get_machine_for_parallel_train(SGVector<index_t> subset)
+{
+	if (m_features->get_feature_class()!=C_DENSE && m_features->get_feature_class()!=C_SPARSE)
+		return NULL;
+
+	// only hyperparameters and settings, the features and labels are set
+	// for every submachine
+	auto machine=make_clone(m_machine,
+		ParameterProperties::HYPER | ParameterProperties::SETTING)->as<CLinearMachine>();
+
+	auto features=m_features->duplicate()->as<CDotFeatures>();
+	if (subset.vlen)
+		features->add_subset(subset);
+	machine->set_features(features);
+
+	return machine;
+}
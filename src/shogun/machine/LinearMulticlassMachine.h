@@ -86,6 +86,15 @@ class CLinearMulticlassMachine : public CMulticlassMachine
 			return m_features;
 		}
 
+		/** get outputs of all submachines. For float64 dense or sparse
+		 * features, the outputs of all classes are computed at once as
+		 * one matrix product with the matrix of weight vectors.
+		 *
+		 * @param outputs array with one entry per submachine to store the
+		 * outputs in
+		 */
+		virtual void get_all_submachine_outputs(CBinaryLabels** outputs);
+
 	protected:
 
 		/** init machine for train with setting features */
@@ -141,6 +150,15 @@ class CLinearMulticlassMachine : public CMulticlassMachine
 			return m_features->get_num_vectors();
 		}
 
+		/** copy of the machine for training one submachine at the same
+		 * time as others, on a copy of the features that shares the data
+		 * of dense and sparse features
+		 *
+		 * @param subset indices of the training vectors, empty for all
+		 * @return untrained copy of the machine, NULL for other features
+		 */
+		virtual CMachine* get_machine_for_parallel_train(SGVector<index_t> subset);
+
 		/** set subset to the features of the machine, deletes old one
 		 *
 		 * @param subset subset instance to set
@@ -59,8 +59,8 @@ bool CMachine::train(CFeatures* data)
 		    support_string_dispatching() &&
 		    data->get_feature_class() == C_STRING)
 			result = train_string(data);
-		else
-			error("Training with {} is not implemented!", data->get_name());
+		else // other feature classes the machine may train on itself
+			result = train_machine(data);
 	}
 	else
 		result = train_machine(data);
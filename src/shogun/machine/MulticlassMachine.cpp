@@ -6,6 +6,8 @@
  *          Evan Shelhamer, Shell Hu, Thoralf Klein, Viktor Gal
  */
 
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/base/TaskScheduler.h>
 #include <shogun/multiclass/MulticlassOneVsRestStrategy.h>
 #include <shogun/machine/LinearMachine.h>
 #include <shogun/machine/KernelMachine.h>
@@ -14,6 +16,8 @@
 #include <shogun/mathematics/Statistics.h>
 #include <shogun/labels/MultilabelLabels.h>
 
+#include <vector>
+
 using namespace shogun;
 
 CMulticlassMachine::CMulticlassMachine()
@@ -82,6 +86,12 @@ float64_t CMulticlassMachine::get_submachine_output(int32_t i, int32_t num)
 	return output;
 }
 
+void CMulticlassMachine::get_all_submachine_outputs(CBinaryLabels** outputs)
+{
+	for (int32_t i=0; i<m_machines->get_num_elements(); ++i)
+		outputs[i] = get_submachine_outputs(i);
+}
+
 CMulticlassLabels* CMulticlassMachine::apply_multiclass(CFeatures* data)
 {
 	SG_DEBUG("entering {}::apply_multiclass({} at {})",
@@ -119,10 +129,9 @@ CMulticlassLabels* CMulticlassMachine::apply_multiclass(CFeatures* data)
 		SGVector<float64_t> As(num_machines);
 		SGVector<float64_t> Bs(num_machines);
 
+		get_all_submachine_outputs(outputs);
 		for (int32_t i=0; i<num_machines; ++i)
 		{
-			outputs[i] = (CBinaryLabels*) get_submachine_outputs(i);
-
 			if (heuris==OVA_SOFTMAX)
 			{
 				CStatistics::SigmoidParamters params = CStatistics::fit_sigmoid(outputs[i]->get_values());
@@ -207,8 +216,7 @@ CMultilabelLabels* CMulticlassMachine::apply_multilabel_output(CFeatures* data,
 		CMultilabelLabels* result=new CMultilabelLabels(num_vectors, n_outputs);
 		CBinaryLabels** outputs=SG_MALLOC(CBinaryLabels*, num_machines);
 
-		for (int32_t i=0; i < num_machines; ++i)
-			outputs[i] = (CBinaryLabels*) get_submachine_outputs(i);
+		get_all_submachine_outputs(outputs);
 
 		SGVector<float64_t> output_for_i(num_machines);
 		for (int32_t i=0; i<num_vectors; i++)
@@ -249,24 +257,63 @@ bool CMulticlassMachine::train_machine(CFeatures* data)
 
 	m_multiclass_strategy->train_start(
 	    multiclass_labels(m_labels), train_labels);
+
+	// submachines are trained at the same time in batches, so that only the
+	// labels of a few of them exist at once
+	const int32_t num_threads=env()->get_num_threads();
+	std::vector<CMachine*> batch;
+	auto train_batch=[&]() {
+		parallel_for(0, (index_t) batch.size(), [&](index_t start, index_t end) {
+			for (index_t i=start; i<end; ++i)
+				batch[i]->train();
+		}, 1);
+
+		for (auto machine : batch)
+		{
+			m_machines->push_back(get_machine_from_trained(machine));
+			SG_UNREF(machine);
+		}
+		batch.clear();
+	};
+
 	while (m_multiclass_strategy->train_has_more())
 	{
 		SGVector<index_t> subset=m_multiclass_strategy->train_prepare_next();
 		if (subset.vlen)
-		{
 			train_labels->add_subset(subset);
-			add_machine_subset(subset);
+
+		// copies also with one thread, so that the submachines do not depend
+		// on the number of threads
+		CMachine* machine=get_machine_for_parallel_train(subset);
+		if (machine)
+		{
+			machine->set_max_train_time(m_machine->get_max_train_time());
+			auto labels=new CBinaryLabels();
+			labels->set_labels(train_labels->get_labels_copy());
+			machine->set_labels(labels);
+			batch.push_back(machine);
+			if (int32_t(batch.size())>=2*num_threads)
+				train_batch();
 		}
+		else
+		{
+			// keep the order of the submachines
+			train_batch();
 
-		m_machine->train();
-		m_machines->push_back(get_machine_from_trained(m_machine));
+			if (subset.vlen)
+				add_machine_subset(subset);
+
+			m_machine->train();
+			m_machines->push_back(get_machine_from_trained(m_machine));
+
+			if (subset.vlen)
+				remove_machine_subset();
+		}
 
 		if (subset.vlen)
-		{
 			train_labels->remove_subset();
-			remove_machine_subset();
-		}
 	}
+	train_batch();
 
 	m_multiclass_strategy->train_stop();
 	SG_UNREF(train_labels);
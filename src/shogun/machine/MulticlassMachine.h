@@ -85,6 +85,14 @@ class CMulticlassMachine : public CBaseMulticlassMachine
 		 */
 		virtual float64_t get_submachine_output(int32_t i, int32_t num);
 
+		/** get outputs of all submachines, by default one
+		 * get_submachine_outputs() call per submachine
+		 *
+		 * @param outputs array with one entry per submachine to store the
+		 * outputs in
+		 */
+		virtual void get_all_submachine_outputs(CBinaryLabels** outputs);
+
 		/** classify all examples
 		 *
 		 * @return resulting labels
@@ -176,6 +184,24 @@ class CMulticlassMachine : public CBaseMulticlassMachine
 		/** get num rhs vectors */
 		virtual int32_t get_num_rhs_vectors() const = 0;
 
+		/** copy of the machine to train one submachine on a subset of the
+		 * training vectors while other submachines are trained at the same
+		 * time. The copy must not share any state with the machine that
+		 * training modifies, but may share thread-safe objects such as the
+		 * features or the kernel. Copies are used for any number of threads,
+		 * so that the submachines do not depend on it. Each copy starts from
+		 * the state of the machine, e.g. the random generator of machines
+		 * that clone it, and gets its maximum training time.
+		 *
+		 * @param subset indices of the training vectors, empty for all
+		 * @return untrained copy of the machine, or NULL if the submachines
+		 * have to be trained one after the other on the machine itself
+		 */
+		virtual CMachine* get_machine_for_parallel_train(SGVector<index_t> subset)
+		{
+			return NULL;
+		}
+
 		/** set subset to the features of the machine, deletes old one
 		 *
 		 * @param subset subset indices to set
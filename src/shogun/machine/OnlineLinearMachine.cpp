@@ -16,6 +16,9 @@
 
 using namespace shogun;
 
+/** number of examples fetched from the features at once in apply */
+static const int32_t apply_batch_size=1024;
+
 COnlineLinearMachine::COnlineLinearMachine()
 : CMachine(), bias(0), features(NULL)
 {
@@ -57,13 +60,17 @@ SGVector<float64_t> COnlineLinearMachine::apply_get_outputs(CFeatures* data)
 
 	std::vector<float64_t> labels;
 	features->start_parser();
-	while (features->get_next_example())
+	// fetch examples in batches, so that the parser is locked once per batch
+	int32_t num_fetched;
+	do
 	{
-		float64_t current_lab=features->dense_dot(m_w.vector, m_w.vlen) + bias;
-
-		labels.push_back(current_lab);
-		features->release_example();
+		index_t num_labels=labels.size();
+		labels.resize(num_labels+apply_batch_size);
+		num_fetched=features->dense_dot_next_batch(labels.data()+num_labels,
+				m_w.vector, m_w.vlen, bias, apply_batch_size);
+		labels.resize(num_labels+num_fetched);
 	}
+	while (num_fetched);
 	features->end_parser();
 
 	SGVector<float64_t> labels_array(labels.size());
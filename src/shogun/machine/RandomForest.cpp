@@ -84,6 +84,7 @@ CRandomForest::CRandomForest(CFeatures* features, CLabels* labels, SGVector<floa
 
 CRandomForest::~CRandomForest()
 {
+	SG_UNREF(m_compiled_trees);
 }
 
 void CRandomForest::set_machine(CMachine* machine)
@@ -139,6 +140,18 @@ int32_t CRandomForest::get_num_random_features() const
 	return dynamic_cast<CRandomCARTree*>(m_machine)->get_feature_subset_size();
 }
 
+void CRandomForest::set_use_histograms(bool histograms)
+{
+	require(m_machine,"m_machine is NULL. It is expected to be RandomCARTree");
+	dynamic_cast<CRandomCARTree*>(m_machine)->set_use_histograms(histograms);
+}
+
+bool CRandomForest::get_use_histograms() const
+{
+	require(m_machine,"m_machine is NULL. It is expected to be RandomCARTree");
+	return dynamic_cast<CRandomCARTree*>(m_machine)->get_use_histograms();
+}
+
 void CRandomForest::set_machine_parameters(CMachine* m, SGVector<index_t> idx)
 {
 	require(m,"Machine supplied is NULL");
@@ -159,11 +172,40 @@ void CRandomForest::set_machine_parameters(CMachine* m, SGVector<index_t> idx)
 	}
 
 	tree->set_weights(weights);
-	tree->set_sorted_features(m_sorted_transposed_feats, m_sorted_indices);
+	if (tree->get_use_histograms())
+		tree->set_binned_features(m_binned_feats, m_bin_thresholds, m_num_bins);
+	else
+		tree->set_sorted_features(m_sorted_transposed_feats, m_sorted_indices);
 	// equate the machine problem types - cloning does not do this
 	tree->set_machine_problem_type(dynamic_cast<CRandomCARTree*>(m_machine)->get_machine_problem_type());
 }
 
+void CRandomForest::compile_trees(bool float32_thresholds)
+{
+	require(m_bags->get_num_elements()==m_num_bags, "Forest not yet trained");
+
+	CFlatTreeEnsemble* compiled=new CFlatTreeEnsemble(float32_thresholds);
+	SG_REF(compiled);
+	for (int32_t i=0;i<m_num_bags;i++)
+	{
+		CSGObject* element=m_bags->get_element(i);
+		compiled->add_tree(dynamic_cast<CCARTree*>(element));
+		SG_UNREF(element);
+	}
+
+	SG_UNREF(m_compiled_trees);
+	m_compiled_trees=compiled;
+}
+
+SGMatrix<float64_t> CRandomForest::apply_outputs_without_combination(CFeatures* data)
+{
+	if (!m_compiled_trees)
+		return CBaggingMachine::apply_outputs_without_combination(data);
+
+	require(data, "Data not supplied");
+	return m_compiled_trees->apply_trees(data->as<CDenseFeatures<float64_t>>());
+}
+
 bool CRandomForest::train_machine(CFeatures* data)
 {
 	if (data)
@@ -174,8 +216,16 @@ bool CRandomForest::train_machine(CFeatures* data)
 	}
 	
 	require(m_features, "Training features not set!");
+
+	// the compiled trees belong to the previous training
+	SG_UNREF(m_compiled_trees);
+	m_compiled_trees=NULL;
 	
-	dynamic_cast<CRandomCARTree*>(m_machine)->pre_sort_features(m_features, m_sorted_transposed_feats, m_sorted_indices);
+	CRandomCARTree* tree=dynamic_cast<CRandomCARTree*>(m_machine);
+	if (tree->get_use_histograms())
+		tree->quantize_features(m_features, m_binned_feats, m_bin_thresholds, m_num_bins);
+	else
+		tree->pre_sort_features(m_features, m_sorted_transposed_feats, m_sorted_indices);
 
 	return CBaggingMachine::train_machine();
 }
@@ -185,6 +235,8 @@ void CRandomForest::init()
 	m_machine=new CRandomCARTree();
 	SG_REF(m_machine);
 	m_weights=SGVector<float64_t>();
+	m_compiled_trees=NULL;
 
 	SG_ADD(&m_weights, kWeights, "weights");
+	SG_ADD(&m_compiled_trees, "compiled_trees", "trees compiled for inference");
 }
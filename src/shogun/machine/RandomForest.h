@@ -33,6 +33,7 @@
 
 #include <shogun/lib/config.h>
 #include <shogun/machine/BaggingMachine.h>
+#include <shogun/multiclass/tree/FlatTreeEnsemble.h>
 
 namespace shogun
 {
@@ -138,9 +139,39 @@ public:
 	 */
 	int32_t get_num_random_features() const;
 
+	/** set whether the trees search node splits on histograms of binned
+	 * features, the features are binned once for all trees
+	 *
+	 * @param histograms whether histograms are used
+	 */
+	void set_use_histograms(bool histograms);
+
+	/** get whether the trees search node splits on histograms
+	 *
+	 * @return whether histograms are used
+	 */
+	bool get_use_histograms() const;
+
+	/** compile the trained trees into flat node arrays, which are used by
+	 * all further applies until the forest is trained again
+	 *
+	 * @param float32_thresholds whether thresholds are stored in single precision
+	 */
+	void compile_trees(bool float32_thresholds=false);
+
+	/** @return whether the trees are compiled */
+	bool is_compiled() const { return m_compiled_trees!=NULL; }
+
 protected:
 
 	virtual bool train_machine(CFeatures* data=NULL);
+
+	/** outputs of all trees, from the compiled trees if available
+	 *
+	 * @param data the data to compute the output for
+	 * @return predictions
+	 */
+	virtual SGMatrix<float64_t> apply_outputs_without_combination(CFeatures* data);
 	/** sets parameters of CARTree - sets machine labels and weights here
 	 *
 	 * @param m machine
@@ -161,6 +192,18 @@ private:
 
 	/** Indices of pre-sorted features */
 	SGMatrix<index_t> m_sorted_indices;
+
+	/** Binned features */
+	SGMatrix<uint8_t> m_binned_feats;
+
+	/** Largest value of every bin */
+	SGMatrix<float64_t> m_bin_thresholds;
+
+	/** Number of bins of every feature */
+	SGVector<int32_t> m_num_bins;
+
+	/** Trees compiled for inference */
+	CFlatTreeEnsemble* m_compiled_trees;
 #ifndef SWIG
 public:
 	static constexpr std::string_view kWeights = "weights";
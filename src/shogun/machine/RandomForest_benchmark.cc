@@ -0,0 +1,114 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <shogun/base/some.h>
+#include <shogun/ensemble/MajorityVote.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/labels/MulticlassLabels.h>
+#include <shogun/machine/RandomForest.h>
+#include <shogun/util/benchmark_data.h>
+
+namespace shogun
+{
+
+/** number of trees of the benchmarked forests */
+static const int32_t forest_num_trees = 32;
+
+class RandomForestFixture : public benchmark::Fixture
+{
+public:
+	void SetUp(const ::benchmark::State& st)
+	{
+		SGVector<float64_t> lab;
+		feats = new CDenseFeatures<float64_t>(
+		    benchmark_blobs(st.range(1), st.range(0), 4, lab));
+		labels = new CMulticlassLabels(lab);
+		SG_REF(feats);
+		SG_REF(labels);
+	}
+
+	void TearDown(const ::benchmark::State&)
+	{
+		SG_UNREF(feats);
+		SG_UNREF(labels);
+	}
+
+	Some<CRandomForest> create_forest(bool use_histograms)
+	{
+		SGVector<bool> feature_types(feats->get_num_features());
+		feature_types.set_const(false);
+
+		auto forest = some<CRandomForest>(feats, labels, forest_num_trees);
+		forest->set_feature_types(feature_types);
+		forest->set_combination_rule(new CMajorityVote());
+		forest->set_use_histograms(use_histograms);
+		forest->put("seed", int32_t(benchmark_seed));
+		return forest;
+	}
+
+	void train(benchmark::State& state, bool use_histograms)
+	{
+		for (auto _ : state)
+			create_forest(use_histograms)->train(feats);
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	void apply(benchmark::State& state, bool compiled, bool float32_thresholds)
+	{
+		auto forest = create_forest(false);
+		forest->train(feats);
+		if (compiled)
+			forest->compile_trees(float32_thresholds);
+
+		for (auto _ : state)
+		{
+			auto result = forest->apply_multiclass(feats);
+			SG_UNREF(result);
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	CDenseFeatures<float64_t>* feats;
+	CMulticlassLabels* labels;
+};
+
+BENCHMARK_DEFINE_F(RandomForestFixture, RandomForest_train)(benchmark::State& state)
+{
+	train(state, false);
+}
+
+BENCHMARK_DEFINE_F(RandomForestFixture, RandomForest_train_histograms)(benchmark::State& state)
+{
+	train(state, true);
+}
+
+BENCHMARK_DEFINE_F(RandomForestFixture, RandomForest_apply)(benchmark::State& state)
+{
+	apply(state, false, false);
+}
+
+BENCHMARK_DEFINE_F(RandomForestFixture, RandomForest_apply_compiled)(benchmark::State& state)
+{
+	apply(state, true, false);
+}
+
+BENCHMARK_DEFINE_F(RandomForestFixture, RandomForest_apply_compiled_float32)(benchmark::State& state)
+{
+	apply(state, true, true);
+}
+
+#define ADD_RANDOMFOREST_ARGS(WHAT) \
+	WHAT->RangeMultiplier(4)->Ranges(BENCHMARK_SMALL_SCALE)->Unit(benchmark::kMillisecond);
+
+ADD_RANDOMFOREST_ARGS(BENCHMARK_REGISTER_F(RandomForestFixture, RandomForest_train))
+ADD_RANDOMFOREST_ARGS(BENCHMARK_REGISTER_F(RandomForestFixture, RandomForest_train_histograms))
+ADD_RANDOMFOREST_ARGS(BENCHMARK_REGISTER_F(RandomForestFixture, RandomForest_apply))
+ADD_RANDOMFOREST_ARGS(BENCHMARK_REGISTER_F(RandomForestFixture, RandomForest_apply_compiled))
+ADD_RANDOMFOREST_ARGS(BENCHMARK_REGISTER_F(RandomForestFixture, RandomForest_apply_compiled_float32))
+
+}
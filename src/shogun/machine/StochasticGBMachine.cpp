@@ -66,6 +66,7 @@ CStochasticGBMachine::~CStochasticGBMachine()
 	SG_UNREF(m_loss);
 	SG_UNREF(m_weak_learners);
 	SG_UNREF(m_gamma);
+	SG_UNREF(m_compiled_trees);
 }
 
 void CStochasticGBMachine::set_machine(CMachine* machine)
@@ -147,6 +148,15 @@ CRegressionLabels* CStochasticGBMachine::apply_regression(CFeatures* data)
 	require(data,"test data supplied is NULL");
 	CDenseFeatures<float64_t>* feats=data->as<CDenseFeatures<float64_t>>();
 
+	if (m_compiled_trees)
+	{
+		SGVector<float64_t> weights(m_num_iter);
+		for (int32_t i=0;i<m_num_iter;i++)
+			weights[i]=m_gamma->get_element(i)*m_learning_rate;
+
+		return new CRegressionLabels(m_compiled_trees->apply_sum(feats, weights));
+	}
+
 	SGVector<float64_t> retlabs(feats->get_num_vectors());
 	retlabs.fill_vector(retlabs.vector,retlabs.vlen,0);
 	for (int32_t i=0;i<m_num_iter;i++)
@@ -170,6 +180,32 @@ CRegressionLabels* CStochasticGBMachine::apply_regression(CFeatures* data)
 	return new CRegressionLabels(retlabs);
 }
 
+void CStochasticGBMachine::compile_trees(bool float32_thresholds)
+{
+	require(m_weak_learners->get_num_elements()==m_num_iter, "Machine not yet trained");
+
+	CFlatTreeEnsemble* compiled=new CFlatTreeEnsemble(float32_thresholds);
+	SG_REF(compiled);
+	for (int32_t i=0;i<m_num_iter;i++)
+	{
+		CSGObject* element=m_weak_learners->get_element(i);
+		CCARTree* tree=dynamic_cast<CCARTree*>(element);
+		if (!tree)
+		{
+			const std::string name=element->get_name();
+			SG_UNREF(element);
+			SG_UNREF(compiled);
+			error("Only CARTree weak learners can be compiled, weak learner {} is a {}", i, name);
+		}
+
+		compiled->add_tree(tree);
+		SG_UNREF(element);
+	}
+
+	SG_UNREF(m_compiled_trees);
+	m_compiled_trees=compiled;
+}
+
 bool CStochasticGBMachine::train_machine(CFeatures* data)
 {
 	require(data,"training data not supplied!");
@@ -181,6 +217,8 @@ bool CStochasticGBMachine::train_machine(CFeatures* data)
 
 	// initialize weak learners array and gamma array
 	initialize_learners();
+	SG_UNREF(m_compiled_trees);
+	m_compiled_trees=NULL;
 
 	// cache predicted labels for intermediate models
 	CRegressionLabels* interf=new CRegressionLabels(feats->get_num_vectors());
@@ -394,6 +432,7 @@ void CStochasticGBMachine::init()
 	m_num_iter=0;
 	m_subset_frac=0;
 	m_learning_rate=0;
+	m_compiled_trees=NULL;
 
 	m_weak_learners=new CDynamicObjectArray();
 	SG_REF(m_weak_learners);
@@ -408,4 +447,5 @@ void CStochasticGBMachine::init()
 	SG_ADD(&m_learning_rate, kLearningRate, "learning rate");
 	SG_ADD(&m_weak_learners, kWeakLearners, "array of weak learners");
 	SG_ADD((CSGObject**)&m_gamma, kGamma, "array of learner weights");
+	SG_ADD(&m_compiled_trees, "compiled_trees", "weak learners compiled for inference");
 }
@@ -39,6 +39,7 @@
 #include <shogun/loss/LossFunction.h>
 #include <shogun/machine/Machine.h>
 #include <shogun/mathematics/RandomMixin.h>
+#include <shogun/multiclass/tree/FlatTreeEnsemble.h>
 
 #include <tuple>
 
@@ -143,6 +144,17 @@ public:
 	 */
 	virtual CRegressionLabels* apply_regression(CFeatures* data=NULL);
 
+	/** compile the trained weak learners into flat node arrays, which are
+	 * used by all further applies until the machine is trained again. The
+	 * weak learners have to be CARTrees.
+	 *
+	 * @param float32_thresholds whether thresholds are stored in single precision
+	 */
+	void compile_trees(bool float32_thresholds=false);
+
+	/** @return whether the weak learners are compiled */
+	bool is_compiled() const { return m_compiled_trees!=NULL; }
+
 protected:
 	/** train machine
 	 *
@@ -232,6 +244,9 @@ protected:
 
 	/** gamma - weak learner weights */
 	CDynamicArray<float64_t>* m_gamma;
+
+	/** weak learners compiled for inference */
+	CFlatTreeEnsemble* m_compiled_trees;
 #ifndef SWIG
 public:
 	static constexpr std::string_view kMachine = "machine";
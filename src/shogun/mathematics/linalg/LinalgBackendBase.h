@@ -36,6 +36,7 @@
 #include <memory>
 #include <shogun/io/SGIO.h>
 #include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGSparseMatrix.h>
 #include <shogun/lib/SGVector.h>
 #include <shogun/lib/common.h>
 #include <shogun/lib/config.h>
@@ -463,6 +464,22 @@ namespace shogun
 		DEFINE_FOR_ALL_PTYPE(BACKEND_GENERIC_IN_PLACE_MATRIX_PROD, SGMatrix)
 #undef BACKEND_GENERIC_IN_PLACE_MATRIX_PROD
 
+/**
+ * Wrapper method of sparse matrix product method.
+ *
+ * @see linalg::matrix_prod
+ */
+#define BACKEND_GENERIC_IN_PLACE_SPARSE_MATRIX_PROD(Type, Container)           \
+	virtual void matrix_prod(                                                  \
+	    const SGSparseMatrix<Type>& a, const Container<Type>& b,               \
+	    Container<Type>& result, bool transpose_A) const                       \
+	{                                                                          \
+		not_implemented(SOURCE_LOCATION);;                                                    \
+	}
+		DEFINE_FOR_ALL_PTYPE(BACKEND_GENERIC_IN_PLACE_SPARSE_MATRIX_PROD, SGVector)
+		DEFINE_FOR_ALL_PTYPE(BACKEND_GENERIC_IN_PLACE_SPARSE_MATRIX_PROD, SGMatrix)
+#undef BACKEND_GENERIC_IN_PLACE_SPARSE_MATRIX_PROD
+
 /**
  * Wrapper method of max method. Return the largest element in a vector or
  * matrix.
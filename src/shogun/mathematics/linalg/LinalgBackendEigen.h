@@ -257,6 +257,15 @@ namespace shogun
 		DEFINE_FOR_ALL_PTYPE(BACKEND_GENERIC_IN_PLACE_MATRIX_PROD, SGMatrix)
 #undef BACKEND_GENERIC_IN_PLACE_MATRIX_PROD
 
+/** Implementation of @see LinalgBackendBase::matrix_prod */
+#define BACKEND_GENERIC_IN_PLACE_SPARSE_MATRIX_PROD(Type, Container)           \
+	virtual void matrix_prod(                                                  \
+	    const SGSparseMatrix<Type>& a, const Container<Type>& b,               \
+	    Container<Type>& result, bool transpose_A) const;
+		DEFINE_FOR_NUMERIC_PTYPE(BACKEND_GENERIC_IN_PLACE_SPARSE_MATRIX_PROD, SGVector)
+		DEFINE_FOR_NUMERIC_PTYPE(BACKEND_GENERIC_IN_PLACE_SPARSE_MATRIX_PROD, SGMatrix)
+#undef BACKEND_GENERIC_IN_PLACE_SPARSE_MATRIX_PROD
+
 /** Implementation of @see LinalgBackendBase::max */
 #define BACKEND_GENERIC_MAX(Type, Container)                                   \
 	virtual Type max(const Container<Type>& a) const;
@@ -690,6 +699,18 @@ namespace shogun
 		    const SGMatrix<T>& a, const SGMatrix<T>& b, SGMatrix<T>& result,
 		    bool transpose_A, bool transpose_B) const;
 
+		/** Multithreaded sparse matrix * vector in-place product method */
+		template <typename T>
+		void matrix_prod_impl(
+		    const SGSparseMatrix<T>& a, const SGVector<T>& b,
+		    SGVector<T>& result, bool transpose_A) const;
+
+		/** Multithreaded sparse matrix * matrix in-place product method */
+		template <typename T>
+		void matrix_prod_impl(
+		    const SGSparseMatrix<T>& a, const SGMatrix<T>& b,
+		    SGMatrix<T>& result, bool transpose_A) const;
+
 		/** Return the largest element in the vector with Eigen3 library */
 		template <typename T>
 		T max_impl(const SGVector<T>& vec) const;
@@ -1433,6 +1433,134 @@ namespace shogun
 			return result;
 		}
 
+		/** Performs the operation \f$x = Ab\f$ for a sparse matrix A, whose
+		 * sparse vectors are the columns, i.e. A has num_features rows and
+		 * num_vectors columns like the matrix of sparse features.
+		 * With transpose, every element of the result is the dot product of
+		 * a sparse vector with b. The vectors are processed in parallel.
+		 * This operation works with CPU backends only.
+		 *
+		 * This version returns the result in-place.
+		 * User should pass an appropriately allocated memory vector.
+		 *
+		 * @param A The sparse matrix
+		 * @param b The vector
+		 * @param result Result vector
+		 * @param transpose Whether to transpose the matrix. Default false
+		 */
+		template <typename T>
+		void matrix_prod(
+		    const SGSparseMatrix<T>& A, const SGVector<T>& b,
+		    SGVector<T>& result, bool transpose = false)
+		{
+			if (transpose)
+			{
+				require(
+				    A.num_features == b.vlen,
+				    "Number of features of sparse matrix A ({}) doesn't match "
+				    "length of vector b ({}).",
+				    A.num_features, b.vlen);
+				require(
+				    result.vlen == A.num_vectors,
+				    "Length of vector result ({}) doesn't match number of "
+				    "vectors of sparse matrix A ({}).",
+				    result.vlen, A.num_vectors);
+			}
+			else
+			{
+				require(
+				    A.num_vectors == b.vlen,
+				    "Number of vectors of sparse matrix A ({}) doesn't match "
+				    "length of vector b ({}).",
+				    A.num_vectors, b.vlen);
+				require(
+				    result.vlen == A.num_features,
+				    "Length of vector result ({}) doesn't match number of "
+				    "features of sparse matrix A ({}).",
+				    result.vlen, A.num_features);
+			}
+			require(
+			    !b.on_gpu() && !result.on_gpu(),
+			    "Sparse matrix products are not supported on GPU.");
+
+			env()->linalg()->get_cpu_backend()->matrix_prod(
+			    A, b, result, transpose);
+		}
+
+		/** Performs the operation \f$x = Ab\f$ for a sparse matrix A,
+		 * see above. This version returns the result in a newly created
+		 * vector.
+		 *
+		 * @param A The sparse matrix
+		 * @param b The vector
+		 * @param transpose Whether to transpose the matrix. Default false
+		 * @return result Result vector
+		 */
+		template <typename T>
+		SGVector<T> matrix_prod(
+		    const SGSparseMatrix<T>& A, const SGVector<T>& b,
+		    bool transpose = false)
+		{
+			SGVector<T> result(transpose ? A.num_vectors : A.num_features);
+			matrix_prod(A, b, result, transpose);
+			return result;
+		}
+
+		/** Performs the operation C = A * B for a sparse matrix A, whose
+		 * sparse vectors are the columns, and a dense matrix B.
+		 * This operation works with CPU backends only.
+		 *
+		 * This version returns the result in-place.
+		 * User should pass an appropriately allocated memory matrix.
+		 *
+		 * @param A The sparse matrix
+		 * @param B The dense matrix
+		 * @param result Result matrix
+		 * @param transpose_A whether to transpose sparse matrix A
+		 */
+		template <typename T>
+		void matrix_prod(
+		    const SGSparseMatrix<T>& A, const SGMatrix<T>& B,
+		    SGMatrix<T>& result, bool transpose_A = false)
+		{
+			const index_t rows = transpose_A ? A.num_vectors : A.num_features;
+			const index_t inner = transpose_A ? A.num_features : A.num_vectors;
+			require(
+			    inner == B.num_rows,
+			    "Number of {} of sparse matrix A ({}) and number of rows for "
+			    "B ({}) should be equal!",
+			    transpose_A ? "features" : "vectors", inner, B.num_rows);
+			require(
+			    result.num_rows == rows && result.num_cols == B.num_cols,
+			    "Dimension mismatch! Result matrix ({}x{}) should be {}x{}.",
+			    result.num_rows, result.num_cols, rows, B.num_cols);
+			require(
+			    !B.on_gpu() && !result.on_gpu(),
+			    "Sparse matrix products are not supported on GPU.");
+
+			env()->linalg()->get_cpu_backend()->matrix_prod(
+			    A, B, result, transpose_A);
+		}
+
+		/** Performs the operation C = A * B for a sparse matrix A, see
+		 * above. This version returns the result in a newly created matrix.
+		 *
+		 * @param A The sparse matrix
+		 * @param B The dense matrix
+		 * @param transpose_A whether to transpose sparse matrix A
+		 * @return The result of the operation
+		 */
+		template <typename T>
+		SGMatrix<T> matrix_prod(
+		    const SGSparseMatrix<T>& A, const SGMatrix<T>& B,
+		    bool transpose_A = false)
+		{
+			SGMatrix<T> result(
+			    transpose_A ? A.num_vectors : A.num_features, B.num_cols);
+			matrix_prod(A, B, result, transpose_A);
+			return result;
+		}
+
 		/**
 		 * Performs the operation y = \alpha ax + \beta y
 		 * This function multiplies a * x (after transposing a, if needed)
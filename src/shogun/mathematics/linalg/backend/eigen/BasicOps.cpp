@@ -30,10 +30,16 @@
  * Authors: 2016 Pan Deng, Soumyajit De, Heiko Strathmann, Viktor Gal
  */
 
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/base/TaskScheduler.h>
 #include <shogun/base/range.h>
+#include <shogun/lib/SGSparseVector.h>
 #include <shogun/mathematics/linalg/LinalgBackendEigen.h>
 #include <shogun/mathematics/linalg/LinalgMacros.h>
 
+#include <algorithm>
+#include <mutex>
+
 using namespace shogun;
 
 #define BACKEND_GENERIC_IN_PLACE_ADD(Type, Container)                          \
@@ -192,6 +198,17 @@ DEFINE_FOR_ALL_PTYPE(BACKEND_GENERIC_IN_PLACE_MATRIX_PROD, SGVector)
 DEFINE_FOR_ALL_PTYPE(BACKEND_GENERIC_IN_PLACE_MATRIX_PROD, SGMatrix)
 #undef BACKEND_GENERIC_IN_PLACE_MATRIX_PROD
 
+#define BACKEND_GENERIC_IN_PLACE_SPARSE_MATRIX_PROD(Type, Container)           \
+	void LinalgBackendEigen::matrix_prod(                                      \
+	    const SGSparseMatrix<Type>& a, const Container<Type>& b,               \
+	    Container<Type>& result, bool transpose_A) const                       \
+	{                                                                          \
+		matrix_prod_impl(a, b, result, transpose_A);                           \
+	}
+DEFINE_FOR_NUMERIC_PTYPE(BACKEND_GENERIC_IN_PLACE_SPARSE_MATRIX_PROD, SGVector)
+DEFINE_FOR_NUMERIC_PTYPE(BACKEND_GENERIC_IN_PLACE_SPARSE_MATRIX_PROD, SGMatrix)
+#undef BACKEND_GENERIC_IN_PLACE_SPARSE_MATRIX_PROD
+
 #define BACKEND_GENERIC_IN_PLACE_SCALE(Type, Container)                        \
 	void LinalgBackendEigen::scale(                                            \
 	    const Container<Type>& a, Type alpha, Container<Type>& result) const   \
@@ -489,6 +506,114 @@ void LinalgBackendEigen::matrix_prod_impl(
 		result_eig = a_eig * b_eig;
 }
 
+/** @return chunk size that gives one chunk per thread, for products that
+ * scatter into per thread sums as large as the result
+ */
+static index_t sparse_scatter_grain(index_t num_vectors)
+{
+	const index_t num_threads = env()->get_num_threads();
+	return std::max(
+	    (num_vectors + num_threads - 1) / num_threads, index_t(1024));
+}
+
+template <typename T>
+void LinalgBackendEigen::matrix_prod_impl(
+    const SGSparseMatrix<T>& a, const SGVector<T>& b, SGVector<T>& result,
+    bool transpose_A) const
+{
+	if (transpose_A)
+	{
+		// a dot product of every sparse vector, which are independent
+		parallel_for(0, a.num_vectors, [&](index_t start, index_t end) {
+			for (index_t i = start; i < end; ++i)
+			{
+				const SGSparseVector<T>& vec = a[i];
+				T sum = 0;
+				for (index_t k = 0; k < vec.num_feat_entries; ++k)
+					sum += vec.features[k].entry * b[vec.features[k].feat_index];
+				result[i] = sum;
+			}
+		});
+		return;
+	}
+
+	result.zero();
+	std::mutex result_mutex;
+	parallel_for(
+	    0, a.num_vectors,
+	    [&](index_t start, index_t end) {
+		    SGVector<T> sum(result.vlen);
+		    sum.zero();
+		    for (index_t i = start; i < end; ++i)
+		    {
+			    const SGSparseVector<T>& vec = a[i];
+			    for (index_t k = 0; k < vec.num_feat_entries; ++k)
+				    sum[vec.features[k].feat_index] +=
+				        vec.features[k].entry * b[i];
+		    }
+
+		    std::lock_guard<std::mutex> lock(result_mutex);
+		    for (index_t j = 0; j < result.vlen; ++j)
+			    result[j] += sum[j];
+	    },
+	    sparse_scatter_grain(a.num_vectors));
+}
+
+template <typename T>
+void LinalgBackendEigen::matrix_prod_impl(
+    const SGSparseMatrix<T>& a, const SGMatrix<T>& b, SGMatrix<T>& result,
+    bool transpose_A) const
+{
+	if (transpose_A)
+	{
+		// a row of the result for every sparse vector, the columns of b
+		// are gathered one after the other
+		parallel_for(0, a.num_vectors, [&](index_t start, index_t end) {
+			for (index_t i = start; i < end; ++i)
+			{
+				const SGSparseVector<T>& vec = a[i];
+				for (index_t c = 0; c < b.num_cols; ++c)
+				{
+					const T* col = b.get_column_vector(c);
+					T sum = 0;
+					for (index_t k = 0; k < vec.num_feat_entries; ++k)
+						sum += vec.features[k].entry *
+						       col[vec.features[k].feat_index];
+					result(i, c) = sum;
+				}
+			}
+		});
+		return;
+	}
+
+	result.zero();
+	std::mutex result_mutex;
+	parallel_for(
+	    0, a.num_vectors,
+	    [&](index_t start, index_t end) {
+		    SGMatrix<T> sum(result.num_rows, result.num_cols);
+		    sum.zero();
+		    for (index_t i = start; i < end; ++i)
+		    {
+			    const SGSparseVector<T>& vec = a[i];
+			    for (index_t c = 0; c < b.num_cols; ++c)
+			    {
+				    const T factor = b(i, c);
+				    T* col = sum.get_column_vector(c);
+				    for (index_t k = 0; k < vec.num_feat_entries; ++k)
+					    col[vec.features[k].feat_index] +=
+					        vec.features[k].entry * factor;
+			    }
+		    }
+
+		    std::lock_guard<std::mutex> lock(result_mutex);
+		    typename SGMatrix<T>::EigenMatrixXtMap result_eig = result;
+		    typename SGMatrix<T>::EigenMatrixXtMap sum_eig = sum;
+		    result_eig += sum_eig;
+	    },
+	    sparse_scatter_grain(a.num_vectors));
+}
+
 template <typename T>
 void LinalgBackendEigen::scale_impl(
     const SGVector<T>& a, T alpha, SGVector<T>& result) const
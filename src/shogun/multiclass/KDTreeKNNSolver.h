@@ -11,6 +11,7 @@
 #include <shogun/lib/common.h>
 #include <shogun/distance/Distance.h>
 #include <shogun/multiclass/KNNSolver.h>
+#include <shogun/multiclass/tree/NbodyTreeIndex.h>
 
 namespace shogun
 {
@@ -31,7 +32,7 @@ class CKDTREEKNNSolver : public CKNNSolver
 		}
 
 		/** deconstructor */
-		virtual ~CKDTREEKNNSolver() { /* nothing to do */ }
+		virtual ~CKDTREEKNNSolver();
 
 		/** constructor
 		 *
@@ -41,8 +42,9 @@ class CKDTREEKNNSolver : public CKNNSolver
 		 * @param min_label m_min_label
 		 * @param train_labels m_train_labels
 		 * @param leaf_size m_leaf_size
+		 * @param index mapped index queried instead of building a tree, optional
 		 */
-		CKDTREEKNNSolver(const int32_t k, const float64_t q, const int32_t num_classes, const int32_t min_label, const SGVector<int32_t> train_labels, const int32_t leaf_size);
+		CKDTREEKNNSolver(const int32_t k, const float64_t q, const int32_t num_classes, const int32_t min_label, const SGVector<int32_t> train_labels, const int32_t leaf_size, CNbodyTreeIndex* index=NULL);
 
 		virtual CMulticlassLabels* classify_objects(CDistance* d, const int32_t num_lab, SGVector<int32_t>& train_lab, SGVector<float64_t>& classes) const;
 
@@ -55,11 +57,21 @@ class CKDTREEKNNSolver : public CKNNSolver
 		void init()
 		{
 			m_leaf_size=0;
+			m_index=NULL;
 		}
 
+		/** k nearest neighbours of the rhs vectors among the lhs vectors
+		 * @param knn_distance distance holding the vectors
+		 * @return k x num_rhs matrix of neighbour indices
+		 */
+		SGMatrix<index_t> query_knn(CDistance* knn_distance) const;
+
 	protected:
 		// leaf size of K-D tree
 		int32_t m_leaf_size;
+
+		// mapped index of the lhs vectors
+		CNbodyTreeIndex* m_index;
 };
 }
 
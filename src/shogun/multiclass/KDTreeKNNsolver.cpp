@@ -3,44 +3,76 @@
  * Copyright (c) 2012-2013 Sergey Lisitsyn
  */
 
+#include <shogun/base/TaskScheduler.h>
 #include <shogun/multiclass/KDTreeKNNSolver.h>
 #include <shogun/multiclass/tree/KDTree.h>
 #include <shogun/lib/Signal.h>
 
 using namespace shogun;
 
-CKDTREEKNNSolver::CKDTREEKNNSolver(const int32_t k, const float64_t q, const int32_t num_classes, const int32_t min_label, const SGVector<int32_t> train_labels,  const int32_t leaf_size):
+CKDTREEKNNSolver::CKDTREEKNNSolver(const int32_t k, const float64_t q, const int32_t num_classes, const int32_t min_label, const SGVector<int32_t> train_labels,  const int32_t leaf_size, CNbodyTreeIndex* index):
 CKNNSolver(k, q, num_classes, min_label, train_labels)
 {
 	init();
 
 	m_leaf_size=leaf_size;
+	m_index=index;
+	SG_REF(m_index);
 }
 
-CMulticlassLabels* CKDTREEKNNSolver::classify_objects(CDistance* knn_distance, const int32_t num_lab, SGVector<int32_t>& train_lab, SGVector<float64_t>& classes) const
+CKDTREEKNNSolver::~CKDTREEKNNSolver()
 {
-	CMulticlassLabels* output=new CMulticlassLabels(num_lab);
-	CFeatures* lhs = knn_distance->get_lhs();
-	CKDTree* kd_tree = new CKDTree(m_leaf_size);
-	kd_tree->build_tree(dynamic_cast<CDenseFeatures<float64_t>*>(lhs));
-	SG_UNREF(lhs);
+	SG_UNREF(m_index);
+}
 
+SGMatrix<index_t> CKDTREEKNNSolver::query_knn(CDistance* knn_distance) const
+{
 	CFeatures* query = knn_distance->get_rhs();
-	kd_tree->query_knn(dynamic_cast<CDenseFeatures<float64_t>*>(query), m_k);
-	SGMatrix<index_t> NN = kd_tree->get_knn_indices();
-	for (int32_t i = 0; i < num_lab && (!cancel_computation()); i++)
+	SGMatrix<index_t> NN;
+	if (m_index)
 	{
-		//write the labels of the k nearest neighbors from theirs indices
-		for (int32_t j=0; j<m_k; j++)
-			train_lab[j] = m_train_labels[ NN(j,i) ];
-
-		//get the index of the 'nearest' class
-		int32_t out_idx = choose_class(classes.vector, train_lab.vector);
-		//write the label of 'nearest' in the output
-		output->set_label(i, out_idx + m_min_label);
+		m_index->query_knn(dynamic_cast<CDenseFeatures<float64_t>*>(query), m_k);
+		NN = m_index->get_knn_indices();
+	}
+	else
+	{
+		CFeatures* lhs = knn_distance->get_lhs();
+		CKDTree* kd_tree = new CKDTree(m_leaf_size);
+		kd_tree->build_tree(dynamic_cast<CDenseFeatures<float64_t>*>(lhs));
+		SG_UNREF(lhs);
+
+		kd_tree->query_knn_dual(dynamic_cast<CDenseFeatures<float64_t>*>(query), m_k);
+		NN = kd_tree->get_knn_indices();
+		SG_UNREF(kd_tree);
 	}
 	SG_UNREF(query);
-	SG_UNREF(kd_tree);
+
+	return NN;
+}
+
+CMulticlassLabels* CKDTREEKNNSolver::classify_objects(CDistance* knn_distance, const int32_t num_lab, SGVector<int32_t>& train_lab, SGVector<float64_t>& classes) const
+{
+	CMulticlassLabels* output=new CMulticlassLabels(num_lab);
+	SGMatrix<index_t> NN = query_knn(knn_distance);
+	parallel_for(0, num_lab, [&](index_t start, index_t end) {
+		if (cancel_computation())
+			return;
+
+		// the buffers passed in are shared, every chunk gets its own
+		SGVector<int32_t> chunk_train_lab(train_lab.vlen);
+		SGVector<float64_t> chunk_classes(classes.vlen);
+		for (int32_t i = start; i < end; i++)
+		{
+			//write the labels of the k nearest neighbors from theirs indices
+			for (int32_t j=0; j<m_k; j++)
+				chunk_train_lab[j] = m_train_labels[ NN(j,i) ];
+
+			//get the index of the 'nearest' class
+			int32_t out_idx = choose_class(chunk_classes.vector, chunk_train_lab.vector);
+			//write the label of 'nearest' in the output
+			output->set_label(i, out_idx + m_min_label);
+		}
+	});
 	return output;
 }
 
@@ -48,32 +80,28 @@ SGVector<int32_t> CKDTREEKNNSolver::classify_objects_k(CDistance* knn_distance,
 {
 	SGVector<int32_t> output(m_k*num_lab);
 
-	//allocation for distances to nearest neighbors
-	SGVector<float64_t> dists(m_k);
+	SGMatrix<index_t> NN = query_knn(knn_distance);
+	parallel_for(0, num_lab, [&](index_t start, index_t end) {
+		if (cancel_computation())
+			return;
 
-	CFeatures* lhs = knn_distance->get_lhs();
-	CKDTree* kd_tree = new CKDTree(m_leaf_size);
-	kd_tree->build_tree(dynamic_cast<CDenseFeatures<float64_t>*>(lhs));
-	SG_UNREF(lhs);
-
-	CFeatures* data = knn_distance->get_rhs();
-	kd_tree->query_knn(dynamic_cast<CDenseFeatures<float64_t>*>(data), m_k);
-	SGMatrix<index_t> NN = kd_tree->get_knn_indices();
-	for (index_t i = 0; i < num_lab && (!cancel_computation()); i++)
-	{
-		//write the labels of the k nearest neighbors from theirs indices
-		for (index_t j=0; j<m_k; j++)
+		// the buffers passed in are shared, every chunk gets its own
+		SGVector<int32_t> chunk_train_lab(train_lab.vlen);
+		SGVector<int32_t> chunk_classes(classes.vlen);
+		SGVector<float64_t> dists(m_k);
+		for (index_t i = start; i < end; i++)
 		{
-			train_lab[j] = m_train_labels[ NN(j,i) ];
-			dists[j] = knn_distance->distance(NN(j,i), i);
-		}
-		CMath::qsort_index(dists.vector, train_lab.vector, m_k);
+			//write the labels of the k nearest neighbors from theirs indices
+			for (index_t j=0; j<m_k; j++)
+			{
+				chunk_train_lab[j] = m_train_labels[ NN(j,i) ];
+				dists[j] = knn_distance->distance(NN(j,i), i);
+			}
+			CMath::qsort_index(dists.vector, chunk_train_lab.vector, m_k);
 
-		choose_class_for_multiple_k(output.vector+i, classes.vector, train_lab.vector, num_lab);
-	}
+			choose_class_for_multiple_k(output.vector+i, chunk_classes.vector, chunk_train_lab.vector, num_lab);
+		}
+	});
 
-	SG_UNREF(data);
-	SG_UNREF(kd_tree);
-	
 	return output;
 }
@@ -8,11 +8,13 @@
 
 #include <shogun/base/Parameter.h>
 #include <shogun/base/progress.h>
+#include <shogun/base/TaskScheduler.h>
 #include <shogun/labels/Labels.h>
 #include <shogun/lib/Signal.h>
 #include <shogun/lib/Time.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/multiclass/KNN.h>
+#include <shogun/multiclass/tree/KDTree.h>
 
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
 
@@ -20,6 +22,14 @@
 
 using namespace shogun;
 
+/** number of test examples whose distances to all train examples are
+ * computed at once, bounded to about 16MB of distances
+ */
+static index_t query_block_size(index_t num_train)
+{
+	return CMath::clamp<index_t>((1 << 21) / CMath::max(num_train, 1), 1, 64);
+}
+
 CKNN::CKNN()
 : CDistanceMachine()
 {
@@ -52,6 +62,7 @@ void CKNN::init()
 	solver=NULL;
 	m_lsh_l = 0;
 	m_lsh_t = 0;
+	m_index=NULL;
 
 	/* use the method classify_multiply_k to experiment with different values
 	 * of k */
@@ -67,6 +78,7 @@ void CKNN::init()
 
 CKNN::~CKNN()
 {
+	SG_UNREF(m_index);
 }
 
 bool CKNN::train_machine(CFeatures* data)
@@ -112,41 +124,47 @@ SGMatrix<index_t> CKNN::nearest_neighbors()
 	    n >= m_k,
 	    "K ({}) must not be larger than the number of examples ({}).", m_k, n);
 
-	//distances to train data
-	SGVector<float64_t> dists(m_train_labels.vlen);
-	//indices to train data
-	SGVector<index_t> train_idxs(m_train_labels.vlen);
+	const index_t num_train=m_train_labels.vlen;
 	//pre-allocation of the nearest neighbors
 	SGMatrix<index_t> NN(m_k, n);
 
 	distance->precompute_lhs();
 	distance->precompute_rhs();
 
-	//for each test example
-	for (auto i : SG_PROGRESS(range(n)))
-	{
-		COMPUTATION_CONTROLLERS
-		//lhs idx 0..num train examples-1 (i.e., all train examples) and rhs idx i
-		distances_lhs(dists,0,m_train_labels.vlen-1,i);
+	auto pb = SG_PROGRESS(range(n));
+	parallel_for(0, n, [&](index_t start, index_t end) {
+		//distances of all train examples to a block of test examples
+		SGMatrix<float64_t> dists=
+			distance->get_distance_block(0, num_train, start, end);
+		//indices to train data
+		SGVector<index_t> train_idxs(num_train);
 
-		//fill in an array with 0..num train examples-1
-		for (int32_t j=0; j<m_train_labels.vlen; j++)
-			train_idxs[j]=j;
+		//for each test example
+		for (index_t i=start; i<end; i++)
+		{
+			COMPUTATION_CONTROLLERS
+			//fill in an array with 0..num train examples-1
+			train_idxs.range_fill();
 
-		//sort the distance vector between test example i and all train examples
-		CMath::qsort_index(dists.vector, train_idxs.vector, m_train_labels.vlen);
+			//sort the distance vector between test example i and all train examples
+			CMath::qsort_index(dists.get_column_vector(i-start),
+				train_idxs.vector, num_train);
 
 #ifdef DEBUG_KNN
-		io::print("\nQuick sort query {}\n", i);
-		for (int32_t j=0; j<m_k; j++)
-			io::print("{} ", train_idxs[j]);
-		io::print("\n");
+			io::print("\nQuick sort query {}\n", i);
+			for (int32_t j=0; j<m_k; j++)
+				io::print("{} ", train_idxs[j]);
+			io::print("\n");
 #endif
 
-		//fill in the output the indices of the nearest neighbors
-		for (int32_t j=0; j<m_k; j++)
-			NN(j,i) = train_idxs[j];
-	}
+			//fill in the output the indices of the nearest neighbors
+			for (int32_t j=0; j<m_k; j++)
+				NN(j,i) = train_idxs[j];
+
+			pb.print_progress();
+		}
+	}, query_block_size(num_train));
+	pb.complete();
 
 	distance->reset_precompute();
 
@@ -195,37 +213,44 @@ CMulticlassLabels* CKNN::classify_NN()
 	require(num_lab, "No vectors on right hand side");
 
 	CMulticlassLabels* output = new CMulticlassLabels(num_lab);
-	SGVector<float64_t> distances(m_train_labels.vlen);
+	const index_t num_train=m_train_labels.vlen;
 
 	io::info("{} test examples", num_lab);
 
 	distance->precompute_lhs();
 
-	// for each test example
-	for (auto i : SG_PROGRESS(range(num_lab)))
-	{
-		COMPUTATION_CONTROLLERS
-		// get distances from i-th test example to 0..num_m_train_labels-1 train examples
-		distances_lhs(distances,0,m_train_labels.vlen-1,i);
-		int32_t j;
-
-		// assuming 0th train examples as nearest to i-th test example
-		int32_t out_idx = 0;
-		float64_t min_dist = distances.vector[0];
+	auto pb = SG_PROGRESS(range(num_lab));
+	parallel_for(0, num_lab, [&](index_t start, index_t end) {
+		// distances from all train examples to a block of test examples
+		SGMatrix<float64_t> distances=
+			distance->get_distance_block(0, num_train, start, end);
 
-		// searching for nearest neighbor by comparing distances
-		for (j=0; j<m_train_labels.vlen; j++)
+		// for each test example
+		for (index_t i=start; i<end; i++)
 		{
-			if (distances.vector[j]<min_dist)
+			COMPUTATION_CONTROLLERS
+			const float64_t* distances_i=distances.get_column_vector(i-start);
+
+			// assuming 0th train examples as nearest to i-th test example
+			int32_t out_idx = 0;
+			float64_t min_dist = distances_i[0];
+
+			// searching for nearest neighbor by comparing distances
+			for (int32_t j=0; j<num_train; j++)
 			{
-				min_dist = distances.vector[j];
-				out_idx = j;
+				if (distances_i[j]<min_dist)
+				{
+					min_dist = distances_i[j];
+					out_idx = j;
+				}
 			}
-		}
 
-		// label i-th test example with label of nearest neighbor with out_idx index
-		output->set_label(i,m_train_labels.vector[out_idx]+m_min_label);
-	}
+			// label i-th test example with label of nearest neighbor with out_idx index
+			output->set_label(i,m_train_labels.vector[out_idx]+m_min_label);
+			pb.print_progress();
+		}
+	}, query_block_size(num_train));
+	pb.complete();
 
 	distance->reset_precompute();
 
@@ -288,6 +313,29 @@ bool CKNN::save(FILE* dstfile)
 	return false;
 }
 
+void CKNN::save_index(const char* fname)
+{
+	require(distance, "Distance not set.");
+	CFeatures* lhs=distance->get_lhs();
+	require(lhs, "No vectors on left hand side");
+
+	CKDTree* kd_tree=new CKDTree(m_leaf_size);
+	SG_REF(kd_tree);
+	kd_tree->build_tree(lhs->as<CDenseFeatures<float64_t>>());
+	SG_UNREF(lhs);
+
+	kd_tree->save_index(fname);
+	SG_UNREF(kd_tree);
+}
+
+void CKNN::load_index(const char* fname)
+{
+	CNbodyTreeIndex* index=new CNbodyTreeIndex(fname);
+	SG_REF(index);
+	SG_UNREF(m_index);
+	m_index=index;
+}
+
 void CKNN::init_solver(KNN_SOLVER knn_solver)
 {
 	switch (knn_solver)
@@ -301,7 +349,14 @@ void CKNN::init_solver(KNN_SOLVER knn_solver)
 	}
 	case KNN_KDTREE:
 	{
-		solver = new CKDTREEKNNSolver(m_k, m_q, m_num_classes, m_min_label, m_train_labels, m_leaf_size);
+		if (m_index)
+		{
+			require(
+			    m_index->get_num_vectors()==distance->get_num_vec_lhs(),
+			    "Index holds {} vectors, but there are {} training vectors",
+			    m_index->get_num_vectors(), distance->get_num_vec_lhs());
+		}
+		solver = new CKDTREEKNNSolver(m_k, m_q, m_num_classes, m_min_label, m_train_labels, m_leaf_size, m_index);
 		SG_REF(solver);
 		break;
 	}
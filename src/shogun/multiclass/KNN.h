@@ -210,6 +210,22 @@ class CKNN : public CDistanceMachine
 			m_lsh_t = t;
 		}
 
+		/** build a KD-tree on the training vectors and save it as an index
+		 * file, which can be mapped by load_index() instead of building the
+		 * tree again
+		 *
+		 * @param fname index file
+		 */
+		void save_index(const char* fname);
+
+		/** map an index file written by save_index(), the KD-tree solver
+		 * queries it instead of building a tree. The index has to be built on
+		 * the current training vectors.
+		 *
+		 * @param fname index file
+		 */
+		void load_index(const char* fname);
+
 	protected:
 		/** classify all examples with nearest neighbor (k=1)
 		 * @return classified labels
@@ -295,6 +311,9 @@ class CKNN : public CDistanceMachine
 
 		/* Number of probes per query for LSH */
 		int32_t m_lsh_t;
+
+		/** mapped index of the training vectors */
+		CNbodyTreeIndex* m_index;
 };
 
 }
@@ -0,0 +1,94 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <shogun/base/some.h>
+#include <shogun/distance/EuclideanDistance.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/labels/MulticlassLabels.h>
+#include <shogun/multiclass/KNN.h>
+#include <shogun/util/benchmark_data.h>
+
+namespace shogun
+{
+
+/** number of query vectors */
+static const index_t knn_num_queries = 1024;
+
+class KNNFixture : public benchmark::Fixture
+{
+public:
+	void SetUp(const ::benchmark::State& st)
+	{
+		SGVector<float64_t> lab;
+		SGMatrix<float64_t> data =
+		    benchmark_blobs(st.range(1), st.range(0) + knn_num_queries, 8, lab);
+
+		// the last vectors are the queries
+		SGMatrix<float64_t> train(data.num_rows, st.range(0));
+		sg_memcpy(train.matrix, data.matrix, int64_t(train.num_rows) * train.num_cols * sizeof(float64_t));
+		SGMatrix<float64_t> query(data.num_rows, knn_num_queries);
+		sg_memcpy(query.matrix, data.get_column_vector(st.range(0)),
+		    int64_t(query.num_rows) * query.num_cols * sizeof(float64_t));
+		lab.resize_vector(st.range(0));
+
+		feats = new CDenseFeatures<float64_t>(train);
+		query_feats = new CDenseFeatures<float64_t>(query);
+		labels = new CMulticlassLabels(lab);
+		SG_REF(feats);
+		SG_REF(query_feats);
+		SG_REF(labels);
+	}
+
+	void TearDown(const ::benchmark::State&)
+	{
+		SG_UNREF(feats);
+		SG_UNREF(query_feats);
+		SG_UNREF(labels);
+	}
+
+	void apply(benchmark::State& state, KNN_SOLVER solver)
+	{
+		auto distance = some<CEuclideanDistance>(feats, feats);
+		auto knn = some<CKNN>(5, distance, labels, solver);
+		knn->train();
+
+		for (auto _ : state)
+		{
+			auto result = knn->apply_multiclass(query_feats);
+			SG_UNREF(result);
+		}
+
+		state.SetItemsProcessed(state.iterations() * knn_num_queries);
+	}
+
+	CDenseFeatures<float64_t>* feats;
+	CDenseFeatures<float64_t>* query_feats;
+	CMulticlassLabels* labels;
+};
+
+BENCHMARK_DEFINE_F(KNNFixture, KNN_brute)(benchmark::State& state)
+{
+	apply(state, KNN_BRUTE);
+}
+
+BENCHMARK_DEFINE_F(KNNFixture, KNN_kdtree)(benchmark::State& state)
+{
+	apply(state, KNN_KDTREE);
+}
+
+BENCHMARK_DEFINE_F(KNNFixture, KNN_cover_tree)(benchmark::State& state)
+{
+	apply(state, KNN_COVER_TREE);
+}
+
+#define ADD_KNN_ARGS(WHAT) \
+	WHAT->RangeMultiplier(4)->Ranges(BENCHMARK_LARGE_SCALE)->Unit(benchmark::kMillisecond);
+
+ADD_KNN_ARGS(BENCHMARK_REGISTER_F(KNNFixture, KNN_brute))
+ADD_KNN_ARGS(BENCHMARK_REGISTER_F(KNNFixture, KNN_kdtree))
+ADD_KNN_ARGS(BENCHMARK_REGISTER_F(KNNFixture, KNN_cover_tree))
+
+}
@@ -15,11 +15,13 @@ using namespace shogun;
 CMulticlassLibSVM::CMulticlassLibSVM(LIBSVM_SOLVER_TYPE st)
 : CMulticlassSVM(new CMulticlassOneVsOneStrategy()), solver_type(st)
 {
+	register_params();
 }
 
 CMulticlassLibSVM::CMulticlassLibSVM(float64_t C, CKernel* k, CLabels* lab)
 : CMulticlassSVM(new CMulticlassOneVsOneStrategy(), C, k, lab), solver_type(LIBSVM_C_SVC)
 {
+	register_params();
 }
 
 CMulticlassLibSVM::~CMulticlassLibSVM()
@@ -28,10 +30,15 @@ CMulticlassLibSVM::~CMulticlassLibSVM()
 
 void CMulticlassLibSVM::register_params()
 {
+	m_use_kernel_row_cache = false;
+
 	SG_ADD_OPTIONS(
 	    (machine_int_t*)&solver_type, "libsvm_solver_type",
 	    "LibSVM solver type", ParameterProperties::NONE,
 	    SG_OPTIONS(LIBSVM_C_SVC, LIBSVM_NU_SVC));
+	SG_ADD(&m_use_kernel_row_cache, "use_kernel_row_cache",
+	    "Whether kernel rows are read from the kernel's row cache",
+	    ParameterProperties::SETTING);
 }
 
 bool CMulticlassLibSVM::train_machine(CFeatures* data)
@@ -97,6 +104,8 @@ bool CMulticlassLibSVM::train_machine(CFeatures* data)
 	param.weight_label = NULL;
 	param.weight = NULL;
 	param.use_bias = svm_proto()->get_bias_enabled();
+	param.use_kernel_row_cache = m_use_kernel_row_cache;
+	param.parallel_grain = LIBSVM_PARALLEL_GRAIN;
 
 	const char* error_msg = svm_check_parameter(&problem,&param);
 
@@ -44,6 +44,26 @@ class CMulticlassLibSVM : public CMulticlassSVM
 		/** @return object name */
 		virtual const char* get_name() const { return "MulticlassLibSVM"; }
 
+		/** read the rows of the kernel matrix from the shared row cache of
+		 * the kernel rather than computing them for every pair of classes.
+		 * The pairs are trained at the same time, so a row is computed once
+		 * for all pairs containing its class, but over all vectors rather
+		 * than the vectors of the two classes, which pays off if the cache
+		 * of the kernel is large enough to hold the rows.
+		 *
+		 * @param use_kernel_row_cache whether to use the kernel's row cache
+		 */
+		void set_use_kernel_row_cache(bool use_kernel_row_cache)
+		{
+			m_use_kernel_row_cache=use_kernel_row_cache;
+		}
+
+		/** @return whether the kernel's row cache is used */
+		bool get_use_kernel_row_cache() const
+		{
+			return m_use_kernel_row_cache;
+		}
+
 	protected:
 		/** train multiclass SVM classifier
 		 *
@@ -61,6 +81,8 @@ class CMulticlassLibSVM : public CMulticlassSVM
 	protected:
 		/** solver type */
 		LIBSVM_SOLVER_TYPE solver_type;
+		/** whether kernel rows are read from the kernel's row cache */
+		bool m_use_kernel_row_cache;
 };
 }
 #endif
@@ -182,6 +182,8 @@ bool CScatterSVM::train_no_bias_libsvm()
 	param.weight = weights;
 	param.nr_class=m_num_classes;
 	param.use_bias = svm_proto()->get_bias_enabled();
+	param.use_kernel_row_cache = false;
+	param.parallel_grain = LIBSVM_PARALLEL_GRAIN;
 
 	const char* error_msg = svm_check_parameter(&problem,&param);
 
@@ -319,6 +321,8 @@ bool CScatterSVM::train_testrule12()
 	param.weight = weights;
 	param.nr_class=m_num_classes;
 	param.use_bias = svm_proto()->get_bias_enabled();
+	param.use_kernel_row_cache = false;
+	param.parallel_grain = LIBSVM_PARALLEL_GRAIN;
 
 	const char* error_msg = svm_check_parameter(&problem,&param);
 
@@ -86,6 +86,17 @@ private:
 	 */
 	virtual float64_t max_dist_dual(bnode_t* nodeq, bnode_t* noder);
 
+	/** create an empty ball tree
+	 *
+	 * @param leaf_size min number of samples in any node
+	 * @param d distance metric to be used
+	 * @return new tree
+	 */
+	virtual CNbodyTree* create_tree(int32_t leaf_size, EDistanceType d) const
+	{
+		return new CBallTree(leaf_size,d);
+	}
+
 	/** get min as well as max distance of a node from a point
 	 *
 	 * @param pt point whose distance is to be calculated
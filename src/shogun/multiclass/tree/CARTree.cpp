@@ -28,8 +28,10 @@
  * either expressed or implied, of the Shogun Development Team.
  */
 
+#include <algorithm>
 #include <vector>
 
+#include <shogun/base/TaskScheduler.h>
 #include <shogun/lib/View.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/eigen3.h>
@@ -43,6 +45,8 @@ using namespace shogun;
 const float64_t CCARTree::MISSING=CMath::MAX_REAL_NUMBER;
 const float64_t CCARTree::EQ_DELTA=1e-7;
 const float64_t CCARTree::MIN_SPLIT_GAIN=1e-7;
+const uint8_t CCARTree::MISSING_BIN=255;
+const int32_t CCARTree::MAX_NOMINAL_SUBSET_BINS=63;
 
 CCARTree::CCARTree()
 : RandomMixin<CTreeMachine<CARTreeNodeData>>()
@@ -290,7 +294,15 @@ bool CCARTree::train_machine(CFeatures* data)
 	}
 
 	auto dense_labels = m_labels->as<CDenseLabels>();
-	set_root(CARTtrain(dense_features,m_weights,dense_labels,0));
+	if (m_histograms)
+	{
+		if (!m_pre_binned)
+			quantize_features(dense_features, m_binned_features, m_bin_thresholds, m_num_bins);
+
+		set_root(CARTtrain_histogram(dense_features,m_weights,dense_labels,get_binned_rows(dense_features)));
+	}
+	else
+		set_root(CARTtrain(dense_features,m_weights,dense_labels,0));
 
 	if (m_apply_cv_pruning)
 	{
@@ -327,6 +339,617 @@ void CCARTree::pre_sort_features(CFeatures* data, SGMatrix<float64_t>& sorted_fe
 
 }
 
+void CCARTree::set_max_bins(int32_t bins)
+{
+	require(bins>1 && bins<=255,"Max number of bins should be in [2, 255]. Supplied value is {}",bins);
+	m_max_bins=bins;
+}
+
+void CCARTree::set_binned_features(SGMatrix<uint8_t>& binned_feats, SGMatrix<float64_t>& bin_thresholds, SGVector<int32_t>& num_bins)
+{
+	m_pre_binned=true;
+	m_binned_features=binned_feats;
+	m_bin_thresholds=bin_thresholds;
+	m_num_bins=num_bins;
+}
+
+void CCARTree::quantize_features(CFeatures* data, SGMatrix<uint8_t>& binned_feats, SGMatrix<float64_t>& bin_thresholds, SGVector<int32_t>& num_bins)
+{
+	SGMatrix<float64_t> mat=(data)->as<CDenseFeatures<float64_t>>()->get_feature_matrix();
+	auto num_feats=mat.num_rows;
+	auto num_vecs=mat.num_cols;
+
+	binned_feats=SGMatrix<uint8_t>(num_vecs, num_feats);
+	bin_thresholds=SGMatrix<float64_t>(m_max_bins, num_feats);
+	num_bins=SGVector<int32_t>(num_feats);
+
+	parallel_for(0, num_feats, [&](index_t start, index_t end) {
+		std::vector<float64_t> values;
+		for (index_t i=start;i<end;++i)
+		{
+			values.clear();
+			for (index_t j=0;j<num_vecs;++j)
+			{
+				if (mat(i,j)!=MISSING)
+					values.push_back(mat(i,j));
+			}
+			std::sort(values.begin(), values.end());
+			index_t n_uvalues=0;
+			for (index_t j=0;j<(index_t)values.size();++j)
+			{
+				if (j==0 || values[j]>values[j-1])
+					n_uvalues++;
+			}
+
+			float64_t* thresholds=bin_thresholds.get_column_vector(i);
+			int32_t n_bins=0;
+			if (n_uvalues<=m_max_bins)
+			{
+				// every value gets its own bin
+				for (index_t j=0;j<(index_t)values.size();++j)
+				{
+					if (j==0 || values[j]>values[j-1])
+						thresholds[n_bins++]=values[j];
+				}
+			}
+			else
+			{
+				require(!types_set() || !m_nominal[i], "Nominal feature {} has {} values, "
+					"histograms support at most {}", i, n_uvalues, m_max_bins);
+
+				// bins at the quantiles of the values
+				for (int32_t b=1;b<=m_max_bins;++b)
+				{
+					float64_t value=values[int64_t(b)*values.size()/m_max_bins-1];
+					if (n_bins==0 || value>thresholds[n_bins-1])
+						thresholds[n_bins++]=value;
+				}
+			}
+			num_bins[i]=n_bins;
+
+			uint8_t* bins=binned_feats.get_column_vector(i);
+			for (index_t j=0;j<num_vecs;++j)
+			{
+				if (mat(i,j)==MISSING)
+					bins[j]=MISSING_BIN;
+				else
+					bins[j]=std::lower_bound(thresholds, thresholds+n_bins, mat(i,j))-thresholds;
+			}
+		}
+	}, 1);
+}
+
+SGVector<index_t> CCARTree::get_binned_rows(CDenseFeatures<float64_t>* data) const
+{
+	SGVector<index_t> rows(data->get_num_vectors());
+	CSubsetStack* subset_stack=data->get_subset_stack();
+	if (m_pre_binned && subset_stack->has_subsets())
+		rows=(subset_stack->get_last_subset())->get_subset_idx().clone();
+	else
+		linalg::range_fill(rows);
+	SG_UNREF(subset_stack);
+
+	return rows;
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+struct CCARTree::HistogramContext
+{
+	/** training data */
+	CDenseFeatures<float64_t>* data;
+	/** column of the binned features of every vector */
+	SGVector<index_t> rows;
+	/** weights of the vectors */
+	SGVector<float64_t> weights;
+	/** labels of the vectors */
+	SGVector<float64_t> labels;
+	/** class of the vectors, classification only */
+	SGVector<index_t> classes;
+	/** unique labels, classification only */
+	SGVector<float64_t> ulabels;
+	/** number of statistics per bin */
+	index_t num_stats;
+	/** offset of the histogram of every feature */
+	SGVector<index_t> offsets;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/** weighted impurity of the statistics of a bin range, that is the Gini
+ * index (classification) or the mean squared deviation (regression)
+ * times the total weight
+ */
+static float64_t weighted_impurity(const float64_t* stats, index_t num_stats, EProblemType mode, float64_t& total_weight)
+{
+	if (mode==PT_REGRESSION)
+	{
+		total_weight=stats[1];
+		if (total_weight<=0)
+			return 0;
+
+		return stats[3]-stats[2]*stats[2]/total_weight;
+	}
+
+	total_weight=0;
+	float64_t squares=0;
+	for (index_t c=1;c<num_stats;++c)
+	{
+		total_weight+=stats[c];
+		squares+=stats[c]*stats[c];
+	}
+	if (total_weight<=0)
+		return 0;
+
+	return total_weight-squares/total_weight;
+}
+
+/** sorts the present bins of a nominal feature by their weighted mean label
+ * (regression) or by the proportion of the first of two classes. The best
+ * division of the values is then one of the splits between neighbours in
+ * this order (Breiman et al, 1984), so I-1 instead of 2^(I-1)-1 divisions
+ * have to be tested.
+ */
+static void sort_nominal_bins(std::vector<int32_t>& ubins, const float64_t* hist, index_t num_stats, EProblemType mode)
+{
+	auto key=[&](int32_t b)
+	{
+		const float64_t* stats=hist+b*num_stats;
+		float64_t w=(mode==PT_REGRESSION) ? stats[1] : stats[1]+stats[2];
+		if (w<=0)
+			return 0.0;
+
+		return (mode==PT_REGRESSION) ? stats[2]/w : stats[1]/w;
+	};
+	std::stable_sort(ubins.begin(), ubins.end(),
+		[&](int32_t a, int32_t b) { return key(a)<key(b); });
+}
+
+CBinaryTreeMachineNode<CARTreeNodeData>* CCARTree::CARTtrain_histogram(CDenseFeatures<float64_t>* data, const SGVector<float64_t>& weights, CDenseLabels* labels, const SGVector<index_t>& rows)
+{
+	require(labels,"labels have to be supplied");
+	require(data,"data matrix has to be supplied");
+	require(m_num_bins.vlen==data->get_num_features(), "Binned features have {} features, "
+		"but the data has {}", m_num_bins.vlen, data->get_num_features());
+
+	HistogramContext ctx;
+	ctx.data=data;
+	ctx.rows=rows;
+	ctx.weights=weights;
+	ctx.labels=labels->get_labels();
+
+	switch(m_mode)
+	{
+		case PT_REGRESSION:
+			// count, weight, weighted sum and weighted sum of squares
+			ctx.num_stats=4;
+			break;
+		case PT_MULTICLASS:
+			{
+				index_t n_ulabels;
+				SGVector<float64_t> ulabels=get_unique_labels(ctx.labels, n_ulabels);
+				ctx.ulabels=SGVector<float64_t>(ulabels.vector, n_ulabels, false).clone();
+				ctx.classes=SGVector<index_t>(ctx.labels.vlen);
+				for (index_t i=0;i<ctx.labels.vlen;++i)
+				{
+					ctx.classes[i]=std::lower_bound(ctx.ulabels.begin(), ctx.ulabels.end(),
+						ctx.labels[i])-ctx.ulabels.begin();
+				}
+
+				// count and weight of every class
+				ctx.num_stats=n_ulabels+1;
+
+				// with more than two classes all divisions of the values of a
+				// nominal feature are tested, and stored as a bit mask
+				for (index_t i=0;n_ulabels>2 && i<m_num_bins.vlen;++i)
+				{
+					require(!m_nominal[i] || m_num_bins[i]<=MAX_NOMINAL_SUBSET_BINS,
+						"Nominal feature {} has {} values, histograms support at most {} "
+						"with more than two classes", i, m_num_bins[i], MAX_NOMINAL_SUBSET_BINS);
+				}
+				break;
+			}
+		default :
+			error("mode should be either PT_MULTICLASS or PT_REGRESSION");
+	}
+
+	ctx.offsets=SGVector<index_t>(m_num_bins.vlen+1);
+	ctx.offsets[0]=0;
+	for (index_t i=0;i<m_num_bins.vlen;++i)
+		ctx.offsets[i+1]=ctx.offsets[i]+m_num_bins[i]*ctx.num_stats;
+
+	SGVector<index_t> vecs(ctx.labels.vlen);
+	linalg::range_fill(vecs);
+
+	return grow_histogram_node(ctx, vecs, SGVector<float64_t>(), 0);
+}
+
+void CCARTree::build_histogram(const HistogramContext& ctx, const SGVector<index_t>& vecs, const SGVector<index_t>& feats, SGVector<float64_t>& histogram) const
+{
+	if (histogram.vlen==0)
+		histogram=SGVector<float64_t>(ctx.offsets[m_num_bins.vlen]);
+
+	const index_t num_rows=m_binned_features.num_rows;
+	const index_t num_stats=ctx.num_stats;
+	parallel_for(0, feats.vlen, [&](index_t start, index_t end) {
+		for (index_t i=start;i<end;++i)
+		{
+			index_t f=feats[i];
+			float64_t* hist=histogram.vector+ctx.offsets[f];
+			std::fill(hist, histogram.vector+ctx.offsets[f+1], 0.0);
+
+			const uint8_t* bins=m_binned_features.matrix+int64_t(f)*num_rows;
+			for (index_t j=0;j<vecs.vlen;++j)
+			{
+				index_t v=vecs[j];
+				uint8_t bin=bins[ctx.rows[v]];
+				if (bin==MISSING_BIN)
+					continue;
+
+				float64_t* stats=hist+bin*num_stats;
+				float64_t w=ctx.weights[v];
+				stats[0]+=1;
+				if (m_mode==PT_REGRESSION)
+				{
+					float64_t y=ctx.labels[v];
+					stats[1]+=w;
+					stats[2]+=w*y;
+					stats[3]+=w*y*y;
+				}
+				else
+				{
+					stats[1+ctx.classes[v]]+=w;
+				}
+			}
+		}
+	}, 1);
+}
+
+CBinaryTreeMachineNode<CARTreeNodeData>* CCARTree::grow_histogram_node(const HistogramContext& ctx, const SGVector<index_t>& vecs, SGVector<float64_t> histogram, int32_t level)
+{
+	bnode_t* node=new bnode_t();
+	const index_t num_vecs=vecs.vlen;
+	const index_t num_feats=m_num_bins.vlen;
+	const index_t num_stats=ctx.num_stats;
+	const bool ordered_nominal=(m_mode==PT_REGRESSION) || (num_stats==3);
+
+	// calculate node label
+	SGVector<float64_t> node_stats(num_stats);
+	node_stats.zero();
+	for (index_t j=0;j<num_vecs;++j)
+	{
+		index_t v=vecs[j];
+		float64_t w=ctx.weights[v];
+		node_stats[0]+=1;
+		if (m_mode==PT_REGRESSION)
+		{
+			node_stats[1]+=w;
+			node_stats[2]+=w*ctx.labels[v];
+			node_stats[3]+=w*ctx.labels[v]*ctx.labels[v];
+		}
+		else
+		{
+			node_stats[1+ctx.classes[v]]+=w;
+		}
+	}
+
+	float64_t tot=0;
+	float64_t node_impurity=weighted_impurity(node_stats.vector, num_stats, m_mode, tot);
+	node->data.total_weight=tot;
+	if (m_mode==PT_REGRESSION)
+	{
+		node->data.node_label=node_stats[2]/tot;
+		node->data.weight_minus_node=node_impurity;
+	}
+	else
+	{
+		index_t maxi=0;
+		for (index_t c=1;c<num_stats-1;++c)
+		{
+			if (node_stats[1+c]>node_stats[1+maxi])
+				maxi=c;
+		}
+		node->data.node_label=ctx.ulabels[maxi];
+		node->data.weight_minus_node=tot-node_stats[1+maxi];
+	}
+
+	// check stopping rules
+	// case 1 : max tree depth reached if max_depth set
+	// case 2 : min node size violated if min_node_size specified
+	// case 3 : node is pure
+	if (((m_max_depth>0) && (level==m_max_depth)) ||
+		((m_min_node_size>1) && (num_vecs<=m_min_node_size)) ||
+		node_impurity<=0)
+	{
+		node->data.num_leaves=1;
+		node->data.weight_minus_branch=node->data.weight_minus_node;
+		return node;
+	}
+
+	// features searched for the split
+	SGVector<index_t> idx(num_feats);
+	linalg::range_fill(idx);
+	index_t subset_size=get_split_subset_size(num_feats);
+	if (subset_size)
+	{
+		random::shuffle(idx, m_prng);
+		idx=SGVector<index_t>(idx.vector, subset_size, false).clone();
+		histogram=SGVector<float64_t>();
+		build_histogram(ctx, vecs, idx, histogram);
+	}
+	else if (histogram.vlen==0)
+	{
+		build_histogram(ctx, vecs, idx, histogram);
+	}
+
+	// best split of every searched feature
+	SGVector<float64_t> gains(idx.vlen);
+	SGVector<int64_t> splits(idx.vlen);
+	parallel_for(0, idx.vlen, [&](index_t start, index_t end) {
+		SGVector<float64_t> left_stats(num_stats);
+		SGVector<float64_t> right_stats(num_stats);
+		SGVector<float64_t> feat_stats(num_stats);
+		for (index_t i=start;i<end;++i)
+		{
+			gains[i]=MIN_SPLIT_GAIN;
+			splits[i]=-1;
+
+			index_t f=idx[i];
+			const float64_t* hist=histogram.vector+ctx.offsets[f];
+			const int32_t n_bins=m_num_bins[f];
+
+			// missing values are left out of the split
+			feat_stats.zero();
+			for (int32_t b=0;b<n_bins;++b)
+			{
+				for (index_t s=0;s<num_stats;++s)
+					feat_stats[s]+=hist[b*num_stats+s];
+			}
+			float64_t feat_weight=0;
+			float64_t feat_impurity=weighted_impurity(feat_stats.vector, num_stats, m_mode, feat_weight);
+			if (feat_weight<=0)
+				continue;
+
+			if (m_nominal[f])
+			{
+				std::vector<int32_t> ubins;
+				for (int32_t b=0;b<n_bins;++b)
+				{
+					if (hist[b*num_stats]>0)
+						ubins.push_back(b);
+				}
+				if (ubins.size()<2)
+					continue;
+
+				if (ordered_nominal)
+				{
+					// the first u+1 values in label order go to the left
+					sort_nominal_bins(ubins, hist, num_stats, m_mode);
+					left_stats.zero();
+					for (index_t u=0;u<(index_t)ubins.size()-1;++u)
+					{
+						for (index_t s=0;s<num_stats;++s)
+							left_stats[s]+=hist[ubins[u]*num_stats+s];
+						for (index_t s=0;s<num_stats;++s)
+							right_stats[s]=feat_stats[s]-left_stats[s];
+
+						float64_t wl=0, wr=0;
+						float64_t g=(feat_impurity
+							-weighted_impurity(left_stats.vector, num_stats, m_mode, wl)
+							-weighted_impurity(right_stats.vector, num_stats, m_mode, wr))/feat_weight;
+						if (g>gains[i])
+						{
+							gains[i]=g;
+							splits[i]=u;
+						}
+					}
+					continue;
+				}
+
+				// test all 2^(I-1)-1 divisions of the values present in the node
+				int64_t num_cases=int64_t(1)<<(ubins.size()-1);
+				for (int64_t k=1;k<num_cases;++k)
+				{
+					left_stats.zero();
+					for (index_t u=0;u<(index_t)ubins.size();++u)
+					{
+						if ((k>>u)&1)
+						{
+							for (index_t s=0;s<num_stats;++s)
+								left_stats[s]+=hist[ubins[u]*num_stats+s];
+						}
+					}
+					for (index_t s=0;s<num_stats;++s)
+						right_stats[s]=feat_stats[s]-left_stats[s];
+
+					float64_t wl=0, wr=0;
+					float64_t g=(feat_impurity
+						-weighted_impurity(left_stats.vector, num_stats, m_mode, wl)
+						-weighted_impurity(right_stats.vector, num_stats, m_mode, wr))/feat_weight;
+					if (g>gains[i])
+					{
+						gains[i]=g;
+						splits[i]=k;
+					}
+				}
+			}
+			else
+			{
+				// thresholds at the upper end of every bin
+				left_stats.zero();
+				for (int32_t b=0;b<n_bins-1;++b)
+				{
+					for (index_t s=0;s<num_stats;++s)
+						left_stats[s]+=hist[b*num_stats+s];
+					if (left_stats[0]==0 || hist[b*num_stats]==0)
+						continue;
+					if (left_stats[0]==feat_stats[0])
+						break;
+
+					for (index_t s=0;s<num_stats;++s)
+						right_stats[s]=feat_stats[s]-left_stats[s];
+
+					float64_t wl=0, wr=0;
+					float64_t g=(feat_impurity
+						-weighted_impurity(left_stats.vector, num_stats, m_mode, wl)
+						-weighted_impurity(right_stats.vector, num_stats, m_mode, wr))/feat_weight;
+					if (g>gains[i])
+					{
+						gains[i]=g;
+						splits[i]=b;
+					}
+				}
+			}
+		}
+	}, 1);
+
+	index_t best=-1;
+	float64_t max_gain=MIN_SPLIT_GAIN;
+	for (index_t i=0;i<idx.vlen;++i)
+	{
+		if (splits[i]>=0 && gains[i]>max_gain)
+		{
+			max_gain=gains[i];
+			best=i;
+		}
+	}
+
+	if (best==-1)
+	{
+		node->data.num_leaves=1;
+		node->data.weight_minus_branch=node->data.weight_minus_node;
+		return node;
+	}
+
+	const index_t best_attribute=idx[best];
+	const int32_t n_bins=m_num_bins[best_attribute];
+	const float64_t* thresholds=m_bin_thresholds.get_column_vector(best_attribute);
+	const float64_t* hist=histogram.vector+ctx.offsets[best_attribute];
+
+	// bins going to the left child
+	SGVector<bool> left_bins(n_bins);
+	std::vector<float64_t> left_transit;
+	std::vector<float64_t> right_transit;
+	if (m_nominal[best_attribute])
+	{
+		std::vector<int32_t> ubins;
+		for (int32_t b=0;b<n_bins;++b)
+		{
+			if (hist[b*num_stats]>0)
+				ubins.push_back(b);
+		}
+
+		left_bins.set_const(false);
+		if (ordered_nominal)
+		{
+			sort_nominal_bins(ubins, hist, num_stats, m_mode);
+			for (index_t u=0;u<=splits[best];++u)
+				left_bins[ubins[u]]=true;
+		}
+		else
+		{
+			for (index_t u=0;u<(index_t)ubins.size();++u)
+				left_bins[ubins[u]]=(splits[best]>>u)&1;
+		}
+
+		for (int32_t b=0;b<n_bins;++b)
+		{
+			if (hist[b*num_stats]==0)
+				continue;
+
+			if (left_bins[b])
+				left_transit.push_back(thresholds[b]);
+			else
+				right_transit.push_back(thresholds[b]);
+		}
+	}
+	else
+	{
+		for (int32_t b=0;b<n_bins;++b)
+			left_bins[b]=(b<=splits[best]);
+		left_transit.push_back(thresholds[splits[best]]);
+		right_transit.push_back(thresholds[splits[best]]);
+	}
+
+	// final data distribution among children
+	const uint8_t* bins=m_binned_features.get_column_vector(best_attribute);
+	SGVector<bool> left_final(num_vecs);
+	index_t num_missing=0;
+	for (index_t j=0;j<num_vecs;++j)
+	{
+		uint8_t bin=bins[ctx.rows[vecs[j]]];
+		if (bin==MISSING_BIN)
+			num_missing++;
+		else
+			left_final[j]=left_bins[bin];
+	}
+
+	if (num_missing>0)
+	{
+		// surrogate splits need the feature values of the node
+		SGMatrix<float64_t> mat(num_feats, num_vecs);
+		SGVector<float64_t> weights(num_vecs);
+		SGVector<bool> is_left_final(num_vecs-num_missing);
+		index_t ilf=0;
+		for (index_t j=0;j<num_vecs;++j)
+		{
+			int32_t len;
+			bool dofree;
+			float64_t* vec=ctx.data->get_feature_vector(vecs[j], len, dofree);
+			sg_memcpy(mat.get_column_vector(j), vec, num_feats*sizeof(float64_t));
+			ctx.data->free_feature_vector(vec, vecs[j], dofree);
+			weights[j]=ctx.weights[vecs[j]];
+
+			if (bins[ctx.rows[vecs[j]]]!=MISSING_BIN)
+				is_left_final[ilf++]=left_final[j];
+		}
+
+		left_final=surrogate_split(mat,weights,is_left_final,best_attribute);
+	}
+
+	index_t count_left=std::count(left_final.begin(), left_final.end(), true);
+	SGVector<index_t> vecsl(count_left);
+	SGVector<index_t> vecsr(num_vecs-count_left);
+	index_t l=0;
+	index_t r=0;
+	for (index_t j=0;j<num_vecs;++j)
+	{
+		if (left_final[j])
+			vecsl[l++]=vecs[j];
+		else
+			vecsr[r++]=vecs[j];
+	}
+
+	// the histograms of the larger child are the difference of the
+	// histograms of the node and of the smaller child
+	SGVector<float64_t> histl;
+	SGVector<float64_t> histr;
+	if (!subset_size)
+	{
+		SGVector<float64_t>& small=(vecsl.vlen<=vecsr.vlen) ? histl : histr;
+		SGVector<float64_t>& large=(vecsl.vlen<=vecsr.vlen) ? histr : histl;
+		build_histogram(ctx, (vecsl.vlen<=vecsr.vlen) ? vecsl : vecsr, idx, small);
+		large=histogram;
+		linalg::add(large, small, large, 1.0, -1.0);
+	}
+	histogram=SGVector<float64_t>();
+
+	bnode_t* left_child=grow_histogram_node(ctx, vecsl, histl, level+1);
+	histl=SGVector<float64_t>();
+	bnode_t* right_child=grow_histogram_node(ctx, vecsr, histr, level+1);
+
+	// set node parameters
+	node->data.attribute_id=best_attribute;
+	node->left(left_child);
+	node->right(right_child);
+	left_child->data.transit_into_values=SGVector<float64_t>(left_transit.size());
+	std::copy(left_transit.begin(), left_transit.end(), left_child->data.transit_into_values.begin());
+	right_child->data.transit_into_values=SGVector<float64_t>(right_transit.size());
+	std::copy(right_transit.begin(), right_transit.end(), right_child->data.transit_into_values.begin());
+	node->data.num_leaves=left_child->data.num_leaves+right_child->data.num_leaves;
+	node->data.weight_minus_branch=left_child->data.weight_minus_branch+right_child->data.weight_minus_branch;
+
+	return node;
+}
+
 CBinaryTreeMachineNode<CARTreeNodeData>* CCARTree::CARTtrain(CDenseFeatures<float64_t>* data, const SGVector<float64_t>& weights, CDenseLabels* labels, int32_t level)
 {
 	require(labels,"labels have to be supplied");
@@ -1188,6 +1811,11 @@ void CCARTree::prune_by_cross_validation(CDenseFeatures<float64_t>* data, int32_
 	SGVector<index_t> subid(num_vecs);
 	random::fill_array(subid, (int32_t)0, folds-1, m_prng);
 
+	// columns of the binned features of the vectors in histogram mode
+	SGVector<index_t> binned_rows;
+	if (m_histograms)
+		binned_rows=get_binned_rows(data);
+
 	// for each fold subset
 	std::vector<float64_t> r_cv;
 	std::vector<float64_t> alphak;
@@ -1220,7 +1848,17 @@ void CCARTree::prune_by_cross_validation(CDenseFeatures<float64_t>* data, int32_
 			subset_weights[j]=m_weights[train_indices.at(j)];
 
 		// train with training subset
-		bnode_t* root = CARTtrain(feats_train, subset_weights, labels_train, 0);
+		bnode_t* root;
+		if (m_histograms)
+		{
+			SGVector<index_t> rows(train_indices.size());
+			for (index_t j = 0; j < train_indices.size(); ++j)
+				rows[j]=binned_rows[train_indices.at(j)];
+
+			root = CARTtrain_histogram(feats_train, subset_weights, labels_train, rows);
+		}
+		else
+			root = CARTtrain(feats_train, subset_weights, labels_train, 0);
 
 		// prune trained tree
 		CTreeMachine<CARTreeNodeData>* tmax=new CTreeMachine<CARTreeNodeData>();
@@ -1494,10 +2132,22 @@ void CCARTree::init()
 	m_label_epsilon=1e-7;
 	m_sorted_features=SGMatrix<float64_t>();
 	m_sorted_indices=SGMatrix<index_t>();
+	m_histograms=false;
+	m_max_bins=255;
+	m_pre_binned=false;
+	m_binned_features=SGMatrix<uint8_t>();
+	m_bin_thresholds=SGMatrix<float64_t>();
+	m_num_bins=SGVector<int32_t>();
 
 	SG_ADD(&m_pre_sort, "pre_sort", "presort");
 	SG_ADD(&m_sorted_features, "sorted_features", "sorted feats");
 	SG_ADD(&m_sorted_indices, "sorted_indices", "sorted indices");
+	SG_ADD(&m_histograms, "histograms", "search splits on histograms");
+	SG_ADD(&m_max_bins, "max_bins", "max number of bins per feature");
+	SG_ADD(&m_pre_binned, "pre_binned", "prebinned");
+	SG_ADD(&m_binned_features, "binned_features", "binned feats");
+	SG_ADD(&m_bin_thresholds, "bin_thresholds", "largest value of every bin");
+	SG_ADD(&m_num_bins, "num_bins", "number of bins of every feature");
 	SG_ADD(&m_nominal, "nominal", "feature types");
 	SG_ADD(&m_weights, "weights", "weights");
 	SG_ADD(
@@ -233,6 +233,52 @@ public:
 
 	void set_sorted_features(SGMatrix<float64_t>& sorted_feats, SGMatrix<index_t>& sorted_indices);
 
+	/** set whether the best splits are searched on histograms of binned
+	 * features instead of on sorted feature values. Nominal features with
+	 * more than two classes may then have at most MAX_NOMINAL_SUBSET_BINS
+	 * values.
+	 *
+	 * @param histograms whether histograms are used
+	 */
+	void set_use_histograms(bool histograms) { m_histograms=histograms; }
+
+	/** get whether the best splits are searched on histograms
+	 *
+	 * @return whether histograms are used
+	 */
+	bool get_use_histograms() const { return m_histograms; }
+
+	/** set max number of bins per feature in histogram mode
+	 *
+	 * @param bins max number of bins, at most 255
+	 */
+	void set_max_bins(int32_t bins);
+
+	/** get max number of bins per feature in histogram mode
+	 *
+	 * @return max number of bins
+	 */
+	int32_t get_max_bins() const { return m_max_bins; }
+
+	/** quantize every feature into at most max bins bins at its quantiles.
+	 * Nominal features get one bin per value.
+	 *
+	 * @param data training data
+	 * @param binned_feats stores the bins, one column per feature
+	 * @param bin_thresholds stores the largest value of every bin, one column per feature
+	 * @param num_bins stores the number of bins of every feature
+	 */
+	void quantize_features(CFeatures* data, SGMatrix<uint8_t>& binned_feats, SGMatrix<float64_t>& bin_thresholds, SGVector<int32_t>& num_bins);
+
+	/** use features quantized by quantize_features() in training, the
+	 * training data has to be a subset of the quantized data
+	 *
+	 * @param binned_feats bins, one column per feature
+	 * @param bin_thresholds largest value of every bin, one column per feature
+	 * @param num_bins number of bins of every feature
+	 */
+	void set_binned_features(SGMatrix<uint8_t>& binned_feats, SGMatrix<float64_t>& bin_thresholds, SGVector<int32_t>& num_bins);
+
 protected:
 	/** train machine - build CART from training data
 	 * @param data training data
@@ -250,6 +296,52 @@ protected:
 	 */
 	virtual CBinaryTreeMachineNode<CARTreeNodeData>* CARTtrain(CDenseFeatures<float64_t>* data, const SGVector<float64_t>& weights, CDenseLabels* labels, int32_t level);
 
+	/** state shared by all nodes while growing a tree on histograms */
+	struct HistogramContext;
+
+	/** builds CART on histograms of the binned features
+	 *
+	 * @param data training data
+	 * @param weights vector of weights of data points
+	 * @param labels labels of data points
+	 * @param rows columns of the binned features holding the data points
+	 * @return pointer to the root of the CART
+	 */
+	bnode_t* CARTtrain_histogram(CDenseFeatures<float64_t>* data, const SGVector<float64_t>& weights, CDenseLabels* labels, const SGVector<index_t>& rows);
+
+	/** recursively grows a subtree on histograms
+	 *
+	 * @param ctx training state
+	 * @param vecs data points in the node
+	 * @param histogram histogram of the node, empty if it has to be built
+	 * @param level current tree depth
+	 * @return pointer to the root of the CART subtree
+	 */
+	bnode_t* grow_histogram_node(const HistogramContext& ctx, const SGVector<index_t>& vecs, SGVector<float64_t> histogram, int32_t level);
+
+	/** builds the histograms of some features in parallel over the features
+	 *
+	 * @param ctx training state
+	 * @param vecs data points in the node
+	 * @param feats features whose histograms are built
+	 * @param histogram stores the histograms
+	 */
+	void build_histogram(const HistogramContext& ctx, const SGVector<index_t>& vecs, const SGVector<index_t>& feats, SGVector<float64_t>& histogram) const;
+
+	/** columns of the binned features holding the vectors of the data
+	 *
+	 * @param data training data
+	 * @return column of every vector
+	 */
+	SGVector<index_t> get_binned_rows(CDenseFeatures<float64_t>* data) const;
+
+	/** number of randomly chosen features searched for each split
+	 *
+	 * @param num_feats number of features
+	 * @return subset size, 0 to search all features
+	 */
+	virtual index_t get_split_subset_size(index_t num_feats) { return 0; }
+
 	/** modify labels for compute_best_attribute
 	 *
 	 * @param labels_vec labels vector
@@ -423,6 +515,14 @@ public:
 	/** equality epsilon */
 	static const float64_t EQ_DELTA;
 
+	/** bin of missing feature values in histogram mode */
+	static const uint8_t MISSING_BIN;
+
+	/** max number of values of a nominal feature in histogram mode with
+	 * more than two classes, where every division of the values is tested
+	 */
+	static const int32_t MAX_NOMINAL_SUBSET_BINS;
+
 protected:
 	/** Returns whether the type of various feature dimensions are specified
 	 * using is_nominal_feature
@@ -450,6 +550,24 @@ protected:
 	/** If pre sorted features are used in train */
 	bool m_pre_sort;
 
+	/** whether splits are searched on histograms of binned features */
+	bool m_histograms;
+
+	/** max number of bins per feature */
+	int32_t m_max_bins;
+
+	/** If pre binned features are used in train */
+	bool m_pre_binned;
+
+	/** binned features, one column per feature */
+	SGMatrix<uint8_t> m_binned_features;
+
+	/** largest value of every bin, one column per feature */
+	SGMatrix<float64_t> m_bin_thresholds;
+
+	/** number of bins of every feature */
+	SGVector<int32_t> m_num_bins;
+
 	/** flag indicating whether cross validation pruning has to be applied or not - false by default **/
 	bool m_apply_cv_pruning;
 
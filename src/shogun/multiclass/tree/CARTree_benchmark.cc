@@ -0,0 +1,91 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <shogun/base/some.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/labels/MulticlassLabels.h>
+#include <shogun/multiclass/tree/CARTree.h>
+#include <shogun/util/benchmark_data.h>
+
+namespace shogun
+{
+
+class CARTreeFixture : public benchmark::Fixture
+{
+public:
+	void SetUp(const ::benchmark::State& st)
+	{
+		SGVector<float64_t> lab;
+		feats = new CDenseFeatures<float64_t>(
+		    benchmark_blobs(st.range(1), st.range(0), 4, lab));
+		labels = new CMulticlassLabels(lab);
+		SG_REF(feats);
+		SG_REF(labels);
+
+		feature_types = SGVector<bool>(st.range(1));
+		feature_types.set_const(false);
+	}
+
+	void TearDown(const ::benchmark::State&)
+	{
+		SG_UNREF(feats);
+		SG_UNREF(labels);
+	}
+
+	Some<CCARTree> create_tree(bool use_histograms)
+	{
+		auto tree = some<CCARTree>(feature_types, PT_MULTICLASS);
+		tree->set_max_depth(10);
+		tree->set_use_histograms(use_histograms);
+		tree->set_labels(labels);
+		return tree;
+	}
+
+	void train(benchmark::State& state, bool use_histograms)
+	{
+		for (auto _ : state)
+			create_tree(use_histograms)->train(feats);
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	CDenseFeatures<float64_t>* feats;
+	CMulticlassLabels* labels;
+	SGVector<bool> feature_types;
+};
+
+BENCHMARK_DEFINE_F(CARTreeFixture, CARTree_train)(benchmark::State& state)
+{
+	train(state, false);
+}
+
+BENCHMARK_DEFINE_F(CARTreeFixture, CARTree_train_histograms)(benchmark::State& state)
+{
+	train(state, true);
+}
+
+BENCHMARK_DEFINE_F(CARTreeFixture, CARTree_apply)(benchmark::State& state)
+{
+	auto tree = create_tree(false);
+	tree->train(feats);
+
+	for (auto _ : state)
+	{
+		auto result = tree->apply_multiclass(feats);
+		SG_UNREF(result);
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#define ADD_CARTREE_ARGS(WHAT) \
+	WHAT->RangeMultiplier(4)->Ranges(BENCHMARK_LARGE_SCALE)->Unit(benchmark::kMillisecond);
+
+ADD_CARTREE_ARGS(BENCHMARK_REGISTER_F(CARTreeFixture, CARTree_train))
+ADD_CARTREE_ARGS(BENCHMARK_REGISTER_F(CARTreeFixture, CARTree_train_histograms))
+ADD_CARTREE_ARGS(BENCHMARK_REGISTER_F(CARTreeFixture, CARTree_apply))
+
+}
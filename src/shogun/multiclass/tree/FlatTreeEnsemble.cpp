@@ -0,0 +1,250 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/base/TaskScheduler.h>
+#include <shogun/multiclass/tree/FlatTreeEnsemble.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+using namespace shogun;
+
+/** number of vectors walking a tree together */
+static const index_t flat_tree_block_size=64;
+
+CFlatTreeEnsemble::CFlatTreeEnsemble()
+: CSGObject()
+{
+	init();
+}
+
+CFlatTreeEnsemble::CFlatTreeEnsemble(bool float32_thresholds)
+: CSGObject()
+{
+	init();
+	m_float32_thresholds=float32_thresholds;
+}
+
+CFlatTreeEnsemble::~CFlatTreeEnsemble()
+{
+}
+
+/** append the elements of a std::vector to a SGVector */
+template <typename T>
+static void append(SGVector<T>& vec, const std::vector<T>& values)
+{
+	index_t len=vec.vlen;
+	vec.resize_vector(len+values.size());
+	std::copy(values.begin(), values.end(), vec.vector+len);
+}
+
+void CFlatTreeEnsemble::add_tree(CCARTree* tree)
+{
+	typedef CBinaryTreeMachineNode<CARTreeNodeData> bnode_t;
+
+	require(tree, "Tree not supplied");
+	bnode_t* root=dynamic_cast<bnode_t*>(tree->get_root());
+	require(root, "Tree not yet trained");
+	SGVector<bool> nominal=tree->get_feature_types();
+
+	const int32_t offset=m_children.vlen;
+	int32_t nominal_offset=m_nominal_values.vlen;
+	std::vector<int32_t> features;
+	std::vector<float64_t> thresholds;
+	std::vector<float32_t> thresholds32;
+	std::vector<int32_t> children;
+	std::vector<float64_t> values;
+	std::vector<int32_t> nominal_offsets;
+	std::vector<float64_t> nominal_values;
+
+	// breadth first, so that the children of a node are adjacent
+	std::queue<std::pair<bnode_t*, int32_t>> nodes;
+	nodes.emplace(root, 0);
+	int32_t depth=0;
+	while (!nodes.empty())
+	{
+		bnode_t* node=nodes.front().first;
+		int32_t level=nodes.front().second;
+		nodes.pop();
+
+		const int32_t pos=offset+children.size();
+		values.push_back(node->data.node_label);
+		if (node->data.num_leaves==1)
+		{
+			features.push_back(0);
+			thresholds.push_back(std::numeric_limits<float64_t>::infinity());
+			thresholds32.push_back(std::numeric_limits<float32_t>::infinity());
+			children.push_back(pos);
+			nominal_offsets.push_back(-1);
+			depth=std::max(depth, level);
+			SG_UNREF(node);
+			continue;
+		}
+
+		bnode_t* left=node->left();
+		bnode_t* right=node->right();
+		const int32_t attribute=node->data.attribute_id;
+		const SGVector<float64_t>& transit=left->data.transit_into_values;
+		features.push_back(attribute);
+		m_num_features=std::max(m_num_features, attribute+1);
+		children.push_back(offset+children.size()+nodes.size()+1);
+
+		if (nominal.vlen && nominal[attribute])
+		{
+			thresholds.push_back(0);
+			thresholds32.push_back(0);
+			nominal_offsets.push_back(nominal_offset);
+			for (index_t i=0; i<transit.vlen; ++i)
+				nominal_values.push_back(transit[i]);
+			nominal_values.push_back(std::numeric_limits<float64_t>::quiet_NaN());
+			nominal_offset+=transit.vlen+1;
+		}
+		else
+		{
+			// round up, so that values equal to the threshold still go left
+			float64_t threshold=transit[0];
+			float32_t threshold32=threshold;
+			if (threshold32<threshold)
+				threshold32=std::nextafter(threshold32, std::numeric_limits<float32_t>::infinity());
+
+			thresholds.push_back(threshold);
+			thresholds32.push_back(threshold32);
+			nominal_offsets.push_back(-1);
+		}
+
+		nodes.emplace(left, level+1);
+		nodes.emplace(right, level+1);
+		SG_UNREF(node);
+	}
+
+	append(m_features, features);
+	append(m_thresholds, thresholds);
+	append(m_thresholds32, thresholds32);
+	append(m_children, children);
+	append(m_values, values);
+	append(m_nominal_offsets, nominal_offsets);
+	append(m_nominal_values, nominal_values);
+	append(m_roots, std::vector<int32_t>(1, offset));
+	append(m_depths, std::vector<int32_t>(1, depth));
+}
+
+bool CFlatTreeEnsemble::go_right_nominal(int32_t node, float64_t value) const
+{
+	for (const float64_t* v=m_nominal_values.vector+m_nominal_offsets[node]; !std::isnan(*v); ++v)
+	{
+		if (*v==value)
+			return false;
+	}
+
+	return true;
+}
+
+template <bool nominal, typename T, typename Output>
+void CFlatTreeEnsemble::evaluate(const SGMatrix<float64_t>& mat, const T* thresholds, Output&& output) const
+{
+	const int32_t* features=m_features.vector;
+	const int32_t* children=m_children.vector;
+	const int32_t dim=mat.num_rows;
+
+	parallel_for(0, mat.num_cols, [&](index_t start, index_t end) {
+		int32_t nodes[flat_tree_block_size];
+		for (index_t block=start; block<end; block+=flat_tree_block_size)
+		{
+			const index_t n=std::min(flat_tree_block_size, end-block);
+			const float64_t* x=mat.matrix+int64_t(block)*dim;
+
+			for (int32_t t=0; t<m_roots.vlen; ++t)
+			{
+				std::fill(nodes, nodes+n, m_roots[t]);
+				for (int32_t level=0; level<m_depths[t]; ++level)
+				{
+					for (index_t i=0; i<n; ++i)
+					{
+						const int32_t node=nodes[i];
+						const float64_t value=x[int64_t(i)*dim+features[node]];
+						if (nominal && m_nominal_offsets[node]>=0)
+							nodes[i]=children[node]+go_right_nominal(node, value);
+						else
+							nodes[i]=children[node]+(value>thresholds[node]);
+					}
+				}
+
+				for (index_t i=0; i<n; ++i)
+					output(block+i, t, m_values[nodes[i]]);
+			}
+		}
+	}, flat_tree_block_size);
+}
+
+template <typename Output>
+void CFlatTreeEnsemble::evaluate(CDenseFeatures<float64_t>* data, Output&& output) const
+{
+	require(data, "Data not supplied");
+	require(m_roots.vlen, "No trees added");
+	require(data->get_num_features()>=m_num_features, "Trees split on {} features, "
+		"but the data has {}", m_num_features, data->get_num_features());
+
+	SGMatrix<float64_t> mat=data->get_feature_matrix();
+	const bool nominal=m_nominal_values.vlen>0;
+	if (m_float32_thresholds)
+	{
+		if (nominal)
+			evaluate<true>(mat, m_thresholds32.vector, output);
+		else
+			evaluate<false>(mat, m_thresholds32.vector, output);
+	}
+	else
+	{
+		if (nominal)
+			evaluate<true>(mat, m_thresholds.vector, output);
+		else
+			evaluate<false>(mat, m_thresholds.vector, output);
+	}
+}
+
+SGMatrix<float64_t> CFlatTreeEnsemble::apply_trees(CDenseFeatures<float64_t>* data) const
+{
+	SGMatrix<float64_t> outputs(data->get_num_vectors(), m_roots.vlen);
+	evaluate(data, [&](index_t i, int32_t t, float64_t value) {
+		outputs(i, t)=value;
+	});
+
+	return outputs;
+}
+
+SGVector<float64_t> CFlatTreeEnsemble::apply_sum(CDenseFeatures<float64_t>* data, SGVector<float64_t> weights) const
+{
+	require(weights.vlen==m_roots.vlen, "Number of weights ({}) should be same as "
+		"number of trees ({})", weights.vlen, m_roots.vlen);
+
+	SGVector<float64_t> sums(data->get_num_vectors());
+	sums.zero();
+	evaluate(data, [&](index_t i, int32_t t, float64_t value) {
+		sums[i]+=weights[t]*value;
+	});
+
+	return sums;
+}
+
+void CFlatTreeEnsemble::init()
+{
+	m_float32_thresholds=false;
+	m_num_features=0;
+
+	SG_ADD(&m_float32_thresholds, "float32_thresholds", "thresholds in single precision");
+	SG_ADD(&m_features, "features", "split feature of every node");
+	SG_ADD(&m_thresholds, "thresholds", "split threshold of every node");
+	SG_ADD(&m_thresholds32, "thresholds32", "single precision split thresholds");
+	SG_ADD(&m_children, "children", "left child of every node");
+	SG_ADD(&m_values, "values", "label of every node");
+	SG_ADD(&m_nominal_offsets, "nominal_offsets", "values of nominal nodes going left");
+	SG_ADD(&m_nominal_values, "nominal_values", "values of nominal splits");
+	SG_ADD(&m_roots, "roots", "root of every tree");
+	SG_ADD(&m_depths, "depths", "depth of every tree");
+	SG_ADD(&m_num_features, "num_features", "number of features the trees split on");
+}
@@ -0,0 +1,156 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef _FLATTREEENSEMBLE_H__
+#define _FLATTREEENSEMBLE_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/base/SGObject.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/multiclass/tree/CARTree.h>
+
+namespace shogun
+{
+
+/** @brief Trained CART trees compiled into flat node arrays for fast
+ * inference.
+ *
+ * The nodes of all trees are stored as a struct of arrays: split feature,
+ * threshold, position of the left child and node label. The two children
+ * of a node are adjacent, so the next node is
+ * \f$left + (x_{feature} > threshold)\f$ and is computed without
+ * branching. Leaves point to themselves with an infinite threshold, so
+ * every vector walks a tree for exactly its depth. Nominal splits compare
+ * against a list of values instead.
+ *
+ * Vectors are evaluated in blocks: every level of a tree is advanced for
+ * the whole block at once, so the loads of the independent walks overlap
+ * instead of waiting for each other. Blocks are processed in parallel.
+ *
+ * Thresholds can be stored in single precision, which halves the size of
+ * the node arrays. They are rounded up, so training vectors still reach
+ * the same leaves, but vectors within float32 precision above a
+ * threshold may go left.
+ */
+class CFlatTreeEnsemble : public CSGObject
+{
+public:
+	/** default constructor */
+	CFlatTreeEnsemble();
+
+	/** constructor
+	 *
+	 * @param float32_thresholds whether thresholds are stored in single precision
+	 */
+	CFlatTreeEnsemble(bool float32_thresholds);
+
+	/** destructor */
+	virtual ~CFlatTreeEnsemble();
+
+	/** get name
+	 * @return FlatTreeEnsemble
+	 */
+	virtual const char* get_name() const { return "FlatTreeEnsemble"; }
+
+	/** append a trained tree
+	 *
+	 * @param tree trained CART
+	 */
+	void add_tree(CCARTree* tree);
+
+	/** @return number of trees */
+	int32_t get_num_trees() const { return m_roots.vlen; }
+
+	/** @return number of nodes of all trees */
+	int32_t get_num_nodes() const { return m_children.vlen; }
+
+	/** @return whether thresholds are stored in single precision */
+	bool get_float32_thresholds() const { return m_float32_thresholds; }
+
+	/** outputs of every tree
+	 *
+	 * @param data vectors to evaluate
+	 * @return num_vectors x num_trees matrix of tree outputs
+	 */
+	SGMatrix<float64_t> apply_trees(CDenseFeatures<float64_t>* data) const;
+
+	/** weighted sum of the tree outputs
+	 *
+	 * @param data vectors to evaluate
+	 * @param weights weight of every tree
+	 * @return weighted sum of every vector
+	 */
+	SGVector<float64_t> apply_sum(CDenseFeatures<float64_t>* data, SGVector<float64_t> weights) const;
+
+private:
+	/** walks all trees for blocks of vectors
+	 *
+	 * @param data vectors to evaluate
+	 * @param output called with vector index, tree index and tree output
+	 */
+	template <typename Output>
+	void evaluate(CDenseFeatures<float64_t>* data, Output&& output) const;
+
+	/** walks all trees for blocks of vectors
+	 *
+	 * @param mat vectors to evaluate
+	 * @param thresholds split thresholds
+	 * @param output called with vector index, tree index and tree output
+	 */
+	template <bool nominal, typename T, typename Output>
+	void evaluate(const SGMatrix<float64_t>& mat, const T* thresholds, Output&& output) const;
+
+	/** whether a vector goes to the right child of a nominal node
+	 *
+	 * @param node position of the node
+	 * @param value feature value of the vector
+	 * @return true if the vector goes right
+	 */
+	bool go_right_nominal(int32_t node, float64_t value) const;
+
+	/** initialize parameters */
+	void init();
+
+private:
+	/** whether thresholds are stored in single precision */
+	bool m_float32_thresholds;
+
+	/** split feature of every node, 0 for leaves */
+	SGVector<int32_t> m_features;
+
+	/** split threshold of every node, infinity for leaves */
+	SGVector<float64_t> m_thresholds;
+
+	/** split threshold of every node in single precision */
+	SGVector<float32_t> m_thresholds32;
+
+	/** left child of every node, the right child follows it. Leaves point
+	 * to themselves.
+	 */
+	SGVector<int32_t> m_children;
+
+	/** label of every node */
+	SGVector<float64_t> m_values;
+
+	/** offset of the values of a nominal node going left, -1 for
+	 * continuous splits and leaves
+	 */
+	SGVector<int32_t> m_nominal_offsets;
+
+	/** values of nominal nodes going left, each list ends with NaN */
+	SGVector<float64_t> m_nominal_values;
+
+	/** root of every tree */
+	SGVector<int32_t> m_roots;
+
+	/** depth of every tree */
+	SGVector<int32_t> m_depths;
+
+	/** number of features the trees split on */
+	int32_t m_num_features;
+};
+} /* namespace shogun */
+
+#endif /* _FLATTREEENSEMBLE_H__ */
@@ -75,6 +75,11 @@ public:
 	 */
 	index_t get_max_index() { return m_inds[0]; }
 
+	/** capacity
+	 * @return number of least distance values stored
+	 */
+	int32_t get_capacity() const { return m_capacity; }
+
 	/** get distances
 	 *
 	 * @return distances stored in the heap
@@ -29,7 +29,12 @@
  */
 
 #include <shogun/multiclass/tree/NbodyTree.h>
+#include <shogun/base/TaskScheduler.h>
 #include <shogun/distributions/KernelDensity.h>
+#include <shogun/io/MemoryMappedFile.h>
+#include <shogun/multiclass/tree/NbodyTreeIndex.h>
+
+#include <cstring>
 
 using namespace shogun;
 
@@ -54,6 +59,11 @@ void CNbodyTree::build_tree(CDenseFeatures<float64_t>* data)
 	m_vec_id.range_fill(0);
 
 	set_root(recursive_build(0,m_data.num_cols-1));
+
+	// leaves scan their vectors linearly, keep them next to each other
+	m_leaf_data=SGMatrix<float64_t>(m_data.num_rows,m_data.num_cols);
+	for (index_t i=0;i<m_data.num_cols;i++)
+		sg_memcpy(m_leaf_data.get_column_vector(i),m_data.get_column_vector(m_vec_id[i]),m_data.num_rows*sizeof(float64_t));
 }
 
 void CNbodyTree::query_knn(CDenseFeatures<float64_t>* data, int32_t k)
@@ -67,20 +77,151 @@ void CNbodyTree::query_knn(CDenseFeatures<float64_t>* data, int32_t k)
 	m_knn_indices=SGMatrix<index_t>(k,qfeats.num_cols);
 	int32_t dim=qfeats.num_rows;
 
-	for (int32_t i=0;i<qfeats.num_cols;i++)
-	{
-		CKNNHeap* heap=new CKNNHeap(k);
-		bnode_t* root=NULL;
-		if (m_root)
-			root=dynamic_cast<bnode_t*>(m_root);
+	bnode_t* root=NULL;
+	if (m_root)
+		root=dynamic_cast<bnode_t*>(m_root);
+
+	parallel_for(0, qfeats.num_cols, [&](index_t start, index_t end) {
+		for (int32_t i=start;i<end;i++)
+		{
+			CKNNHeap heap(k);
+			float64_t mdist=min_dist(root,qfeats.matrix+i*dim,dim);
+			query_knn_single(&heap,mdist,root,qfeats.matrix+i*dim,dim);
+			sg_memcpy(m_knn_dists.matrix+i*k,heap.get_dists(),k*sizeof(float64_t));
+			sg_memcpy(m_knn_indices.matrix+i*k,heap.get_indices(),k*sizeof(index_t));
+		}
+	});
+}
+
+void CNbodyTree::query_knn_dual(CDenseFeatures<float64_t>* data, int32_t k)
+{
+	require(data,"Query data not supplied");
+	require(data->get_num_features()==m_data.num_rows,"query data dimension should be same as training data dimension");
+
+	m_knn_done=true;
+	int32_t num_queries=data->get_num_vectors();
+	m_knn_dists=SGMatrix<float64_t>(k,num_queries);
+	m_knn_indices=SGMatrix<index_t>(k,num_queries);
+
+	CNbodyTree* query_tree=create_tree(m_leaf_size,m_dist);
+	SG_REF(query_tree);
+	query_tree->build_tree(data);
+
+	bnode_t* root=NULL;
+	if (m_root)
+		root=dynamic_cast<bnode_t*>(m_root);
+
+	std::vector<bnode_t*> leaves;
+	collect_leaves(dynamic_cast<bnode_t*>(query_tree->m_root),leaves);
+
+	// leaves of the query tree are independent, so they are the unit of work
+	parallel_for(0, index_t(leaves.size()), [&](index_t start, index_t end) {
+		for (index_t l=start;l<end;l++)
+		{
+			bnode_t* leaf=leaves[l];
+			index_t qstart=leaf->data.start_idx;
+			index_t qend=leaf->data.end_idx;
+
+			std::vector<CKNNHeap> heaps;
+			heaps.reserve(qend-qstart+1);
+			for (index_t i=qstart;i<=qend;i++)
+				heaps.emplace_back(k);
 
-		float64_t mdist=min_dist(root,qfeats.matrix+i*dim,dim);
-		query_knn_single(heap,mdist,root,qfeats.matrix+i*dim,dim);
-		sg_memcpy(m_knn_dists.matrix+i*k,heap->get_dists(),k*sizeof(float64_t));
-		sg_memcpy(m_knn_indices.matrix+i*k,heap->get_indices(),k*sizeof(index_t));
+			float64_t upper_dist=CMath::INFTY;
+			query_knn_dual_leaf(heaps.data(),query_tree,leaf,root,min_dist_dual(leaf,root),upper_dist);
 
-		delete(heap);
+			for (index_t i=qstart;i<=qend;i++)
+			{
+				index_t q=query_tree->m_vec_id[i];
+				CKNNHeap& heap=heaps[i-qstart];
+				sg_memcpy(m_knn_dists.matrix+q*k,heap.get_dists(),k*sizeof(float64_t));
+				sg_memcpy(m_knn_indices.matrix+q*k,heap.get_indices(),k*sizeof(index_t));
+			}
+		}
+	}, 1);
+
+	for (auto leaf : leaves)
+		SG_UNREF(leaf);
+	SG_UNREF(query_tree);
+}
+
+void CNbodyTree::save_index(const char* fname)
+{
+	require(fname,"No index file given");
+	require(m_root,"Tree not built yet");
+	require(m_dist==D_EUCLIDEAN || m_dist==D_MANHATTAN,"distance metric not supported by the index");
+
+	std::vector<bnode_t*> nodes;
+	std::vector<std::pair<int64_t,int64_t>> children;
+	flatten_nodes(dynamic_cast<bnode_t*>(m_root),nodes,children);
+
+	const int64_t dim=m_data.num_rows;
+	const int64_t num_vectors=m_data.num_cols;
+	const int64_t num_nodes=nodes.size();
+	const bool has_centers=nodes[0]->data.center.vlen==dim;
+
+	// all sections are multiples of 8 bytes, which keeps them aligned
+	NbodyTreeIndexHeader header;
+	memset(&header,0,sizeof(header));
+	strncpy(header.magic,"SGNBIDX",8);
+	header.version=1;
+	header.distance=m_dist;
+	header.dim=dim;
+	header.num_vectors=num_vectors;
+	header.num_nodes=num_nodes;
+	header.has_centers=has_centers;
+
+	int64_t offset=sizeof(NbodyTreeIndexHeader);
+	header.nodes_offset=offset;
+	offset+=num_nodes*sizeof(NbodyTreeIndexNode);
+	header.bbox_lower_offset=offset;
+	offset+=num_nodes*dim*sizeof(float64_t);
+	header.bbox_upper_offset=offset;
+	offset+=num_nodes*dim*sizeof(float64_t);
+	header.centers_offset=offset;
+	if (has_centers)
+		offset+=num_nodes*dim*sizeof(float64_t);
+	header.vec_id_offset=offset;
+	offset+=num_vectors*sizeof(int64_t);
+	header.data_offset=offset;
+	offset+=num_vectors*dim*sizeof(float64_t);
+
+	CMemoryMappedFile<char>* file=new CMemoryMappedFile<char>(fname,'w',offset);
+	SG_REF(file);
+	char* map=file->get_map();
+	sg_memcpy(map,&header,sizeof(header));
+
+	NbodyTreeIndexNode* flat_nodes=reinterpret_cast<NbodyTreeIndexNode*>(map+header.nodes_offset);
+	float64_t* bbox_lower=reinterpret_cast<float64_t*>(map+header.bbox_lower_offset);
+	float64_t* bbox_upper=reinterpret_cast<float64_t*>(map+header.bbox_upper_offset);
+	float64_t* centers=reinterpret_cast<float64_t*>(map+header.centers_offset);
+	for (int64_t i=0;i<num_nodes;i++)
+	{
+		const NbodyTreeNodeData& data=nodes[i]->data;
+		flat_nodes[i].start_idx=data.start_idx;
+		flat_nodes[i].end_idx=data.end_idx;
+		flat_nodes[i].left=children[i].first;
+		flat_nodes[i].right=children[i].second;
+		flat_nodes[i].radius=data.radius;
+		flat_nodes[i].is_leaf=data.is_leaf;
+
+		sg_memcpy(bbox_lower+i*dim,data.bbox_lower.vector,dim*sizeof(float64_t));
+		sg_memcpy(bbox_upper+i*dim,data.bbox_upper.vector,dim*sizeof(float64_t));
+		if (has_centers)
+			sg_memcpy(centers+i*dim,data.center.vector,dim*sizeof(float64_t));
+
+		SG_UNREF(nodes[i]);
 	}
+
+	int64_t* vec_id=reinterpret_cast<int64_t*>(map+header.vec_id_offset);
+	for (int64_t i=0;i<num_vectors;i++)
+		vec_id[i]=m_vec_id[i];
+
+	sg_memcpy(map+header.data_offset,m_leaf_data.matrix,num_vectors*dim*sizeof(float64_t));
+
+	// the file is created one byte larger than requested
+	file->set_truncate_size(offset);
+	SG_UNREF(file);
 }
 
 SGVector<float64_t> CNbodyTree::log_kernel_density(SGMatrix<float64_t> test, EKernelType kernel, float64_t h, float64_t atol, float64_t rtol)
@@ -177,7 +318,7 @@ void CNbodyTree::query_knn_single(CKNNHeap* heap, float64_t mdist, bnode_t* node
 		index_t end=node->data.end_idx;
 
 		for (int32_t i=start;i<=end;i++)
-			heap->push(m_vec_id[i],distance(m_vec_id[i],arr,dim));
+			heap->push(m_vec_id[i],leaf_distance(i,arr,dim));
 
 		return;
 	}
@@ -212,6 +353,110 @@ float64_t CNbodyTree::distance(index_t vec, float64_t* arr, int32_t dim)
 	return actual_dists(ret);
 }
 
+float64_t CNbodyTree::leaf_distance(index_t pos, const float64_t* arr, int32_t dim)
+{
+	const float64_t* vec=m_leaf_data.get_column_vector(pos);
+	float64_t ret=0;
+	for (int32_t i=0;i<dim;i++)
+		ret+=add_dim_dist(vec[i]-arr[i]);
+
+	return actual_dists(ret);
+}
+
+void CNbodyTree::query_knn_dual_leaf(CKNNHeap* heaps, CNbodyTree* query_tree, bnode_t* querynode,
+	bnode_t* refnode, float64_t mdist, float64_t& upper_dist)
+{
+	index_t qstart=querynode->data.start_idx;
+	index_t qend=querynode->data.end_idx;
+
+	// no query of the leaf can have a neighbor in this node
+	float64_t max_knn_dist=0;
+	for (index_t i=qstart;i<=qend;i++)
+		max_knn_dist=CMath::max(max_knn_dist,heaps[i-qstart].get_max_dist());
+
+	if (mdist>CMath::min(max_knn_dist,upper_dist))
+		return;
+
+	index_t rstart=refnode->data.start_idx;
+	index_t rend=refnode->data.end_idx;
+
+	// every query has at least k vectors of this node within the max distance
+	if (rend-rstart+1>=heaps[0].get_capacity())
+		upper_dist=CMath::min(upper_dist,max_dist_dual(querynode,refnode));
+
+	if (refnode->data.is_leaf)
+	{
+		int32_t dim=m_data.num_rows;
+		for (index_t i=qstart;i<=qend;i++)
+		{
+			const float64_t* query=query_tree->m_leaf_data.get_column_vector(i);
+			CKNNHeap& heap=heaps[i-qstart];
+			for (index_t j=rstart;j<=rend;j++)
+				heap.push(m_vec_id[j],leaf_distance(j,query,dim));
+		}
+
+		return;
+	}
+
+	bnode_t* cleft=refnode->left();
+	bnode_t* cright=refnode->right();
+
+	float64_t min_dist_left=min_dist_dual(querynode,cleft);
+	float64_t min_dist_right=min_dist_dual(querynode,cright);
+
+	if (min_dist_left<=min_dist_right)
+	{
+		query_knn_dual_leaf(heaps,query_tree,querynode,cleft,min_dist_left,upper_dist);
+		query_knn_dual_leaf(heaps,query_tree,querynode,cright,min_dist_right,upper_dist);
+	}
+	else
+	{
+		query_knn_dual_leaf(heaps,query_tree,querynode,cright,min_dist_right,upper_dist);
+		query_knn_dual_leaf(heaps,query_tree,querynode,cleft,min_dist_left,upper_dist);
+	}
+
+	SG_UNREF(cleft);
+	SG_UNREF(cright);
+}
+
+int64_t CNbodyTree::flatten_nodes(bnode_t* node, std::vector<bnode_t*>& nodes, std::vector<std::pair<int64_t,int64_t>>& children)
+{
+	int64_t pos=nodes.size();
+	SG_REF(node);
+	nodes.push_back(node);
+	children.emplace_back(-1,-1);
+
+	if (node->data.is_leaf)
+		return pos;
+
+	bnode_t* cleft=node->left();
+	bnode_t* cright=node->right();
+	int64_t left=flatten_nodes(cleft,nodes,children);
+	int64_t right=flatten_nodes(cright,nodes,children);
+	children[pos]=std::make_pair(left,right);
+	SG_UNREF(cleft);
+	SG_UNREF(cright);
+
+	return pos;
+}
+
+void CNbodyTree::collect_leaves(bnode_t* node, std::vector<bnode_t*>& leaves)
+{
+	if (node->data.is_leaf)
+	{
+		SG_REF(node);
+		leaves.push_back(node);
+		return;
+	}
+
+	bnode_t* cleft=node->left();
+	bnode_t* cright=node->right();
+	collect_leaves(cleft,leaves);
+	collect_leaves(cright,leaves);
+	SG_UNREF(cleft);
+	SG_UNREF(cright);
+}
+
 CBinaryTreeMachineNode<NbodyTreeNodeData>* CNbodyTree::recursive_build(index_t start, index_t end)
 {
 	bnode_t* node=new bnode_t();
@@ -260,7 +505,7 @@ void CNbodyTree::get_kde_single(bnode_t* node,float64_t* data, EKernelType kerne
 
 		for (int32_t i=node->data.start_idx;i<=node->data.end_idx;i++)
 		{
-			float64_t pt_eval=CKernelDensity::log_kernel(kernel,distance(m_vec_id[i],data,m_data.num_rows),h);
+			float64_t pt_eval=CKernelDensity::log_kernel(kernel,leaf_distance(i,data,m_data.num_rows),h);
 			min_bound_global=logsumexp(pt_eval,min_bound_global);
 		}
 
@@ -337,7 +582,7 @@ void CNbodyTree::kde_dual(bnode_t* refnode, bnode_t* querynode, SGVector<index_t
 			float64_t q=-CMath::INFTY;
 			for (int32_t j=refnode->data.start_idx;j<=refnode->data.end_idx;j++)
 			{
-				float64_t pt_eval=CKernelDensity::log_kernel(kernel_type,distance(m_vec_id[j],qdata.matrix+dim*qid[i],dim),h);
+				float64_t pt_eval=CKernelDensity::log_kernel(kernel_type,leaf_distance(j,qdata.matrix+dim*qid[i],dim),h);
 				q=logsumexp(q,pt_eval);
 			}
 
@@ -579,6 +824,7 @@ void CNbodyTree::init()
 	m_data=SGMatrix<float64_t>();
 	m_leaf_size=1;
 	m_vec_id=SGVector<index_t>();
+	m_leaf_data=SGMatrix<float64_t>();
 	m_dist=D_EUCLIDEAN;
 	m_knn_done=false;
 	m_knn_dists=SGMatrix<float64_t>();
@@ -587,6 +833,7 @@ void CNbodyTree::init()
 	SG_ADD(&m_data,"m_data","data matrix");
 	SG_ADD(&m_leaf_size,"m_leaf_size","leaf size");
 	SG_ADD(&m_vec_id,"m_vec_id","id of vectors");
+	SG_ADD(&m_leaf_data,"m_leaf_data","data matrix in rearranged order");
 	SG_ADD(&m_knn_done,"knn_done","knn done or not");
 	SG_ADD(&m_knn_dists,"m_knn_dists","knn distances");
 	SG_ADD(&m_knn_indices,"knn_indices","knn indices");
@@ -41,6 +41,9 @@
 #include <shogun/multiclass/tree/KNNHeap.h>
 #include <shogun/features/DenseFeatures.h>
 
+#include <utility>
+#include <vector>
+
 namespace shogun
 {
 
@@ -77,6 +80,13 @@ public:
 	 */
 	void build_tree(CDenseFeatures<float64_t>* data);
 
+	/** write the built tree to a flat index file, which can be mapped
+	 * and queried by CNbodyTreeIndex without building the tree again
+	 *
+	 * @param fname name of the index file
+	 */
+	void save_index(const char* fname);
+
 	/** apply knn
 	 *
 	 * @param data vectors whose KNNs are required
@@ -84,6 +94,19 @@ public:
 	 */
 	void query_knn(CDenseFeatures<float64_t>* data, int32_t k);
 
+	/** apply knn on a batch of query vectors with a dual tree traversal.
+	 * A tree of the same type is built on the query vectors. The points
+	 * of every leaf of the query tree search the reference tree together,
+	 * pruning reference nodes with the node to node bounds min_dist_dual()
+	 * and max_dist_dual(). Leaves are processed in parallel.
+	 * The results are available through get_knn_dists() and
+	 * get_knn_indices() as with query_knn().
+	 *
+	 * @param data vectors whose KNNs are required
+	 * @param k K value in KNN
+	 */
+	void query_knn_dual(CDenseFeatures<float64_t>* data, int32_t k);
+
 	/** get log of kernel density at query points
 	 *
 	 * @param test query points at which kernel density is to be calculated
@@ -164,6 +187,14 @@ protected:
 	 */
 	virtual void min_max_dist(float64_t* pt, bnode_t* node, float64_t &lower,float64_t &upper, int32_t dim)=0;
 
+	/** create an empty tree of the same type, used as query tree
+	 *
+	 * @param leaf_size min number of samples in any node
+	 * @param d distance metric to be used
+	 * @return new tree
+	 */
+	virtual CNbodyTree* create_tree(int32_t leaf_size, EDistanceType d) const=0;
+
 	/** convert squared distances to actual distances
 	 *
 	 * @param dists distance value
@@ -186,6 +217,15 @@ protected:
 	 */
 	float64_t distance(index_t vec, float64_t* arr, int32_t dim);
 
+	/** distance between a vector stored in a leaf and another vector
+	 *
+	 * @param pos position of the vector in the rearranged order
+	 * @param arr query vector
+	 * @param dim dimension of query vector
+	 * @return distance b/w vectors
+	 */
+	float64_t leaf_distance(index_t pos, const float64_t* arr, int32_t dim);
+
 	/** compute distance component contributed by present dimension
 	 *
 	 * @param d displacement component at chosen dimension
@@ -215,6 +255,37 @@ private:
 	 */
 	void query_knn_single(CKNNHeap* heap, float64_t min_dist, bnode_t* node, float64_t* arr, int32_t dim);
 
+	/** search the k nearest neighbors of all queries in a leaf of the
+	 * query tree
+	 *
+	 * @param heaps heaps of the queries in the leaf, in their order in the
+	 * query tree
+	 * @param query_tree tree built on the query vectors
+	 * @param querynode leaf of the query tree
+	 * @param refnode current node of the reference tree
+	 * @param mdist minimum distance b/w query leaf and the current node
+	 * @param upper_dist upper bound of the k-th nearest neighbor distance
+	 * of all queries in the leaf, derived from visited reference nodes
+	 */
+	void query_knn_dual_leaf(CKNNHeap* heaps, CNbodyTree* query_tree, bnode_t* querynode,
+		bnode_t* refnode, float64_t mdist, float64_t& upper_dist);
+
+	/** collect the leaves of a subtree
+	 *
+	 * @param node root of the subtree
+	 * @param leaves vector the leaves are appended to, each with a reference
+	 */
+	void collect_leaves(bnode_t* node, std::vector<bnode_t*>& leaves);
+
+	/** assign positions to the nodes of a subtree in depth first order
+	 *
+	 * @param node root of the subtree
+	 * @param nodes vector the nodes are appended to, each with a reference
+	 * @param children positions of the left and right children, -1 for leaves
+	 * @return position of node
+	 */
+	int64_t flatten_nodes(bnode_t* node, std::vector<bnode_t*>& nodes, std::vector<std::pair<int64_t,int64_t>>& children);
+
 	/** find kde at each query point
 	 *
 	 * @param node current node
@@ -316,6 +387,11 @@ protected:
 	/** vector id */
 	SGVector<index_t> m_vec_id;
 
+	/** copy of the data matrix in the rearranged order, so the vectors of
+	 * a leaf are contiguous
+	 */
+	SGMatrix<float64_t> m_leaf_data;
+
 private:
 	/** leaf size */
 	int32_t m_leaf_size;
@@ -0,0 +1,242 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/base/TaskScheduler.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/multiclass/tree/NbodyTreeIndex.h>
+
+#include <cstring>
+#include <limits>
+
+using namespace shogun;
+
+CNbodyTreeIndex::CNbodyTreeIndex()
+: CSGObject()
+{
+	init();
+}
+
+CNbodyTreeIndex::CNbodyTreeIndex(const char* fname)
+: CSGObject()
+{
+	init();
+
+	require(fname, "No index file given");
+	m_file=new CMemoryMappedFile<char>(fname);
+	SG_REF(m_file);
+
+	const char* map=m_file->get_map();
+	uint64_t size=m_file->get_size();
+	require(size>=sizeof(NbodyTreeIndexHeader), "{} is too small to be an index file", fname);
+
+	m_header=reinterpret_cast<const NbodyTreeIndexHeader*>(map);
+	require(!strncmp(m_header->magic, "SGNBIDX", 8), "{} is not an index file", fname);
+	require(m_header->version==1, "Index file {} has unsupported version {}", fname, m_header->version);
+
+	m_dist=(EDistanceType) m_header->distance;
+	require(m_dist==D_EUCLIDEAN || m_dist==D_MANHATTAN, "Index file {} uses an unsupported distance", fname);
+
+	const int64_t dim=m_header->dim;
+	const int64_t num_vectors=m_header->num_vectors;
+	const int64_t num_nodes=m_header->num_nodes;
+	// bounds that keep the section sizes below from overflowing
+	require(num_nodes>0 && num_nodes<=(int64_t) (size/sizeof(NbodyTreeIndexNode))
+		&& num_vectors>0 && num_vectors<=std::numeric_limits<index_t>::max()
+		&& dim>0 && dim<=(int64_t) (size/sizeof(float64_t))/CMath::max(num_nodes, num_vectors),
+		"Index file {} has a corrupt header", fname);
+
+	auto check_section = [&](int64_t offset, int64_t bytes) {
+		require(offset>0 && offset%sizeof(float64_t)==0 && offset+bytes<=(int64_t) size,
+			"Index file {} is truncated or corrupt", fname);
+		return map+offset;
+	};
+
+	m_nodes=reinterpret_cast<const NbodyTreeIndexNode*>(
+		check_section(m_header->nodes_offset, num_nodes*sizeof(NbodyTreeIndexNode)));
+	m_bbox_lower=reinterpret_cast<const float64_t*>(
+		check_section(m_header->bbox_lower_offset, num_nodes*dim*sizeof(float64_t)));
+	m_bbox_upper=reinterpret_cast<const float64_t*>(
+		check_section(m_header->bbox_upper_offset, num_nodes*dim*sizeof(float64_t)));
+	if (m_header->has_centers)
+	{
+		m_centers=reinterpret_cast<const float64_t*>(
+			check_section(m_header->centers_offset, num_nodes*dim*sizeof(float64_t)));
+	}
+	m_vec_id=reinterpret_cast<const int64_t*>(
+		check_section(m_header->vec_id_offset, num_vectors*sizeof(int64_t)));
+	m_data=reinterpret_cast<const float64_t*>(
+		check_section(m_header->data_offset, num_vectors*dim*sizeof(float64_t)));
+
+	// queries follow the children and read the vectors of the leaves
+	// without checks, node i's children come after it in the file
+	for (int64_t i=0; i<num_nodes; i++)
+	{
+		const NbodyTreeIndexNode& n=m_nodes[i];
+		if (n.is_leaf)
+		{
+			require(n.start_idx>=0 && n.start_idx<=n.end_idx && n.end_idx<num_vectors,
+				"Index file {} has a corrupt leaf {}", fname, i);
+		}
+		else
+		{
+			require(n.left>i && n.left<num_nodes && n.right>i && n.right<num_nodes,
+				"Index file {} has a corrupt node {}", fname, i);
+		}
+	}
+	for (int64_t i=0; i<num_vectors; i++)
+	{
+		require(m_vec_id[i]>=0 && m_vec_id[i]<num_vectors,
+			"Index file {} has a corrupt vector index {}", fname, i);
+	}
+
+	SG_DEBUG("Mapped index {} with {} vectors of dimension {} in {} nodes", fname, num_vectors, dim, num_nodes)
+}
+
+CNbodyTreeIndex::~CNbodyTreeIndex()
+{
+	SG_UNREF(m_file);
+}
+
+int64_t CNbodyTreeIndex::get_num_vectors() const
+{
+	return m_header ? m_header->num_vectors : 0;
+}
+
+int64_t CNbodyTreeIndex::get_dim() const
+{
+	return m_header ? m_header->dim : 0;
+}
+
+void CNbodyTreeIndex::query_knn(CDenseFeatures<float64_t>* data, int32_t k)
+{
+	require(m_header, "No index file mapped");
+	require(data, "Query data not supplied");
+	require(data->get_num_features()==m_header->dim, "query data dimension should be same as index dimension");
+
+	SGMatrix<float64_t> qfeats=data->get_feature_matrix();
+	m_knn_dists=SGMatrix<float64_t>(k, qfeats.num_cols);
+	m_knn_indices=SGMatrix<index_t>(k, qfeats.num_cols);
+	int32_t dim=qfeats.num_rows;
+
+	parallel_for(0, qfeats.num_cols, [&](index_t start, index_t end) {
+		for (index_t i=start; i<end; i++)
+		{
+			CKNNHeap heap(k);
+			const float64_t* feat=qfeats.matrix+int64_t(i)*dim;
+			query_knn_single(heap, min_dist(0, feat), 0, feat);
+			sg_memcpy(m_knn_dists.matrix+int64_t(i)*k, heap.get_dists(), k*sizeof(float64_t));
+			sg_memcpy(m_knn_indices.matrix+int64_t(i)*k, heap.get_indices(), k*sizeof(index_t));
+		}
+	});
+}
+
+SGMatrix<float64_t> CNbodyTreeIndex::get_knn_dists()
+{
+	return m_knn_dists;
+}
+
+SGMatrix<index_t> CNbodyTreeIndex::get_knn_indices()
+{
+	return m_knn_indices;
+}
+
+void CNbodyTreeIndex::query_knn_single(CKNNHeap& heap, float64_t mdist, int64_t node, const float64_t* feat) const
+{
+	if (mdist>heap.get_max_dist())
+		return;
+
+	const NbodyTreeIndexNode& n=m_nodes[node];
+	if (n.is_leaf)
+	{
+		for (int64_t i=n.start_idx; i<=n.end_idx; i++)
+			heap.push(m_vec_id[i], distance(i, feat));
+
+		return;
+	}
+
+	float64_t min_dist_left=min_dist(n.left, feat);
+	float64_t min_dist_right=min_dist(n.right, feat);
+
+	if (min_dist_left<=min_dist_right)
+	{
+		query_knn_single(heap, min_dist_left, n.left, feat);
+		query_knn_single(heap, min_dist_right, n.right, feat);
+	}
+	else
+	{
+		query_knn_single(heap, min_dist_right, n.right, feat);
+		query_knn_single(heap, min_dist_left, n.left, feat);
+	}
+}
+
+float64_t CNbodyTreeIndex::min_dist(int64_t node, const float64_t* feat) const
+{
+	const int64_t dim=m_header->dim;
+	const float64_t* lower=m_bbox_lower+node*dim;
+	const float64_t* upper=m_bbox_upper+node*dim;
+
+	float64_t dist=0;
+	for (int64_t i=0; i<dim; i++)
+	{
+		float64_t d=CMath::max(CMath::max(lower[i]-feat[i], feat[i]-upper[i]), 0.0);
+		dist+=add_dim_dist(d);
+	}
+	dist=actual_dists(dist);
+
+	// ball trees also bound the distance by the ball around the center
+	if (m_centers)
+	{
+		const float64_t* center=m_centers+node*dim;
+		float64_t center_dist=0;
+		for (int64_t i=0; i<dim; i++)
+			center_dist+=add_dim_dist(center[i]-feat[i]);
+
+		dist=CMath::max(dist, actual_dists(center_dist)-m_nodes[node].radius);
+	}
+
+	return dist;
+}
+
+float64_t CNbodyTreeIndex::distance(int64_t pos, const float64_t* feat) const
+{
+	const int64_t dim=m_header->dim;
+	const float64_t* vec=m_data+pos*dim;
+
+	float64_t ret=0;
+	for (int64_t i=0; i<dim; i++)
+		ret+=add_dim_dist(vec[i]-feat[i]);
+
+	return actual_dists(ret);
+}
+
+float64_t CNbodyTreeIndex::add_dim_dist(float64_t d) const
+{
+	if (m_dist==D_EUCLIDEAN)
+		return d*d;
+
+	return CMath::abs(d);
+}
+
+float64_t CNbodyTreeIndex::actual_dists(float64_t dists) const
+{
+	if (m_dist==D_MANHATTAN)
+		return dists;
+
+	return std::sqrt(dists);
+}
+
+void CNbodyTreeIndex::init()
+{
+	m_file=NULL;
+	m_header=NULL;
+	m_nodes=NULL;
+	m_bbox_lower=NULL;
+	m_bbox_upper=NULL;
+	m_centers=NULL;
+	m_vec_id=NULL;
+	m_data=NULL;
+	m_dist=D_EUCLIDEAN;
+	m_knn_dists=SGMatrix<float64_t>();
+	m_knn_indices=SGMatrix<index_t>();
+}
@@ -0,0 +1,194 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef _NBODYTREEINDEX_H__
+#define _NBODYTREEINDEX_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/base/SGObject.h>
+#include <shogun/distance/Distance.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/io/MemoryMappedFile.h>
+#include <shogun/multiclass/tree/KNNHeap.h>
+
+namespace shogun
+{
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/** header of a nearest neighbour index file */
+struct NbodyTreeIndexHeader
+{
+	/** file magic "SGNBIDX" */
+	char magic[8];
+	/** version of the format */
+	uint32_t version;
+	/** distance metric, EDistanceType */
+	uint32_t distance;
+	/** dimension of the vectors */
+	int64_t dim;
+	/** number of vectors */
+	int64_t num_vectors;
+	/** number of nodes */
+	int64_t num_nodes;
+	/** whether the nodes have ball centers */
+	int64_t has_centers;
+	/** byte offsets of the sections from the start of the file */
+	int64_t nodes_offset;
+	int64_t bbox_lower_offset;
+	int64_t bbox_upper_offset;
+	int64_t centers_offset;
+	int64_t vec_id_offset;
+	int64_t data_offset;
+};
+
+/** node of a nearest neighbour index file, children are referenced by
+ * their position in the node array */
+struct NbodyTreeIndexNode
+{
+	/** first position of the vectors of the node */
+	int64_t start_idx;
+	/** last position of the vectors of the node */
+	int64_t end_idx;
+	/** left child, -1 for leaves */
+	int64_t left;
+	/** right child, -1 for leaves */
+	int64_t right;
+	/** radius of the ball around the center */
+	float64_t radius;
+	/** whether the node is a leaf */
+	int64_t is_leaf;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/** @brief Read-only nearest neighbour index mapped from a file written by
+ * CNbodyTree::save_index().
+ *
+ * The file holds the nodes of the tree as a flat array with children
+ * referenced by position, the bounding boxes (and ball centers) of the
+ * nodes and the data vectors in leaf order. All sections are located by
+ * offsets, so the file is queried directly where it is mapped, without
+ * building any objects. Pages are loaded on demand and shared between
+ * processes mapping the same file.
+ *
+ * The file uses the byte order of the machine that wrote it.
+ */
+class CNbodyTreeIndex : public CSGObject
+{
+public:
+	/** default constructor */
+	CNbodyTreeIndex();
+
+	/** constructor
+	 *
+	 * @param fname index file written by CNbodyTree::save_index()
+	 */
+	CNbodyTreeIndex(const char* fname);
+
+	/** destructor */
+	virtual ~CNbodyTreeIndex();
+
+	/** get name
+	 * @return NbodyTreeIndex
+	 */
+	virtual const char* get_name() const { return "NbodyTreeIndex"; }
+
+	/** @return number of indexed vectors */
+	int64_t get_num_vectors() const;
+
+	/** @return dimension of the indexed vectors */
+	int64_t get_dim() const;
+
+	/** apply knn, the queries are processed in parallel
+	 *
+	 * @param data vectors whose KNNs are required
+	 * @param k K value in KNN
+	 */
+	void query_knn(CDenseFeatures<float64_t>* data, int32_t k);
+
+	/** distance b/w KNN vectors and query vectors
+	 * @return distances
+	 */
+	SGMatrix<float64_t> get_knn_dists();
+
+	/** indices of KNN vectors to query vectors
+	 * @return Matrix of indices
+	 */
+	SGMatrix<index_t> get_knn_indices();
+
+private:
+	/** lower bound of the distance between a node and a query vector
+	 * @param node position of the node
+	 * @param feat query vector
+	 * @return min distance
+	 */
+	float64_t min_dist(int64_t node, const float64_t* feat) const;
+
+	/** distance between a vector of the index and a query vector
+	 * @param pos position of the vector in leaf order
+	 * @param feat query vector
+	 * @return distance
+	 */
+	float64_t distance(int64_t pos, const float64_t* feat) const;
+
+	/** distance component contributed by one dimension
+	 * @param d displacement in that dimension
+	 * @return distance component
+	 */
+	float64_t add_dim_dist(float64_t d) const;
+
+	/** convert accumulated components to the actual distance
+	 * @param dists accumulated distance components
+	 * @return actual distance
+	 */
+	float64_t actual_dists(float64_t dists) const;
+
+	/** depth first knn search of a query vector
+	 * @param heap heap of the k nearest vectors found so far
+	 * @param mdist minimum distance b/w query vector and node
+	 * @param node position of the current node
+	 * @param feat query vector
+	 */
+	void query_knn_single(CKNNHeap& heap, float64_t mdist, int64_t node, const float64_t* feat) const;
+
+	/** initialize parameters */
+	void init();
+
+private:
+	/** mapped index file */
+	CMemoryMappedFile<char>* m_file;
+
+	/** header at the start of the mapping */
+	const NbodyTreeIndexHeader* m_header;
+
+	/** node array */
+	const NbodyTreeIndexNode* m_nodes;
+
+	/** bounding box lower bounds, dim per node */
+	const float64_t* m_bbox_lower;
+
+	/** bounding box upper bounds, dim per node */
+	const float64_t* m_bbox_upper;
+
+	/** ball centers, dim per node, NULL if not stored */
+	const float64_t* m_centers;
+
+	/** ids of the vectors in leaf order */
+	const int64_t* m_vec_id;
+
+	/** vectors in leaf order */
+	const float64_t* m_data;
+
+	/** distance metric */
+	EDistanceType m_dist;
+
+	/** knn distances */
+	SGMatrix<float64_t> m_knn_dists;
+
+	/** knn indices */
+	SGMatrix<index_t> m_knn_indices;
+};
+} /* namespace shogun */
+
+#endif /* _NBODYTREEINDEX_H__ */
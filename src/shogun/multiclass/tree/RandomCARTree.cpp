@@ -55,17 +55,22 @@ index_t CRandomCARTree::compute_best_attribute(const SGMatrix<float64_t>& mat, c
 
 {
 	auto num_feats = (m_pre_sort) ? mat.num_cols : mat.num_rows;
+	subset_size=get_split_subset_size(num_feats);
 
+	return CCARTree::compute_best_attribute(mat,weights,labels,left,right,is_left_final,num_missing_final,count_left,count_right,subset_size, active_indices);
+
+}
+
+index_t CRandomCARTree::get_split_subset_size(index_t num_feats)
+{
 	// if subset size is not set choose sqrt(num_feats) by default
 	if (m_randsubset_size==0)
 		m_randsubset_size = std::sqrt((float64_t)num_feats);
-	subset_size=m_randsubset_size;
-
-	require(subset_size<=num_feats, "The Feature subset size(set {}) should be less than"
-	" or equal to the total number of features({} here).",subset_size,num_feats);
 
-	return CCARTree::compute_best_attribute(mat,weights,labels,left,right,is_left_final,num_missing_final,count_left,count_right,subset_size, active_indices);
+	require(m_randsubset_size<=num_feats, "The Feature subset size(set {}) should be less than"
+	" or equal to the total number of features({} here).",m_randsubset_size,num_feats);
 
+	return m_randsubset_size;
 }
 
 void CRandomCARTree::init()
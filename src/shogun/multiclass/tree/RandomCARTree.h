@@ -89,6 +89,13 @@ protected:
 		SGVector<float64_t>& left, SGVector<float64_t>& right, SGVector<bool>& is_left_final, index_t &num_missing,
 		index_t &count_left, index_t &count_right, index_t subset_size=0, const SGVector<index_t>& active_indices=SGVector<index_t>());
 
+	/** number of randomly chosen features searched for each split
+	 *
+	 * @param num_feats number of features
+	 * @return subset size
+	 */
+	virtual index_t get_split_subset_size(index_t num_feats);
+
 private:
 	/** initialize parameters */
 	void init();
@@ -38,6 +38,8 @@
 #include <string.h>
 #include <stdarg.h>
 
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/base/TaskScheduler.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
 #include <shogun/mathematics/UniformIntDistribution.h>
@@ -46,8 +48,90 @@
 #include <shogun/lib/Time.h>
 #include <shogun/lib/Signal.h>
 
+#include <algorithm>
+#include <vector>
+
 using namespace shogun;
 
+// minimum number of examples per block of the parallel sums below
+static const int32_t block_size=4096;
+
+// number of blocks of examples for the parallel sums, at most one per thread
+// so that there are few partial sums
+static int32_t num_blocks(int32_t num)
+{
+	return std::max(1, std::min(env()->get_num_threads(), num/block_size));
+}
+
+// sum of term(i) over [0,num). The blocks are summed on all threads and
+// added up in order, so one block gives the serial result
+template <class F>
+static double parallel_sum(int32_t num, F term)
+{
+	const int32_t blocks=num_blocks(num);
+	std::vector<double> sums(blocks, 0);
+	parallel_for(0, blocks, [&](index_t first, index_t last) {
+		for (index_t b=first; b<last; b++)
+		{
+			const int32_t end=int64_t(num)*(b+1)/blocks;
+			for (int32_t i=int64_t(num)*b/blocks; i<end; i++)
+				sums[b]+=term(i);
+		}
+	}, 1);
+
+	double sum=0;
+	for (auto block_sum : sums)
+		sum+=block_sum;
+	return sum;
+}
+
+// res = sum_k v[k]*x_{index(k)} over [0,num), with the sum of v in the bias
+// element if used. Every block of examples adds to its own vector, which are
+// added up in order
+template <class F>
+static void parallel_XTv(const liblinear_problem* prob, int32_t num, const double* v, F index, double* res)
+{
+	int32_t n=prob->n;
+	if (prob->use_bias)
+		n--;
+
+	const int32_t blocks=num_blocks(num);
+	std::vector<SGVector<float64_t>> partial(blocks-1);
+	memset(res, 0, sizeof(double)*prob->n);
+	parallel_for(0, blocks, [&](index_t first, index_t last) {
+		for (index_t b=first; b<last; b++)
+		{
+			double* out=res;
+			if (b>0)
+			{
+				partial[b-1]=SGVector<float64_t>(prob->n);
+				partial[b-1].zero();
+				out=partial[b-1].vector;
+			}
+
+			const int32_t end=int64_t(num)*(b+1)/blocks;
+			for (int32_t k=int64_t(num)*b/blocks; k<end; k++)
+			{
+				prob->x->add_to_dense_vec(v[k], index(k), out, n);
+
+				if (prob->use_bias)
+					out[n]+=v[k];
+			}
+		}
+	}, 1);
+
+	if (blocks>1)
+	{
+		parallel_for(0, prob->n, [&](index_t start, index_t end) {
+			for (const auto& block : partial)
+			{
+				for (index_t j=start; j<end; j++)
+					res[j]+=block[j];
+			}
+		}, block_size);
+	}
+}
+
 l2r_lr_fun::l2r_lr_fun(const liblinear_problem *p, float64_t* Cs)
 {
 	int l=p->l;
@@ -68,21 +152,19 @@ l2r_lr_fun::~l2r_lr_fun()
 
 double l2r_lr_fun::fun(double *w)
 {
-	int i;
 	double f=0;
 	float64_t *y=m_prob->y;
 	int l=m_prob->l;
 	int32_t n=m_prob->n;
 
 	Xv(w, z);
-	for(i=0;i<l;i++)
-	{
+	f += parallel_sum(l, [&](int32_t i) {
 		double yz = y[i]*z[i];
 		if (yz >= 0)
-			f += C[i]*log(1 + exp(-yz));
+			return C[i]*log(1 + exp(-yz));
 		else
-			f += C[i]*(-yz+log(1 + exp(yz)));
-	}
+			return C[i]*(-yz+log(1 + exp(yz)));
+	});
 	SGVector<float64_t> w_wrap(w, n, false);
 	f += 0.5 *linalg::dot(w_wrap, w_wrap);
 
@@ -96,12 +178,14 @@ void l2r_lr_fun::grad(double *w, double *g)
 	int l=m_prob->l;
 	int w_size=get_nr_variable();
 
-	for(i=0;i<l;i++)
-	{
-		z[i] = 1/(1 + exp(-y[i]*z[i]));
-		D[i] = z[i]*(1-z[i]);
-		z[i] = C[i]*(z[i]-1)*y[i];
-	}
+	parallel_for(0, l, [&](index_t start, index_t end) {
+		for(index_t j=start;j<end;j++)
+		{
+			z[j] = 1/(1 + exp(-y[j]*z[j]));
+			D[j] = z[j]*(1-z[j]);
+			z[j] = C[j]*(z[j]-1)*y[j];
+		}
+	}, block_size);
 	XTv(z, g);
 
 	for(i=0;i<w_size;i++)
@@ -147,21 +231,7 @@ void l2r_lr_fun::Xv(double *v, double *res_Xv)
 
 void l2r_lr_fun::XTv(double *v, double *res_XTv)
 {
-	int l=m_prob->l;
-	int32_t n=m_prob->n;
-
-	memset(res_XTv, 0, sizeof(double)*m_prob->n);
-
-	if (m_prob->use_bias)
-		n--;
-
-	for (int32_t i=0;i<l;i++)
-	{
-		m_prob->x->add_to_dense_vec(v[i], i, res_XTv, n);
-
-		if (m_prob->use_bias)
-			res_XTv[n]+=v[i];
-	}
+	parallel_XTv(m_prob, m_prob->l, v, [](int32_t i) { return i; }, res_XTv);
 }
 
 l2r_l2_svc_fun::l2r_l2_svc_fun(const liblinear_problem *p, double* Cs)
@@ -186,20 +256,17 @@ l2r_l2_svc_fun::~l2r_l2_svc_fun()
 
 double l2r_l2_svc_fun::fun(double *w)
 {
-	int i;
 	double f=0;
 	float64_t *y=m_prob->y;
 	int l=m_prob->l;
 	int w_size=get_nr_variable();
 
 	Xv(w, z);
-	for(i=0;i<l;i++)
-	{
+	f += parallel_sum(l, [&](int32_t i) {
 		z[i] = y[i]*z[i];
 		double d = 1-z[i];
-		if (d > 0)
-			f += C[i]*d*d;
-	}
+		return d > 0 ? C[i]*d*d : 0.0;
+	});
 	SGVector<float64_t> w_wrap(w, w_size, false);
 	f += 0.5*linalg::dot(w_wrap, w_wrap);
 
@@ -288,19 +355,8 @@ void l2r_l2_svc_fun::subXv(double *v, double *res_Xv)
 
 void l2r_l2_svc_fun::subXTv(double *v, double *XTv)
 {
-	int32_t n=m_prob->n;
-
-	if (m_prob->use_bias)
-		n--;
-
-	memset(XTv, 0, sizeof(float64_t)*m_prob->n);
-	for (int32_t i=0;i<sizeI;i++)
-	{
-		m_prob->x->add_to_dense_vec(v[i], I[i], XTv, n);
-
-		if (m_prob->use_bias)
-			XTv[n]+=v[i];
-	}
+	const int* index=I;
+	parallel_XTv(m_prob, sizeI, v, [index](int32_t k) { return index[k]; }, XTv);
 }
 
 l2r_l2_svr_fun::l2r_l2_svr_fun(const liblinear_problem *prob, double *Cs, double p):
@@ -0,0 +1,119 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/base/TaskScheduler.h>
+#include <shogun/io/SGIO.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
+#include <shogun/preprocessor/IncompleteCholesky.h>
+
+#include <algorithm>
+
+using namespace shogun;
+
+CIncompleteCholesky::CIncompleteCholesky() : CLowRankKernelMap()
+{
+	init();
+}
+
+CIncompleteCholesky::CIncompleteCholesky(
+    CKernel* kernel, int32_t num_landmarks, float64_t tolerance)
+    : CLowRankKernelMap(kernel, num_landmarks)
+{
+	init();
+	set_tolerance(tolerance);
+}
+
+void CIncompleteCholesky::init()
+{
+	m_tolerance = 1e-6;
+
+	SG_ADD(
+	    &m_tolerance, "tolerance", "largest residual diagonal to stop at",
+	    ParameterProperties::HYPER);
+}
+
+CIncompleteCholesky::~CIncompleteCholesky()
+{
+}
+
+void CIncompleteCholesky::fit(CFeatures* features)
+{
+	require(m_kernel, "Kernel not set");
+	require(features, "No features provided");
+
+	cleanup();
+
+	const int32_t n = features->get_num_vectors();
+	const int32_t max_rank = std::min(m_num_landmarks, n);
+	const index_t grain = 256;
+
+	m_kernel->init(features, features);
+
+	SGVector<float64_t> residual(n);
+	parallel_for(0, n, [&](index_t start, index_t end) {
+		for (index_t i = start; i < end; i++)
+			residual[i] = m_kernel->kernel(i, i);
+	}, grain);
+
+	SGMatrix<float64_t> G(n, max_rank);
+	SGVector<index_t> pivots(max_rank);
+	int32_t rank = 0;
+	for (; rank < max_rank; rank++)
+	{
+		const index_t p =
+		    std::max_element(residual.vector, residual.vector + n) -
+		    residual.vector;
+		if (residual[p] <= m_tolerance)
+			break;
+
+		pivots[rank] = p;
+		const float64_t pivot = std::sqrt(residual[p]);
+		float64_t* column = G.get_column_vector(rank);
+		parallel_for(0, n, [&](index_t start, index_t end) {
+			for (index_t i = start; i < end; i++)
+			{
+				float64_t value = m_kernel->kernel(i, p);
+				for (int32_t l = 0; l < rank; l++)
+					value -= G(i, l) * G(p, l);
+
+				column[i] = value / pivot;
+				residual[i] -= column[i] * column[i];
+			}
+		}, grain);
+		residual[p] = 0;
+	}
+	m_kernel->cleanup();
+
+	require(rank > 0, "Kernel matrix diagonal is below the tolerance ({})",
+		m_tolerance);
+	io::info("Incomplete Cholesky stopped at rank {}", rank);
+
+	// the rows of the pivots are lower triangular
+	SGMatrix<float64_t> L(rank, rank);
+	SGMatrix<float64_t> identity(rank, rank);
+	L.zero();
+	identity.set_const(0);
+	for (int32_t i = 0; i < rank; i++)
+	{
+		for (int32_t j = 0; j <= i; j++)
+			L(i, j) = G(pivots[i], j);
+		identity(i, i) = 1;
+	}
+
+	set_landmarks(features, SGVector<index_t>(pivots.vector, rank, false).clone());
+	m_projection = linalg::triangular_solver(L, identity, true);
+
+	m_fitted = true;
+}
+
+void CIncompleteCholesky::set_tolerance(float64_t tolerance)
+{
+	require(tolerance >= 0, "Tolerance ({}) must not be negative", tolerance);
+	m_tolerance = tolerance;
+}
+
+float64_t CIncompleteCholesky::get_tolerance() const
+{
+	return m_tolerance;
+}
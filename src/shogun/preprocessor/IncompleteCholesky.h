@@ -0,0 +1,86 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef INCOMPLETECHOLESKY_H__
+#define INCOMPLETECHOLESKY_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/preprocessor/LowRankKernelMap.h>
+
+namespace shogun
+{
+
+/** @brief Preprocessor IncompleteCholesky maps features to the explicit
+ * features of the pivoted incomplete Cholesky decomposition of a kernel.
+ *
+ * Fitting greedily factorizes the kernel matrix of the training data as
+ * \f$K\approx GG^\top\f$, where every column of \f$G\f$ pivots on the vector
+ * with the largest residual diagonal \f$K_{ii}-\sum_l G_{il}^2\f$. It stops
+ * after the maximum number of landmarks or when the largest residual is at
+ * most the tolerance, so the rank adapts to the spectrum of the kernel. Only
+ * the columns of the pivots are computed, each on all threads.
+ *
+ * The pivots are the landmarks \f$z_1,\dots,z_m\f$. With the lower
+ * triangular rows \f$L\f$ of \f$G\f$ that belong to them, a vector is mapped
+ * to
+ *
+ * \f[
+ *	\phi(x)=L^{-1}\left(k(z_1,x),\dots,k(z_m,x)\right)^\top,
+ * \f]
+ *
+ * which reproduces the rows of \f$G\f$ for the training data.
+ *
+ * Fine, S., & Scheinberg, K. (2001). Efficient SVM training using low-rank
+ * kernel representations. Journal of Machine Learning Research, 2, 243-264.
+ */
+class CIncompleteCholesky : public CLowRankKernelMap
+{
+public:
+	/** default constructor */
+	CIncompleteCholesky();
+
+	/** constructor
+	 *
+	 * @param kernel kernel to approximate
+	 * @param num_landmarks maximum number of landmarks
+	 * @param tolerance largest residual diagonal to stop at
+	 */
+	CIncompleteCholesky(
+	    CKernel* kernel, int32_t num_landmarks, float64_t tolerance = 1e-6);
+
+	virtual ~CIncompleteCholesky();
+
+	/** factorizes the kernel matrix of the features and computes the
+	 * projection
+	 *
+	 * @param features training features
+	 */
+	virtual void fit(CFeatures* features);
+
+	/** setter for tolerance
+	 * @param tolerance largest residual diagonal to stop at
+	 */
+	void set_tolerance(float64_t tolerance);
+
+	/** getter for tolerance
+	 * @return tolerance
+	 */
+	float64_t get_tolerance() const;
+
+	/** @return object name */
+	virtual const char* get_name() const { return "IncompleteCholesky"; }
+
+	/** @return the type of preprocessor */
+	virtual EPreprocessorType get_type() const { return P_INCOMPLETECHOLESKY; }
+
+private:
+	void init();
+
+protected:
+	/** largest residual diagonal to stop at */
+	float64_t m_tolerance;
+};
+}
+#endif
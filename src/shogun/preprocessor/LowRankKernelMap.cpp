@@ -0,0 +1,148 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/base/TaskScheduler.h>
+#include <shogun/io/SGIO.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
+#include <shogun/preprocessor/LowRankKernelMap.h>
+
+#include <algorithm>
+
+using namespace shogun;
+
+CLowRankKernelMap::CLowRankKernelMap() : CPreprocessor()
+{
+	init();
+}
+
+CLowRankKernelMap::CLowRankKernelMap(CKernel* kernel, int32_t num_landmarks)
+    : CPreprocessor()
+{
+	init();
+	set_kernel(kernel);
+	set_num_landmarks(num_landmarks);
+}
+
+void CLowRankKernelMap::init()
+{
+	m_fitted = false;
+	m_kernel = NULL;
+	m_num_landmarks = 100;
+	m_landmarks = NULL;
+
+	SG_ADD(&m_kernel, "kernel", "kernel to approximate", ParameterProperties::HYPER);
+	SG_ADD(
+	    &m_num_landmarks, "num_landmarks", "maximum number of landmarks",
+	    ParameterProperties::HYPER);
+	SG_ADD(&m_landmark_indices, "landmark_indices",
+		"indices of the landmarks in the training features");
+	SG_ADD(&m_landmarks, "landmarks", "landmarks chosen from the training features");
+	SG_ADD(&m_projection, "projection", "projection of the landmark kernel values");
+}
+
+CLowRankKernelMap::~CLowRankKernelMap()
+{
+	SG_UNREF(m_landmarks);
+	SG_UNREF(m_kernel);
+}
+
+void CLowRankKernelMap::cleanup()
+{
+	SG_UNREF(m_landmarks);
+	m_landmarks = NULL;
+	m_landmark_indices = SGVector<index_t>();
+	m_projection = SGMatrix<float64_t>();
+
+	m_fitted = false;
+}
+
+void CLowRankKernelMap::set_landmarks(
+    CFeatures* features, SGVector<index_t> indices)
+{
+	SG_UNREF(m_landmarks);
+	m_landmark_indices = indices;
+	m_landmarks = features->copy_subset(indices);
+	SG_REF(m_landmarks);
+}
+
+CFeatures* CLowRankKernelMap::transform(CFeatures* features, bool inplace)
+{
+	return new CDenseFeatures<float64_t>(apply_to_feature_matrix(features));
+}
+
+SGMatrix<float64_t> CLowRankKernelMap::apply_to_feature_matrix(CFeatures* features)
+{
+	assert_fitted();
+	require(features, "No features provided");
+
+	const int32_t num_vectors = features->get_num_vectors();
+	const int32_t num_landmarks = m_landmarks->get_num_vectors();
+	const index_t block_size = 64;
+	SGMatrix<float64_t> result(m_projection.num_rows, num_vectors);
+
+	m_kernel->init(m_landmarks, features);
+	parallel_for(0, num_vectors, [&](index_t start, index_t end) {
+		SGMatrix<float64_t> values(num_landmarks, block_size);
+		for (index_t first = start; first < end; first += block_size)
+		{
+			const index_t last = std::min(first + block_size, end);
+			for (index_t i = first; i < last; i++)
+			{
+				for (index_t j = 0; j < num_landmarks; j++)
+					values(j, i - first) = m_kernel->kernel(j, i);
+			}
+
+			SGMatrix<float64_t> block_values(
+			    values.matrix, num_landmarks, last - first, false);
+			SGMatrix<float64_t> block(
+			    result.get_column_vector(first), result.num_rows, last - first,
+			    false);
+			linalg::matrix_prod(m_projection, block_values, block);
+		}
+	}, block_size);
+	m_kernel->cleanup();
+
+	return result;
+}
+
+EFeatureClass CLowRankKernelMap::get_feature_class()
+{
+	return C_ANY;
+}
+
+EFeatureType CLowRankKernelMap::get_feature_type()
+{
+	return F_ANY;
+}
+
+void CLowRankKernelMap::set_kernel(CKernel* kernel)
+{
+	SG_REF(kernel);
+	SG_UNREF(m_kernel);
+	m_kernel = kernel;
+}
+
+CKernel* CLowRankKernelMap::get_kernel() const
+{
+	SG_REF(m_kernel);
+	return m_kernel;
+}
+
+void CLowRankKernelMap::set_num_landmarks(int32_t num_landmarks)
+{
+	require(num_landmarks > 0, "Number of landmarks ({}) must be positive",
+		num_landmarks);
+	m_num_landmarks = num_landmarks;
+}
+
+int32_t CLowRankKernelMap::get_num_landmarks() const
+{
+	return m_num_landmarks;
+}
+
+CFeatures* CLowRankKernelMap::get_landmarks() const
+{
+	SG_REF(m_landmarks);
+	return m_landmarks;
+}
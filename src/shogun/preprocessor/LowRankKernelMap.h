@@ -0,0 +1,150 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef LOWRANKKERNELMAP_H__
+#define LOWRANKKERNELMAP_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/kernel/Kernel.h>
+#include <shogun/lib/common.h>
+#include <shogun/preprocessor/Preprocessor.h>
+
+namespace shogun
+{
+
+/** @brief Base class of the preprocessors that map features to explicit
+ * features of a low rank approximation of a kernel.
+ *
+ * The map is given by landmarks \f$z_1,\dots,z_m\f$ chosen from the training
+ * data when fitting, and a projection matrix \f$P\f$. A vector \f$x\f$ is
+ * mapped to
+ *
+ * \f[
+ *	\phi(x)=P\left(k(z_1,x),\dots,k(z_m,x)\right)^\top,
+ * \f]
+ *
+ * such that \f$\phi(x)^\top\phi(y)\approx k(x,y)\f$. The kernel can be on
+ * any type of features, the result are always CDenseFeatures. Linear
+ * machines such as CLibLinear, CLinearRidgeRegression or the SGD solvers can
+ * then be trained on the result with \f$O(nm)\f$ kernel evaluations instead
+ * of the \f$O(n^2)\f$ of a kernel machine.
+ *
+ * The features are mapped on all threads, in blocks of vectors, so that only
+ * the kernel values of the current blocks are kept.
+ */
+class CLowRankKernelMap : public CPreprocessor
+{
+public:
+	/** default constructor */
+	CLowRankKernelMap();
+
+	/** constructor
+	 *
+	 * @param kernel kernel to approximate
+	 * @param num_landmarks maximum number of landmarks
+	 */
+	CLowRankKernelMap(CKernel* kernel, int32_t num_landmarks);
+
+	virtual ~CLowRankKernelMap();
+
+	/** Map features to the approximate kernel feature space. In-place mode
+	 * is not supported.
+	 *
+	 * @param features features to transform, of the type of the kernel
+	 * @param inplace ignored
+	 * @return the mapped CDenseFeatures
+	 */
+	virtual CFeatures* transform(CFeatures* features, bool inplace = true);
+
+	/** map features to the approximate kernel feature space
+	 *
+	 * @param features features of the type of the kernel
+	 * @return mapped vectors as the columns of a matrix
+	 */
+	SGMatrix<float64_t> apply_to_feature_matrix(CFeatures* features);
+
+	/// cleanup
+	virtual void cleanup();
+
+	virtual EFeatureClass get_feature_class();
+
+	virtual EFeatureType get_feature_type();
+
+	/** setter for kernel
+	 * @param kernel kernel to approximate
+	 */
+	void set_kernel(CKernel* kernel);
+
+	/** getter for kernel
+	 * @return kernel
+	 */
+	CKernel* get_kernel() const;
+
+	/** setter for the maximum number of landmarks, i.e. the rank of the
+	 * approximation
+	 * @param num_landmarks number of landmarks
+	 */
+	void set_num_landmarks(int32_t num_landmarks);
+
+	/** getter for the maximum number of landmarks
+	 * @return number of landmarks
+	 */
+	int32_t get_num_landmarks() const;
+
+	/** @return the landmarks chosen when fitting */
+	CFeatures* get_landmarks() const;
+
+	/** @return indices of the landmarks in the training features */
+	SGVector<index_t> get_landmark_indices() const
+	{
+		return m_landmark_indices;
+	}
+
+	/** @return projection matrix, target dimension x number of landmarks */
+	SGMatrix<float64_t> get_projection_matrix() const
+	{
+		return m_projection;
+	}
+
+	/** @return dimension of the mapped features */
+	int32_t get_target_dim() const
+	{
+		return m_projection.num_rows;
+	}
+
+	/** @return object name */
+	virtual const char* get_name() const { return "LowRankKernelMap"; }
+
+protected:
+	/** sets the given vectors of the training features as the landmarks
+	 *
+	 * @param features training features
+	 * @param indices indices of the landmarks, in the order of the columns
+	 * of the projection matrix
+	 */
+	void set_landmarks(CFeatures* features, SGVector<index_t> indices);
+
+private:
+	void init();
+
+protected:
+	/** kernel to approximate */
+	CKernel* m_kernel;
+
+	/** maximum number of landmarks */
+	int32_t m_num_landmarks;
+
+	/** indices of the landmarks in the training features */
+	SGVector<index_t> m_landmark_indices;
+
+	/** landmarks */
+	CFeatures* m_landmarks;
+
+	/** projection matrix */
+	SGMatrix<float64_t> m_projection;
+};
+}
+#endif
@@ -0,0 +1,82 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/io/SGIO.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/RandomNamespace.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
+#include <shogun/preprocessor/Nystrom.h>
+
+#include <limits>
+
+using namespace shogun;
+
+CNystrom::CNystrom() : RandomMixin<CLowRankKernelMap>()
+{
+}
+
+CNystrom::CNystrom(CKernel* kernel, int32_t num_landmarks)
+    : RandomMixin<CLowRankKernelMap>(kernel, num_landmarks)
+{
+}
+
+CNystrom::~CNystrom()
+{
+}
+
+void CNystrom::fit(CFeatures* features)
+{
+	require(m_kernel, "Kernel not set");
+	require(features, "No features provided");
+
+	cleanup();
+
+	const int32_t n = features->get_num_vectors();
+	int32_t m = m_num_landmarks;
+	if (m > n)
+	{
+		io::warn(
+		    "Number of landmarks ({}) is larger than the number of vectors, "
+		    "using all {} vectors.",
+		    m, n);
+		m = n;
+	}
+
+	SGVector<index_t> permutation(n);
+	permutation.range_fill();
+	random::shuffle(permutation, m_prng);
+	SGVector<index_t> indices(m);
+	for (index_t i = 0; i < m; ++i)
+		indices[i] = permutation[i];
+	CMath::qsort(indices.vector, m);
+	set_landmarks(features, indices);
+
+	m_kernel->init(m_landmarks, m_landmarks);
+	SGMatrix<float64_t> kernel_matrix = m_kernel->get_kernel_matrix();
+	m_kernel->cleanup();
+
+	SGVector<float64_t> eigenvalues(m);
+	SGMatrix<float64_t> eigenvectors(m, m);
+	linalg::eigen_solver_symmetric(kernel_matrix, eigenvalues, eigenvectors, m);
+
+	// eigenvalues are in increasing order, the numerically zero ones are
+	// dropped rather than amplified
+	const float64_t threshold =
+	    eigenvalues[m - 1] * m * std::numeric_limits<float64_t>::epsilon();
+	int32_t rank = 0;
+	while (rank < m && eigenvalues[m - rank - 1] > threshold)
+		rank++;
+	require(rank > 0, "Kernel matrix of the landmarks is zero");
+
+	m_projection = SGMatrix<float64_t>(rank, m);
+	for (int32_t i = 0; i < rank; i++)
+	{
+		const auto idx = m - i - 1;
+		const float64_t scale = 1.0 / std::sqrt(eigenvalues[idx]);
+		for (int32_t j = 0; j < m; j++)
+			m_projection(i, j) = eigenvectors(j, idx) * scale;
+	}
+
+	m_fitted = true;
+}
@@ -0,0 +1,64 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef NYSTROM_H__
+#define NYSTROM_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/mathematics/RandomMixin.h>
+#include <shogun/preprocessor/LowRankKernelMap.h>
+
+namespace shogun
+{
+
+/** @brief Preprocessor Nystrom maps features to the explicit features of the
+ * Nyström approximation of a kernel.
+ *
+ * The \f$m\f$ landmarks \f$z_1,\dots,z_m\f$ are sampled uniformly without
+ * replacement from the training data. With the eigendecomposition
+ * \f$K_{mm}=U\Lambda U^\top\f$ of their kernel matrix, a vector is mapped to
+ *
+ * \f[
+ *	\phi(x)=\Lambda^{-\frac{1}{2}}U^\top\left(k(z_1,x),\dots,k(z_m,x)\right)^\top,
+ * \f]
+ *
+ * so that \f$\phi(x)^\top\phi(y)=k_m(x)^\top K_{mm}^{-1}k_m(y)\f$.
+ * Eigenvalues that are numerically zero are dropped, hence the target
+ * dimension is at most the number of landmarks.
+ *
+ * This is the approximation CKRRNystrom uses internally, see
+ *
+ * Williams, C., & Seeger, M. (2001). Using the Nyström method to speed up
+ * kernel machines. Advances in Neural Information Processing Systems 13.
+ */
+class CNystrom : public RandomMixin<CLowRankKernelMap>
+{
+public:
+	/** default constructor */
+	CNystrom();
+
+	/** constructor
+	 *
+	 * @param kernel kernel to approximate
+	 * @param num_landmarks number of landmarks
+	 */
+	CNystrom(CKernel* kernel, int32_t num_landmarks);
+
+	virtual ~CNystrom();
+
+	/** samples the landmarks from the features and computes the projection
+	 *
+	 * @param features training features
+	 */
+	virtual void fit(CFeatures* features);
+
+	/** @return object name */
+	virtual const char* get_name() const { return "Nystrom"; }
+
+	/** @return the type of preprocessor */
+	virtual EPreprocessorType get_type() const { return P_NYSTROM; }
+};
+}
+#endif
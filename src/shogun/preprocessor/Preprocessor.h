@@ -49,7 +49,9 @@ enum EPreprocessorType
 	P_HOMOGENEOUSKERNELMAP = 180,
 	P_PNORM = 190,
 	P_RESCALEFEATURES = 200,
-	P_FISHERLDA = 210
+	P_FISHERLDA = 210,
+	P_NYSTROM = 220,
+	P_INCOMPLETECHOLESKY = 230
 };
 
 /** @brief Class Preprocessor defines a preprocessor interface.
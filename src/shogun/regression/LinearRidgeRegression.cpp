@@ -95,6 +95,73 @@ bool CLinearRidgeRegression::train_machine_templated(
 	return true;
 }
 
+bool CLinearRidgeRegression::train_machine(CFeatures* data)
+{
+	require(
+	    data->get_feature_class() == C_DISK_DENSE,
+	    "Training with {} is not implemented!", data->get_name());
+
+	auto feats = data->as<CDiskDotFeatures>();
+	CSubsetStack* subset_stack = feats->get_subset_stack();
+	bool has_subsets = subset_stack->has_subsets();
+	SG_UNREF(subset_stack);
+	require(!has_subsets, "Subsets of {} are not supported", feats->get_name());
+
+	return train_disk(feats);
+}
+
+bool CLinearRidgeRegression::train_disk(const CDiskDotFeatures* feats)
+{
+	auto N = feats->get_num_vectors();
+	auto D = feats->get_dim_feature_space();
+	require(
+	    N >= D, "Training on {} needs at least as many vectors ({}) as "
+	            "dimensions ({})",
+	    feats->get_name(), N, D);
+
+	auto y = regression_labels(m_labels)->get_labels();
+
+	// X X^T, X y and the sum of the vectors, one block in memory at a time
+	SGMatrix<float64_t> cov(D, D);
+	SGVector<float64_t> Xy(D);
+	SGVector<float64_t> x_sum(D);
+	cov.zero();
+	Xy.zero();
+	x_sum.zero();
+	for (int32_t block = 0; block < feats->get_num_blocks(); ++block)
+	{
+		auto mat = feats->get_block(block);
+		SGVector<float64_t> y_block(
+		    y.vector + feats->get_block_start(block), mat.num_cols, false);
+
+		linalg::dgemm(1.0, mat, mat, false, true, 1.0, cov);
+		linalg::dgemv(1.0, mat, false, y_block, 1.0, Xy);
+		if (m_use_bias)
+			linalg::add(x_sum, linalg::rowwise_sum(mat), x_sum);
+	}
+
+	SGVector<float64_t> x_mean;
+	float64_t y_mean = 0;
+	linalg::add_ridge(cov, m_tau);
+	if (m_use_bias)
+	{
+		x_mean = x_sum;
+		linalg::scale(x_mean, x_mean, 1.0 / N);
+		y_mean = linalg::mean(y);
+		linalg::rank_update(cov, x_mean, (float64_t)-N);
+		linalg::add(Xy, x_mean, Xy, 1.0, -N * y_mean);
+	}
+
+	auto L = linalg::cholesky_factor(cov);
+	SGVector<float64_t> w = linalg::cholesky_solver(L, Xy);
+	set_w(w);
+
+	if (m_use_bias)
+		set_bias(y_mean - linalg::dot(w, x_mean));
+
+	return true;
+}
+
 bool CLinearRidgeRegression::load(FILE* srcfile)
 {
 	SG_SET_LOCALE_C;
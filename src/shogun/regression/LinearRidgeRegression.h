@@ -11,6 +11,7 @@
 #include <shogun/lib/config.h>
 
 #include <shogun/features/DenseFeatures.h>
+#include <shogun/features/DiskDotFeatures.h>
 #include <shogun/machine/FeatureDispatchCRTP.h>
 #include <shogun/machine/LinearMachine.h>
 #include <shogun/regression/Regression.h>
@@ -108,6 +109,23 @@ namespace shogun
 		template <typename T>
 		bool train_machine_templated(const CDenseFeatures<T>* feats);
 
+		/** train on CDiskDotFeatures, block by block, so that the data
+		 * need not fit into memory. Dense features are dispatched to
+		 * train_machine_templated instead.
+		 *
+		 * @param data training data
+		 * @return whether training was successful
+		 */
+		virtual bool train_machine(CFeatures* data=NULL);
+
+		/** accumulate the normal equations over the blocks of features
+		 * read from disk
+		 *
+		 * @param feats training data
+		 * @return whether training was successful
+		 */
+		bool train_disk(const CDiskDotFeatures* feats);
+
 	private:
 		void init();
 
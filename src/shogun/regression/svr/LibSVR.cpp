@@ -132,6 +132,8 @@ bool CLibSVR::train_machine(CFeatures* data)
 	param.weight_label = weights_label;
 	param.weight = weights;
 	param.use_bias = get_bias_enabled();
+	param.use_kernel_row_cache = false;
+	param.parallel_grain = LIBSVM_PARALLEL_GRAIN;
 
 	const char* error_msg = svm_check_parameter(&problem,&param);
 
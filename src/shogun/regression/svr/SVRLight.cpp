@@ -29,25 +29,10 @@ extern "C" {
 #endif
 
 #include <shogun/base/Parallel.h>
-
-#ifdef HAVE_PTHREAD
-#include <pthread.h>
-#endif
+#include <shogun/base/TaskScheduler.h>
 
 using namespace shogun;
 
-#ifndef DOXYGEN_SHOULD_SKIP_THIS
-struct S_THREAD_PARAM_SVRLIGHT
-{
-	float64_t* lin;
-	int32_t start, end;
-	int32_t* active2dnum;
-	int32_t* docs;
-	CKernel* kernel;
-    int32_t num_vectors;
-};
-#endif // DOXYGEN_SHOULD_SKIP_THIS
-
 CSVRLight::CSVRLight(float64_t C, float64_t eps, CKernel* k, CLabels* lab)
 : CSVMLight(C, k, lab)
 {
@@ -357,18 +342,6 @@ float64_t CSVRLight::compute_objective_function(
   return(criterion);
 }
 
-void* CSVRLight::update_linear_component_linadd_helper(void *params_)
-{
-	S_THREAD_PARAM_SVRLIGHT * params = (S_THREAD_PARAM_SVRLIGHT*) params_ ;
-
-	int32_t jj=0, j=0 ;
-
-	for(jj=params->start;(jj<params->end) && (j=params->active2dnum[jj])>=0;jj++)
-		params->lin[j]+=params->kernel->compute_optimized(CSVRLight::regression_fix_index2(params->docs[j], params->num_vectors));
-
-	return NULL ;
-}
-
 int32_t CSVRLight::regression_fix_index(int32_t i)
 {
 	if (i>=num_vectors)
@@ -402,7 +375,7 @@ void CSVRLight::update_linear_component(
      /* based on the change of the variables */
      /* in the current working set */
 {
-	int32_t i=0,ii=0,j=0,jj=0;
+	int32_t i=0,ii=0,jj=0;
 
 	if (kernel->has_property(KP_LINADD) && get_linadd_enabled())
 	{
@@ -425,56 +398,17 @@ void CSVRLight::update_linear_component(
 
 			if (num_working>0)
 			{
-			// TODO: port to use OpenMP backend instead of pthread
-#ifdef HAVE_PTHREAD
-				int32_t num_threads=env()->get_num_threads();
-#else
-				int32_t num_threads=1;
-#endif
-				if (num_threads < 2)
-				{
-					for(jj=0;(j=active2dnum[jj])>=0;jj++) {
-						lin[j]+=kernel->compute_optimized(regression_fix_index(docs[j]));
-					}
-				}
-#ifdef HAVE_PTHREAD
-				else
-				{
-					int32_t num_elem = 0 ;
-					for(jj=0;(j=active2dnum[jj])>=0;jj++) num_elem++ ;
-
-					pthread_t* threads = SG_MALLOC(pthread_t, num_threads-1);
-					S_THREAD_PARAM_SVRLIGHT* params = SG_MALLOC(S_THREAD_PARAM_SVRLIGHT, num_threads-1);
-					int32_t start = 0 ;
-					int32_t step = num_elem/num_threads ;
-					int32_t end = step ;
+				int32_t num_active=0;
+				while (active2dnum[num_active]>=0)
+					num_active++;
 
-					for (int32_t t=0; t<num_threads-1; t++)
+				parallel_for(0, num_active, [&](index_t start, index_t end) {
+					for (index_t k=start; k<end; k++)
 					{
-						params[t].kernel = kernel ;
-						params[t].lin = lin ;
-						params[t].docs = docs ;
-						params[t].active2dnum=active2dnum ;
-						params[t].start = start ;
-						params[t].end = end ;
-						params[t].num_vectors=num_vectors ;
-
-						start=end ;
-						end+=step ;
-						pthread_create(&threads[t], NULL, update_linear_component_linadd_helper, (void*)&params[t]) ;
+						int32_t idx=active2dnum[k];
+						lin[idx]+=kernel->compute_optimized(regression_fix_index(docs[idx]));
 					}
-
-					for(jj=params[num_threads-2].end;(j=active2dnum[jj])>=0;jj++) {
-						lin[j]+=kernel->compute_optimized(regression_fix_index(docs[j]));
-					}
-					void* ret;
-					for (int32_t t=0; t<num_threads-1; t++)
-						pthread_join(threads[t], &ret) ;
-
-					SG_FREE(params);
-					SG_FREE(threads);
-				}
-#endif
+				}, 256);
 			}
 		}
 	}
@@ -486,11 +420,15 @@ void CSVRLight::update_linear_component(
 					a, a_old, working2dnum, totdoc,	lin, aicache, c) ;
 		}
 		else {
+			int32_t num_active=0;
+			while (active2dnum[num_active]>=0)
+				num_active++;
+
 			for(jj=0;(i=working2dnum[jj])>=0;jj++) {
 				if(a[i] != a_old[i]) {
 					kernel->get_kernel_row(i,active2dnum,aicache);
-					for(ii=0;(j=active2dnum[ii])>=0;ii++)
-						lin[j]+=(a[i]-a_old[i])*aicache[j]*(float64_t)label[i];
+					update_lin(lin, aicache, active2dnum, num_active,
+							(a[i]-a_old[i])*(float64_t)label[i]);
 				}
 			}
 		}
@@ -676,7 +614,7 @@ void CSVRLight::reactivate_inactive_examples(
         shrinking. */
      /* Computes lin for those variables from scratch. */
 {
-  int32_t i=0,j,ii=0,jj,t,*changed2dnum,*inactive2dnum;
+  int32_t i=0,ii=0,t,*changed2dnum,*inactive2dnum;
   int32_t *changed,*inactive;
   float64_t *a_old,dist;
   float64_t ex_c,target;
@@ -696,12 +634,15 @@ void CSVRLight::reactivate_inactive_examples(
 
 	  if (num_modified>0)
 	  {
-		  for(i=0;i<totdoc;i++) {
-			  if(!shrink_state->active[i]) {
-				  lin[i]=shrink_state->last_lin[i]+kernel->compute_optimized(regression_fix_index(docs[i]));
+		  parallel_for(0, totdoc, [&](index_t start, index_t end) {
+			  for (index_t k=start; k<end; k++)
+			  {
+				  if(!shrink_state->active[k]) {
+					  lin[k]=shrink_state->last_lin[k]+kernel->compute_optimized(regression_fix_index(docs[k]));
+				  }
+				  shrink_state->last_lin[k]=lin[k];
 			  }
-			  shrink_state->last_lin[i]=lin[i];
-		  }
+		  }, 256);
 	  }
   }
   else
@@ -723,10 +664,14 @@ void CSVRLight::reactivate_inactive_examples(
 		  compute_index(inactive,totdoc,inactive2dnum);
 		  compute_index(changed,totdoc,changed2dnum);
 
+		  int32_t num_inactive=0;
+		  while (inactive2dnum[num_inactive]>=0)
+			  num_inactive++;
+
 		  for(ii=0;(i=changed2dnum[ii])>=0;ii++) {
 			  CKernelMachine::kernel->get_kernel_row(i,inactive2dnum,aicache);
-			  for(jj=0;(j=inactive2dnum[jj])>=0;jj++)
-				  lin[j]+=(a[i]-a_old[i])*aicache[j]*(float64_t)label[i];
+			  update_lin(lin, aicache, inactive2dnum, num_inactive,
+					  (a[i]-a_old[i])*(float64_t)label[i]);
 		  }
 	  }
 	  SG_FREE(changed);
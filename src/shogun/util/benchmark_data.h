@@ -0,0 +1,98 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#ifndef _BENCHMARK_DATA_H_
+#define _BENCHMARK_DATA_H_
+
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGVector.h>
+
+#include <random>
+
+namespace shogun
+{
+	/** Seed of all synthetic benchmark data, so that every run and every
+	 * release benchmarks the same problems.
+	 */
+	static constexpr uint64_t benchmark_seed = 42;
+
+	/** Standard normal dense data
+	 *
+	 * @param dim dimension of the vectors
+	 * @param num_vecs number of vectors
+	 * @return dim x num_vecs matrix
+	 */
+	inline SGMatrix<float64_t> benchmark_gaussian_data(index_t dim, index_t num_vecs)
+	{
+		std::mt19937_64 prng(benchmark_seed);
+		std::normal_distribution<float64_t> normal;
+
+		SGMatrix<float64_t> mat(dim, num_vecs);
+		for (int64_t i = 0; i < int64_t(dim) * num_vecs; ++i)
+			mat.matrix[i] = normal(prng);
+
+		return mat;
+	}
+
+	/** Gaussian blobs around random centers, one per class. The classes
+	 * overlap slightly, so that learners do not converge trivially.
+	 *
+	 * @param dim dimension of the vectors
+	 * @param num_vecs number of vectors
+	 * @param num_classes number of blobs
+	 * @param labels class of every vector, 0 to num_classes-1
+	 * @return dim x num_vecs matrix
+	 */
+	inline SGMatrix<float64_t> benchmark_blobs(
+	    index_t dim, index_t num_vecs, int32_t num_classes,
+	    SGVector<float64_t>& labels)
+	{
+		std::mt19937_64 prng(benchmark_seed);
+		std::normal_distribution<float64_t> normal;
+		std::uniform_real_distribution<float64_t> uniform(-3.0, 3.0);
+		std::uniform_int_distribution<int32_t> uniform_class(0, num_classes - 1);
+
+		SGMatrix<float64_t> centers(dim, num_classes);
+		for (int64_t i = 0; i < int64_t(dim) * num_classes; ++i)
+			centers.matrix[i] = uniform(prng);
+
+		SGMatrix<float64_t> mat(dim, num_vecs);
+		labels = SGVector<float64_t>(num_vecs);
+		for (index_t i = 0; i < num_vecs; ++i)
+		{
+			int32_t c = uniform_class(prng);
+			labels[i] = c;
+			for (index_t j = 0; j < dim; ++j)
+				mat(j, i) = centers(j, c) + normal(prng);
+		}
+
+		return mat;
+	}
+
+	/** Two Gaussian blobs with +1/-1 labels
+	 *
+	 * @param dim dimension of the vectors
+	 * @param num_vecs number of vectors
+	 * @param labels +1 or -1 for every vector
+	 * @return dim x num_vecs matrix
+	 */
+	inline SGMatrix<float64_t> benchmark_binary_blobs(
+	    index_t dim, index_t num_vecs, SGVector<float64_t>& labels)
+	{
+		SGMatrix<float64_t> mat = benchmark_blobs(dim, num_vecs, 2, labels);
+		for (index_t i = 0; i < num_vecs; ++i)
+			labels[i] = 2 * labels[i] - 1;
+
+		return mat;
+	}
+} // namespace shogun
+
+/** Sizes of the synthetic problems. Benchmarks are run at several scales,
+ * so that changes to the asymptotic behaviour show up as well as constant
+ * factors. Ranges are (number of vectors, dimension).
+ */
+#define BENCHMARK_SMALL_SCALE {{1 << 10, 1 << 12}, {16, 64}}
+#define BENCHMARK_LARGE_SCALE {{1 << 12, 1 << 16}, {16, 64}}
+
+#endif /* _BENCHMARK_DATA_H_ */
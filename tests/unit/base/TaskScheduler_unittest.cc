@@ -0,0 +1,164 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+#include <gtest/gtest.h>
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/base/TaskScheduler.h>
+#include <shogun/io/SGIO.h>
+#include <shogun/lib/exception/ShogunException.h>
+
+#include <atomic>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace shogun;
+
+TEST(TaskScheduler, task_group_runs_all_tasks)
+{
+	TaskScheduler scheduler(4);
+	EXPECT_EQ(scheduler.get_num_threads(), 4);
+	EXPECT_EQ(scheduler.get_num_workers(), 3);
+	EXPECT_FALSE(scheduler.is_worker());
+
+	std::atomic<int32_t> counter(0);
+	TaskGroup group(&scheduler);
+	for (int32_t i = 0; i < 1000; ++i)
+		group.run([&counter]() { counter++; });
+	group.wait();
+
+	EXPECT_EQ(counter, 1000);
+}
+
+TEST(TaskScheduler, single_thread_runs_inline)
+{
+	TaskScheduler scheduler(1);
+	EXPECT_EQ(scheduler.get_num_workers(), 0);
+
+	auto caller = std::this_thread::get_id();
+	bool same_thread = false;
+	TaskGroup group(&scheduler);
+	group.run([&]() { same_thread = std::this_thread::get_id() == caller; });
+	group.wait();
+
+	EXPECT_TRUE(same_thread);
+}
+
+TEST(TaskScheduler, nested_groups_stay_within_budget)
+{
+	const int32_t num_threads = 3;
+	TaskScheduler scheduler(num_threads);
+
+	std::mutex mutex;
+	std::set<std::thread::id> threads;
+	std::atomic<int32_t> counter(0);
+
+	TaskGroup outer(&scheduler);
+	for (int32_t i = 0; i < 8; ++i)
+	{
+		outer.run([&]() {
+			TaskGroup inner(&scheduler);
+			for (int32_t j = 0; j < 8; ++j)
+			{
+				inner.run([&]() {
+					{
+						std::lock_guard<std::mutex> lock(mutex);
+						threads.insert(std::this_thread::get_id());
+					}
+					counter++;
+				});
+			}
+			inner.wait();
+		});
+	}
+	outer.wait();
+
+	EXPECT_EQ(counter, 64);
+	EXPECT_LE(int32_t(threads.size()), num_threads);
+}
+
+TEST(TaskScheduler, exceptions_are_rethrown)
+{
+	TaskScheduler scheduler(2);
+	TaskGroup group(&scheduler);
+	for (int32_t i = 0; i < 10; ++i)
+	{
+		group.run([i]() {
+			if (i == 5)
+				throw std::runtime_error("task failed");
+		});
+	}
+	EXPECT_THROW(group.wait(), std::runtime_error);
+
+	// the group can be reused after a failure
+	std::atomic<int32_t> counter(0);
+	group.run([&counter]() { counter++; });
+	group.wait();
+	EXPECT_EQ(counter, 1);
+}
+
+TEST(TaskScheduler, parallel_for_covers_range)
+{
+	const index_t num = 10007;
+	std::vector<int32_t> visits(num, 0);
+
+	parallel_for(0, num, [&visits](index_t start, index_t end) {
+		for (index_t i = start; i < end; ++i)
+			visits[i]++;
+	});
+
+	for (index_t i = 0; i < num; ++i)
+		EXPECT_EQ(visits[i], 1);
+
+	// empty ranges do not call the body
+	bool called = false;
+	parallel_for(5, 5, [&called](index_t, index_t) { called = true; });
+	EXPECT_FALSE(called);
+}
+
+TEST(TaskScheduler, parallel_for_grain)
+{
+	std::atomic<int32_t> num_chunks(0);
+	std::atomic<bool> chunks_bounded(true);
+	parallel_for(
+	    0, 100,
+	    [&](index_t start, index_t end) {
+		    num_chunks++;
+		    if (end - start > 7)
+			    chunks_bounded = false;
+	    },
+	    7);
+
+	EXPECT_TRUE(chunks_bounded);
+	if (env()->get_num_threads() > 1)
+		EXPECT_GE(num_chunks, 100 / 7);
+}
+
+TEST(TaskScheduler, parallel_for_rethrows)
+{
+	EXPECT_THROW(
+	    parallel_for(
+	        0, 1000,
+	        [](index_t start, index_t end) {
+		        for (index_t i = start; i < end; ++i)
+		        {
+			        if (i == 500)
+				        error("index {}", i);
+		        }
+	        },
+	        10),
+	    ShogunException);
+}
+
+TEST(TaskScheduler, env_scheduler_follows_num_threads)
+{
+	int32_t num_threads = env()->get_num_threads();
+
+	env()->set_num_threads(3);
+	EXPECT_EQ(env()->get_task_scheduler()->get_num_threads(), 3);
+	env()->set_num_threads(1);
+	EXPECT_EQ(env()->get_task_scheduler()->get_num_threads(), 1);
+
+	env()->set_num_threads(num_threads);
+}
@@ -33,12 +33,15 @@
 */
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
 #include <rxcpp/rx-lite.hpp>
 #include <shogun/lib/Signal.h>
 
 #include "environments/LinearTestEnvironment.h"
 #include <shogun/base/some.h>
+#include <shogun/classifier/AveragedPerceptron.h>
 #include <shogun/classifier/Perceptron.h>
 #include <shogun/evaluation/ContingencyTableEvaluation.h>
 #include <shogun/features/DenseFeatures.h>
@@ -48,6 +51,42 @@ using namespace shogun;
 
 extern LinearTestEnvironment* linear_test_env;
 
+/* trains with float32 weights enabled, which the perceptrons update in place
+ * after set_w(), and applies to float32 features */
+void check_float32_weights(CLinearMachine* machine)
+{
+	auto env = linear_test_env->getBinaryLabelData();
+	auto features = wrap(env->get_features_train());
+	auto labels = wrap(env->get_labels_train());
+	auto test_features = wrap(env->get_features_test());
+
+	machine->set_float32_weights(true);
+	machine->set_labels(labels);
+	machine->train(features);
+	auto expected = wrap(machine->apply_binary(test_features));
+
+	SGMatrix<float64_t> data = test_features->get_feature_matrix();
+	SGMatrix<float32_t> data32(data.num_rows, data.num_cols);
+	for (index_t i = 0; i < data.num_rows * data.num_cols; i++)
+		data32.matrix[i] = data.matrix[i];
+	auto test_features32 = some<CDenseFeatures<float32_t>>(data32);
+
+	SGVector<float64_t> w = machine->get_w();
+	SGVector<float32_t> w32 = machine->get_w_float32();
+	ASSERT_EQ(w32.vlen, w.vlen);
+	for (index_t i = 0; i < w.vlen; i++)
+		EXPECT_EQ(w32[i], (float32_t)w[i]);
+
+	auto result = wrap(machine->apply_binary(test_features32));
+	ASSERT_EQ(result->get_num_labels(), expected->get_num_labels());
+	for (index_t i = 0; i < result->get_num_labels(); i++)
+	{
+		float64_t value = expected->get_value(i);
+		EXPECT_NEAR(
+		    result->get_value(i), value, 1e-5 * std::max(1.0, std::abs(value)));
+	}
+}
+
 TEST(Perceptron, train)
 {
 	auto env = linear_test_env->getBinaryLabelData();
@@ -89,3 +128,15 @@ TEST(Perceptron, custom_hyperplane_initialization)
 	EXPECT_TRUE(perceptron_initialized->get_w().equals(weights));
 }
 
+
+TEST(Perceptron, apply_float32_weights)
+{
+	auto perceptron = some<CPerceptron>();
+	check_float32_weights(perceptron);
+}
+
+TEST(AveragedPerceptron, apply_float32_weights)
+{
+	auto perceptron = some<CAveragedPerceptron>();
+	check_float32_weights(perceptron);
+}
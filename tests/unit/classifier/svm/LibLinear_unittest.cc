@@ -5,9 +5,13 @@
  */
 
 #include <gtest/gtest.h>
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/base/range.h>
+#include <shogun/base/some.h>
 #include <shogun/classifier/svm/LibLinear.h>
 #include <shogun/features/DataGenerator.h>
 #include <shogun/features/DenseFeatures.h>
+#include <shogun/features/SparseFeatures.h>
 #include <shogun/evaluation/ContingencyTableEvaluation.h>
 #include <shogun/mathematics/Math.h>
 
@@ -446,3 +450,152 @@ TEST_F(LibLinear, simple_set_train_L2R_LR_DUAL_BIAS)
 	// bias, not l1
 	train_with_solver_simple(liblinear_solver_type, true, false, t_w);
 }
+
+TEST_F(LibLinear, apply_float32_weights)
+{
+	generate_data_l2();
+
+	auto ll = some<CLibLinear>();
+	ll->set_bias_enabled(true);
+	ll->set_labels(ground_truth);
+	ll->set_liblinear_solver_type(L2R_L2LOSS_SVC_DUAL);
+	ll->train(train_feats);
+	auto expected = wrap(ll->apply_binary(test_feats));
+
+	SGMatrix<float64_t> data = test_feats->get_feature_matrix();
+	SGMatrix<float32_t> data32(data.num_rows, data.num_cols);
+	for (auto i : range(data.num_rows * data.num_cols))
+		data32.matrix[i] = data.matrix[i];
+	auto test_feats32 = some<CDenseFeatures<float32_t>>(data32);
+
+	EXPECT_EQ(ll->get_w_float32().vlen, 0);
+	ll->set_float32_weights(true);
+	SGVector<float64_t> w = ll->get_w();
+	SGVector<float32_t> w32 = ll->get_w_float32();
+	ASSERT_EQ(w32.vlen, w.vlen);
+	for (auto i : range(w.vlen))
+		EXPECT_EQ(w32[i], (float32_t)w[i]);
+
+	auto result = wrap(ll->apply_binary(test_feats32));
+	ASSERT_EQ(result->get_num_labels(), expected->get_num_labels());
+	for (auto i : range(result->get_num_labels()))
+	{
+		EXPECT_NEAR(result->get_value(i), expected->get_value(i), 1e-4);
+		EXPECT_NEAR(ll->apply_one(i), expected->get_value(i), 1e-4);
+	}
+}
+
+class LibLinearThreads : public ::testing::Test
+{
+protected:
+	void SetUp()
+	{
+		std::mt19937_64 prng(23);
+		std::normal_distribution<float64_t> normal;
+		std::bernoulli_distribution nonzero(0.3);
+
+		// sparse vectors, so that the asynchronous coordinate descent
+		// updates of different threads rarely touch the same weights
+		SGMatrix<float64_t> data(dim, num_vecs);
+		SGVector<float64_t> lab(num_vecs);
+		for (index_t i = 0; i < num_vecs; ++i)
+		{
+			lab[i] = i % 2 ? 1 : -1;
+			for (index_t j = 0; j < dim; ++j)
+			{
+				data(j, i) = 0;
+				if (nonzero(prng))
+					data(j, i) = normal(prng) + lab[i] * (j % 3 + 1) * 0.3;
+			}
+		}
+
+		features = new CDenseFeatures<float64_t>(data);
+		labels = new CBinaryLabels(lab);
+		SG_REF(features);
+		SG_REF(labels);
+		num_threads = env()->get_num_threads();
+	}
+
+	void TearDown()
+	{
+		env()->set_num_threads(num_threads);
+		SG_UNREF(features);
+		SG_UNREF(labels);
+	}
+
+	Some<CLibLinear> train(
+	    LIBLINEAR_SOLVER_TYPE st, int32_t threads, bool async,
+	    CDotFeatures* feats = NULL)
+	{
+		env()->set_num_threads(threads);
+		auto ll = some<CLibLinear>(st);
+		ll->set_bias_enabled(true);
+		ll->set_async_coordinate_descent(async);
+		ll->set_epsilon(1e-6);
+		ll->put("seed", 7);
+		ll->set_labels(labels);
+		ll->train(feats ? feats : features);
+		return ll;
+	}
+
+	const index_t dim = 10;
+	const index_t num_vecs = 20000;
+	int32_t num_threads;
+	CDenseFeatures<float64_t>* features;
+	CBinaryLabels* labels;
+};
+
+TEST_F(LibLinearThreads, tron_same_solution)
+{
+	for (auto st : {L2R_LR, L2R_L2LOSS_SVC})
+	{
+		auto serial = train(st, 1, false);
+		auto parallel = train(st, 4, false);
+
+		SGVector<float64_t> w = serial->get_w();
+		SGVector<float64_t> parallel_w = parallel->get_w();
+		for (auto i : range(dim))
+			EXPECT_NEAR(w[i], parallel_w[i], 1e-8);
+		EXPECT_NEAR(serial->get_bias(), parallel->get_bias(), 1e-8);
+	}
+}
+
+TEST_F(LibLinearThreads, async_coordinate_descent)
+{
+	for (auto st : {L2R_L2LOSS_SVC_DUAL, L2R_L1LOSS_SVC_DUAL, L2R_LR_DUAL})
+	{
+		auto serial = train(st, 1, false);
+		auto async = train(st, 4, true);
+
+		SGVector<float64_t> w = serial->get_w();
+		SGVector<float64_t> async_w = async->get_w();
+		for (auto i : range(dim))
+			EXPECT_NEAR(w[i], async_w[i], 1e-2);
+		EXPECT_NEAR(serial->get_bias(), async->get_bias(), 1e-2);
+
+		auto expected = wrap(serial->apply_binary(features));
+		auto result = wrap(async->apply_binary(features));
+		int32_t num_different = 0;
+		for (auto i : range(num_vecs))
+			num_different += expected->get_label(i) != result->get_label(i);
+		EXPECT_LE(num_different, num_vecs / 100);
+	}
+}
+
+TEST_F(LibLinearThreads, async_coordinate_descent_sparse)
+{
+	auto sparse = some<CSparseFeatures<float64_t>>(features);
+	auto csr = some<CSparseFeatures<float64_t>>(features);
+	csr->convert_to_csr();
+
+	auto serial = train(L2R_L2LOSS_SVC_DUAL, 1, false);
+	SGVector<float64_t> w = serial->get_w();
+	for (auto feats : {sparse.get(), csr.get()})
+	{
+		auto async = train(L2R_L2LOSS_SVC_DUAL, 4, true, feats);
+		SGVector<float64_t> async_w = async->get_w();
+		for (auto i : range(dim))
+			EXPECT_NEAR(w[i], async_w[i], 1e-2);
+		EXPECT_NEAR(serial->get_bias(), async->get_bias(), 1e-2);
+	}
+}
@@ -0,0 +1,127 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/base/some.h>
+#include <shogun/classifier/svm/LibSVM.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/labels/BinaryLabels.h>
+#include <shogun/mathematics/NormalDistribution.h>
+
+#include <random>
+
+using namespace shogun;
+
+class LibSVMTest : public ::testing::Test
+{
+protected:
+	void SetUp()
+	{
+		std::mt19937_64 prng(23);
+		NormalDistribution<float64_t> normal;
+
+		// overlapping classes, so that there are many free alphas. Every
+		// vector is there twice, half the data apart, so that the working
+		// set selection sees equal gradients in different blocks.
+		SGMatrix<float64_t> data(dim, num_vecs);
+		SGVector<float64_t> lab(num_vecs);
+		for (index_t i=0; i<num_vecs/2; ++i)
+		{
+			lab[i]=i%2 ? 1 : -1;
+			lab[i+num_vecs/2]=lab[i];
+			for (index_t j=0; j<dim; ++j)
+			{
+				data(j, i)=normal(prng)+0.7*lab[i];
+				data(j, i+num_vecs/2)=data(j, i);
+			}
+		}
+
+		features=new CDenseFeatures<float64_t>(data);
+		labels=new CBinaryLabels(lab);
+		SG_REF(features);
+		SG_REF(labels);
+		num_threads=env()->get_num_threads();
+	}
+
+	void TearDown()
+	{
+		env()->set_num_threads(num_threads);
+		SG_UNREF(features);
+		SG_UNREF(labels);
+	}
+
+	Some<CLibSVM> train(
+		bool float32_cache, int32_t threads,
+		int32_t parallel_grain=LIBSVM_PARALLEL_GRAIN)
+	{
+		env()->set_num_threads(threads);
+		auto kernel=some<CGaussianKernel>(features, features, 2.0);
+		kernel->set_float32_row_cache(float32_cache);
+
+		auto svm=some<CLibSVM>(1.0, kernel, labels);
+		svm->set_parallel_grain(parallel_grain);
+		svm->train();
+		return svm;
+	}
+
+	void expect_same_solution(CLibSVM* serial, CLibSVM* parallel)
+	{
+		SGVector<float64_t> alphas=serial->get_alphas();
+		SGVector<float64_t> parallel_alphas=parallel->get_alphas();
+		ASSERT_EQ(alphas.vlen, parallel_alphas.vlen);
+		EXPECT_EQ(serial->get_bias(), parallel->get_bias());
+		for (index_t i=0; i<alphas.vlen; ++i)
+		{
+			EXPECT_EQ(serial->get_support_vector(i), parallel->get_support_vector(i));
+			EXPECT_EQ(alphas[i], parallel_alphas[i]);
+		}
+	}
+
+	const index_t dim=3;
+	const index_t num_vecs=600;
+	int32_t num_threads;
+	CDenseFeatures<float64_t>* features;
+	CBinaryLabels* labels;
+};
+
+TEST_F(LibSVMTest, threads_give_same_solution)
+{
+	for (auto float32_cache : {false, true})
+	{
+		auto serial=train(float32_cache, 1);
+		auto parallel=train(float32_cache, 4);
+		expect_same_solution(serial, parallel);
+	}
+}
+
+TEST_F(LibSVMTest, parallel_blocks_give_same_solution)
+{
+	// blocks of 16 examples, so that the working set selection and the
+	// gradient updates are split over many parallel tasks
+	auto serial=train(false, 1);
+	for (auto threads : {1, 4})
+	{
+		auto parallel=train(false, threads, 16);
+		expect_same_solution(serial, parallel);
+	}
+}
+
+TEST_F(LibSVMTest, float32_cache)
+{
+	auto svm64=train(false, 4);
+	auto svm32=train(true, 4);
+
+	auto out64=svm64->apply_binary(features);
+	auto out32=svm32->apply_binary(features);
+	SGVector<float64_t> values64=out64->get_values();
+	SGVector<float64_t> values32=out32->get_values();
+	for (index_t i=0; i<num_vecs; ++i)
+		EXPECT_NEAR(values64[i], values32[i], 1e-3);
+
+	SG_UNREF(out64);
+	SG_UNREF(out32);
+}
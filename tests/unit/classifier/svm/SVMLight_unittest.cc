@@ -0,0 +1,108 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/lib/config.h>
+
+#ifdef USE_SVMLIGHT
+#include <gtest/gtest.h>
+
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/base/some.h>
+#include <shogun/classifier/svm/SVMLight.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/LinearKernel.h>
+#include <shogun/labels/BinaryLabels.h>
+#include <shogun/mathematics/NormalDistribution.h>
+
+#include <random>
+
+using namespace shogun;
+
+class SVMLightTest : public ::testing::Test
+{
+protected:
+	void SetUp()
+	{
+		std::mt19937_64 prng(31);
+		NormalDistribution<float64_t> normal;
+
+		// overlapping classes, so that many alphas stay at the bound and
+		// get shrunk away, and enough vectors that the linear component
+		// updates are split over several parallel blocks
+		SGMatrix<float64_t> data(dim, num_vecs);
+		SGVector<float64_t> lab(num_vecs);
+		for (index_t i=0; i<num_vecs; ++i)
+		{
+			lab[i]=i%2 ? 1 : -1;
+			for (index_t j=0; j<dim; ++j)
+				data(j, i)=normal(prng)+0.5*lab[i];
+		}
+
+		features=new CDenseFeatures<float64_t>(data);
+		labels=new CBinaryLabels(lab);
+		SG_REF(features);
+		SG_REF(labels);
+		num_threads=env()->get_num_threads();
+	}
+
+	void TearDown()
+	{
+		env()->set_num_threads(num_threads);
+		SG_UNREF(features);
+		SG_UNREF(labels);
+	}
+
+	Some<CSVMLight> train(CKernel* kernel, bool linadd, int32_t threads)
+	{
+		env()->set_num_threads(threads);
+		kernel->init(features, features);
+
+		auto svm=some<CSVMLight>(1.0, kernel, labels);
+		svm->set_linadd_enabled(linadd);
+		svm->set_shrinking_enabled(true);
+		svm->train();
+		return svm;
+	}
+
+	void expect_same_solution(CSVMLight* serial, CSVMLight* parallel)
+	{
+		SGVector<float64_t> alphas=serial->get_alphas();
+		SGVector<float64_t> parallel_alphas=parallel->get_alphas();
+		ASSERT_GT(alphas.vlen, 0);
+		ASSERT_EQ(alphas.vlen, parallel_alphas.vlen);
+		EXPECT_EQ(serial->get_bias(), parallel->get_bias());
+		for (index_t i=0; i<alphas.vlen; ++i)
+		{
+			EXPECT_EQ(serial->get_support_vector(i), parallel->get_support_vector(i));
+			EXPECT_EQ(alphas[i], parallel_alphas[i]);
+		}
+	}
+
+	const index_t dim=3;
+	const index_t num_vecs=5000;
+	int32_t num_threads;
+	CDenseFeatures<float64_t>* features;
+	CBinaryLabels* labels;
+};
+
+TEST_F(SVMLightTest, linadd_threads_give_same_solution)
+{
+	auto serial=train(some<CLinearKernel>(), true, 1);
+	auto parallel=train(some<CLinearKernel>(), true, 4);
+	expect_same_solution(serial, parallel);
+}
+
+TEST_F(SVMLightTest, kernel_cache_threads_give_same_solution)
+{
+	// the linear kernel without linadd goes through the kernel cache
+	auto serial=train(some<CLinearKernel>(), false, 1);
+	auto parallel=train(some<CLinearKernel>(), false, 4);
+	expect_same_solution(serial, parallel);
+
+	serial=train(some<CGaussianKernel>(2.0), false, 1);
+	parallel=train(some<CGaussianKernel>(2.0), false, 4);
+	expect_same_solution(serial, parallel);
+}
+#endif //USE_SVMLIGHT
@@ -9,10 +9,14 @@
 #include <shogun/clustering/KMeans.h>
 #include <shogun/clustering/KMeansMiniBatch.h>
 #include <shogun/distance/EuclideanDistance.h>
+#include <shogun/distance/ManhattanMetric.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/labels/MulticlassLabels.h>
 #include <shogun/lib/observers/ParameterObserver.h>
 #include <shogun/lib/observers/ParameterObserverLogger.h>
+#include <shogun/lib/exception/ShogunException.h>
+
+#include <random>
 
 using namespace shogun;
 
@@ -285,3 +289,88 @@ TEST(KMeans, random_centers_assign)
 	SG_UNREF(features);
 }
 
+
+TEST(KMeans, accelerated_methods_match_lloyd)
+{
+	const int32_t num_clusters=6;
+	const int32_t num_points=600;
+	const int32_t dim=4;
+
+	/* blobs around random centers */
+	std::mt19937_64 prng(17);
+	std::normal_distribution<float64_t> normal;
+	SGMatrix<float64_t> blob_centers(dim, num_clusters);
+	for (int32_t j=0; j<num_clusters; j++)
+	{
+		for (int32_t d=0; d<dim; d++)
+			blob_centers(d, j)=10*normal(prng);
+	}
+
+	SGMatrix<float64_t> data(dim, num_points);
+	for (int32_t i=0; i<num_points; i++)
+	{
+		for (int32_t d=0; d<dim; d++)
+			data(d, i)=blob_centers(d, i%num_clusters)+2*normal(prng);
+	}
+
+	/* the first points as initial centers, two of them in the same blob */
+	SGMatrix<float64_t> initial_centers(dim, num_clusters);
+	for (int32_t j=0; j<num_clusters; j++)
+	{
+		for (int32_t d=0; d<dim; d++)
+			initial_centers(d, j)=data(d, j==1 ? num_clusters : j);
+	}
+
+	auto features=some<CDenseFeatures<float64_t>>(data);
+	EKMeansMethod methods[]={KMM_LLOYD, KMM_ELKAN, KMM_HAMERLY};
+	SGMatrix<float64_t> centers[3];
+	SGVector<float64_t> labels[3];
+
+	for (int32_t m=0; m<3; m++)
+	{
+		auto distance=some<CEuclideanDistance>(features, features);
+		auto clustering=some<CKMeans>(
+			num_clusters, distance, initial_centers.clone());
+		clustering->set_method(methods[m]);
+		EXPECT_EQ(clustering->get_method(), methods[m]);
+
+		clustering->train(features);
+		centers[m]=clustering->get_cluster_centers();
+
+		auto result=clustering->apply_multiclass(features);
+		labels[m]=result->get_labels();
+		SG_UNREF(result);
+	}
+
+	for (int32_t m=1; m<3; m++)
+	{
+		for (int32_t i=0; i<num_points; i++)
+			EXPECT_EQ(labels[0][i], labels[m][i]);
+
+		for (int32_t j=0; j<num_clusters; j++)
+		{
+			for (int32_t d=0; d<dim; d++)
+				EXPECT_NEAR(centers[0](d, j), centers[m](d, j), 1E-10);
+		}
+	}
+}
+
+TEST(KMeans, accelerated_methods_require_euclidean)
+{
+	SGMatrix<float64_t> rect(2, 4);
+	rect(0,0)=0;
+	rect(1,0)=0;
+	rect(0,1)=0;
+	rect(1,1)=10;
+	rect(0,2)=20;
+	rect(1,2)=0;
+	rect(0,3)=20;
+	rect(1,3)=10;
+
+	auto features=some<CDenseFeatures<float64_t>>(rect);
+	auto distance=some<CManhattanMetric>(features, features);
+	auto clustering=some<CKMeans>(2, distance);
+	clustering->set_method(KMM_ELKAN);
+
+	EXPECT_THROW(clustering->train(features), ShogunException);
+}
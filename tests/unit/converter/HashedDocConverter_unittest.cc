@@ -169,3 +169,83 @@ TEST(HashedDocConverterTest, apply_quadratic_test)
 	SG_FREE(hashes);
 	SG_UNREF(converter);
 }
+
+TEST(HashedDocConverterTest, apply_unigrams_with_skips)
+{
+	const char* doc_1 = "Shogun";
+	const char* grams[] = {"Sho", "hog", "ogu", "gun"};
+
+	const int32_t seed = 0xdeadbeaf;
+	int32_t dimension = 32;
+	int32_t hash_bits = 5;
+
+	// skips have no effect on unigrams, every token is counted once
+	SGVector<float64_t> vec(dimension);
+	SGVector<float64_t>::fill_vector(vec.vector, vec.vlen, 0);
+	for (index_t i=0; i<4; i++)
+		vec[CHash::MurmurHash3((uint8_t* ) &grams[i][0], 3, seed) % dimension]++;
+
+	CNGramTokenizer* tzer = new CNGramTokenizer(3);
+	CHashedDocConverter* converter = new CHashedDocConverter(tzer, hash_bits, false, 1, 2);
+
+	SGVector<char> doc(const_cast<char* >(doc_1), 6, false);
+
+	SGSparseVector<float64_t> c_doc = converter->apply(doc);
+
+	float64_t num_indices = 0;
+	for (index_t i=0; i<c_doc.num_feat_entries; i++)
+	{
+		EXPECT_EQ(c_doc.features[i].entry,
+					vec[c_doc.features[i].feat_index]);
+		num_indices += c_doc.features[i].entry;
+	}
+	EXPECT_EQ(num_indices, 4);
+
+	SG_UNREF(converter);
+}
+
+TEST(HashedDocConverterTest, apply_short_document)
+{
+	const char* doc_1 = "Shogun";
+	const char* grams[] = {"Sho", "hog", "ogu", "gun"};
+	uint32_t hashes[4];
+
+	const int32_t seed = 0xdeadbeaf;
+	for (index_t i=0; i<4; i++)
+		hashes[i] = CHash::MurmurHash3((uint8_t* ) &grams[i][0], 3, seed);
+
+	int32_t dimension = 32;
+	int32_t hash_bits = 5;
+
+	// the ngrams are limited by the number of tokens of the document
+	SGVector<float64_t> vec(dimension);
+	SGVector<float64_t>::fill_vector(vec.vector, vec.vlen, 0);
+	for (index_t i=0; i<4; i++)
+	{
+		uint32_t val = hashes[i];
+		vec[val % dimension]++;
+		for (index_t j=i+1; j<4; j++)
+		{
+			val = val ^ hashes[j];
+			vec[val % dimension]++;
+		}
+	}
+
+	CNGramTokenizer* tzer = new CNGramTokenizer(3);
+	CHashedDocConverter* converter = new CHashedDocConverter(tzer, hash_bits, false, 6, 0);
+
+	SGVector<char> doc(const_cast<char* >(doc_1), 6, false);
+
+	SGSparseVector<float64_t> c_doc = converter->apply(doc);
+
+	float64_t num_indices = 0;
+	for (index_t i=0; i<c_doc.num_feat_entries; i++)
+	{
+		EXPECT_EQ(c_doc.features[i].entry,
+					vec[c_doc.features[i].feat_index]);
+		num_indices += c_doc.features[i].entry;
+	}
+	EXPECT_EQ(num_indices, 10);
+
+	SG_UNREF(converter);
+}
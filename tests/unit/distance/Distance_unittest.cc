@@ -6,12 +6,48 @@
 
 #include <gtest/gtest.h>
 
+#include <shogun/distance/ChebyshewMetric.h>
+#include <shogun/distance/CosineDistance.h>
 #include <shogun/distance/CustomMahalanobisDistance.h>
+#include <shogun/distance/EuclideanDistance.h>
+#include <shogun/distance/ManhattanMetric.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/lib/SGMatrix.h>
+#include <shogun/mathematics/NormalDistribution.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
+#include <shogun/preprocessor/NormOne.h>
+
+#include <random>
 
 using namespace shogun;
 
+template <typename PRNG>
+static SGMatrix<float64_t>
+generate_std_norm_matrix(const index_t num_feats, const index_t dim, PRNG& prng)
+{
+	SGMatrix<float64_t> data(dim, num_feats);
+	NormalDistribution<float64_t> normal_dist;
+	for (index_t i=0; i<num_feats; ++i)
+	{
+		for (index_t j=0; j<dim; ++j)
+			data(j, i)=normal_dist(prng);
+	}
+	return data;
+}
+
+static void check_blocked_distance_matrix(CDistance* distance)
+{
+	SGMatrix<float64_t> dm=distance->get_distance_matrix();
+	ASSERT_EQ(dm.num_rows, distance->get_num_vec_lhs());
+	ASSERT_EQ(dm.num_cols, distance->get_num_vec_rhs());
+
+	for (index_t i=0; i<dm.num_rows; ++i)
+	{
+		for (index_t j=0; j<dm.num_cols; ++j)
+			EXPECT_NEAR(dm(i, j), distance->distance(i, j), 1E-12);
+	}
+}
+
 TEST(Distance, custom_mahalanobis)
 {
 	// Create a couple of simple 2D features
@@ -37,3 +73,150 @@ TEST(Distance, custom_mahalanobis)
 
 	SG_UNREF(distance)
 }
+
+TEST(Distance, blocked_distance_matrix)
+{
+	const index_t num_feats_p=300;
+	const index_t num_feats_q=270;
+	const index_t dim=5;
+	int32_t seed=100;
+	std::mt19937_64 prng(seed);
+
+	SGMatrix<float64_t> data_p=generate_std_norm_matrix(num_feats_p, dim, prng);
+	SGMatrix<float64_t> data_q=generate_std_norm_matrix(num_feats_q, dim, prng);
+	CDenseFeatures<float64_t>* feats_p=new CDenseFeatures<float64_t>(data_p);
+	CDenseFeatures<float64_t>* feats_q=new CDenseFeatures<float64_t>(data_q);
+	SG_REF(feats_p);
+	SG_REF(feats_q);
+
+	CDistance* distances[]={
+		new CEuclideanDistance(), new CCosineDistance(),
+		new CManhattanMetric(), new CChebyshewMetric()};
+
+	for (auto distance : distances)
+	{
+		SG_REF(distance);
+
+		distance->init(feats_p, feats_q);
+		check_blocked_distance_matrix(distance);
+
+		// symmetric case
+		distance->init(feats_p, feats_p);
+		check_blocked_distance_matrix(distance);
+
+		SG_UNREF(distance);
+	}
+
+	CEuclideanDistance* euclidean=new CEuclideanDistance(feats_p, feats_q);
+	euclidean->set_disable_sqrt(true);
+	check_blocked_distance_matrix(euclidean);
+	SG_UNREF(euclidean);
+
+	SG_UNREF(feats_p);
+	SG_UNREF(feats_q);
+}
+
+/* features that normalize the vectors of data on the fly, and features of
+ * the normalized vectors */
+static void create_normalized_features(SGMatrix<float64_t> data,
+	CDenseFeatures<float64_t>*& feats, CDenseFeatures<float64_t>*& expected_feats)
+{
+	SGMatrix<float64_t> normalized=data.clone();
+	for (index_t i=0; i<data.num_cols; i++)
+	{
+		SGVector<float64_t> x=normalized.get_column(i);
+		linalg::scale(x, x, 1.0/linalg::norm(x));
+		normalized.set_column(i, x);
+	}
+
+	feats=new CDenseFeatures<float64_t>(data);
+	CNormOne* preproc=new CNormOne();
+	preproc->fit(feats);
+	feats->add_preprocessor(preproc);
+	expected_feats=new CDenseFeatures<float64_t>(normalized);
+	SG_REF(feats);
+	SG_REF(expected_feats);
+}
+
+TEST(Distance, blocked_distance_matrix_unapplied_preprocessor)
+{
+	const index_t num_feats_p=300;
+	const index_t num_feats_q=270;
+	const index_t dim=4;
+	int32_t seed=100;
+	std::mt19937_64 prng(seed);
+
+	// the preprocessors are applied on the fly by get_feature_vector()
+	CDenseFeatures<float64_t>* feats_p;
+	CDenseFeatures<float64_t>* feats_q;
+	CDenseFeatures<float64_t>* expected_p;
+	CDenseFeatures<float64_t>* expected_q;
+	create_normalized_features(
+		generate_std_norm_matrix(num_feats_p, dim, prng), feats_p, expected_p);
+	create_normalized_features(
+		generate_std_norm_matrix(num_feats_q, dim, prng), feats_q, expected_q);
+
+	CDistance* distances[]={
+		new CEuclideanDistance(), new CCosineDistance(),
+		new CManhattanMetric(), new CChebyshewMetric()};
+
+	for (auto distance : distances)
+	{
+		SG_REF(distance);
+
+		distance->init(expected_p, expected_q);
+		SGMatrix<float64_t> expected=distance->get_distance_matrix();
+
+		distance->init(feats_p, feats_q);
+		check_blocked_distance_matrix(distance);
+		SGMatrix<float64_t> dm=distance->get_distance_matrix();
+		for (index_t i=0; i<num_feats_p*num_feats_q; ++i)
+			EXPECT_NEAR(dm[i], expected[i], 1E-12);
+
+		SG_UNREF(distance);
+	}
+
+	SG_UNREF(feats_p);
+	SG_UNREF(feats_q);
+	SG_UNREF(expected_p);
+	SG_UNREF(expected_q);
+}
+
+TEST(Distance, get_distance_block)
+{
+	const index_t num_feats=200;
+	const index_t dim=4;
+	int32_t seed=100;
+	std::mt19937_64 prng(seed);
+
+	SGMatrix<float64_t> data=generate_std_norm_matrix(num_feats, dim, prng);
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+	CEuclideanDistance* distance=new CEuclideanDistance(feats, feats);
+
+	SGMatrix<float64_t> block=distance->get_distance_block(10, 47, 150, 200);
+	ASSERT_EQ(block.num_rows, 37);
+	ASSERT_EQ(block.num_cols, 50);
+	for (index_t i=0; i<block.num_rows; ++i)
+	{
+		for (index_t j=0; j<block.num_cols; ++j)
+			EXPECT_NEAR(block(i, j), distance->distance(10+i, 150+j), 1E-12);
+	}
+
+	// with a subset the features can not be used directly, the block is
+	// computed entry by entry
+	SGVector<index_t> subset(num_feats/2);
+	for (index_t i=0; i<subset.vlen; ++i)
+		subset[i]=2*i;
+	feats->add_subset(subset);
+	distance->init(feats, feats);
+
+	block=distance->get_distance_block(0, 20, 5, 25);
+	for (index_t i=0; i<block.num_rows; ++i)
+	{
+		for (index_t j=0; j<block.num_cols; ++j)
+			EXPECT_NEAR(block(i, j), distance->distance(i, 5+j), 1E-12);
+	}
+	check_blocked_distance_matrix(distance);
+
+	SG_UNREF(distance);
+}
@@ -14,6 +14,7 @@
 #include <shogun/mathematics/UniformIntDistribution.h>
 #include <shogun/mathematics/NormalDistribution.h>
 #include <shogun/lib/View.h>
+#include <shogun/lib/exception/ShogunException.h>
 
 #include <random>
 
@@ -303,3 +304,85 @@ TEST(DenseFeaturesTest, view)
 			    feature_matrix_subset2(i, j), data(i, subset1[subset2[j]]));
 	}
 }
+
+TEST(DenseFeaturesTest, dot_range)
+{
+	const index_t dim = 5;
+	const index_t num_vectors = 40;
+	std::mt19937_64 prng(23);
+	std::normal_distribution<float32_t> normal;
+
+	SGMatrix<float32_t> data(dim, num_vectors);
+	for (auto i : range(dim * num_vectors))
+		data.matrix[i] = normal(prng);
+	SGVector<float32_t> w(dim);
+	for (auto i : range(dim))
+		w[i] = normal(prng);
+	auto feats = some<CDenseFeatures<float32_t>>(data);
+
+	auto expected_dot = [&](index_t i) {
+		float64_t result = 0.5;
+		for (auto j : range(dim))
+			result += (float64_t)data(j, i) * w[j];
+		return result;
+	};
+
+	SGVector<float32_t> dots = feats->dot_range(3, 31, w, 0.5);
+	ASSERT_EQ(dots.vlen, 28);
+	for (auto i : range(dots.vlen))
+		EXPECT_NEAR(dots[i], expected_dot(i + 3), 1e-5);
+
+	SGVector<index_t> subset{7, 0, 39, 12};
+	feats->add_subset(subset);
+	dots = feats->dot_range(0, subset.vlen, w, 0.5);
+	ASSERT_EQ(dots.vlen, subset.vlen);
+	for (auto i : range(subset.vlen))
+		EXPECT_NEAR(dots[i], expected_dot(subset[i]), 1e-5);
+
+	EXPECT_EQ(feats->dot_range(2, 2, w).vlen, 0);
+	EXPECT_THROW(feats->dot_range(0, 5, w), ShogunException);
+}
+
+TEST(DenseFeaturesTest, dense_dot_range)
+{
+	const index_t dim = 6;
+	const index_t num_vectors = 700;
+	std::mt19937_64 prng(29);
+	std::uniform_int_distribution<int32_t> uniform(-10, 10);
+
+	SGMatrix<int32_t> data(dim, num_vectors);
+	SGMatrix<float64_t> data64(dim, num_vectors);
+	for (auto i : range(dim * num_vectors))
+		data64.matrix[i] = data.matrix[i] = uniform(prng);
+	SGVector<float64_t> w(dim);
+	for (auto i : range(dim))
+		w[i] = uniform(prng) / 4.0;
+	SGVector<float64_t> alphas(num_vectors);
+	for (auto i : range(num_vectors))
+		alphas[i] = i % 5 - 2;
+
+	auto feats = some<CDenseFeatures<int32_t>>(data);
+	auto feats64 = some<CDenseFeatures<float64_t>>(data64);
+
+	const int32_t start = 11;
+	const int32_t stop = 650;
+	SGVector<float64_t> output(stop - start);
+	SGVector<float64_t> output64(stop - start);
+	feats->dense_dot_range(
+	    output.vector, start, stop, alphas.vector, w.vector, dim, 0.5);
+	feats64->dense_dot_range(
+	    output64.vector, start, stop, alphas.vector, w.vector, dim, 0.5);
+	for (auto i : range(output.vlen))
+	{
+		const float64_t expected =
+		    alphas[i] * feats64->dot(i + start, w) + 0.5;
+		EXPECT_NEAR(output[i], expected, 1e-10);
+		EXPECT_NEAR(output64[i], expected, 1e-10);
+	}
+
+	SGVector<index_t> subset{5, 600, 3};
+	feats->add_subset(subset);
+	feats->dense_dot_range(output.vector, 0, 3, NULL, w.vector, dim, 0);
+	for (auto i : range(subset.vlen))
+		EXPECT_NEAR(output[i], feats64->dot(subset[i], w), 1e-10);
+}
@@ -0,0 +1,214 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/base/some.h>
+#include <shogun/classifier/svm/LibLinear.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/features/DiskDotFeatures.h>
+#include <shogun/io/DatasetFile.h>
+#include <shogun/labels/BinaryLabels.h>
+#include <shogun/labels/RegressionLabels.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
+#include <shogun/regression/LinearRidgeRegression.h>
+#include "../utils/Utils.h"
+
+#include <cstdio>
+#include <random>
+
+using namespace shogun;
+
+class DiskDotFeaturesTest : public ::testing::Test
+{
+protected:
+	void SetUp()
+	{
+		std::mt19937_64 prng(17);
+		std::normal_distribution<float64_t> normal;
+
+		data=SGMatrix<float64_t>(dim, num_vecs);
+		for (int64_t i=0; i<int64_t(dim)*num_vecs; ++i)
+			data.matrix[i]=normal(prng);
+
+		w=SGVector<float64_t>(dim);
+		for (index_t i=0; i<dim; ++i)
+			w[i]=normal(prng);
+
+		labels=SGVector<float64_t>(num_vecs);
+		for (index_t i=0; i<num_vecs; ++i)
+			labels[i]=linalg::dot(SGVector<float64_t>(data.get_column_vector(i), dim, false), w)+0.1*normal(prng)+2;
+
+		generate_temp_filename(fname);
+		auto out=some<CDatasetFile>(fname, 'w', UNCOMPRESSED, 32);
+		out->write_dense(data, labels);
+	}
+
+	void TearDown()
+	{
+		std::remove(fname);
+	}
+
+	const index_t dim=6;
+	const index_t num_vecs=300;
+	char fname[32]="DiskDotFeatures.XXXXXX";
+	SGMatrix<float64_t> data;
+	SGVector<float64_t> w;
+	SGVector<float64_t> labels;
+};
+
+TEST_F(DiskDotFeaturesTest, dot)
+{
+	auto feats=some<CDiskDotFeatures>(fname);
+	auto dense=some<CDenseFeatures<float64_t>>(data);
+	EXPECT_EQ(num_vecs, feats->get_num_vectors());
+	EXPECT_EQ(dim, feats->get_dim_feature_space());
+	EXPECT_EQ(10, feats->get_num_blocks());
+
+	// backwards, so that every block misses the cache and the prefetch
+	for (index_t i=num_vecs-1; i>=0; --i)
+	{
+		EXPECT_NEAR(dense->dot(i, w), feats->dot(i, w), 1e-12);
+		EXPECT_NEAR(dense->dot(i, dense, num_vecs-1-i), feats->dot(i, dense, num_vecs-1-i), 1e-12);
+	}
+
+	SGVector<float64_t> sum(dim);
+	SGVector<float64_t> expected(dim);
+	sum.zero();
+	expected.zero();
+	for (index_t i=0; i<num_vecs; ++i)
+	{
+		feats->add_to_dense_vec(0.5, i, sum.vector, dim, true);
+		dense->add_to_dense_vec(0.5, i, expected.vector, dim, true);
+	}
+	for (index_t j=0; j<dim; ++j)
+		EXPECT_NEAR(expected[j], sum[j], 1e-9);
+
+	int32_t index;
+	float64_t value;
+	void* it=feats->get_feature_iterator(42);
+	for (index_t j=0; j<dim; ++j)
+	{
+		ASSERT_TRUE(feats->get_next_feature(index, value, it));
+		EXPECT_EQ(j, index);
+		EXPECT_EQ(data(j, 42), value);
+	}
+	EXPECT_FALSE(feats->get_next_feature(index, value, it));
+	feats->free_feature_iterator(it);
+}
+
+TEST_F(DiskDotFeaturesTest, dense_dot_range)
+{
+	auto feats=some<CDiskDotFeatures>(fname, 1);
+	auto dense=some<CDenseFeatures<float64_t>>(data);
+
+	SGVector<float64_t> alphas(num_vecs);
+	for (index_t i=0; i<num_vecs; ++i)
+		alphas[i]=i%7-3;
+
+	// a range starting and ending within blocks
+	const int32_t start=17;
+	const int32_t stop=250;
+	SGVector<float64_t> output(stop-start);
+	SGVector<float64_t> expected(stop-start);
+	feats->dense_dot_range(output.vector, start, stop, alphas.vector, w.vector, dim, 0.5);
+	dense->dense_dot_range(expected.vector, start, stop, alphas.vector, w.vector, dim, 0.5);
+	for (index_t i=0; i<output.vlen; ++i)
+		EXPECT_NEAR(expected[i], output[i], 1e-12);
+
+	SGVector<index_t> subset(50);
+	for (index_t i=0; i<subset.vlen; ++i)
+		subset[i]=(i*37)%num_vecs;
+	feats->add_subset(subset);
+	dense->add_subset(subset);
+	feats->dense_dot_range(output.vector, 0, subset.vlen, NULL, w.vector, dim, 0);
+	dense->dense_dot_range(expected.vector, 0, subset.vlen, NULL, w.vector, dim, 0);
+	for (index_t i=0; i<subset.vlen; ++i)
+		EXPECT_NEAR(expected[i], output[i], 1e-12);
+}
+
+TEST_F(DiskDotFeaturesTest, float32)
+{
+	char fname32[]="DiskDotFeatures32.XXXXXX";
+	generate_temp_filename(fname32);
+
+	SGMatrix<float32_t> data32(dim, num_vecs);
+	for (int64_t i=0; i<int64_t(dim)*num_vecs; ++i)
+		data32.matrix[i]=data.matrix[i];
+	{
+		auto out=some<CDatasetFile>(fname32, 'w', UNCOMPRESSED, 100);
+		out->write_dense(data32);
+	}
+
+	auto feats=some<CDiskDotFeatures>(fname32);
+	EXPECT_EQ(3, feats->get_num_blocks());
+	for (index_t i=0; i<num_vecs; ++i)
+	{
+		SGVector<float64_t> vec=feats->get_feature_vector(i);
+		for (index_t j=0; j<dim; ++j)
+			EXPECT_EQ(data32(j, i), vec[j]);
+	}
+
+	std::remove(fname32);
+}
+
+TEST_F(DiskDotFeaturesTest, linear_ridge_regression)
+{
+	auto feats=some<CDiskDotFeatures>(fname);
+	auto dense=some<CDenseFeatures<float64_t>>(data);
+	CDatasetFile* file=feats->get_dataset_file();
+	auto lab=some<CRegressionLabels>(file->get_labels());
+	SG_UNREF(file);
+
+	auto model=some<CLinearRidgeRegression>();
+	model->set_tau(0.1);
+	model->set_labels(lab);
+	model->train(feats);
+
+	auto expected=some<CLinearRidgeRegression>();
+	expected->set_tau(0.1);
+	expected->set_labels(lab);
+	expected->train(dense);
+
+	SGVector<float64_t> model_w=model->get_w();
+	SGVector<float64_t> expected_w=expected->get_w();
+	for (index_t j=0; j<dim; ++j)
+		EXPECT_NEAR(expected_w[j], model_w[j], 1e-9);
+	EXPECT_NEAR(expected->get_bias(), model->get_bias(), 1e-9);
+}
+
+TEST_F(DiskDotFeaturesTest, liblinear)
+{
+	auto feats=some<CDiskDotFeatures>(fname);
+	auto dense=some<CDenseFeatures<float64_t>>(data);
+	for (int32_t block=0; block<feats->get_num_blocks(); ++block)
+	{
+		index_t end=block+1<feats->get_num_blocks() ?
+			feats->get_block_start(block+1) : num_vecs;
+		for (index_t i=feats->get_block_start(block); i<end; ++i)
+			EXPECT_EQ(block, feats->get_vector_block(i));
+	}
+	EXPECT_EQ(-1, dense->get_vector_block(0));
+
+	auto lab=some<CBinaryLabels>(num_vecs);
+	for (index_t i=0; i<num_vecs; ++i)
+		lab->set_label(i, labels[i]>2 ? 1 : -1);
+
+	// the blocks are visited in another order than the dense vectors, but
+	// both converge to the same solution
+	auto model=some<CLibLinear>(L2R_L2LOSS_SVC_DUAL);
+	model->set_epsilon(1e-8);
+	model->set_labels(lab);
+	model->train(feats);
+
+	auto expected=some<CLibLinear>(L2R_L2LOSS_SVC_DUAL);
+	expected->set_epsilon(1e-8);
+	expected->set_labels(lab);
+	expected->train(dense);
+
+	SGVector<float64_t> model_w=model->get_w();
+	SGVector<float64_t> expected_w=expected->get_w();
+	for (index_t j=0; j<dim; ++j)
+		EXPECT_NEAR(expected_w[j], model_w[j], 1e-4);
+}
@@ -15,6 +15,7 @@
 #include <shogun/lib/Hash.h>
 #include <shogun/mathematics/UniformIntDistribution.h>
 
+#include <cstring>
 #include <random>
 
 using namespace shogun;
@@ -312,3 +313,67 @@ TEST(HashedDocDotFeaturesTest, quadratic_add_to_dense)
 	SG_UNREF(hddf);
 	SG_FREE(hashes);
 }
+
+TEST(HashedDocDotFeaturesTest, cached_hashes)
+{
+	const char* docs[] = {"You're never too old to rock and roll, if you're too young to die",
+		"Give me some rope, tie me to dream, give me the hope to run out of steam",
+		"Thank you Jack Daniels, Old Number Seven, Tennessee Whiskey got me drinking in heaven",
+		"Old", "Jack Daniels"};
+
+	std::vector<SGVector<char>> list;
+	for (auto doc : docs)
+	{
+		SGVector<char> string(strlen(doc));
+		for (index_t i=0; i<string.vlen; i++)
+			string[i] = doc[i];
+		list.push_back(string);
+	}
+
+	int32_t dimension = 64;
+	int32_t hash_bits = 6;
+
+	CDelimiterTokenizer* tokenizer = new CDelimiterTokenizer();
+	tokenizer->delimiters[' '] = 1;
+	tokenizer->delimiters['\''] = 1;
+	tokenizer->delimiters[','] = 1;
+
+	CStringFeatures<char>* doc_collection = new CStringFeatures<char>(list, RAWBYTE);
+	CHashedDocDotFeatures* hddf = new CHashedDocDotFeatures(hash_bits, doc_collection,
+			tokenizer, true, 3, 2);
+	CHashedDocDotFeatures* cached = new CHashedDocDotFeatures(hash_bits, doc_collection,
+			tokenizer, true, 3, 2);
+	cached->cache_hashes();
+	EXPECT_FALSE(hddf->is_hash_cached());
+	EXPECT_TRUE(cached->is_hash_cached());
+
+	std::mt19937_64 prng(12);
+	UniformIntDistribution<int32_t> uniform_int_dist;
+	SGVector<float64_t> vec(dimension);
+	for (index_t i=0; i<dimension; i++)
+		vec[i] = uniform_int_dist(prng, {-dimension, dimension});
+
+	SGVector<float64_t> sum(dimension);
+	SGVector<float64_t> cached_sum(dimension);
+	sum.zero();
+	cached_sum.zero();
+
+	for (index_t i=0; i<doc_collection->get_num_vectors(); i++)
+	{
+		EXPECT_NEAR(hddf->dot(i, vec), cached->dot(i, vec), 1e-9);
+		for (index_t j=0; j<doc_collection->get_num_vectors(); j++)
+			EXPECT_NEAR(hddf->dot(i, hddf, j), cached->dot(i, cached, j), 1e-9);
+
+		hddf->add_to_dense_vec(-0.5, i, sum.vector, sum.vlen, true);
+		cached->add_to_dense_vec(-0.5, i, cached_sum.vector, cached_sum.vlen, true);
+	}
+
+	for (index_t i=0; i<dimension; i++)
+		EXPECT_NEAR(sum[i], cached_sum[i], 1e-9);
+
+	cached->clear_hash_cache();
+	EXPECT_FALSE(cached->is_hash_cached());
+
+	SG_UNREF(cached);
+	SG_UNREF(hddf);
+}
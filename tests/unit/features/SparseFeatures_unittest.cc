@@ -12,6 +12,7 @@
 #include <shogun/io/stream/FileInputStream.h>
 #include <shogun/io/stream/FileOutputStream.h>
 #include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/exception/ShogunException.h>
 #include <shogun/features/SparseFeatures.h>
 #include <string>
 
@@ -413,3 +414,183 @@ TEST(SparseFeaturesTest,subset_get_full_feature_vector_smaller)
 
 	SG_UNREF(features);
 }
+
+TEST(SparseFeaturesTest,csr_same_as_sparse_vectors)
+{
+	SGMatrix<float64_t> data(7, 11);
+	for (index_t i=0; i<data.num_rows*data.num_cols; ++i)
+		data.matrix[i]=(i%3==0) ? i*0.5 : 0;
+
+	auto sparse=some<CSparseFeatures<float64_t>>(data);
+	auto csr=some<CSparseFeatures<float64_t>>(data);
+	csr->convert_to_csr();
+	EXPECT_TRUE(csr->is_csr());
+	EXPECT_FALSE(sparse->is_csr());
+	EXPECT_EQ(sparse->get_num_vectors(), csr->get_num_vectors());
+	EXPECT_EQ(sparse->get_num_features(), csr->get_num_features());
+	EXPECT_EQ(sparse->get_num_nonzero_entries(), csr->get_num_nonzero_entries());
+	EXPECT_EQ(csr->get_num_nonzero_entries(), csr->get_csr_values().vlen);
+	EXPECT_TRUE(data.equals(csr->get_full_feature_matrix()));
+
+	SGVector<float64_t> w(data.num_rows);
+	w.range_fill(1.0);
+	SGVector<float64_t> sq(data.num_cols);
+	SGVector<float64_t> csr_sq(data.num_cols);
+	sparse->compute_squared(sq.vector);
+	csr->compute_squared(csr_sq.vector);
+	for (index_t i=0; i<data.num_cols; ++i)
+	{
+		EXPECT_EQ(sparse->get_nnz_features_for_vector(i), csr->get_nnz_features_for_vector(i));
+		EXPECT_EQ(sparse->dot(i, w), csr->dot(i, w));
+		EXPECT_EQ(sparse->dense_dot(2.0, i, w.vector, w.vlen, 1.0),
+			csr->dense_dot(2.0, i, w.vector, w.vlen, 1.0));
+		EXPECT_EQ(sparse->dot(i, sparse, 10-i), csr->dot(i, csr, 10-i));
+		EXPECT_EQ(sq[i], csr_sq[i]);
+
+		SGSparseVector<float64_t> expected=sparse->get_sparse_feature_vector(i);
+		SGSparseVector<float64_t> vec=csr->get_sparse_feature_vector(i);
+		ASSERT_EQ(expected.num_feat_entries, vec.num_feat_entries);
+		for (index_t j=0; j<vec.num_feat_entries; ++j)
+		{
+			EXPECT_EQ(expected.features[j].feat_index, vec.features[j].feat_index);
+			EXPECT_EQ(expected.features[j].entry, vec.features[j].entry);
+		}
+
+		int32_t index;
+		float64_t value;
+		void* it=csr->get_feature_iterator(i);
+		for (index_t j=0; j<expected.num_feat_entries; ++j)
+		{
+			ASSERT_TRUE(csr->get_next_feature(index, value, it));
+			EXPECT_EQ(expected.features[j].feat_index, index);
+			EXPECT_EQ(expected.features[j].entry, value);
+		}
+		EXPECT_FALSE(csr->get_next_feature(index, value, it));
+		csr->free_feature_iterator(it);
+	}
+
+	SGVector<float64_t> sum(data.num_rows);
+	SGVector<float64_t> csr_sum(data.num_rows);
+	sum.zero();
+	csr_sum.zero();
+	for (index_t i=0; i<data.num_cols; ++i)
+	{
+		sparse->add_to_dense_vec(-0.5, i, sum.vector, sum.vlen, true);
+		csr->add_to_dense_vec(-0.5, i, csr_sum.vector, csr_sum.vlen, true);
+	}
+	for (index_t j=0; j<data.num_rows; ++j)
+		EXPECT_EQ(sum[j], csr_sum[j]);
+
+	SGVector<index_t> subset_idx(3);
+	subset_idx[0]=9;
+	subset_idx[1]=0;
+	subset_idx[2]=4;
+	csr->add_subset(subset_idx);
+	auto copy=wrap(csr->copy_subset(SGVector<index_t>({2, 0})));
+	SGMatrix<float64_t> copy_data=copy->as<CSparseFeatures<float64_t>>()->get_full_feature_matrix();
+	for (index_t j=0; j<data.num_rows; ++j)
+	{
+		EXPECT_EQ(data(j, 4), copy_data(j, 0));
+		EXPECT_EQ(data(j, 9), copy_data(j, 1));
+	}
+}
+
+TEST(SparseFeaturesTest,csr_external_buffers)
+{
+	// vectors {0:1, 3:2}, {}, {1:3, 2:4, 4:5}
+	index_t offsets[]={0, 2, 2, 5};
+	index_t indices[]={0, 3, 1, 2, 4};
+	float64_t values[]={1, 2, 3, 4, 5};
+
+	auto features=some<CSparseFeatures<float64_t>>(SGVector<index_t>(offsets, 4, false),
+		SGVector<index_t>(indices, 5, false), SGVector<float64_t>(values, 5, false));
+	EXPECT_EQ(3, features->get_num_vectors());
+	EXPECT_EQ(5, features->get_num_features());
+	// the buffers are used without copying them
+	EXPECT_EQ(values, features->get_csr_values().vector);
+	EXPECT_EQ(3, features->get_feature(2, 1));
+	EXPECT_EQ(0, features->get_feature(1, 1));
+
+	values[4]=6;
+	EXPECT_EQ(6, features->get_feature(2, 4));
+
+	SGVector<index_t> unsorted({1, 0});
+	EXPECT_THROW(features->set_csr_feature_matrix(SGVector<index_t>({0, 2}),
+		unsorted, SGVector<float64_t>({1, 2})), ShogunException);
+	EXPECT_THROW(features->set_csr_feature_matrix(SGVector<index_t>({0, 2}),
+		SGVector<index_t>({0, 5}), SGVector<float64_t>({1, 2}), 5), ShogunException);
+	EXPECT_EQ(3, features->get_num_vectors());
+}
+
+TEST(SparseFeaturesTest,csr_transposed)
+{
+	SGMatrix<int32_t> data(4, 6);
+	for (index_t i=0; i<data.num_rows*data.num_cols; ++i)
+		data.matrix[i]=(i%4==1 || i%5==0) ? i : 0;
+
+	auto features=some<CSparseFeatures<int32_t>>(data);
+	SGVector<index_t> offsets;
+	SGVector<index_t> indices;
+	SGVector<int32_t> values;
+	features->get_csc_feature_matrix(offsets, indices, values);
+	ASSERT_EQ(data.num_rows+1, offsets.vlen);
+	for (index_t j=0; j<data.num_rows; ++j)
+	{
+		index_t k=offsets[j];
+		for (index_t i=0; i<data.num_cols; ++i)
+		{
+			if (data(j, i)==0)
+				continue;
+
+			ASSERT_LT(k, offsets[j+1]);
+			EXPECT_EQ(i, indices[k]);
+			EXPECT_EQ(data(j, i), values[k]);
+			++k;
+		}
+		EXPECT_EQ(offsets[j+1], k);
+	}
+
+	features->convert_to_csr();
+	auto transposed=wrap(features->get_transposed());
+	EXPECT_TRUE(transposed->is_csr());
+	EXPECT_EQ(data.num_cols, transposed->get_num_features());
+	EXPECT_EQ(data.num_rows, transposed->get_num_vectors());
+
+	SGMatrix<int32_t> transposed_data=transposed->get_full_feature_matrix();
+	for (index_t j=0; j<data.num_rows; ++j)
+	{
+		for (index_t i=0; i<data.num_cols; ++i)
+			EXPECT_EQ(data(j, i), transposed_data(i, j));
+	}
+}
+
+TEST(SparseFeaturesTest,dense_dot_range)
+{
+	SGMatrix<float64_t> data(5, 40);
+	for (index_t i=0; i<data.num_rows*data.num_cols; ++i)
+		data.matrix[i]=(i%4==0) ? 0 : (i%9)-4;
+
+	auto sparse=some<CSparseFeatures<float64_t>>(data);
+	auto csr=some<CSparseFeatures<float64_t>>(data);
+	csr->convert_to_csr();
+
+	// a longer vector than the number of features
+	SGVector<float64_t> w(7);
+	w.range_fill(-2.0);
+	SGVector<float64_t> alphas(30);
+	alphas.range_fill(1.0);
+
+	SGVector<float64_t> output(30);
+	SGVector<float64_t> csr_output(30);
+	sparse->dense_dot_range(output.vector, 5, 35, alphas.vector, w.vector, w.vlen, 0.5);
+	csr->dense_dot_range(csr_output.vector, 5, 35, alphas.vector, w.vector, w.vlen, 0.5);
+	for (index_t i=0; i<30; ++i)
+	{
+		float64_t expected=0.5;
+		for (index_t j=0; j<data.num_rows; ++j)
+			expected+=alphas[i]*data(j, i+5)*w[j];
+
+		EXPECT_EQ(expected, output[i]);
+		EXPECT_EQ(expected, csr_output[i]);
+	}
+}
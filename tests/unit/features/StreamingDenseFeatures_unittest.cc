@@ -138,3 +138,152 @@ TEST(StreamingDenseFeaturesTest, reset_stream)
 	feats->end_parser();
 	SG_UNREF(feats);
 }
+
+TEST(StreamingDenseFeaturesTest, parallel_parsing)
+{
+	int32_t seed = 17;
+	index_t n=4000;
+	index_t dim=16;
+	char fname[] = "StreamingDenseFeatures_parallel.XXXXXX";
+	generate_temp_filename(fname);
+
+	std::mt19937_64 prng(seed);
+	NormalDistribution<float64_t> normal_dist;
+
+	SGMatrix<float64_t> data(dim,n);
+	float64_t expected_sum = 0;
+	for (index_t i=0; i<dim*n; ++i)
+	{
+		data.matrix[i] = normal_dist(prng);
+		expected_sum += data.matrix[i];
+	}
+
+	CDenseFeatures<float64_t>* orig_feats=new CDenseFeatures<float64_t>(data);
+	CCSVFile* saved_features = new CCSVFile(fname, 'w');
+	orig_feats->save(saved_features);
+	saved_features->close();
+	SG_UNREF(saved_features);
+
+	for (bool ordered : {true, false})
+	{
+		CStreamingAsciiFile* input = new CStreamingAsciiFile(fname);
+		input->set_delimiter(',');
+		CStreamingDenseFeatures<float64_t>* feats
+			= new CStreamingDenseFeatures<float64_t>(input, false, 64);
+		// smallest chunks, so that the file is split among the threads
+		feats->set_num_parse_threads(4, ordered, 1);
+
+		index_t i = 0;
+		float64_t sum = 0;
+		feats->start_parser();
+		while (feats->get_next_example())
+		{
+			SGVector<float64_t> example = feats->get_vector();
+			ASSERT_EQ(dim, example.vlen);
+
+			for (index_t j = 0; j < dim; j++)
+			{
+				if (ordered)
+					EXPECT_NEAR(data(j, i), example.vector[j], 1E-5);
+				sum += example.vector[j];
+			}
+
+			feats->release_example();
+			i++;
+		}
+		feats->end_parser();
+
+		EXPECT_EQ(n, i);
+		EXPECT_NEAR(expected_sum, sum, 1E-3);
+		SG_UNREF(feats);
+	}
+
+	SG_UNREF(orig_feats);
+	std::remove(fname);
+}
+
+TEST(StreamingDenseFeaturesTest, parallel_parsing_error)
+{
+	index_t n=40;
+	index_t malformed=24;
+	char fname[] = "StreamingDenseFeatures_error.XXXXXX";
+	generate_temp_filename(fname);
+
+	FILE* file=fopen(fname, "w");
+	for (index_t i=0; i<n; ++i)
+		fprintf(file, i==malformed ? "%d,x,1\n" : "%d,0,1\n", i);
+	fclose(file);
+
+	CStreamingAsciiFile* input = new CStreamingAsciiFile(fname);
+	input->set_delimiter(',');
+	CStreamingDenseFeatures<float64_t>* feats
+		= new CStreamingDenseFeatures<float64_t>(input, false, 64);
+	feats->set_num_parse_threads(4, true, 1);
+
+	// the examples before the malformed line are returned, then its error
+	index_t i = 0;
+	feats->start_parser();
+	EXPECT_THROW(
+		{
+			while (feats->get_next_example())
+			{
+				EXPECT_EQ(i, feats->get_vector()[0]);
+				feats->release_example();
+				i++;
+			}
+		},
+		ShogunException);
+	feats->end_parser();
+	EXPECT_EQ(malformed, i);
+
+	SG_UNREF(feats);
+	std::remove(fname);
+}
+
+TEST(StreamingDenseFeaturesTest, batch_reading)
+{
+	int32_t seed = 17;
+	index_t n=50;
+	index_t dim=3;
+
+	std::mt19937_64 prng(seed);
+	NormalDistribution<float64_t> normal_dist;
+
+	SGMatrix<float64_t> data(dim,n);
+	SGVector<float64_t> labels(n);
+	for (index_t i=0; i<dim*n; ++i)
+		data.matrix[i] = normal_dist(prng);
+	for (index_t i=0; i<n; ++i)
+		labels[i] = i;
+
+	CDenseFeatures<float64_t>* orig_feats=new CDenseFeatures<float64_t>(data);
+	CStreamingDenseFeatures<float64_t>* feats
+		= new CStreamingDenseFeatures<float64_t>(orig_feats, labels.vector);
+
+	index_t i = 0;
+	int32_t num;
+	feats->start_parser();
+	while ((num = feats->get_next_batch(16)))
+	{
+		SGMatrix<float64_t> batch = feats->get_batch();
+		SGVector<float64_t> batch_labels = feats->get_batch_labels();
+
+		ASSERT_EQ(dim, batch.num_rows);
+		ASSERT_EQ(num, batch.num_cols);
+		ASSERT_EQ(num, batch_labels.vlen);
+		EXPECT_TRUE(num == 16 || i + num == n);
+
+		for (index_t k = 0; k < num; k++)
+		{
+			for (index_t j = 0; j < dim; j++)
+				EXPECT_EQ(data(j, i + k), batch(j, k));
+			EXPECT_EQ(labels[i + k], batch_labels[k]);
+		}
+
+		i += num;
+	}
+	feats->end_parser();
+	EXPECT_EQ(n, i);
+
+	SG_UNREF(feats);
+}
@@ -83,3 +83,170 @@ TEST(StreamingSparseFeaturesTest, parse_file)
 
   std::remove(fname);
 }
+
+TEST(StreamingSparseFeaturesTest, parallel_parsing)
+{
+  char fname[] = "StreamingSparseFeatures_parallel.XXXXXX";
+  generate_temp_filename(fname);
+
+  int32_t seed = 100;
+  int32_t max_num_entries=20;
+  int32_t max_label_value=1;
+  float64_t max_entry_value=1;
+
+  int32_t num_vec=3000;
+  int32_t num_feat=0;
+
+  std::mt19937_64 prng(seed);
+  UniformIntDistribution<int32_t> uniform_int_dist;
+  UniformRealDistribution<float64_t> uniform_real_dist;
+
+  SGSparseVector<float64_t>* data=SG_MALLOC(SGSparseVector<float64_t>, num_vec);
+  float64_t* labels=SG_MALLOC(float64_t, num_vec);
+  float64_t label_sum=0;
+  int64_t num_entries=0;
+  for (int32_t i=0; i<num_vec; i++)
+  {
+    data[i]=SGSparseVector<float64_t>(uniform_int_dist(prng, {0, max_num_entries}));
+    labels[i]=(float64_t) uniform_int_dist(prng, {-max_label_value, max_label_value});
+    label_sum+=labels[i];
+    num_entries+=data[i].num_feat_entries;
+    for (int32_t j=0; j<data[i].num_feat_entries; j++)
+    {
+      int32_t feat_index=(j+1)*2;
+      if (feat_index>num_feat)
+        num_feat=feat_index;
+
+      data[i].features[j].feat_index=feat_index-1;
+      data[i].features[j].entry=uniform_real_dist(prng, {0.0, max_entry_value});
+    }
+  }
+  CLibSVMFile* fout = new CLibSVMFile(fname, 'w', NULL);
+  fout->set_sparse_matrix(data, num_feat, num_vec, labels);
+  SG_UNREF(fout);
+
+  for (bool ordered : {true, false})
+  {
+    CStreamingAsciiFile *file = new CStreamingAsciiFile(fname);
+    CStreamingSparseFeatures<float64_t> *stream_features =
+      new CStreamingSparseFeatures<float64_t>(file, true, 64);
+    // smallest chunks, so that the file is split among the threads
+    stream_features->set_num_parse_threads(4, ordered, 1);
+
+    stream_features->start_parser();
+    index_t i = 0;
+    float64_t streamed_label_sum = 0;
+    int64_t streamed_num_entries = 0;
+    while (stream_features->get_next_example())
+    {
+        SGSparseVector<float64_t> v = stream_features->get_vector();
+        streamed_label_sum += stream_features->get_label();
+        streamed_num_entries += v.num_feat_entries;
+
+        if (ordered)
+        {
+          EXPECT_EQ(labels[i], stream_features->get_label());
+          ASSERT_EQ(data[i].num_feat_entries, v.num_feat_entries);
+          for (index_t j = 0; j < data[i].num_feat_entries; j++)
+          {
+            EXPECT_EQ(data[i].features[j].feat_index, v.features[j].feat_index);
+            EXPECT_DOUBLE_EQ(data[i].features[j].entry, v.features[j].entry);
+          }
+        }
+
+        stream_features->release_example();
+        i++;
+    }
+    stream_features->end_parser();
+
+    EXPECT_EQ(num_vec, i);
+    EXPECT_EQ(label_sum, streamed_label_sum);
+    EXPECT_EQ(num_entries, streamed_num_entries);
+    SG_UNREF(stream_features);
+  }
+
+  SG_FREE(data);
+  SG_FREE(labels);
+
+  std::remove(fname);
+}
+
+TEST(StreamingSparseFeaturesTest, batch_reading)
+{
+  char fname[] = "StreamingSparseFeatures_batch.XXXXXX";
+  generate_temp_filename(fname);
+
+  int32_t seed = 100;
+  int32_t max_num_entries=20;
+  int32_t max_label_value=1;
+  float64_t max_entry_value=1;
+
+  int32_t num_vec=50;
+  int32_t num_feat=0;
+
+  std::mt19937_64 prng(seed);
+  UniformIntDistribution<int32_t> uniform_int_dist;
+  UniformRealDistribution<float64_t> uniform_real_dist;
+
+  SGSparseVector<float64_t>* data=SG_MALLOC(SGSparseVector<float64_t>, num_vec);
+  float64_t* labels=SG_MALLOC(float64_t, num_vec);
+  for (int32_t i=0; i<num_vec; i++)
+  {
+    data[i]=SGSparseVector<float64_t>(uniform_int_dist(prng, {0, max_num_entries}));
+    labels[i]=(float64_t) uniform_int_dist(prng, {-max_label_value, max_label_value});
+    for (int32_t j=0; j<data[i].num_feat_entries; j++)
+    {
+      int32_t feat_index=(j+1)*2;
+      if (feat_index>num_feat)
+        num_feat=feat_index;
+
+      data[i].features[j].feat_index=feat_index-1;
+      data[i].features[j].entry=uniform_real_dist(prng, {0.0, max_entry_value});
+    }
+  }
+  CLibSVMFile* fout = new CLibSVMFile(fname, 'w', NULL);
+  fout->set_sparse_matrix(data, num_feat, num_vec, labels);
+  SG_UNREF(fout);
+
+  CStreamingAsciiFile *file = new CStreamingAsciiFile(fname);
+  CStreamingSparseFeatures<float64_t> *stream_features =
+    new CStreamingSparseFeatures<float64_t>(file, true, 8);
+
+  stream_features->start_parser();
+  index_t i = 0;
+  int32_t num;
+  // more than the ring size, which limits the batch
+  while ((num = stream_features->get_next_batch(16)))
+  {
+      SGVector<index_t> offsets = stream_features->get_batch_offsets();
+      SGVector<index_t> indices = stream_features->get_batch_indices();
+      SGVector<float64_t> values = stream_features->get_batch_values();
+      SGVector<float64_t> batch_labels = stream_features->get_batch_labels();
+
+      EXPECT_LE(num, 8);
+      ASSERT_EQ(num+1, offsets.vlen);
+      ASSERT_EQ(offsets[num], indices.vlen);
+      ASSERT_EQ(offsets[num], values.vlen);
+
+      for (index_t k = 0; k < num; k++)
+      {
+        EXPECT_EQ(labels[i+k], batch_labels[k]);
+        ASSERT_EQ(data[i+k].num_feat_entries, offsets[k+1]-offsets[k]);
+        for (index_t j = 0; j < data[i+k].num_feat_entries; j++)
+        {
+          EXPECT_EQ(data[i+k].features[j].feat_index, indices[offsets[k]+j]);
+          EXPECT_DOUBLE_EQ(data[i+k].features[j].entry, values[offsets[k]+j]);
+        }
+      }
+
+      i += num;
+  }
+  stream_features->end_parser();
+  EXPECT_EQ(num_vec, i);
+
+  SG_UNREF(stream_features);
+  SG_FREE(data);
+  SG_FREE(labels);
+
+  std::remove(fname);
+}
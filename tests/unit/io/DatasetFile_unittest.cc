@@ -0,0 +1,273 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/base/some.h>
+#include <shogun/features/MappedDenseFeatures.h>
+#include <shogun/features/MappedSparseFeatures.h>
+#include <shogun/io/DatasetFile.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGSparseMatrix.h>
+#include <shogun/lib/exception/ShogunException.h>
+#include "../utils/Utils.h"
+
+#include <cstdio>
+#include <random>
+
+using namespace shogun;
+
+static SGMatrix<float64_t> dataset_dense_data(index_t dim, index_t num_vecs, int32_t seed)
+{
+	std::mt19937_64 prng(seed);
+	std::uniform_int_distribution<int32_t> uniform(-100, 100);
+
+	// multiples of 1/4, so that they survive text files unchanged
+	SGMatrix<float64_t> data(dim, num_vecs);
+	for (int64_t i=0; i<int64_t(dim)*num_vecs; ++i)
+		data.matrix[i]=uniform(prng)/4.0;
+
+	return data;
+}
+
+static SGSparseMatrix<float64_t> dataset_sparse_data(index_t dim, index_t num_vecs, int32_t seed)
+{
+	std::mt19937_64 prng(seed);
+	std::uniform_int_distribution<int32_t> uniform(1, 100);
+
+	SGSparseMatrix<float64_t> data(dim, num_vecs);
+	for (index_t i=0; i<num_vecs; ++i)
+	{
+		index_t len=0;
+		data[i]=SGSparseVector<float64_t>(dim);
+		for (index_t j=0; j<dim; ++j)
+		{
+			if (uniform(prng)>30)
+				continue;
+
+			data[i].features[len].feat_index=j;
+			data[i].features[len].entry=uniform(prng)/4.0;
+			++len;
+		}
+		data[i].num_feat_entries=len;
+	}
+
+	return data;
+}
+
+static void check_dense(const SGMatrix<float64_t>& expected, const SGMatrix<float64_t>& actual)
+{
+	ASSERT_EQ(expected.num_rows, actual.num_rows);
+	ASSERT_EQ(expected.num_cols, actual.num_cols);
+	for (int64_t i=0; i<int64_t(expected.num_rows)*expected.num_cols; ++i)
+		EXPECT_EQ(expected.matrix[i], actual.matrix[i]);
+}
+
+static void check_sparse(const SGSparseMatrix<float64_t>& expected, const SGSparseMatrix<float64_t>& actual)
+{
+	ASSERT_EQ(expected.num_vectors, actual.num_vectors);
+	for (index_t i=0; i<expected.num_vectors; ++i)
+	{
+		ASSERT_EQ(expected[i].num_feat_entries, actual[i].num_feat_entries);
+		for (index_t j=0; j<expected[i].num_feat_entries; ++j)
+		{
+			EXPECT_EQ(expected[i].features[j].feat_index, actual[i].features[j].feat_index);
+			EXPECT_EQ(expected[i].features[j].entry, actual[i].features[j].entry);
+		}
+	}
+}
+
+TEST(DatasetFile, dense)
+{
+	char fname[]="DatasetFile_dense.XXXXXX";
+	generate_temp_filename(fname);
+
+	const index_t dim=7;
+	SGMatrix<float64_t> data=dataset_dense_data(dim, 250, 1);
+	SGVector<float64_t> labels(data.num_cols);
+	labels.range_fill();
+
+	{
+		auto out=some<CDatasetFile>(fname, 'w', UNCOMPRESSED, 32);
+		// appending splits the vectors into chunks
+		out->write_dense(SGMatrix<float64_t>(data.matrix, dim, 100, false),
+			SGVector<float64_t>(labels.vector, 100, false));
+		out->write_dense(SGMatrix<float64_t>(data.matrix+100*dim, dim, 150, false),
+			SGVector<float64_t>(labels.vector+100, 150, false));
+		EXPECT_THROW(out->write_dense(SGMatrix<float64_t>(dim+1, 1)), ShogunException);
+	}
+
+	auto file=some<CDatasetFile>(fname);
+	EXPECT_FALSE(file->is_sparse());
+	EXPECT_EQ(PT_FLOAT64, file->get_primitive_type());
+	EXPECT_EQ(dim, file->get_num_features());
+	EXPECT_EQ(250, file->get_num_vectors());
+	EXPECT_EQ(4+5, file->get_num_chunks());
+	EXPECT_THROW(file->get_matrix<float32_t>(), ShogunException);
+	EXPECT_THROW(file->get_sparse_matrix<float64_t>(), ShogunException);
+
+	check_dense(data, file->get_matrix<float64_t>());
+	SGVector<float64_t> file_labels=file->get_labels();
+	for (index_t i=0; i<labels.vlen; ++i)
+		EXPECT_EQ(labels[i], file_labels[i]);
+
+	for (int64_t c=0; c<file->get_num_chunks(); ++c)
+	{
+		SGMatrix<float64_t> chunk=file->get_dense_chunk<float64_t>(c);
+		const int64_t first=file->get_chunk_first_vector(c);
+		ASSERT_EQ(file->get_chunk_num_vectors(c), chunk.num_cols);
+		for (index_t i=0; i<chunk.num_cols; ++i)
+		{
+			for (index_t j=0; j<dim; ++j)
+				EXPECT_EQ(data(j, first+i), chunk(j, i));
+		}
+	}
+
+	auto feats=some<CMappedDenseFeatures<float64_t>>(file);
+	EXPECT_EQ(dim, feats->get_num_features());
+	EXPECT_EQ(250, feats->get_num_vectors());
+	// uncompressed files are used where they are mapped
+	EXPECT_EQ(file->get_matrix<float64_t>().matrix, feats->get_feature_matrix().matrix);
+
+	auto copy=wrap(dynamic_cast<CDenseFeatures<float64_t>*>(feats->duplicate()));
+	// the copy keeps the file mapped
+	feats.reset();
+	file.reset();
+	check_dense(data, copy->get_feature_matrix());
+
+	std::remove(fname);
+}
+
+TEST(DatasetFile, sparse)
+{
+	char fname[]="DatasetFile_sparse.XXXXXX";
+	generate_temp_filename(fname);
+
+	SGSparseMatrix<float64_t> data=dataset_sparse_data(20, 123, 2);
+	{
+		auto out=some<CDatasetFile>(fname, 'w', UNCOMPRESSED, 50);
+		out->write_sparse(data);
+		out->close();
+		EXPECT_THROW(out->write_sparse(data), ShogunException);
+	}
+
+	auto feats=some<CMappedSparseFeatures<float64_t>>(fname);
+	EXPECT_EQ(123, feats->get_num_vectors());
+	CDatasetFile* file=feats->get_dataset_file();
+	EXPECT_EQ(3, file->get_num_chunks());
+	EXPECT_FALSE(file->has_labels());
+	SG_UNREF(file);
+
+	for (index_t i=0; i<data.num_vectors; ++i)
+	{
+		SGSparseVector<float64_t> vec=feats->get_sparse_feature_vector(i);
+		ASSERT_EQ(data[i].num_feat_entries, vec.num_feat_entries);
+		for (index_t j=0; j<vec.num_feat_entries; ++j)
+		{
+			EXPECT_EQ(data[i].features[j].feat_index, vec.features[j].feat_index);
+			EXPECT_EQ(data[i].features[j].entry, vec.features[j].entry);
+		}
+		feats->free_sparse_feature_vector(i);
+	}
+
+	std::remove(fname);
+}
+
+TEST(DatasetFile, convert_csv)
+{
+	char csv_fname[]="DatasetFile_csv.XXXXXX";
+	char fname[]="DatasetFile_csv_out.XXXXXX";
+	generate_temp_filename(csv_fname);
+	generate_temp_filename(fname);
+
+	const index_t dim=5;
+	SGMatrix<float64_t> data=dataset_dense_data(dim, 77, 3);
+	FILE* f=fopen(csv_fname, "w");
+	for (index_t i=0; i<data.num_cols; ++i)
+	{
+		fprintf(f, "%d", i%3);
+		for (index_t j=0; j<dim; ++j)
+			fprintf(f, ",%.2f", data(j, i));
+		fprintf(f, "\n");
+	}
+	fclose(f);
+
+	CDatasetFile::convert_csv(csv_fname, fname, true, ',', UNCOMPRESSED, 10);
+
+	auto file=some<CDatasetFile>(fname);
+	EXPECT_EQ(dim, file->get_num_features());
+	EXPECT_EQ(8, file->get_num_chunks());
+	check_dense(data, file->get_matrix<float64_t>());
+
+	SGVector<float64_t> labels=file->get_labels();
+	ASSERT_EQ(data.num_cols, labels.vlen);
+	for (index_t i=0; i<labels.vlen; ++i)
+		EXPECT_EQ(i%3, labels[i]);
+
+	std::remove(csv_fname);
+	std::remove(fname);
+}
+
+TEST(DatasetFile, convert_libsvm)
+{
+	char libsvm_fname[]="DatasetFile_libsvm.XXXXXX";
+	char fname[]="DatasetFile_libsvm_out.XXXXXX";
+	generate_temp_filename(libsvm_fname);
+	generate_temp_filename(fname);
+
+	SGSparseMatrix<float64_t> data=dataset_sparse_data(30, 64, 4);
+	FILE* f=fopen(libsvm_fname, "w");
+	for (index_t i=0; i<data.num_vectors; ++i)
+	{
+		fprintf(f, "%d", 2*(i%2)-1);
+		for (index_t j=0; j<data[i].num_feat_entries; ++j)
+			fprintf(f, " %d:%.2f", data[i].features[j].feat_index+1, data[i].features[j].entry);
+		fprintf(f, "\n");
+	}
+	fclose(f);
+
+	CDatasetFile::convert_libsvm(libsvm_fname, fname, UNCOMPRESSED, 16);
+
+	auto file=some<CDatasetFile>(fname);
+	EXPECT_TRUE(file->is_sparse());
+	EXPECT_EQ(4, file->get_num_chunks());
+	check_sparse(data, file->get_sparse_matrix<float64_t>());
+
+	SGVector<float64_t> labels=file->get_labels();
+	for (index_t i=0; i<labels.vlen; ++i)
+		EXPECT_EQ(2*(i%2)-1, labels[i]);
+
+	std::remove(libsvm_fname);
+	std::remove(fname);
+}
+
+#ifdef USE_GZIP
+TEST(DatasetFile, compression)
+{
+	char fname[]="DatasetFile_gzip.XXXXXX";
+	generate_temp_filename(fname);
+
+	// mostly zeros, so that every chunk is compressed
+	SGMatrix<float64_t> dense(50, 300);
+	dense.zero();
+	for (index_t i=0; i<dense.num_cols; ++i)
+		dense(i%dense.num_rows, i)=i;
+
+	{
+		auto out=some<CDatasetFile>(fname, 'w', GZIP, 64);
+		out->write_dense(dense);
+	}
+
+	auto file=some<CDatasetFile>(fname);
+	EXPECT_EQ(GZIP, file->get_compression());
+	SGMatrix<float64_t> mat=file->get_matrix<float64_t>();
+	check_dense(dense, mat);
+	check_dense(SGMatrix<float64_t>(dense.matrix+128*dense.num_rows, dense.num_rows, 64, false),
+		file->get_dense_chunk<float64_t>(2));
+
+	auto feats=some<CMappedDenseFeatures<float64_t>>(file);
+	check_dense(dense, feats->get_feature_matrix());
+
+	std::remove(fname);
+}
+#endif
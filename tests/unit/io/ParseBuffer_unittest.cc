@@ -0,0 +1,132 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/io/streaming/ParseBuffer.h>
+
+#include <thread>
+#include <vector>
+
+using namespace shogun;
+
+/** reads num examples from the ring, waiting for each one */
+static std::vector<int32_t> read_examples(CParseBuffer<int32_t>* ring, int32_t num)
+{
+	std::vector<int32_t> values;
+	while ((int32_t) values.size()<num)
+	{
+		Example<int32_t>* ex=ring->get_unused_example();
+		if (!ex)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		EXPECT_EQ(1, ex->length);
+		values.push_back(ex->fv[0]);
+		ring->finalize_example(false);
+	}
+
+	return values;
+}
+
+TEST(ParseBuffer, single_writer)
+{
+	const int32_t num=10000;
+	auto ring=new CParseBuffer<int32_t>(8);
+	ring->set_free_vectors_on_destruct(false);
+
+	std::vector<int32_t> data(num);
+	std::thread writer([&]() {
+		for (int32_t i=0; i<num; i++)
+		{
+			data[i]=i;
+			Example<int32_t>* ex=ring->get_free_example();
+			ex->fv=&data[i];
+			ex->length=1;
+			ex->label=i;
+			ring->copy_example(ex);
+		}
+	});
+
+	std::vector<int32_t> values=read_examples(ring, num);
+	writer.join();
+
+	for (int32_t i=0; i<num; i++)
+		EXPECT_EQ(i, values[i]);
+
+	SG_UNREF(ring);
+}
+
+TEST(ParseBuffer, multiple_writers)
+{
+	const int32_t num_writers=4;
+	const int32_t num=5000;
+	auto ring=new CParseBuffer<int32_t>(8);
+	ring->set_free_vectors_on_destruct(false);
+
+	// value of an example is writer*num+i
+	std::vector<int32_t> data(num_writers*num);
+	std::vector<std::thread> writers;
+	for (int32_t w=0; w<num_writers; w++)
+	{
+		writers.emplace_back([&, w]() {
+			for (int32_t i=0; i<num; i++)
+			{
+				data[w*num+i]=w*num+i;
+				Example<int32_t>* ex=ring->claim_free_example();
+				ex->fv=&data[w*num+i];
+				ex->length=1;
+				ring->publish_example(ex);
+			}
+		});
+	}
+
+	std::vector<int32_t> values=read_examples(ring, num_writers*num);
+	for (auto& writer : writers)
+		writer.join();
+
+	// every writer's examples arrive exactly once and in order
+	std::vector<int32_t> next(num_writers, 0);
+	for (auto value : values)
+	{
+		int32_t w=value/num;
+		EXPECT_EQ(next[w], value%num);
+		next[w]++;
+	}
+	for (int32_t w=0; w<num_writers; w++)
+		EXPECT_EQ(num, next[w]);
+
+	SG_UNREF(ring);
+}
+
+TEST(ParseBuffer, batches)
+{
+	auto ring=new CParseBuffer<int32_t>(8);
+	ring->set_free_vectors_on_destruct(false);
+
+	std::vector<int32_t> data={0, 1, 2, 3, 4};
+	for (int32_t i=0; i<5; i++)
+	{
+		Example<int32_t>* ex=ring->get_free_example();
+		ex->fv=&data[i];
+		ex->length=1;
+		ring->copy_example(ex);
+	}
+
+	Example<int32_t>* examples[8];
+	ASSERT_EQ(5, ring->get_unused_examples(8, examples));
+	for (int32_t i=0; i<5; i++)
+		EXPECT_EQ(i, examples[i]->fv[0]);
+
+	ring->finalize_examples(3, false);
+	ASSERT_EQ(2, ring->get_unused_examples(8, examples));
+	EXPECT_EQ(3, examples[0]->fv[0]);
+	EXPECT_EQ(4, examples[1]->fv[0]);
+
+	ring->finalize_examples(2, false);
+	EXPECT_EQ(NULL, ring->get_unused_example());
+
+	SG_UNREF(ring);
+}
@@ -0,0 +1,281 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+#include <gtest/gtest.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/KernelRowCache.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/exception/ShogunException.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace shogun;
+
+static void fill_row(index_t row, float64_t* data, index_t length)
+{
+	for (index_t j = 0; j < length; ++j)
+		data[j] = row * length + j;
+}
+
+TEST(KernelRowCache, hits_and_misses)
+{
+	const index_t num_rows = 10;
+	const index_t length = 100;
+	KernelRowCache<float64_t> cache(num_rows, length, 1, 2);
+	EXPECT_EQ(cache.get_capacity(), num_rows);
+
+	auto compute = [length](index_t row, float64_t* data) {
+		fill_row(row, data, length);
+	};
+
+	for (index_t k = 0; k < 3; ++k)
+	{
+		for (index_t i = 0; i < num_rows; ++i)
+		{
+			auto row = cache.get_row(i, compute);
+			ASSERT_EQ(row.size(), length);
+			EXPECT_TRUE(row.is_cached());
+			for (index_t j = 0; j < length; ++j)
+				EXPECT_EQ(row[j], i * length + j);
+		}
+	}
+
+	EXPECT_EQ(cache.get_misses(), num_rows);
+	EXPECT_EQ(cache.get_hits(), 2 * num_rows);
+	EXPECT_EQ(cache.get_evictions(), 0);
+
+	cache.clear();
+	EXPECT_FALSE(cache.contains(0));
+	cache.reset_statistics();
+	EXPECT_EQ(cache.get_hits(), 0);
+	EXPECT_EQ(cache.get_misses(), 0);
+}
+
+TEST(KernelRowCache, pinned_rows_are_not_evicted)
+{
+	const index_t length = 10;
+	// zero MB gives a single slot
+	KernelRowCache<float64_t> cache(5, length, 0, 1);
+	EXPECT_EQ(cache.get_capacity(), 1);
+
+	auto compute = [length](index_t row, float64_t* data) {
+		fill_row(row, data, length);
+	};
+
+	{
+		auto first = cache.get_row(1, compute);
+		auto second = cache.get_row(2, compute);
+		EXPECT_TRUE(first.is_cached());
+		EXPECT_FALSE(second.is_cached());
+		EXPECT_EQ(second[3], 2 * length + 3);
+		EXPECT_TRUE(cache.contains(1));
+		EXPECT_EQ(cache.get_evictions(), 0);
+	}
+
+	auto third = cache.get_row(2, compute);
+	EXPECT_TRUE(third.is_cached());
+	EXPECT_FALSE(cache.contains(1));
+	EXPECT_EQ(cache.get_evictions(), 1);
+}
+
+TEST(KernelRowCache, failed_compute_frees_slot)
+{
+	const index_t length = 10;
+	KernelRowCache<float64_t> cache(5, length, 0, 1);
+	ASSERT_EQ(cache.get_capacity(), 1);
+
+	auto compute = [length](index_t row, float64_t* data) {
+		fill_row(row, data, length);
+	};
+	auto fail = [](index_t, float64_t*) {
+		throw ShogunException("kernel failed");
+	};
+
+	EXPECT_THROW(cache.get_row(1, fail), ShogunException);
+	EXPECT_FALSE(cache.contains(1));
+
+	{
+		auto row = cache.get_row(1, compute);
+		EXPECT_TRUE(row.is_cached());
+		EXPECT_EQ(row[3], length + 3);
+	}
+	EXPECT_TRUE(cache.contains(1));
+
+	// the slot is used again after a failure that evicted its row
+	EXPECT_THROW(cache.get_row(2, fail), ShogunException);
+	auto row = cache.get_row(3, compute);
+	EXPECT_TRUE(row.is_cached());
+	EXPECT_EQ(row[3], 3 * length + 3);
+}
+
+TEST(KernelRowCache, rows_outlive_cache)
+{
+	const index_t length = 10;
+	auto compute = [length](index_t row, float64_t* data) {
+		fill_row(row, data, length);
+	};
+
+	auto cache = std::make_unique<KernelRowCache<float64_t>>(5, length, 1, 1);
+	auto cleared = cache->get_row(1, compute);
+	cache->clear();
+	EXPECT_FALSE(cache->contains(1));
+
+	// the cleared slot is not handed out again while the row is pinned
+	auto row = cache->get_row(2, compute);
+	EXPECT_EQ(row[3], 2 * length + 3);
+	EXPECT_EQ(cleared[3], length + 3);
+
+	cache.reset();
+	EXPECT_EQ(cleared[3], length + 3);
+	EXPECT_EQ(row[3], 2 * length + 3);
+}
+
+TEST(KernelRowCache, kernel_rows_outlive_row_cache)
+{
+	const index_t num_vectors = 20;
+	const index_t dim = 3;
+
+	SGMatrix<float64_t> data(dim, num_vectors);
+	for (index_t i = 0; i < dim * num_vectors; ++i)
+		data.matrix[i] = i % 7 - 3.0;
+
+	auto feats = new CDenseFeatures<float64_t>(data);
+	auto kernel = new CGaussianKernel(feats, feats, 2);
+	SG_REF(kernel);
+	kernel->set_float32_row_cache(false);
+
+	auto row = kernel->get_cached_kernel_row<float64_t>(3);
+	SGVector<float64_t> expected(row.size());
+	for (index_t j = 0; j < row.size(); ++j)
+		expected[j] = row[j];
+
+	// recreates the row cache, then drops it with the features
+	kernel->set_float32_row_cache(true);
+	kernel->remove_lhs_and_rhs();
+	SG_UNREF(kernel);
+
+	for (index_t j = 0; j < expected.vlen; ++j)
+		EXPECT_EQ(row[j], expected[j]);
+}
+
+TEST(KernelRowCache, concurrent_get_or_compute)
+{
+	const index_t num_rows = 64;
+	const index_t length = 4096;
+	// capacity is 32 rows, so rows keep getting evicted
+	KernelRowCache<float64_t> cache(num_rows, length, 1, 4);
+	EXPECT_EQ(cache.get_capacity(), 32);
+
+	std::atomic<int64_t> computed(0);
+	auto compute = [length, &computed](index_t row, float64_t* data) {
+		computed++;
+		fill_row(row, data, length);
+	};
+
+	std::atomic<bool> all_correct(true);
+	std::vector<std::thread> threads;
+	for (index_t t = 0; t < 4; ++t)
+	{
+		threads.emplace_back([&, t]() {
+			for (index_t k = 0; k < 500; ++k)
+			{
+				index_t i = (k * 7 + t * 13) % num_rows;
+				auto row = cache.get_row(i, compute);
+				for (index_t j = 0; j < length; j += 101)
+				{
+					if (row[j] != i * length + j)
+						all_correct = false;
+				}
+			}
+		});
+	}
+	for (auto& thread : threads)
+		thread.join();
+
+	EXPECT_TRUE(all_correct);
+	EXPECT_EQ(cache.get_hits() + cache.get_misses(), 4 * 500);
+	EXPECT_EQ(cache.get_misses(), computed);
+	EXPECT_GT(cache.get_evictions(), 0);
+}
+
+TEST(KernelRowCache, kernel_cached_rows)
+{
+	const index_t num_vectors = 20;
+	const index_t dim = 3;
+
+	SGMatrix<float64_t> data(dim, num_vectors);
+	for (index_t i = 0; i < dim * num_vectors; ++i)
+		data.matrix[i] = i % 7 - 3.0;
+
+	auto feats = new CDenseFeatures<float64_t>(data);
+	auto kernel = new CGaussianKernel(feats, feats, 2);
+	SG_REF(kernel);
+	kernel->set_float32_row_cache(false);
+
+	SGMatrix<float64_t> km = kernel->get_kernel_matrix();
+
+	SGVector<index_t> rows(num_vectors);
+	rows.range_fill();
+	kernel->cache_kernel_rows(rows);
+	EXPECT_EQ(kernel->get_row_cache_misses(), num_vectors);
+
+	for (index_t i = 0; i < num_vectors; ++i)
+	{
+		auto row = kernel->get_cached_kernel_row<float64_t>(i);
+		ASSERT_EQ(row.size(), num_vectors);
+		for (index_t j = 0; j < num_vectors; ++j)
+			EXPECT_NEAR(row[j], km(i, j), 1E-12);
+	}
+	EXPECT_EQ(kernel->get_row_cache_hits(), num_vectors);
+	EXPECT_EQ(kernel->get_row_cache_evictions(), 0);
+
+	kernel->reset_row_cache();
+	kernel->get_cached_kernel_row<float64_t>(0);
+	EXPECT_EQ(kernel->get_row_cache_misses(), num_vectors + 1);
+
+	SG_UNREF(kernel);
+}
+
+TEST(KernelRowCache, kernel_float32_cached_rows)
+{
+	const index_t num_vectors = 20;
+	const index_t dim = 3;
+
+	SGMatrix<float64_t> data(dim, num_vectors);
+	for (index_t i = 0; i < dim * num_vectors; ++i)
+		data.matrix[i] = i % 5 - 2.0;
+
+	auto feats = new CDenseFeatures<float64_t>(data);
+	auto kernel = new CGaussianKernel(feats, feats, 2);
+	SG_REF(kernel);
+	kernel->set_float32_row_cache(false);
+	kernel->get_cached_kernel_row<float64_t>(0);
+	EXPECT_THROW(kernel->get_cached_kernel_row<float32_t>(0), ShogunException);
+
+	// switching the precision drops the cached rows
+	kernel->set_float32_row_cache(true);
+	EXPECT_TRUE(kernel->get_float32_row_cache());
+	EXPECT_EQ(kernel->get_row_cache_misses(), 0);
+	EXPECT_THROW(kernel->get_cached_kernel_row<float64_t>(0), ShogunException);
+
+	SGMatrix<float64_t> km = kernel->get_kernel_matrix();
+	SGVector<index_t> rows(num_vectors);
+	rows.range_fill();
+	kernel->cache_kernel_rows(rows);
+	EXPECT_EQ(kernel->get_row_cache_misses(), num_vectors);
+
+	for (index_t i = 0; i < num_vectors; ++i)
+	{
+		auto row = kernel->get_cached_kernel_row<float32_t>(i);
+		ASSERT_EQ(row.size(), num_vectors);
+		for (index_t j = 0; j < num_vectors; ++j)
+			EXPECT_NEAR(row[j], km(i, j), 1E-6);
+	}
+	EXPECT_EQ(kernel->get_row_cache_hits(), num_vectors);
+
+	SG_UNREF(kernel);
+}
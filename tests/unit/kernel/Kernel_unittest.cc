@@ -29,12 +29,19 @@
  */
 
 #include <gtest/gtest.h>
+#include <shogun/base/ShogunEnv.h>
 #include <shogun/lib/common.h>
 #include <shogun/lib/SGVector.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/LinearKernel.h>
+#include <shogun/kernel/PolyKernel.h>
+#include <shogun/kernel/SigmoidKernel.h>
+#include <shogun/kernel/normalizer/SqrtDiagKernelNormalizer.h>
 #include <shogun/mathematics/NormalDistribution.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
+#include <shogun/preprocessor/NormOne.h>
 
 using namespace shogun;
 
@@ -427,3 +434,170 @@ TEST(Kernel, gaussian_get_kernel_matrix)
 
 	SG_UNREF(kernel);
 }
+
+static void check_blocked_kernel_matrix(CKernel* kernel, float64_t tolerance)
+{
+	SGMatrix<float64_t> km=kernel->get_kernel_matrix();
+	ASSERT_EQ(km.num_rows, kernel->get_num_vec_lhs());
+	ASSERT_EQ(km.num_cols, kernel->get_num_vec_rhs());
+	for (index_t i=0; i<km.num_rows; i++)
+		for (index_t j=0; j<km.num_cols; ++j)
+			EXPECT_NEAR(kernel->kernel(i,j), km(i, j), tolerance);
+}
+
+TEST(Kernel, blocked_kernel_matrix_dense_dot_kernels)
+{
+	const int32_t seed = 100;
+	// more than one block of 256 vectors on each side
+	const index_t num_feats_p=300;
+	const index_t num_feats_q=270;
+	const index_t dim=5;
+
+	std::mt19937_64 prng(seed);
+	SGMatrix<float64_t> data_p = generate_std_norm_matrix(num_feats_p, dim, prng);
+	SGMatrix<float64_t> data_q = generate_std_norm_matrix(num_feats_q, dim, prng);
+	CDenseFeatures<float64_t>* feats_p=new CDenseFeatures<float64_t>(data_p);
+	CDenseFeatures<float64_t>* feats_q=new CDenseFeatures<float64_t>(data_q);
+	SG_REF(feats_p);
+	SG_REF(feats_q);
+
+	CKernel* kernels[]={
+		new CLinearKernel(), new CPolyKernel(10, 3, 1.0, 0.5),
+		new CSigmoidKernel(10, 0.1, 0.5), new CGaussianKernel(10, 2.0)};
+
+	for (auto kernel : kernels)
+	{
+		SG_REF(kernel);
+		kernel->init(feats_p, feats_q);
+		check_blocked_kernel_matrix(kernel, 1E-12);
+		kernel->init(feats_p, feats_p);
+		check_blocked_kernel_matrix(kernel, 1E-12);
+		SG_UNREF(kernel);
+	}
+
+	SG_UNREF(feats_p);
+	SG_UNREF(feats_q);
+}
+
+TEST(Kernel, blocked_kernel_matrix_normalizer_and_subset)
+{
+	const int32_t seed = 100;
+	const index_t num_feats=300;
+	const index_t dim=4;
+
+	std::mt19937_64 prng(seed);
+	SGMatrix<float64_t> data = generate_std_norm_matrix(num_feats, dim, prng);
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+
+	CLinearKernel* kernel=new CLinearKernel(feats, feats);
+	kernel->set_normalizer(new CSqrtDiagKernelNormalizer());
+	kernel->init(feats, feats);
+	check_blocked_kernel_matrix(kernel, 1E-12);
+
+	// subsets fall back to the per-entry path
+	SGVector<index_t> subset(num_feats/2);
+	for (index_t i=0; i<subset.vlen; i++)
+		subset[i]=2*i;
+	feats->add_subset(subset);
+	kernel->init(feats, feats);
+	check_blocked_kernel_matrix(kernel, 1E-12);
+
+	SG_UNREF(kernel);
+}
+
+TEST(Kernel, blocked_kernel_matrix_unapplied_preprocessor)
+{
+	const int32_t seed = 100;
+	const index_t num_feats=300;
+	const index_t dim=4;
+
+	std::mt19937_64 prng(seed);
+	SGMatrix<float64_t> data = generate_std_norm_matrix(num_feats, dim, prng);
+	SGMatrix<float64_t> normalized = data.clone();
+	for (index_t i=0; i<num_feats; i++)
+	{
+		SGVector<float64_t> x = normalized.get_column(i);
+		linalg::scale(x, x, 1.0/linalg::norm(x));
+		normalized.set_column(i, x);
+	}
+
+	// the preprocessor is applied on the fly by get_feature_vector()
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+	CNormOne* preproc=new CNormOne();
+	preproc->fit(feats);
+	feats->add_preprocessor(preproc);
+	CDenseFeatures<float64_t>* expected_feats=new CDenseFeatures<float64_t>(normalized);
+	SG_REF(feats);
+	SG_REF(expected_feats);
+
+	CKernel* kernels[]={
+		new CLinearKernel(), new CPolyKernel(10, 3, 1.0, 0.5),
+		new CSigmoidKernel(10, 0.1, 0.5), new CGaussianKernel(10, 2.0)};
+
+	for (auto kernel : kernels)
+	{
+		SG_REF(kernel);
+		kernel->init(expected_feats, expected_feats);
+		SGMatrix<float64_t> expected=kernel->get_kernel_matrix();
+
+		kernel->init(feats, feats);
+		check_blocked_kernel_matrix(kernel, 1E-12);
+		SGMatrix<float64_t> km=kernel->get_kernel_matrix();
+		for (index_t i=0; i<num_feats*num_feats; i++)
+			EXPECT_NEAR(km[i], expected[i], 1E-12);
+		SG_UNREF(kernel);
+	}
+
+	SG_UNREF(feats);
+	SG_UNREF(expected_feats);
+}
+
+#ifdef USE_SVMLIGHT
+TEST(Kernel, svmlight_kernel_cache_rows)
+{
+	const int32_t seed = 100;
+	const index_t num_feats=1500;
+	const index_t dim=3;
+
+	std::mt19937_64 prng(seed);
+	SGMatrix<float64_t> data = generate_std_norm_matrix(num_feats, dim, prng);
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+	CGaussianKernel* kernel=new CGaussianKernel(feats, feats, 2.0);
+
+	const int32_t num_threads=env()->get_num_threads();
+	env()->set_num_threads(4);
+	kernel->kernel_cache_init(10);
+
+	// a working set, every other example is active
+	SGVector<int32_t> rows(20);
+	for (index_t i=0; i<rows.vlen; i++)
+		rows[i]=i*71;
+	kernel->cache_multiple_kernel_rows(rows.vector, rows.vlen);
+
+	SGVector<int32_t> active2dnum(num_feats/2+1);
+	for (index_t i=0; i<num_feats/2; i++)
+		active2dnum[i]=2*i;
+	active2dnum[num_feats/2]=-1;
+
+	SGVector<float64_t> buffer(num_feats);
+	// cached rows, followed by rows that are not cached
+	for (auto row : {0, 71, 497, 1349, 3, 1000})
+	{
+		buffer.zero();
+		kernel->get_kernel_row(row, active2dnum.vector, buffer.vector);
+		for (index_t i=0; i<num_feats; i++)
+		{
+			float64_t expected = i%2==0 ? kernel->kernel(row, i) : 0;
+			EXPECT_NEAR(expected, buffer[i], 1E-6);
+		}
+
+		kernel->get_kernel_row(row, NULL, buffer.vector, true);
+		for (index_t i=0; i<num_feats; i++)
+			EXPECT_NEAR(kernel->kernel(row, i), buffer[i], 1E-6);
+	}
+
+	kernel->kernel_cache_cleanup();
+	env()->set_num_threads(num_threads);
+	SG_UNREF(kernel);
+}
+#endif // USE_SVMLIGHT
@@ -54,3 +54,35 @@ TEST(DelimiterTokenizerTest, tokenization)
 	ASSERT_EQ(token_in_tokens, 5);
 	SG_UNREF(tokenizer);
 }
+
+TEST(DelimiterTokenizerTest, token_spans)
+{
+	const char* text = "	This is  	the ultimate test!	";
+	SGVector<char> cv(const_cast<char* >(text), 30, false);
+
+	CDelimiterTokenizer* tokenizer = new CDelimiterTokenizer();
+	tokenizer->init_for_whitespace();
+	tokenizer->set_skip_delimiters(true);
+	tokenizer->set_text(cv);
+
+	std::vector<index_t> starts;
+	std::vector<index_t> ends;
+	index_t num_tokens = tokenizer->next_token_spans(starts, ends);
+	EXPECT_FALSE(tokenizer->has_next());
+
+	tokenizer->set_text(cv);
+	index_t token_start = 0;
+	index_t token = 0;
+	while (tokenizer->has_next())
+	{
+		index_t token_end = tokenizer->next_token_idx(token_start);
+		ASSERT_LT(token, num_tokens);
+		EXPECT_EQ(token_start, starts[token]);
+		EXPECT_EQ(token_end, ends[token]);
+		token++;
+	}
+
+	EXPECT_EQ(5, num_tokens);
+	EXPECT_EQ(num_tokens, token);
+	SG_UNREF(tokenizer);
+}
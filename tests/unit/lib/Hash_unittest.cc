@@ -0,0 +1,49 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/lib/Hash.h>
+#include <shogun/lib/SGVector.h>
+
+#include <random>
+#include <vector>
+
+using namespace shogun;
+
+TEST(HashTest, batch_murmur_hash)
+{
+	std::mt19937_64 prng(7);
+	std::uniform_int_distribution<int32_t> byte(0, 255);
+	std::uniform_int_distribution<index_t> length(0, 40);
+
+	SGVector<uint8_t> data(4096);
+	for (index_t i=0; i<data.vlen; i++)
+		data[i] = byte(prng);
+
+	// spans of all lengths, so that both the interleaved groups and
+	// the remainder see tails of every size
+	std::vector<index_t> starts;
+	std::vector<index_t> ends;
+	index_t pos = 0;
+	while (true)
+	{
+		index_t len = length(prng);
+		if (pos+len > data.vlen)
+			break;
+		starts.push_back(pos);
+		ends.push_back(pos+len);
+		pos += len/2 + 1;
+	}
+
+	const int32_t num = starts.size();
+	const uint32_t seed = 0xdeadbeaf;
+	std::vector<uint32_t> hashes(num);
+	CHash::BatchMurmurHash3(data.vector, starts.data(), ends.data(), num, seed, hashes.data());
+
+	for (int32_t i=0; i<num; i++)
+	{
+		EXPECT_EQ(CHash::MurmurHash3(data.vector+starts[i], ends[i]-starts[i], seed),
+				hashes[i]);
+	}
+}
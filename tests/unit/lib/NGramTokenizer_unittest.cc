@@ -29,3 +29,30 @@ TEST(NGramTokenizerTest, tokenization)
 
 	SG_UNREF(tokenizer);
 }
+
+TEST(NGramTokenizerTest, token_spans)
+{
+	const char* text = "This is the ultimate test!";
+	SGVector<char> cv(const_cast<char* >(text), 26, false);
+
+	int32_t n = 3;
+	CNGramTokenizer* tokenizer = new CNGramTokenizer(n);
+	tokenizer->set_text(cv);
+
+	std::vector<index_t> starts;
+	std::vector<index_t> ends;
+	index_t num_tokens = tokenizer->next_token_spans(starts, ends);
+	EXPECT_FALSE(tokenizer->has_next());
+
+	// every ngram of the text, as returned by next_token_idx()
+	ASSERT_EQ(num_tokens, 26-n+1);
+	ASSERT_EQ(starts.size(), num_tokens);
+	ASSERT_EQ(ends.size(), num_tokens);
+	for (index_t i=0; i<num_tokens; i++)
+	{
+		EXPECT_EQ(starts[i], i);
+		EXPECT_EQ(ends[i], i+n);
+	}
+
+	SG_UNREF(tokenizer);
+}
@@ -179,3 +179,28 @@ TEST_F(StochasticGBMachine, sinusoid_curve_fitting_subset_fraction)
 	EXPECT_NEAR(ret[8], -0.4408978052, epsilon);
 	EXPECT_NEAR(ret[9], 0.5380825978, epsilon);
 }
+
+TEST_F(StochasticGBMachine, sinusoid_curve_fitting_compiled)
+{
+	const int32_t seed = 2855;
+
+	SGVector<bool> ft(1);
+	ft[0] = false;
+	CCARTree* tree = new CCARTree(ft);
+	tree->set_max_depth(2);
+	CSquaredLoss* sq = new CSquaredLoss();
+	auto sgbm = some<CStochasticGBMachine>(tree, sq, 100, 0.1, 1.0);
+	sgbm->put("seed", seed);
+	sgbm->set_labels(train_labels);
+	sgbm->train(train_feats);
+
+	auto ret_labels = wrap(sgbm->apply_regression(test_feats));
+	sgbm->compile_trees();
+	EXPECT_TRUE(sgbm->is_compiled());
+	auto compiled_labels = wrap(sgbm->apply_regression(test_feats));
+
+	SGVector<float64_t> ret = ret_labels->get_labels();
+	SGVector<float64_t> compiled = compiled_labels->get_labels();
+	for (index_t i = 0; i < num_test_samples; i++)
+		EXPECT_NEAR(ret[i], compiled[i], epsilon);
+}
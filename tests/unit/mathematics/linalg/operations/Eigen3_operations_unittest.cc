@@ -2,6 +2,7 @@
 
 #include <shogun/base/range.h>
 #include <shogun/lib/config.h>
+#include <shogun/lib/SGSparseMatrix.h>
 #include <shogun/lib/exception/ShogunException.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/linalg/LinalgNamespace.h>
@@ -1151,6 +1152,76 @@ TYPED_TEST(
 		EXPECT_NEAR(x[i], ref[i], get_epsilon<TypeParam>());
 }
 
+TYPED_TEST(LinalgBackendEigenAllTypesTest, SGSparseMatrix_SGVector_matrix_prod)
+{
+	const index_t rows = 4;
+	const index_t cols = 3;
+
+	SGMatrix<TypeParam> A(rows, cols);
+	SGVector<TypeParam> b(cols);
+	SGVector<TypeParam> c(rows);
+
+	for (index_t i = 0; i < cols; ++i)
+	{
+		for (index_t j = 0; j < rows; ++j)
+			A(j, i) = (i + j) % 2 ? 0 : i * rows + j;
+		b[i] = 2 * i;
+	}
+	for (index_t j = 0; j < rows; ++j)
+		c[j] = j + 1;
+
+	SGSparseMatrix<TypeParam> S(A);
+	auto x = matrix_prod(S, b);
+	auto ref = matrix_prod(A, b);
+	auto y = matrix_prod(S, c, true);
+	auto ref_transpose = matrix_prod(A, c, true);
+
+	EXPECT_EQ(rows, x.vlen);
+	for (index_t j = 0; j < rows; ++j)
+		EXPECT_EQ(ref[j], x[j]);
+
+	EXPECT_EQ(cols, y.vlen);
+	for (index_t i = 0; i < cols; ++i)
+		EXPECT_EQ(ref_transpose[i], y[i]);
+
+	SGVector<TypeParam> wrong(rows + 1);
+	EXPECT_THROW(matrix_prod(S, b, wrong), ShogunException);
+}
+
+TYPED_TEST(LinalgBackendEigenAllTypesTest, SGSparseMatrix_SGMatrix_matrix_prod)
+{
+	const index_t rows = 5;
+	const index_t cols = 4;
+	const index_t dim = 3;
+
+	SGMatrix<TypeParam> A(rows, cols);
+	SGMatrix<TypeParam> B(cols, dim);
+	SGMatrix<TypeParam> C(rows, dim);
+
+	for (index_t i = 0; i < rows * cols; ++i)
+		A[i] = i % 3 ? 0 : i;
+	for (index_t i = 0; i < cols * dim; ++i)
+		B[i] = i;
+	for (index_t i = 0; i < rows * dim; ++i)
+		C[i] = i % 4;
+
+	SGSparseMatrix<TypeParam> S(A);
+	auto X = matrix_prod(S, B);
+	auto ref = matrix_prod(A, B);
+	auto Y = matrix_prod(S, C, true);
+	auto ref_transpose = matrix_prod(A, C, true);
+
+	EXPECT_EQ(rows, X.num_rows);
+	EXPECT_EQ(dim, X.num_cols);
+	for (index_t i = 0; i < rows * dim; ++i)
+		EXPECT_EQ(ref[i], X[i]);
+
+	EXPECT_EQ(cols, Y.num_rows);
+	EXPECT_EQ(dim, Y.num_cols);
+	for (index_t i = 0; i < cols * dim; ++i)
+		EXPECT_EQ(ref_transpose[i], Y[i]);
+}
+
 TYPED_TEST(LinalgBackendEigenAllTypesTest, SGMatrix_matrix_product)
 {
 	const index_t dim1 = 2, dim2 = 4, dim3 = 2;
@@ -8,6 +8,9 @@
 #include <shogun/labels/BinaryLabels.h>
 #include <shogun/features/DataGenerator.h>
 #include <shogun/mathematics/RandomNamespace.h>
+#include "../utils/Utils.h"
+
+#include <cstdio>
 
 using namespace shogun;
 
@@ -109,6 +112,25 @@ TEST_F(KNNTest, kdtree_solver)
 	SG_UNREF(output);
 }
 
+TEST_F(KNNTest, kdtree_solver_index)
+{
+	char fname[] = "KNN_kdtree_index.XXXXXX";
+	generate_temp_filename(fname);
+
+	auto knn = some<CKNN>(k, distance, labels, KNN_KDTREE);
+	knn->train(features);
+	knn->save_index(fname);
+	knn->load_index(fname);
+	auto output = knn->apply(features_test)->as<CMulticlassLabels>();
+	SG_REF(output);
+
+	for ( index_t i = 0; i < labels_test->get_num_labels(); ++i )
+		EXPECT_EQ(output->get_label(i), ((CMulticlassLabels*)labels_test)->get_label(i));
+
+	SG_UNREF(output);
+	std::remove(fname);
+}
+
 TEST_F(KNNTest, lsh_solver)
 {
 	auto knn = some<CKNN>(k, distance, labels, KNN_LSH);
@@ -7,6 +7,7 @@
 #include <shogun/base/ShogunEnv.h>
 #include <shogun/multiclass/MulticlassLibLinear.h>
 #include <shogun/features/DenseFeatures.h>
+#include <shogun/features/SparseFeatures.h>
 #include <shogun/mathematics/NormalDistribution.h>
 
 using namespace shogun;
@@ -66,3 +67,58 @@ TEST(MulticlassLibLinearTest,train_and_apply)
 	SG_UNREF(labels_test);
 	SG_UNREF(pred);
 }
+
+TEST(MulticlassLibLinearTest, batched_outputs)
+{
+	index_t num_vec=60;
+	index_t num_feat=7;
+	index_t num_class=4;
+
+	SGMatrix<float64_t> matrix(num_feat, num_vec);
+	CMulticlassLabels* labels=new CMulticlassLabels(num_vec);
+	std::mt19937_64 prng(7);
+	NormalDistribution<float64_t> normal_dist;
+	for (index_t i=0; i<num_vec; ++i)
+	{
+		labels->set_label(i, i%num_class);
+		for (index_t j=0; j<num_feat; ++j)
+			matrix(j, i)=normal_dist(prng)+(j==i%num_class ? 3 : 0);
+	}
+
+	CDenseFeatures<float64_t>* features=new CDenseFeatures<float64_t>(matrix);
+	CMulticlassLibLinear* mll=new CMulticlassLibLinear(1.0, features, labels);
+	SG_REF(mll);
+	mll->train();
+
+	// scores of every class, computed one machine and vector at a time
+	SGMatrix<float64_t> expected(num_class, num_vec);
+	for (index_t c=0; c<num_class; ++c)
+	{
+		CLinearMachine* machine=mll->get_machine(c)->as<CLinearMachine>();
+		SGVector<float64_t> w=machine->get_w();
+		for (index_t i=0; i<num_vec; ++i)
+		{
+			expected(c, i)=machine->get_bias();
+			for (index_t j=0; j<num_feat; ++j)
+				expected(c, i)+=w[j]*matrix(j, i);
+		}
+		SG_UNREF(machine);
+	}
+
+	auto sparse=new CSparseFeatures<float64_t>(features);
+	CDotFeatures* test_features[]={features, sparse};
+	for (auto feats : test_features)
+	{
+		CMulticlassLabels* pred=mll->apply_multiclass(feats);
+		for (index_t i=0; i<num_vec; ++i)
+		{
+			SGVector<float64_t> confidences=pred->get_multiclass_confidences(i);
+			ASSERT_EQ(confidences.vlen, num_class);
+			for (index_t c=0; c<num_class; ++c)
+				EXPECT_NEAR(confidences[c], expected(c, i), 1e-10);
+		}
+		SG_UNREF(pred);
+	}
+
+	SG_UNREF(mll);
+}
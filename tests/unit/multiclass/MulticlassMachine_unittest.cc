@@ -0,0 +1,242 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/classifier/svm/LibLinear.h>
+#include <shogun/classifier/svm/LibSVM.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/labels/BinaryLabels.h>
+#include <shogun/labels/MulticlassLabels.h>
+#include <shogun/machine/KernelMulticlassMachine.h>
+#include <shogun/machine/LinearMulticlassMachine.h>
+#include <shogun/mathematics/NormalDistribution.h>
+#include <shogun/multiclass/MulticlassLibSVM.h>
+#include <shogun/multiclass/MulticlassOneVsOneStrategy.h>
+#include <shogun/multiclass/MulticlassOneVsRestStrategy.h>
+
+#include <random>
+
+using namespace shogun;
+
+class MulticlassMachineTest : public ::testing::Test
+{
+protected:
+	void SetUp()
+	{
+		std::mt19937_64 prng(57);
+		NormalDistribution<float64_t> normal;
+
+		// every class is shifted along its own direction, so that each of the
+		// binary subproblems trained in parallel has a different solution
+		SGMatrix<float64_t> data(dim, num_vecs);
+		labels=new CMulticlassLabels(num_vecs);
+		for (index_t i=0; i<num_vecs; ++i)
+		{
+			const index_t label=i%num_classes;
+			labels->set_label(i, label);
+			for (index_t j=0; j<dim; ++j)
+				data(j, i)=normal(prng);
+			data(label%dim, i)+=label<dim ? 2 : -2;
+		}
+
+		features=new CDenseFeatures<float64_t>(data);
+		SG_REF(features);
+		SG_REF(labels);
+		num_threads=env()->get_num_threads();
+	}
+
+	void TearDown()
+	{
+		env()->set_num_threads(num_threads);
+		SG_UNREF(features);
+		SG_UNREF(labels);
+	}
+
+	const index_t dim=3;
+	const index_t num_classes=6;
+	const index_t num_vecs=300;
+	int32_t num_threads;
+	CDenseFeatures<float64_t>* features;
+	CMulticlassLabels* labels;
+};
+
+TEST_F(MulticlassMachineTest, kernel_one_vs_rest_parallel)
+{
+	CKernelMulticlassMachine* machines[2];
+	for (int32_t k=0; k<2; ++k)
+	{
+		env()->set_num_threads(k ? 4 : 1);
+		auto kernel=new CGaussianKernel(features, features, 2.0);
+		machines[k]=new CKernelMulticlassMachine(
+			new CMulticlassOneVsRestStrategy(), kernel, new CLibSVM(), labels);
+		SG_REF(machines[k]);
+		machines[k]->train();
+	}
+
+	ASSERT_EQ(num_classes, machines[0]->get_num_machines());
+	ASSERT_EQ(num_classes, machines[1]->get_num_machines());
+	for (int32_t i=0; i<num_classes; ++i)
+	{
+		auto serial=machines[0]->get_machine(i)->as<CKernelMachine>();
+		auto parallel=machines[1]->get_machine(i)->as<CKernelMachine>();
+
+		ASSERT_EQ(serial->get_num_support_vectors(), parallel->get_num_support_vectors());
+		EXPECT_NEAR(serial->get_bias(), parallel->get_bias(), 1e-10);
+		for (int32_t j=0; j<serial->get_num_support_vectors(); ++j)
+		{
+			EXPECT_EQ(serial->get_support_vector(j), parallel->get_support_vector(j));
+			EXPECT_NEAR(serial->get_alpha(j), parallel->get_alpha(j), 1e-10);
+		}
+
+		SG_UNREF(serial);
+		SG_UNREF(parallel);
+	}
+
+	SG_UNREF(machines[0]);
+	SG_UNREF(machines[1]);
+}
+
+TEST_F(MulticlassMachineTest, kernel_batched_outputs)
+{
+	auto kernel=new CGaussianKernel(features, features, 2.0);
+	auto machine=new CKernelMulticlassMachine(
+		new CMulticlassOneVsRestStrategy(), kernel, new CLibSVM(), labels);
+	SG_REF(machine);
+	machine->train();
+
+	auto result=machine->apply_multiclass(features);
+	for (int32_t i=0; i<num_classes; ++i)
+	{
+		auto submachine=machine->get_machine(i)->as<CKernelMachine>();
+		auto outputs=submachine->apply_binary(features);
+		for (index_t j=0; j<num_vecs; ++j)
+			EXPECT_NEAR(outputs->get_value(j), result->get_multiclass_confidences(j)[i], 1e-10);
+
+		SG_UNREF(outputs);
+		SG_UNREF(submachine);
+	}
+
+	SG_UNREF(result);
+	SG_UNREF(machine);
+}
+
+TEST_F(MulticlassMachineTest, linear_one_vs_one_parallel)
+{
+	CLinearMulticlassMachine* machines[2];
+	for (int32_t k=0; k<2; ++k)
+	{
+		env()->set_num_threads(k ? 4 : 1);
+		auto svm=new CLibLinear(L2R_L2LOSS_SVC);
+		svm->set_bias_enabled(true);
+		machines[k]=new CLinearMulticlassMachine(
+			new CMulticlassOneVsOneStrategy(), features, svm, labels);
+		SG_REF(machines[k]);
+		machines[k]->train();
+	}
+
+	ASSERT_EQ(num_classes*(num_classes-1)/2, machines[0]->get_num_machines());
+	ASSERT_EQ(machines[0]->get_num_machines(), machines[1]->get_num_machines());
+	for (int32_t i=0; i<machines[0]->get_num_machines(); ++i)
+	{
+		auto serial=machines[0]->get_machine(i)->as<CLinearMachine>();
+		auto parallel=machines[1]->get_machine(i)->as<CLinearMachine>();
+
+		SGVector<float64_t> w=serial->get_w();
+		SGVector<float64_t> parallel_w=parallel->get_w();
+		ASSERT_EQ(w.vlen, parallel_w.vlen);
+		for (index_t j=0; j<w.vlen; ++j)
+			EXPECT_NEAR(w[j], parallel_w[j], 1e-10);
+		EXPECT_NEAR(serial->get_bias(), parallel->get_bias(), 1e-10);
+
+		SG_UNREF(serial);
+		SG_UNREF(parallel);
+	}
+
+	auto serial_result=machines[0]->apply_multiclass(features);
+	auto parallel_result=machines[1]->apply_multiclass(features);
+	for (index_t j=0; j<num_vecs; ++j)
+		EXPECT_EQ(serial_result->get_label(j), parallel_result->get_label(j));
+
+	// the original features are not left with a subset
+	EXPECT_EQ(num_vecs, features->get_num_vectors());
+
+	SG_UNREF(serial_result);
+	SG_UNREF(parallel_result);
+	SG_UNREF(machines[0]);
+	SG_UNREF(machines[1]);
+}
+
+TEST_F(MulticlassMachineTest, libsvm_kernel_row_cache)
+{
+	CMulticlassLibSVM* machines[2];
+	for (int32_t k=0; k<2; ++k)
+	{
+		env()->set_num_threads(k ? 4 : 1);
+		auto kernel=new CGaussianKernel(features, features, 2.0);
+		machines[k]=new CMulticlassLibSVM(1.0, kernel, labels);
+		machines[k]->set_use_kernel_row_cache(k==1);
+		SG_REF(machines[k]);
+		machines[k]->train();
+	}
+
+	auto serial_result=machines[0]->apply_multiclass(features);
+	auto parallel_result=machines[1]->apply_multiclass(features);
+	for (index_t j=0; j<num_vecs; ++j)
+	{
+		EXPECT_EQ(serial_result->get_label(j), parallel_result->get_label(j));
+		SGVector<float64_t> serial_conf=serial_result->get_multiclass_confidences(j);
+		SGVector<float64_t> parallel_conf=parallel_result->get_multiclass_confidences(j);
+		for (index_t i=0; i<serial_conf.vlen; ++i)
+			EXPECT_NEAR(serial_conf[i], parallel_conf[i], 1e-10);
+	}
+
+	SG_UNREF(serial_result);
+	SG_UNREF(parallel_result);
+	SG_UNREF(machines[0]);
+	SG_UNREF(machines[1]);
+}
+
+TEST_F(MulticlassMachineTest, linear_default_solver_threads)
+{
+	CLinearMulticlassMachine* machines[2];
+	for (int32_t k=0; k<2; ++k)
+	{
+		env()->set_num_threads(k ? 4 : 1);
+		auto svm=new CLibLinear();
+		svm->put("seed", 17);
+		svm->set_bias_enabled(true);
+		svm->set_max_train_time(60);
+		machines[k]=new CLinearMulticlassMachine(
+			new CMulticlassOneVsRestStrategy(), features, svm, labels);
+		SG_REF(machines[k]);
+		machines[k]->train();
+	}
+
+	ASSERT_EQ(num_classes, machines[0]->get_num_machines());
+	ASSERT_EQ(num_classes, machines[1]->get_num_machines());
+	for (int32_t i=0; i<num_classes; ++i)
+	{
+		auto serial=machines[0]->get_machine(i)->as<CLinearMachine>();
+		auto parallel=machines[1]->get_machine(i)->as<CLinearMachine>();
+
+		EXPECT_EQ(60, serial->get_max_train_time());
+		EXPECT_EQ(60, parallel->get_max_train_time());
+
+		SGVector<float64_t> w=serial->get_w();
+		SGVector<float64_t> parallel_w=parallel->get_w();
+		ASSERT_EQ(w.vlen, parallel_w.vlen);
+		for (index_t j=0; j<w.vlen; ++j)
+			EXPECT_NEAR(w[j], parallel_w[j], 1e-10);
+		EXPECT_NEAR(serial->get_bias(), parallel->get_bias(), 1e-10);
+
+		SG_UNREF(serial);
+		SG_UNREF(parallel);
+	}
+
+	SG_UNREF(machines[0]);
+	SG_UNREF(machines[1]);
+}
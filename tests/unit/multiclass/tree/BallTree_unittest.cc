@@ -33,6 +33,8 @@
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/multiclass/tree/BallTree.h>
 
+#include <random>
+
 using namespace shogun;
 
 TEST(BallTree,tree_structure)
@@ -115,3 +117,48 @@ TEST(BallTree, knn_query)
 	SG_UNREF(feats);
 	SG_UNREF(tree);
 }
+
+TEST(BallTree, knn_query_dual)
+{
+	const int32_t dim=3;
+	const int32_t num_ref=1000;
+	const int32_t num_query=300;
+	const int32_t k=5;
+
+	std::mt19937_64 prng(12);
+	std::uniform_real_distribution<float64_t> uniform(-10, 10);
+	SGMatrix<float64_t> data(dim,num_ref);
+	for (index_t i=0;i<data.num_rows*data.num_cols;i++)
+		data[i]=uniform(prng);
+
+	SGMatrix<float64_t> test_data(dim,num_query);
+	for (index_t i=0;i<test_data.num_rows*test_data.num_cols;i++)
+		test_data[i]=uniform(prng);
+
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+	CDenseFeatures<float64_t>* qfeats=new CDenseFeatures<float64_t>(test_data);
+
+	CBallTree* tree=new CBallTree(10);
+	tree->build_tree(feats);
+
+	tree->query_knn(qfeats,k);
+	SGMatrix<index_t> ind=tree->get_knn_indices().clone();
+	SGMatrix<float64_t> dists=tree->get_knn_dists().clone();
+
+	tree->query_knn_dual(qfeats,k);
+	SGMatrix<index_t> ind_dual=tree->get_knn_indices();
+	SGMatrix<float64_t> dists_dual=tree->get_knn_dists();
+
+	for (index_t i=0;i<num_query;i++)
+	{
+		for (index_t j=0;j<k;j++)
+		{
+			EXPECT_EQ(ind(j,i),ind_dual(j,i));
+			EXPECT_NEAR(dists(j,i),dists_dual(j,i),1E-12);
+		}
+	}
+
+	SG_UNREF(qfeats);
+	SG_UNREF(feats);
+	SG_UNREF(tree);
+}
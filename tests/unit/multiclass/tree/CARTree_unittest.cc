@@ -31,7 +31,9 @@
 #include <gtest/gtest.h>
 #include <shogun/base/some.h>
 #include <shogun/features/DenseFeatures.h>
+#include <shogun/labels/RegressionLabels.h>
 #include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/exception/ShogunException.h>
 #include <shogun/multiclass/tree/CARTree.h>
 
 #include <random>
@@ -641,3 +643,298 @@ TEST(CARTree,cv_prune_simple)
 	SG_UNREF(c);
 	SG_UNREF(root);
 }
+
+TEST(CARTree, histogram_quantize)
+{
+	const index_t num_vecs=1000;
+	std::mt19937_64 prng(57);
+	std::uniform_real_distribution<float64_t> uniform(-5, 5);
+
+	SGMatrix<float64_t> data(2,num_vecs);
+	for (index_t i=0;i<num_vecs;++i)
+	{
+		data(0,i)=uniform(prng);
+		// few distinct values get one bin each
+		data(1,i)=i%7;
+	}
+	data(0,3)=CCARTree::MISSING;
+
+	auto feats = some<CDenseFeatures<float64_t>>(data);
+	auto c = some<CCARTree>();
+	c->set_max_bins(16);
+
+	SGMatrix<uint8_t> binned;
+	SGMatrix<float64_t> thresholds;
+	SGVector<int32_t> num_bins;
+	c->quantize_features(feats, binned, thresholds, num_bins);
+
+	EXPECT_EQ(num_vecs, binned.num_rows);
+	EXPECT_EQ(2, binned.num_cols);
+	EXPECT_LE(num_bins[0], 16);
+	EXPECT_GT(num_bins[0], 8);
+	EXPECT_EQ(7, num_bins[1]);
+
+	for (index_t f=0;f<2;++f)
+	{
+		for (index_t b=1;b<num_bins[f];++b)
+			EXPECT_LT(thresholds(b-1,f), thresholds(b,f));
+
+		for (index_t i=0;i<num_vecs;++i)
+		{
+			if (data(f,i)==CCARTree::MISSING)
+			{
+				EXPECT_EQ(255, binned(i,f));
+				continue;
+			}
+
+			index_t b=binned(i,f);
+			ASSERT_LT(b, num_bins[f]);
+			EXPECT_LE(data(f,i), thresholds(b,f));
+			if (b>0)
+				EXPECT_GT(data(f,i), thresholds(b-1,f));
+		}
+	}
+	EXPECT_EQ(4.0, thresholds(4,1));
+}
+
+TEST(CARTree, histogram_classify)
+{
+	const index_t num_vecs=600;
+	std::mt19937_64 prng(23);
+	std::uniform_real_distribution<float64_t> uniform(0, 1);
+
+	// three classes separated by axis aligned boundaries
+	auto generate = [&](SGMatrix<float64_t>& data, SGVector<float64_t>& lab) {
+		for (index_t i=0;i<data.num_cols;++i)
+		{
+			for (index_t j=0;j<data.num_rows;++j)
+				data(j,i)=uniform(prng);
+
+			if (data(0,i)<=0.3)
+				lab[i]=0;
+			else if (data(1,i)<=0.6)
+				lab[i]=1;
+			else
+				lab[i]=2;
+		}
+	};
+
+	SGMatrix<float64_t> data(3,num_vecs);
+	SGVector<float64_t> lab(num_vecs);
+	generate(data, lab);
+	SGMatrix<float64_t> test(3,200);
+	SGVector<float64_t> test_lab(200);
+	generate(test, test_lab);
+
+	SGVector<bool> ft(3);
+	ft.set_const(false);
+
+	auto feats = some<CDenseFeatures<float64_t>>(data);
+	auto test_feats = some<CDenseFeatures<float64_t>>(test);
+	auto labels = some<CMulticlassLabels>(lab);
+
+	auto c = some<CCARTree>();
+	c->set_labels(labels);
+	c->set_feature_types(ft);
+	c->set_use_histograms(true);
+	c->set_max_bins(64);
+	c->train(feats);
+
+	// only the vectors falling into the bins around the boundaries can be
+	// misclassified
+	auto result = c->apply_multiclass(feats);
+	SGVector<float64_t> res_vector=result->get_labels();
+	index_t errors=0;
+	for (index_t i=0;i<num_vecs;++i)
+		errors+=(lab[i]!=res_vector[i]);
+	EXPECT_LE(errors, 10);
+	SG_UNREF(result);
+
+	result = c->apply_multiclass(test_feats);
+	res_vector=result->get_labels();
+	errors=0;
+	for (index_t i=0;i<test_lab.vlen;++i)
+		errors+=(test_lab[i]!=res_vector[i]);
+	EXPECT_LE(errors, 15);
+	SG_UNREF(result);
+}
+
+TEST(CARTree, histogram_regression)
+{
+	const index_t num_vecs=500;
+	std::mt19937_64 prng(31);
+	std::uniform_int_distribution<int32_t> uniform(0, 99);
+
+	SGMatrix<float64_t> data(2,num_vecs);
+	SGVector<float64_t> lab(num_vecs);
+	for (index_t i=0;i<num_vecs;++i)
+	{
+		data(0,i)=uniform(prng);
+		data(1,i)=uniform(prng);
+		lab[i]=(data(0,i)<=40 ? 1.5 : -2.0)+(data(1,i)<=70 ? 0.0 : 3.0);
+	}
+
+	SGVector<bool> ft(2);
+	ft.set_const(false);
+
+	auto feats = some<CDenseFeatures<float64_t>>(data);
+	auto labels = some<CRegressionLabels>(lab);
+
+	auto exact = some<CCARTree>(ft, PT_REGRESSION);
+	exact->set_labels(labels);
+	exact->train(feats);
+
+	// 100 values fit into the bins, so the histograms find the exact splits
+	auto c = some<CCARTree>(ft, PT_REGRESSION);
+	c->set_labels(labels);
+	c->set_use_histograms(true);
+	c->train(feats);
+
+	auto result = c->apply_regression(feats);
+	auto exact_result = exact->apply_regression(feats);
+	SGVector<float64_t> res_vector=result->get_labels();
+	SGVector<float64_t> exact_vector=exact_result->get_labels();
+	for (index_t i=0;i<num_vecs;++i)
+	{
+		EXPECT_NEAR(lab[i], res_vector[i], 1e-10);
+		EXPECT_NEAR(exact_vector[i], res_vector[i], 1e-10);
+	}
+
+	SG_UNREF(result);
+	SG_UNREF(exact_result);
+}
+
+TEST(CARTree, histogram_handle_missing)
+{
+	SGMatrix<float64_t> data(3,9);
+	data(0,0)=1;
+	data(1,0)=3;
+	data(2,0)=6;
+
+	data(0,1)=1;
+	data(1,1)=3;
+	data(2,1)=6;
+
+	data(0,2)=1;
+	data(1,2)=3;
+	data(2,2)=6;
+
+	data(0,3)=2;
+	data(1,3)=5;
+	data(2,3)=7;
+
+	data(0,4)=2;
+	data(1,4)=4;
+	data(2,4)=8;
+
+	data(0,5)=CCARTree::MISSING;
+	data(1,5)=5;
+	data(2,5)=7;
+
+	data(0,6)=3;
+	data(1,6)=4;
+	data(2,6)=8;
+
+	data(0,7)=3;
+	data(1,7)=4;
+	data(2,7)=8;
+
+	data(0,8)=3;
+	data(1,8)=4;
+	data(2,8)=8;
+
+	SGVector<float64_t> lab(9);
+	lab[0]=1;
+	lab[1]=1;
+	lab[2]=1;
+	lab[3]=1;
+	lab[4]=1;
+	lab[5]=1;
+	lab[6]=2;
+	lab[7]=2;
+	lab[8]=2;
+
+	SGVector<bool> ft=SGVector<bool>(3);
+	ft[0]=false;
+	ft[1]=false;
+	ft[2]=false;
+
+	auto feats = some<CDenseFeatures<float64_t>>(data);
+	CMulticlassLabels* labels=new CMulticlassLabels(lab);
+
+	CCARTree* c=new CCARTree();
+	c->set_labels(labels);
+	c->set_feature_types(ft);
+	c->set_use_histograms(true);
+	c->train(feats);
+
+	CBinaryTreeMachineNode<CARTreeNodeData>* root=dynamic_cast<CBinaryTreeMachineNode<CARTreeNodeData>*>(c->get_root());
+	CBinaryTreeMachineNode<CARTreeNodeData>* left=root->left();
+	CBinaryTreeMachineNode<CARTreeNodeData>* right=root->right();
+
+	// the first attribute separates the known values, the missing one goes
+	// left with the majority of its surrogates
+	EXPECT_EQ(0.0,root->data.attribute_id);
+	EXPECT_EQ(9.0,root->data.total_weight);
+	EXPECT_EQ(6.0,left->data.total_weight);
+	EXPECT_EQ(3.0,right->data.total_weight);
+	EXPECT_EQ(2.0,left->data.transit_into_values[0]);
+
+	SG_UNREF(root);
+	SG_UNREF(left);
+	SG_UNREF(right);
+	SG_UNREF(c);
+}
+
+TEST(CARTree, histogram_nominal_many_values)
+{
+	// a nominal feature with 100 values, half of which belong together
+	// regardless of their order
+	const index_t num_vecs=400;
+	SGMatrix<float64_t> data(1,num_vecs);
+	SGVector<float64_t> reg_lab(num_vecs);
+	SGVector<float64_t> lab(num_vecs);
+	for (index_t i=0;i<num_vecs;++i)
+	{
+		const index_t value=i%100;
+		const bool left=(value*37)%100<50;
+		data(0,i)=value;
+		reg_lab[i]=left ? 1.5 : -2.0;
+		lab[i]=left ? 0 : 1;
+	}
+
+	SGVector<bool> ft(1);
+	ft[0]=true;
+	auto feats = some<CDenseFeatures<float64_t>>(data);
+
+	// regression and two classes find the division in a single split
+	auto reg = some<CCARTree>(ft, PT_REGRESSION);
+	reg->set_labels(some<CRegressionLabels>(reg_lab));
+	reg->set_use_histograms(true);
+	reg->set_max_depth(1);
+	reg->train(feats);
+
+	auto reg_result = reg->apply_regression(feats);
+	SGVector<float64_t> reg_vector=reg_result->get_labels();
+	for (index_t i=0;i<num_vecs;++i)
+		EXPECT_NEAR(reg_lab[i], reg_vector[i], 1e-10);
+	SG_UNREF(reg_result);
+
+	auto c = some<CCARTree>(ft, PT_MULTICLASS);
+	c->set_labels(some<CMulticlassLabels>(lab));
+	c->set_use_histograms(true);
+	c->set_max_depth(1);
+	c->train(feats);
+
+	auto result = c->apply_multiclass(feats);
+	SGVector<float64_t> res_vector=result->get_labels();
+	for (index_t i=0;i<num_vecs;++i)
+		EXPECT_EQ(lab[i], res_vector[i]);
+	SG_UNREF(result);
+
+	// with more classes every division would have to be tested
+	for (index_t i=0;i<num_vecs;++i)
+		lab[i]=i%3;
+	c->set_labels(some<CMulticlassLabels>(lab));
+	EXPECT_THROW(c->train(feats), ShogunException);
+}
@@ -0,0 +1,158 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/base/some.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/labels/MulticlassLabels.h>
+#include <shogun/labels/RegressionLabels.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/multiclass/tree/CARTree.h>
+#include <shogun/multiclass/tree/FlatTreeEnsemble.h>
+
+#include <random>
+
+using namespace shogun;
+
+TEST(FlatTreeEnsemble, apply_trees_continuous)
+{
+	const index_t num_vecs=300;
+	std::mt19937_64 prng(7);
+	std::uniform_real_distribution<float64_t> uniform(-1, 1);
+
+	SGMatrix<float64_t> data(3, num_vecs);
+	SGVector<float64_t> lab(num_vecs);
+	for (index_t i=0;i<num_vecs;++i)
+	{
+		for (index_t j=0;j<data.num_rows;++j)
+			data(j,i)=uniform(prng);
+		lab[i]=std::sin(3*data(0,i))+data(1,i)*data(2,i);
+	}
+
+	SGMatrix<float64_t> test(3, 100);
+	for (index_t i=0;i<test.num_cols;++i)
+	{
+		for (index_t j=0;j<test.num_rows;++j)
+			test(j,i)=uniform(prng);
+	}
+
+	SGVector<bool> ft(3);
+	ft.set_const(false);
+	auto feats = some<CDenseFeatures<float64_t>>(data);
+	auto test_feats = some<CDenseFeatures<float64_t>>(test);
+	auto labels = some<CRegressionLabels>(lab);
+
+	auto ensemble = some<CFlatTreeEnsemble>();
+	CRegressionLabels* expected[3];
+	for (int32_t t=0;t<3;++t)
+	{
+		auto tree = some<CCARTree>(ft, PT_REGRESSION);
+		tree->set_max_depth(2+2*t);
+		tree->set_labels(labels);
+		tree->train(feats);
+		expected[t]=tree->apply_regression(test_feats);
+		ensemble->add_tree(tree);
+	}
+	EXPECT_EQ(3, ensemble->get_num_trees());
+
+	SGMatrix<float64_t> outputs=ensemble->apply_trees(test_feats);
+	ASSERT_EQ(test.num_cols, outputs.num_rows);
+	ASSERT_EQ(3, outputs.num_cols);
+
+	SGVector<float64_t> weights(3);
+	weights[0]=0.5;
+	weights[1]=-1.0;
+	weights[2]=2.0;
+	SGVector<float64_t> sums=ensemble->apply_sum(test_feats, weights);
+
+	for (index_t i=0;i<test.num_cols;++i)
+	{
+		float64_t sum=0;
+		for (int32_t t=0;t<3;++t)
+		{
+			EXPECT_EQ(expected[t]->get_label(i), outputs(i,t));
+			sum+=weights[t]*expected[t]->get_label(i);
+		}
+		EXPECT_NEAR(sum, sums[i], 1e-12);
+	}
+
+	for (int32_t t=0;t<3;++t)
+		SG_UNREF(expected[t]);
+}
+
+TEST(FlatTreeEnsemble, apply_trees_nominal)
+{
+	const index_t num_vecs=200;
+	std::mt19937_64 prng(11);
+	std::uniform_int_distribution<int32_t> category(1, 4);
+
+	SGMatrix<float64_t> data(3, num_vecs);
+	SGVector<float64_t> lab(num_vecs);
+	for (index_t i=0;i<num_vecs;++i)
+	{
+		for (index_t j=0;j<data.num_rows;++j)
+			data(j,i)=category(prng);
+		lab[i]=(data(0,i)==2 || data(1,i)>=3) ? 1.0 : 0.0;
+	}
+
+	// mixed nominal and continuous features
+	SGVector<bool> ft(3);
+	ft[0]=true;
+	ft[1]=true;
+	ft[2]=false;
+	auto feats = some<CDenseFeatures<float64_t>>(data);
+	auto labels = some<CMulticlassLabels>(lab);
+
+	auto tree = some<CCARTree>(ft, PT_MULTICLASS);
+	tree->set_labels(labels);
+	tree->train(feats);
+
+	auto ensemble = some<CFlatTreeEnsemble>();
+	ensemble->add_tree(tree);
+
+	auto expected = tree->apply_multiclass(feats);
+	SGMatrix<float64_t> outputs=ensemble->apply_trees(feats);
+	for (index_t i=0;i<num_vecs;++i)
+		EXPECT_EQ(expected->get_label(i), outputs(i,0));
+
+	SG_UNREF(expected);
+}
+
+TEST(FlatTreeEnsemble, float32_thresholds)
+{
+	const index_t num_vecs=300;
+	std::mt19937_64 prng(13);
+	std::uniform_int_distribution<int32_t> uniform(0, 999);
+
+	// integer values are exact in single precision
+	SGMatrix<float64_t> data(2, num_vecs);
+	SGVector<float64_t> lab(num_vecs);
+	for (index_t i=0;i<num_vecs;++i)
+	{
+		data(0,i)=uniform(prng);
+		data(1,i)=uniform(prng);
+		lab[i]=(data(0,i)<=400 ? 1.0 : -1.0)+data(1,i)/1000.0;
+	}
+
+	SGVector<bool> ft(2);
+	ft.set_const(false);
+	auto feats = some<CDenseFeatures<float64_t>>(data);
+	auto labels = some<CRegressionLabels>(lab);
+
+	auto tree = some<CCARTree>(ft, PT_REGRESSION);
+	tree->set_max_depth(6);
+	tree->set_labels(labels);
+	tree->train(feats);
+
+	auto ensemble = some<CFlatTreeEnsemble>(true);
+	ensemble->add_tree(tree);
+	EXPECT_TRUE(ensemble->get_float32_thresholds());
+
+	auto expected = tree->apply_regression(feats);
+	SGMatrix<float64_t> outputs=ensemble->apply_trees(feats);
+	for (index_t i=0;i<num_vecs;++i)
+		EXPECT_EQ(expected->get_label(i), outputs(i,0));
+
+	SG_UNREF(expected);
+}
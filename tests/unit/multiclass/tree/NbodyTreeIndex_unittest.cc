@@ -0,0 +1,153 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/exception/ShogunException.h>
+#include <shogun/multiclass/tree/BallTree.h>
+#include <shogun/multiclass/tree/KDTree.h>
+#include <shogun/multiclass/tree/NbodyTreeIndex.h>
+#include "../../utils/Utils.h"
+
+#include <cstdio>
+#include <random>
+
+using namespace shogun;
+
+void check_index_knn(CNbodyTree* tree, int32_t seed)
+{
+	const int32_t dim=3;
+	const int32_t num_ref=1000;
+	const int32_t num_query=300;
+	const int32_t k=5;
+
+	std::mt19937_64 prng(seed);
+	std::uniform_real_distribution<float64_t> uniform(-10, 10);
+	SGMatrix<float64_t> data(dim,num_ref);
+	for (index_t i=0;i<data.num_rows*data.num_cols;i++)
+		data[i]=uniform(prng);
+
+	SGMatrix<float64_t> test_data(dim,num_query);
+	for (index_t i=0;i<test_data.num_rows*test_data.num_cols;i++)
+		test_data[i]=uniform(prng);
+
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+	CDenseFeatures<float64_t>* qfeats=new CDenseFeatures<float64_t>(test_data);
+	SG_REF(feats);
+	SG_REF(qfeats);
+
+	tree->build_tree(feats);
+	tree->query_knn(qfeats,k);
+	SGMatrix<index_t> ind=tree->get_knn_indices();
+	SGMatrix<float64_t> dists=tree->get_knn_dists();
+
+	char fname[]="NbodyTreeIndex.XXXXXX";
+	generate_temp_filename(fname);
+	tree->save_index(fname);
+
+	CNbodyTreeIndex* index=new CNbodyTreeIndex(fname);
+	EXPECT_EQ(index->get_num_vectors(),num_ref);
+	EXPECT_EQ(index->get_dim(),dim);
+
+	index->query_knn(qfeats,k);
+	SGMatrix<index_t> ind_index=index->get_knn_indices();
+	SGMatrix<float64_t> dists_index=index->get_knn_dists();
+
+	for (index_t i=0;i<num_query;i++)
+	{
+		for (index_t j=0;j<k;j++)
+		{
+			EXPECT_EQ(ind(j,i),ind_index(j,i));
+			EXPECT_NEAR(dists(j,i),dists_index(j,i),1E-12);
+		}
+	}
+
+	SG_UNREF(index);
+	SG_UNREF(qfeats);
+	SG_UNREF(feats);
+	std::remove(fname);
+}
+
+TEST(NbodyTreeIndex, kdtree_knn_query)
+{
+	CKDTree* tree=new CKDTree(10);
+	check_index_knn(tree,12);
+	SG_UNREF(tree);
+}
+
+TEST(NbodyTreeIndex, kdtree_manhattan_knn_query)
+{
+	CKDTree* tree=new CKDTree(10,D_MANHATTAN);
+	check_index_knn(tree,13);
+	SG_UNREF(tree);
+}
+
+TEST(NbodyTreeIndex, balltree_knn_query)
+{
+	CBallTree* tree=new CBallTree(10);
+	check_index_knn(tree,14);
+	SG_UNREF(tree);
+}
+
+TEST(NbodyTreeIndex, invalid_file)
+{
+	char fname[]="NbodyTreeIndex_invalid.XXXXXX";
+	generate_temp_filename(fname);
+
+	FILE* f=fopen(fname,"wb");
+	for (int32_t i=0;i<256;i++)
+		fputc('x',f);
+	fclose(f);
+
+	EXPECT_THROW(new CNbodyTreeIndex(fname),ShogunException);
+	std::remove(fname);
+}
+
+TEST(NbodyTreeIndex, corrupt_nodes)
+{
+	std::mt19937_64 prng(15);
+	std::uniform_real_distribution<float64_t> uniform(-10, 10);
+	SGMatrix<float64_t> data(2,100);
+	for (index_t i=0;i<data.num_rows*data.num_cols;i++)
+		data[i]=uniform(prng);
+
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+	SG_REF(feats);
+	CKDTree* tree=new CKDTree(10);
+	tree->build_tree(feats);
+
+	char fname[]="NbodyTreeIndex_corrupt.XXXXXX";
+	generate_temp_filename(fname);
+	tree->save_index(fname);
+
+	NbodyTreeIndexHeader header;
+	FILE* f=fopen(fname,"r+b");
+	ASSERT_EQ(fread(&header,sizeof(header),1,f),1u);
+
+	// the root's left child pointing back at the root
+	NbodyTreeIndexNode root;
+	fseek(f,header.nodes_offset,SEEK_SET);
+	ASSERT_EQ(fread(&root,sizeof(root),1,f),1u);
+	ASSERT_FALSE(root.is_leaf);
+	NbodyTreeIndexNode corrupt=root;
+	corrupt.left=0;
+	fseek(f,header.nodes_offset,SEEK_SET);
+	fwrite(&corrupt,sizeof(corrupt),1,f);
+	fflush(f);
+	EXPECT_THROW(new CNbodyTreeIndex(fname),ShogunException);
+
+	// a vector index beyond the data
+	fseek(f,header.nodes_offset,SEEK_SET);
+	fwrite(&root,sizeof(root),1,f);
+	int64_t vec_id=header.num_vectors;
+	fseek(f,header.vec_id_offset,SEEK_SET);
+	fwrite(&vec_id,sizeof(vec_id),1,f);
+	fclose(f);
+	EXPECT_THROW(new CNbodyTreeIndex(fname),ShogunException);
+
+	SG_UNREF(tree);
+	SG_UNREF(feats);
+	std::remove(fname);
+}
@@ -278,4 +278,84 @@ TEST_F(RandomForest, score_consistent_with_binary_trivial_data)
 	EXPECT_NEAR(1.0, values_vector[9], 1e-1);
 
 	SG_UNREF(result);
-}
\ No newline at end of file
+}
+
+TEST_F(RandomForest, classify_histograms)
+{
+	const index_t num_vecs=500;
+	std::mt19937_64 prng(19);
+	std::uniform_real_distribution<float64_t> uniform(0, 1);
+
+	SGMatrix<float64_t> data(3, num_vecs);
+	SGVector<float64_t> lab(num_vecs);
+	for (index_t i=0;i<num_vecs;++i)
+	{
+		for (index_t j=0;j<data.num_rows;++j)
+			data(j,i)=uniform(prng);
+		lab[i]=(data(0,i)+data(1,i)<=1.0) ? 0.0 : 1.0;
+	}
+
+	// test vectors away from the boundary
+	SGMatrix<float64_t> test(3, 100);
+	SGVector<float64_t> test_lab(100);
+	for (index_t i=0;i<test.num_cols;++i)
+	{
+		do
+		{
+			for (index_t j=0;j<test.num_rows;++j)
+				test(j,i)=uniform(prng);
+		} while (std::abs(test(0,i)+test(1,i)-1.0)<0.1);
+		test_lab[i]=(test(0,i)+test(1,i)<=1.0) ? 0.0 : 1.0;
+	}
+
+	auto feats = some<CDenseFeatures<float64_t>>(data);
+	auto test_feats = some<CDenseFeatures<float64_t>>(test);
+	auto labels = some<CMulticlassLabels>(lab);
+
+	SGVector<bool> ft(3);
+	ft.set_const(false);
+
+	auto c = some<CRandomForest>(feats, labels, 20, 2);
+	c->set_feature_types(ft);
+	c->set_combination_rule(new CMajorityVote());
+	c->set_use_histograms(true);
+	c->put("seed", 19);
+	c->train(feats);
+
+	auto result = c->apply_multiclass(test_feats);
+	SGVector<float64_t> res_vector=result->get_labels();
+	index_t errors=0;
+	for (index_t i=0;i<test_lab.vlen;++i)
+		errors+=(test_lab[i]!=res_vector[i]);
+	EXPECT_LE(errors, 5);
+
+	SG_UNREF(result);
+}
+
+TEST_F(RandomForest, classify_compiled)
+{
+	int32_t seed = 2343;
+	auto c = some<CRandomForest>(weather_features_train, weather_labels_train, 50, 2);
+	c->set_feature_types(weather_ft);
+	c->set_combination_rule(new CMajorityVote());
+	c->put("seed", seed);
+	c->train(weather_features_train);
+
+	auto result = c->apply_multiclass(weather_features_test);
+	EXPECT_FALSE(c->is_compiled());
+	c->compile_trees();
+	EXPECT_TRUE(c->is_compiled());
+	auto compiled_result = c->apply_multiclass(weather_features_test);
+
+	SGVector<float64_t> res_vector=result->get_labels();
+	SGVector<float64_t> compiled_vector=compiled_result->get_labels();
+	for (index_t i=0;i<res_vector.vlen;++i)
+		EXPECT_EQ(res_vector[i], compiled_vector[i]);
+
+	// training again drops the compiled trees
+	c->train(weather_features_train);
+	EXPECT_FALSE(c->is_compiled());
+
+	SG_UNREF(result);
+	SG_UNREF(compiled_result);
+}
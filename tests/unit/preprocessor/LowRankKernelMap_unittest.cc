@@ -0,0 +1,180 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <gtest/gtest.h>
+
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/classifier/svm/LibLinear.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/labels/BinaryLabels.h>
+#include <shogun/mathematics/linalg/LinalgNamespace.h>
+#include <shogun/preprocessor/IncompleteCholesky.h>
+#include <shogun/preprocessor/Nystrom.h>
+
+#include <random>
+
+using namespace shogun;
+
+class LowRankKernelMapTest : public ::testing::Test
+{
+protected:
+	void SetUp()
+	{
+		std::mt19937_64 prng(29);
+		std::normal_distribution<float64_t> normal;
+
+		// an unlabelled cloud, the classification test derives its labels
+		// from the distance to the origin
+		SGMatrix<float64_t> data(dim, num_vecs);
+		for (int64_t i = 0; i < int64_t(dim) * num_vecs; ++i)
+			data.matrix[i] = normal(prng);
+
+		features = new CDenseFeatures<float64_t>(data);
+		kernel = new CGaussianKernel(2.0);
+		SG_REF(features);
+		SG_REF(kernel);
+		num_threads = env()->get_num_threads();
+	}
+
+	void TearDown()
+	{
+		env()->set_num_threads(num_threads);
+		SG_UNREF(features);
+		SG_UNREF(kernel);
+	}
+
+	/* checks that the mapped landmarks reproduce the kernel between the
+	 * landmarks and all vectors */
+	void check_landmarks(CLowRankKernelMap* map, float64_t eps)
+	{
+		SGMatrix<float64_t> mapped = map->apply_to_feature_matrix(features);
+		SGVector<index_t> landmarks = map->get_landmark_indices();
+		ASSERT_EQ(mapped.num_rows, map->get_target_dim());
+		ASSERT_EQ(mapped.num_cols, num_vecs);
+
+		kernel->init(features, features);
+		for (auto p : landmarks)
+		{
+			SGVector<float64_t> phi_p = mapped.get_column(p);
+			for (index_t i = 0; i < num_vecs; ++i)
+			{
+				SGVector<float64_t> phi_i = mapped.get_column(i);
+				EXPECT_NEAR(kernel->kernel(p, i), linalg::dot(phi_p, phi_i), eps);
+			}
+		}
+		kernel->cleanup();
+	}
+
+	const index_t dim = 3;
+	const index_t num_vecs = 200;
+	int32_t num_threads;
+	CDenseFeatures<float64_t>* features;
+	CGaussianKernel* kernel;
+};
+
+TEST_F(LowRankKernelMapTest, nystrom_landmarks)
+{
+	auto nystrom = new CNystrom(kernel, 20);
+	SG_REF(nystrom);
+	nystrom->put("seed", 3);
+	nystrom->fit(features);
+
+	EXPECT_EQ(20, nystrom->get_landmark_indices().vlen);
+	EXPECT_LE(nystrom->get_target_dim(), 20);
+	check_landmarks(nystrom, 1e-6);
+
+	SG_UNREF(nystrom);
+}
+
+TEST_F(LowRankKernelMapTest, incomplete_cholesky)
+{
+	auto cholesky = new CIncompleteCholesky(kernel, 30, 0);
+	SG_REF(cholesky);
+	cholesky->fit(features);
+
+	EXPECT_EQ(30, cholesky->get_target_dim());
+	check_landmarks(cholesky, 1e-6);
+
+	// with a tolerance, the rank adapts to the kernel and the residual
+	// bounds the error of all kernel values
+	auto wide = new CGaussianKernel(10.0);
+	SG_REF(wide);
+	cholesky->set_kernel(wide);
+	cholesky->set_num_landmarks(num_vecs);
+	cholesky->set_tolerance(1e-8);
+	cholesky->fit(features);
+	EXPECT_LT(cholesky->get_target_dim(), num_vecs);
+
+	SGMatrix<float64_t> mapped = cholesky->apply_to_feature_matrix(features);
+	wide->init(features, features);
+	for (index_t i = 0; i < num_vecs; i += 7)
+	{
+		SGVector<float64_t> phi_i = mapped.get_column(i);
+		for (index_t j = 0; j < num_vecs; ++j)
+		{
+			SGVector<float64_t> phi_j = mapped.get_column(j);
+			EXPECT_NEAR(wide->kernel(i, j), linalg::dot(phi_i, phi_j), 1e-6);
+		}
+	}
+	wide->cleanup();
+	SG_UNREF(wide);
+
+	SG_UNREF(cholesky);
+}
+
+TEST_F(LowRankKernelMapTest, threads)
+{
+	auto nystrom = new CNystrom(kernel, 30);
+	SG_REF(nystrom);
+	nystrom->fit(features);
+
+	env()->set_num_threads(1);
+	SGMatrix<float64_t> serial = nystrom->apply_to_feature_matrix(features);
+	env()->set_num_threads(4);
+	SGMatrix<float64_t> parallel = nystrom->apply_to_feature_matrix(features);
+
+	for (int64_t i = 0; i < int64_t(serial.num_rows) * serial.num_cols; ++i)
+		EXPECT_NEAR(serial.matrix[i], parallel.matrix[i], 1e-12);
+
+	SG_UNREF(nystrom);
+}
+
+TEST_F(LowRankKernelMapTest, liblinear_on_nystrom_features)
+{
+	// inside or outside of a sphere, not linearly separable in the input
+	SGMatrix<float64_t> data = features->get_feature_matrix();
+	SGVector<float64_t> lab(num_vecs);
+	for (index_t i = 0; i < num_vecs; ++i)
+	{
+		SGVector<float64_t> x = data.get_column(i);
+		lab[i] = linalg::dot(x, x) > 2.4 ? 1 : -1;
+	}
+	auto labels = new CBinaryLabels(lab);
+	SG_REF(labels);
+
+	auto nystrom = new CNystrom(kernel, 50);
+	SG_REF(nystrom);
+	nystrom->put("seed", 5);
+	nystrom->fit(features);
+	auto mapped = nystrom->transform(features);
+	SG_REF(mapped);
+
+	auto svm = new CLibLinear(10, mapped->as<CDotFeatures>(), labels);
+	SG_REF(svm);
+	svm->set_liblinear_solver_type(L2R_L2LOSS_SVC_DUAL);
+	svm->train();
+
+	auto result = svm->apply_binary(mapped);
+	int32_t num_correct = 0;
+	for (index_t i = 0; i < num_vecs; ++i)
+		num_correct += result->get_label(i) == lab[i];
+	EXPECT_GT(num_correct, 0.9 * num_vecs);
+
+	SG_UNREF(result);
+	SG_UNREF(svm);
+	SG_UNREF(mapped);
+	SG_UNREF(nystrom);
+	SG_UNREF(labels);
+}
@@ -0,0 +1,110 @@
+/*
+ * This software is distributed under BSD 3-clause license (see LICENSE file).
+ */
+
+#include <shogun/lib/config.h>
+
+#ifdef USE_SVMLIGHT
+#include <gtest/gtest.h>
+
+#include <shogun/base/ShogunEnv.h>
+#include <shogun/base/some.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/LinearKernel.h>
+#include <shogun/labels/RegressionLabels.h>
+#include <shogun/mathematics/NormalDistribution.h>
+#include <shogun/regression/svr/SVRLight.h>
+
+#include <random>
+
+using namespace shogun;
+
+class SVRLightTest : public ::testing::Test
+{
+protected:
+	void SetUp()
+	{
+		std::mt19937_64 prng(37);
+		NormalDistribution<float64_t> normal;
+
+		// a noisy linear function, so that most examples are outside of
+		// the tube, their alphas stay at the bound and get shrunk away
+		SGMatrix<float64_t> data(dim, num_vecs);
+		SGVector<float64_t> lab(num_vecs);
+		for (index_t i=0; i<num_vecs; ++i)
+		{
+			lab[i]=normal(prng);
+			for (index_t j=0; j<dim; ++j)
+			{
+				data(j, i)=normal(prng);
+				lab[i]+=(j+1)*data(j, i);
+			}
+		}
+
+		features=new CDenseFeatures<float64_t>(data);
+		labels=new CRegressionLabels(lab);
+		SG_REF(features);
+		SG_REF(labels);
+		num_threads=env()->get_num_threads();
+	}
+
+	void TearDown()
+	{
+		env()->set_num_threads(num_threads);
+		SG_UNREF(features);
+		SG_UNREF(labels);
+	}
+
+	Some<CSVRLight> train(CKernel* kernel, bool linadd, int32_t threads)
+	{
+		env()->set_num_threads(threads);
+		kernel->init(features, features);
+
+		auto svr=some<CSVRLight>(1.0, 0.1, kernel, labels);
+		svr->set_linadd_enabled(linadd);
+		svr->set_shrinking_enabled(true);
+		svr->train();
+		return svr;
+	}
+
+	void expect_same_solution(CSVRLight* serial, CSVRLight* parallel)
+	{
+		SGVector<float64_t> alphas=serial->get_alphas();
+		SGVector<float64_t> parallel_alphas=parallel->get_alphas();
+		ASSERT_GT(alphas.vlen, 0);
+		ASSERT_EQ(alphas.vlen, parallel_alphas.vlen);
+		EXPECT_EQ(serial->get_bias(), parallel->get_bias());
+		for (index_t i=0; i<alphas.vlen; ++i)
+		{
+			EXPECT_EQ(serial->get_support_vector(i), parallel->get_support_vector(i));
+			EXPECT_EQ(alphas[i], parallel_alphas[i]);
+		}
+	}
+
+	const index_t dim=3;
+	const index_t num_vecs=3000;
+	int32_t num_threads;
+	CDenseFeatures<float64_t>* features;
+	CRegressionLabels* labels;
+};
+
+TEST_F(SVRLightTest, linadd_threads_give_same_solution)
+{
+	auto serial=train(some<CLinearKernel>(), true, 1);
+	auto parallel=train(some<CLinearKernel>(), true, 4);
+	expect_same_solution(serial, parallel);
+}
+
+TEST_F(SVRLightTest, kernel_cache_threads_give_same_solution)
+{
+	// the linear kernel without linadd goes through the kernel cache
+	auto serial=train(some<CLinearKernel>(), false, 1);
+	auto parallel=train(some<CLinearKernel>(), false, 4);
+	expect_same_solution(serial, parallel);
+
+	serial=train(some<CGaussianKernel>(2.0), false, 1);
+	parallel=train(some<CGaussianKernel>(2.0), false, 4);
+	expect_same_solution(serial, parallel);
+}
+#endif //USE_SVMLIGHT